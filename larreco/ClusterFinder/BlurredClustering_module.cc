@@ -11,6 +11,7 @@
 // Framework includes:
 #include "art/Framework/Core/ModuleMacros.h"
 #include "art/Framework/Principal/Event.h"
+#include "art/Framework/Principal/Run.h"
 #include "fhiclcpp/ParameterSet.h"
 #include "art/Framework/Principal/Handle.h"
 #include "art/Persistency/Common/Ptr.h"
@@ -51,6 +52,7 @@ public:
   explicit BlurredClustering(fhicl::ParameterSet const& pset);
   virtual ~BlurredClustering();
 
+  void beginRun(art::Run &run);
   void produce(art::Event &evt);
   void reconfigure(fhicl::ParameterSet const &p);
 
@@ -94,6 +96,11 @@ void cluster::BlurredClustering::reconfigure(fhicl::ParameterSet const& p) {
   fTrackShowerSeparationAlg.reconfigure(p.get<fhicl::ParameterSet>("TrackShowerSeparationAlg"));
 }
 
+void cluster::BlurredClustering::beginRun(art::Run&) {
+  fBlurredClusteringAlg.UpdateGeometry();
+  fMergeClusterAlg.UpdateGeometry();
+}
+
 void cluster::BlurredClustering::produce(art::Event &evt) {
 
   fEvent  = evt.event();
@@ -35,6 +35,10 @@
  *          SeedFinderAlg:                Parameter block required by the Hough Seed Finder algorithm
  *          PCASeedFinderAlg:             Parameter block required by the PCA Seed Finder algorithm
  *          ParrallelHitsAlg:             Parameter block required by the parallel hits algorithm
+ *          MinSpanTreeAlg:               Parameter block required by the minimum spanning tree splitting algorithm
+ *          EnableMSTSplitting:           if true then split clusters at the gaps of their minimum spanning tree
+ *          MSTMinHits:                   minimum number of 3D hits in a cluster to try the minimum spanning tree splitting
+ *          NumThreads:                   number of threads for the per cluster skeleton and seed finding stages
  *
  *          The current producer module does not try to analyze or break apart PFParticles
  *          so, for example, all tracks emanating from a common vertex will be associated
@@ -73,9 +77,11 @@
 #include "larreco/RecoAlg/Cluster3DAlgs/PrincipalComponentsAlg.h"
 #include "larreco/RecoAlg/Cluster3DAlgs/SkeletonAlg.h"
 #include "larreco/RecoAlg/Cluster3DAlgs/DBScanAlg.h"
+#include "larreco/RecoAlg/Cluster3DAlgs/MinSpanTreeAlg.h"
 #include "larreco/RecoAlg/ClusterRecoUtil/StandardClusterParamsAlg.h"
 #include "larreco/RecoAlg/ClusterRecoUtil/OverriddenClusterParamsAlg.h"
 #include "larreco/RecoAlg/ClusterParamsImportWrapper.h"
+#include "larreco/RecoAlg/ParallelFor.h"
 #include "larreco/ClusterFinder/ClusterCreator.h"
 
 // ROOT includes
@@ -86,6 +92,7 @@
 #include <functional>
 #include <iostream>
 #include <memory>
+#include <iterator>
 
 //------------------------------------------------------------------------------------------------------------------------------------------
 
@@ -138,12 +145,12 @@ typedef std::map<geo::View_t, RecobClusterParameters> ViewToClusterParamsMap;
 class ClusterParameters
 {
 public:
-    ClusterParameters(reco::HitPairClusterMap::iterator& mapItr) : m_hitPairListPtr(mapItr->second)
+    ClusterParameters(reco::HitPairClusterMap::iterator& mapItr) : m_hitPairListPtr(mapItr->second), m_sharedHits(false)
     {
         m_clusterParams.clear();
     }
     
-    ClusterParameters(reco::HitPairListPtr& hitList) : m_hitPairListPtr(hitList)
+    ClusterParameters(reco::HitPairListPtr& hitList) : m_hitPairListPtr(hitList), m_sharedHits(false)
     {
         m_clusterParams.clear();
     }
@@ -157,6 +164,8 @@ public:
     reco::HitPairListPtr&     m_hitPairListPtr;
     reco::PrincipalComponents m_fullPCA;
     reco::PrincipalComponents m_skeletonPCA;
+    SeedHitPairListPairVec    m_seedHitPairVec;  ///< Candidate seeds and seed hits found for this cluster
+    bool                      m_sharedHits;      ///< The cluster shares 3D hits with another one
 };
     
 typedef std::list<ClusterParameters> ClusterParametersList;
@@ -239,28 +248,68 @@ private:
      */
     void FillClusterParams(ClusterParameters& clusterParams, double rejectFraction = 0.5, double maxLostRatio = 0.75) const;
     
+    /**
+     *  @brief Run the per cluster reconstruction on the candidate 3D clusters: skeleton, splitting and seeds
+     *
+     *  The skeleton and the seed finding of different clusters are independent and run on m_numThreads
+     *  threads, the splitting modifies the list of clusters (and the 2D hit bookkeeping) and runs serially
+     *  in the order of the list.
+     *
+     *  @param hitPairClusterMap     The map holding the hit lists of the clusters, new clusters are added to it
+     *  @param clusterParametersList The list of clusters
+     */
+    void ProcessClusters(reco::HitPairClusterMap& hitPairClusterMap, ClusterParametersList& clusterParametersList);
+    
+    /**
+     *  @brief Find the medial skeleton of a cluster and run the PCA on the skeleton hits
+     *
+     *  @param clusterParameters     The given cluster parameters object
+     */
+    void skeletonizeCluster(ClusterParameters& clusterParameters) const;
+    
+    /**
+     *  @brief Look for the signatures of clusters to split and call the splitting methods
+     *
+     *  @param clusterParameters     The given cluster parameters object to try to split
+     *  @param hitPairClusterMap     The map holding the hit lists of the clusters, new clusters are added to it
+     *  @param clusterParametersList The list of clusters
+     */
+    void splitCluster(ClusterParameters&       clusterParameters,
+                      reco::HitPairClusterMap& hitPairClusterMap,
+                      ClusterParametersList&   clusterParametersList) const;
+    
     /**
      *  @brief An interface to the seed finding algorithm
      *
+     *  @param cluster      structure of information representing a single cluster, the candidate seeds are stored in it
+     */
+    void findTrackSeeds(ClusterParameters& cluster) const;
+    
+    /**
+     *  @brief Produce the art seeds from the candidate seeds of a cluster
+     *
      *  @param evt          the ART event
      *  @param cluster      structure of information representing a single cluster
      *  @param hitToPtrMap  This maps our Cluster2D hits back to art Ptr's to reco Hits
      *  @param seedVec      the output vector of candidate seeds
      *  @param seedHitAssns the associations between the seeds and the 2D hits making them
      */
-    void findTrackSeeds(art::Event&                         evt,
-                        ClusterParameters&                  cluster,
-                        RecobHitToPtrMap&                   hitToPtrMap,
-                        std::vector<recob::Seed>&           seedVec,
-                        art::Assns<recob::Seed,recob::Hit>& seedHitAssns) const;
+    void ProduceArtSeeds(art::Event&                         evt,
+                         const ClusterParameters&            cluster,
+                         RecobHitToPtrMap&                   hitToPtrMap,
+                         std::vector<recob::Seed>&           seedVec,
+                         art::Assns<recob::Seed,recob::Hit>& seedHitAssns) const;
     
     /**
      *  @brief Attempt to split clusters by using a minimum spanning tree
      *
      *  @param clusterParameters     The given cluster parameters object to try to split
+     *  @param hitPairClusterMap     The map holding the hit lists of the clusters, new clusters are added to it
      *  @param clusterParametersList The list of clusters
      */
-    void splitClustersWithMST(ClusterParameters& clusterParameters, ClusterParametersList& clusterParametersList) const;
+    void splitClustersWithMST(ClusterParameters&       clusterParameters,
+                              reco::HitPairClusterMap& hitPairClusterMap,
+                              ClusterParametersList&   clusterParametersList) const;
     
     /**
      *  @brief Attempt to split clusters using the output of the Hough Filter
@@ -305,6 +354,9 @@ private:
     double                    m_clusHitRejectionFrac;  ///< Cluster hit purity must exceed this to be kept
     double                    m_parallelHitsCosAng;    ///< Cut for PCA 3rd axis angle to X axis
     double                    m_parallelHitsTransWid;  ///< Cut on transverse width of cluster (PCA 2nd eigenvalue)
+    bool                      m_enableMSTSplitting;    ///< Split clusters at the gaps of their minimum spanning tree
+    size_t                    m_mstMinHits;            ///< Minimum number of 3D hits to try the MST splitting
+    size_t                    m_numThreads;            ///< Number of threads for the per cluster stages
 
     /**
      *   Tree variables for output
@@ -318,7 +370,13 @@ private:
     float                     m_makeHitsTime;          ///< Keeps track of time to build 3D hits
     float                     m_buildNeighborhoodTime; ///< Keeps track of time to build epsilon neighborhood
     float                     m_dbscanTime;            ///< Keeps track of time to run DBScan
+    float                     m_buildClustersTime;     ///< Keeps track of time to build the cluster parameters
+    float                     m_skeletonTime;          ///< Keeps track of time to find the skeletons
+    float                     m_splitTime;             ///< Keeps track of time to split clusters
+    float                     m_seedFindTime;          ///< Keeps track of time to find the seeds
     float                     m_finishTime;            ///< Keeps track of time to run output module
+    int                       m_clusters;              ///< Keeps track of the number of clusters processed
+    int                       m_threads;               ///< Keeps track of the number of threads used
     
     /** 
      *   Other useful variables
@@ -332,6 +390,7 @@ private:
     HoughSeedFinderAlg        m_seedFinderAlg;         ///<  Seed finder
     PCASeedFinderAlg          m_pcaSeedFinderAlg;      ///<  Use PCA axis to find seeds
     ParallelHitsSeedFinderAlg m_parallelHitsAlg;       ///<  Deal with parallel hits clusters
+    MinSpanTreeAlg            m_minSpanTreeAlg;        ///<  Split clusters with a minimum spanning tree
 };
 
 DEFINE_ART_MODULE(Cluster3D)
@@ -349,7 +408,8 @@ Cluster3D::Cluster3D(fhicl::ParameterSet const &pset) :
     m_skeletonAlg(pset.get<fhicl::ParameterSet>("SkeletonAlg")),
     m_seedFinderAlg(pset.get<fhicl::ParameterSet>("SeedFinderAlg")),
     m_pcaSeedFinderAlg(pset.get<fhicl::ParameterSet>("PCASeedFinderAlg")),
-    m_parallelHitsAlg(pset.get<fhicl::ParameterSet>("ParallelHitsAlg"))
+    m_parallelHitsAlg(pset.get<fhicl::ParameterSet>("ParallelHitsAlg")),
+    m_minSpanTreeAlg(pset.get<fhicl::ParameterSet>("MinSpanTreeAlg", fhicl::ParameterSet()))
 {
     this->reconfigure(pset);
 
@@ -382,6 +442,14 @@ void Cluster3D::reconfigure(fhicl::ParameterSet const &pset)
     m_clusHitRejectionFrac = pset.get<double>     ("ClusterHitRejectionFrac",    0.5);
     m_parallelHitsCosAng   = pset.get<double>     ("ParallelHitsCosAng",       0.999);
     m_parallelHitsTransWid = pset.get<double>     ("ParallelHitsTransWid",      25.0);
+    m_enableMSTSplitting   = pset.get<bool>       ("EnableMSTSplitting",       false);
+    m_mstMinHits           = pset.get<size_t>     ("MSTMinHits",                 100);
+    m_numThreads           = pset.get<size_t>     ("NumThreads",                   1);
+    
+    // The Hough histogram display draws to ROOT canvases, which must stay in one thread
+    if (pset.get<fhicl::ParameterSet>("SeedFinderAlg").get<bool>("DisplayHoughHist", false)) m_numThreads = 1;
+    
+    if (m_numThreads < 1) m_numThreads = 1;
     
     m_dbScanAlg.reconfigure(pset.get<fhicl::ParameterSet>("DBScanAlg"));
     m_pcaAlg.reconfigure(pset.get<fhicl::ParameterSet>("PrincipalComponentsAlg"));
@@ -389,6 +457,7 @@ void Cluster3D::reconfigure(fhicl::ParameterSet const &pset)
     m_seedFinderAlg.reconfigure(pset.get<fhicl::ParameterSet>("SeedFinderAlg"));
     m_pcaSeedFinderAlg.reconfigure(pset.get<fhicl::ParameterSet>("PCASeedFinderAlg"));
     m_parallelHitsAlg.reconfigure(pset.get<fhicl::ParameterSet>("ParallelHitsAlg"));
+    m_minSpanTreeAlg.reconfigure(pset.get<fhicl::ParameterSet>("MinSpanTreeAlg", fhicl::ParameterSet()));
 }
 
 //------------------------------------------------------------------------------------------------------------------------------------------
@@ -427,6 +496,7 @@ void Cluster3D::produce(art::Event &evt)
     // external profilers
     cet::cpu_timer theClockTotal;
     cet::cpu_timer theClockArtHits;
+    cet::cpu_timer theClockBuildClusters;
     cet::cpu_timer theClockFinish;
     
     if (m_enableMonitoring)
@@ -459,8 +529,15 @@ void Cluster3D::produce(art::Event &evt)
         // Call the main workhorse algorithm for building the local version of candidate 3D clusters
         m_dbScanAlg.ClusterHitsDBScan(viewToHitVectorMap, viewToWireToHitSetMap, *hitPairList, hitPairClusterMap);
         
+        if (m_enableMonitoring) theClockBuildClusters.start();
+        
         // Given the work above, process and build the list of 3D clusters to output
         BuildClusterInfo(hitPairClusterMap, clusterParametersList, m_clusHitRejectionFrac);
+        
+        if (m_enableMonitoring) theClockBuildClusters.stop();
+        
+        // Skeletons, splitting and seeds for each of the clusters
+        ProcessClusters(hitPairClusterMap, clusterParametersList);
     }
     
     if(m_enableMonitoring) theClockFinish.start();
@@ -483,12 +560,17 @@ void Cluster3D::produce(art::Event &evt)
         m_makeHitsTime          = m_dbScanAlg.getTimeToExecute(DBScanAlg::BUILDTHREEDHITS);
         m_buildNeighborhoodTime = m_dbScanAlg.getTimeToExecute(DBScanAlg::BUILDHITTOHITMAP);
         m_dbscanTime            = m_dbScanAlg.getTimeToExecute(DBScanAlg::RUNDBSCAN);
+        m_buildClustersTime     = theClockBuildClusters.accumulated_real_time();
         m_finishTime            = theClockFinish.accumulated_real_time();
         m_hits                  = static_cast<int>(clusterHit2DMasterVec.size());
+        m_clusters              = static_cast<int>(clusterParametersList.size());
+        m_threads               = static_cast<int>(m_numThreads);
         m_pRecoTree->Fill();
         
         mf::LogDebug("Cluster3D") << "*** Cluster3D total time: " << m_totalTime << ", art: " << m_artHitsTime << ", make: " << m_makeHitsTime
-        << ", build: " << m_buildNeighborhoodTime << ", dbscan: " << m_dbscanTime << ", finish: " << m_finishTime << std::endl;
+        << ", build: " << m_buildNeighborhoodTime << ", dbscan: " << m_dbscanTime << ", clusters: " << m_buildClustersTime
+        << ", skeleton: " << m_skeletonTime << ", split: " << m_splitTime << ", seeds: " << m_seedFindTime
+        << " (" << m_threads << " threads), finish: " << m_finishTime << std::endl;
     }
     
     // Will we ever get here? ;-)
@@ -509,7 +591,13 @@ void Cluster3D::InitializeMonitoring()
     m_pRecoTree->Branch("makeHitsTime",         &m_makeHitsTime,          "time/F");
     m_pRecoTree->Branch("buildneigborhoodTime", &m_buildNeighborhoodTime, "time/F");
     m_pRecoTree->Branch("dbscanTime",           &m_dbscanTime,            "time/F");
+    m_pRecoTree->Branch("buildClustersTime",    &m_buildClustersTime,     "time/F");
+    m_pRecoTree->Branch("skeletonTime",         &m_skeletonTime,          "time/F");
+    m_pRecoTree->Branch("splitTime",            &m_splitTime,             "time/F");
+    m_pRecoTree->Branch("seedFindTime",         &m_seedFindTime,          "time/F");
     m_pRecoTree->Branch("finishTime",           &m_finishTime,            "time/F");
+    m_pRecoTree->Branch("clusters",             &m_clusters,              "clusters/I");
+    m_pRecoTree->Branch("threads",              &m_threads,               "threads/I");
 }
 
 //------------------------------------------------------------------------------------------------------------------------------------------
@@ -524,7 +612,13 @@ void Cluster3D::PrepareEvent(const art::Event &evt)
     m_makeHitsTime          = 0.f;
     m_buildNeighborhoodTime = 0.f;
     m_dbscanTime            = 0.f;
+    m_buildClustersTime     = 0.f;
+    m_skeletonTime          = 0.f;
+    m_splitTime             = 0.f;
+    m_seedFindTime          = 0.f;
     m_finishTime            = 0.f;
+    m_clusters              = 0;
+    m_threads               = 0;
 }
 
 //------------------------------------------------------------------------------------------------------------------------------------------
@@ -801,7 +895,9 @@ void Cluster3D::FillClusterParams(ClusterParameters& clusterParams, double rejec
                 }
                 
                 // First stage of feature extraction runs here
-                m_pcaAlg.PCAAnalysis_3D(clusterParams.m_hitPairListPtr, clusterParams.m_fullPCA);
+                lar_cluster3d::PrincipalComponentsAccumulator pcaMoments;
+                
+                m_pcaAlg.PCAAnalysis_3D(clusterParams.m_hitPairListPtr, clusterParams.m_fullPCA, pcaMoments);
                 
                 // Must have a valid pca
                 if (clusterParams.m_fullPCA.getSvdOK())
@@ -813,15 +909,19 @@ void Cluster3D::FillClusterParams(ClusterParameters& clusterParams, double rejec
                     
                         if (maxDoca < 5.)
                         {
-                            size_t curHitVectorSize = hitPairVector.size();
+                            reco::HitPairListPtr rescuedHitList;
                         
                             m_pcaAlg.PCAAnalysis_calc3DDocas(usedHitPairList, clusterParams.m_fullPCA);
                             
                             for(const auto& hit3D : usedHitPairList)
-                                if (hit3D->getDocaToAxis() < maxDoca) hitPairVector.push_back(hit3D);
+                                if (hit3D->getDocaToAxis() < maxDoca) rescuedHitList.push_back(hit3D);
                         
-                            if (hitPairVector.size() > curHitVectorSize)
-                                m_pcaAlg.PCAAnalysis_3D(clusterParams.m_hitPairListPtr, clusterParams.m_fullPCA);
+                            // Only the rescued hits need to be added to the analysis
+                            if (!rescuedHitList.empty())
+                            {
+                                hitPairVector.insert(hitPairVector.end(), rescuedHitList.begin(), rescuedHitList.end());
+                                m_pcaAlg.PCAAnalysis_add3DHits(rescuedHitList, clusterParams.m_fullPCA, pcaMoments);
+                            }
                         }
                     }
                 
@@ -835,11 +935,7 @@ void Cluster3D::FillClusterParams(ClusterParameters& clusterParams, double rejec
     return;
 }
     
-void Cluster3D::findTrackSeeds(art::Event&                         evt,
-                               ClusterParameters&                  cluster,
-                               RecobHitToPtrMap&                   hitToPtrMap,
-                               std::vector<recob::Seed>&           seedVec,
-                               art::Assns<recob::Seed,recob::Hit>& seedHitAssns) const
+void Cluster3D::findTrackSeeds(ClusterParameters& cluster) const
 {
     /**
      *  @brief This method provides an interface to various algorithms for finding candiate 
@@ -851,6 +947,9 @@ void Cluster3D::findTrackSeeds(art::Event&                         evt,
     reco::PrincipalComponents& skeletonPCA    = cluster.m_skeletonPCA;
     reco::HitPairListPtr&      hitPairListPtr = cluster.m_hitPairListPtr;
     reco::HitPairListPtr       skeletonListPtr;
+    SeedHitPairListPairVec&    seedHitPairVec = cluster.m_seedHitPairVec;
+    
+    seedHitPairVec.clear();
 
     // We want to work with the "skeleton" hits so first step is to call the algorithm to
     // recover only these hits from the entire input collection
@@ -860,8 +959,6 @@ void Cluster3D::findTrackSeeds(art::Event&                         evt,
     // the skeleton hits position in the Y-Z plane
     m_skeletonAlg.AverageSkeletonPositions(skeletonListPtr);
     
-    SeedHitPairListPairVec seedHitPairVec;
-    
     // Some combination of the elements below will be used to determine which seed finding algorithm
     // to pursue below
     double eigenVal0 = 3. * sqrt(skeletonPCA.getEigenValues()[0]);
@@ -897,9 +994,18 @@ void Cluster3D::findTrackSeeds(art::Event&                         evt,
         // return a list of candidate seeds and seed hits
         m_seedFinderAlg.findTrackSeeds(skeletonListPtr, skeletonPCA, seedHitPairVec);
     }
-
-    // Go through the returned lists and build out the art friendly seeds and hits
-    for(const auto& seedHitPair : seedHitPairVec)
+    
+    return;
+}
+    
+void Cluster3D::ProduceArtSeeds(art::Event&                         evt,
+                                const ClusterParameters&            cluster,
+                                RecobHitToPtrMap&                   hitToPtrMap,
+                                std::vector<recob::Seed>&           seedVec,
+                                art::Assns<recob::Seed,recob::Hit>& seedHitAssns) const
+{
+    // Go through the lists found by the seed finding and build out the art friendly seeds and hits
+    for(const auto& seedHitPair : cluster.m_seedHitPairVec)
     {
         seedVec.push_back(seedHitPair.first);
         
@@ -927,187 +1033,211 @@ void Cluster3D::findTrackSeeds(art::Event&                         evt,
     return;
 }
     
-struct Hit3DDistanceOrder
+void Cluster3D::ProcessClusters(reco::HitPairClusterMap& hitPairClusterMap, ClusterParametersList& clusterParametersList)
 {
-    bool operator()(const std::pair<double, const reco::ClusterHit3D*>& left, const std::pair<double, const reco::ClusterHit3D*>& right)
-    {
-        return left.first < right.first;
-    }
-};
-    
-void Cluster3D::splitClustersWithMST(ClusterParameters& clusterParameters, ClusterParametersList& clusterParametersList) const
-{
-    // This is being left in place for future development. Essentially, it was an attempt to implement
-    // a Minimum Spanning Tree as a way to split a particular cluster topology, one where two straight
-    // tracks cross closely enought to appear as one cluster. As of Feb 2, 2015 I think the idea is still
-    // worth merit so am leaving this module in place for now.
-    //
-    // If this routine is called then we believe we have a cluster which needs splitting.
-    // The way we will do this is to use a Minimum Spanning Tree algorithm to associate all
-    // hits together by their distance apart. In theory, we should be able to split the cluster
-    // by finding the largest distance and splitting at that point.
-    //
-    // Typedef some data structures that we will use.
-    // Start with the adjacency map
-    typedef std::pair<double, const reco::ClusterHit3D*>                DistanceHit3DPair;
-    typedef std::list<DistanceHit3DPair >                               DistanceHit3DPairList;
-    typedef std::map<const reco::ClusterHit3D*, DistanceHit3DPairList > Hit3DToDistanceMap;
-    
-    // Now typedef the lists we'll keep
-    typedef std::list<const reco::ClusterHit3D*>                        Hit3DList;
-    typedef std::pair<Hit3DList::iterator, Hit3DList::iterator>         Hit3DEdgePair;
-    typedef std::pair<double, Hit3DEdgePair >                           DistanceEdgePair;
-    typedef std::list<DistanceEdgePair >                                DistanceEdgePairList;
-    
-    struct DistanceEdgePairOrder
-    {
-        bool operator()(const DistanceEdgePair& left, const DistanceEdgePair& right) const
-        {
-            return left.first > right.first;
-        }
-    };
-    
-    // Recover the hits we'll work on.
-    // Note that we use on the skeleton hits so will need to recover them
-    reco::HitPairListPtr& hitPairListPtr = clusterParameters.m_hitPairListPtr;
-    reco::HitPairListPtr  skeletonListPtr;
-    
-    // We want to work with the "skeleton" hits so first step is to call the algorithm to
-    // recover only these hits from the entire input collection
-    m_skeletonAlg.GetSkeletonHits(hitPairListPtr, skeletonListPtr);
+    /**
+     *  @brief Drive the per cluster reconstruction in three stages
+     *
+     *         1) the medial skeleton and the skeleton PCA, which only touch the 3D hits of each cluster
+     *            (the clusters out of DBScan do not share 3D hits) and so run concurrently
+     *         2) the splitting of clusters, serially and in the order of the list since the new clusters are
+     *            appended to the list and claim their 2D hits in turn. Steps 1 and 2 are repeated on the clusters
+     *            made by the splitting until none is added.
+     *         3) the seed finding, concurrently again except for the clusters sharing 3D hits which are done
+     *            serially afterwards. The seeds are kept with each cluster and made into art objects in
+     *            the order of the list by ProduceArtClusters
+     */
+    cet::cpu_timer theClockSkeleton;
+    cet::cpu_timer theClockSplit;
+    cet::cpu_timer theClockSeeds;
     
-    // Skeleton hits are nice but we can do better if we then make a pass through to "average"
-    // the skeleton hits position in the Y-Z plane
-    m_skeletonAlg.AverageSkeletonPositions(skeletonListPtr);
+    std::vector<ClusterParameters*> clusterVec;
     
-    // First task is to define and build the adjacency map
-    Hit3DToDistanceMap hit3DToDistanceMap;
+    ClusterParametersList::iterator roundStartItr = clusterParametersList.begin();
     
-    for(reco::HitPairListPtr::const_iterator hit3DOuterItr = skeletonListPtr.begin(); hit3DOuterItr != skeletonListPtr.end(); )
+    while(roundStartItr != clusterParametersList.end())
     {
-        const reco::ClusterHit3D* hit3DOuter   = *hit3DOuterItr++;
-        DistanceHit3DPairList&    outerHitList = hit3DToDistanceMap[hit3DOuter];
-        TVector3                  outerPos(hit3DOuter->getPosition()[0], hit3DOuter->getPosition()[1], hit3DOuter->getPosition()[2]);
+        clusterVec.clear();
         
-        for(reco::HitPairListPtr::const_iterator hit3DInnerItr = hit3DOuterItr; hit3DInnerItr != skeletonListPtr.end(); hit3DInnerItr++)
+        for(ClusterParametersList::iterator clusterItr = roundStartItr; clusterItr != clusterParametersList.end(); clusterItr++)
+            clusterVec.push_back(&*clusterItr);
+        
+        // The splitting below appends to the list, remember where this round stops
+        ClusterParametersList::iterator roundLastItr = std::prev(clusterParametersList.end());
+        
+        if (m_enableMonitoring) theClockSkeleton.start();
+        
+        util::ParallelFor(clusterVec.size(), m_numThreads, [this, &clusterVec](size_t idx, size_t){skeletonizeCluster(*clusterVec[idx]);});
+        
+        if (m_enableMonitoring)
         {
-            const reco::ClusterHit3D* hit3DInner = *hit3DInnerItr;
-            TVector3                  innerPos(hit3DInner->getPosition()[0], hit3DInner->getPosition()[1], hit3DInner->getPosition()[2]);
-            TVector3                  deltaPos = innerPos - outerPos;
-            double                    hitDistance(deltaPos.Mag());
-            
-            if (hitDistance > 20.) continue;
-            
-            hit3DToDistanceMap[hit3DInner].emplace_back(DistanceHit3DPair(hitDistance,hit3DOuter));
-            outerHitList.emplace_back(DistanceHit3DPair(hitDistance,hit3DInner));
+            theClockSkeleton.stop();
+            theClockSplit.start();
         }
         
-        // Make sure our membership bit is clear
-        hit3DOuter->clearStatusBits(reco::ClusterHit3D::SELECTEDBYMST);
+        for(auto& clusterParameters : clusterVec) splitCluster(*clusterParameters, hitPairClusterMap, clusterParametersList);
+        
+        if (m_enableMonitoring) theClockSplit.stop();
+        
+        roundStartItr = std::next(roundLastItr);
     }
     
-    // Make pass through again to order each of the lists
-    for(auto& mapPair : hit3DToDistanceMap)
+    if (m_enableMonitoring) theClockSeeds.start();
+    
+    // Seeds for the clusters with their own hits in parallel, then the others
+    std::vector<ClusterParameters*> sharedClusterVec;
+    
+    clusterVec.clear();
+    
+    for(auto& clusterParameters : clusterParametersList)
     {
-        mapPair.second.sort(Hit3DDistanceOrder());
+        if (!clusterParameters.m_fullPCA.getSvdOK()) continue;
+        
+        if (clusterParameters.m_sharedHits) sharedClusterVec.push_back(&clusterParameters);
+        else                                clusterVec.push_back(&clusterParameters);
     }
     
-    // Get the containers for the MST to operate on/with
-    Hit3DList            hit3DList;
-    DistanceEdgePairList distanceEdgePairList;
+    util::ParallelFor(clusterVec.size(), m_numThreads, [this, &clusterVec](size_t idx, size_t){findTrackSeeds(*clusterVec[idx]);});
     
-    // Initialize with first element
-    hit3DList.emplace_back(skeletonListPtr.front());
-    distanceEdgePairList.emplace_back(DistanceEdgePair(0.,Hit3DEdgePair(hit3DList.begin(),hit3DList.begin())));
+    for(auto& clusterParameters : sharedClusterVec) findTrackSeeds(*clusterParameters);
     
-    skeletonListPtr.front()->setStatusBit(reco::ClusterHit3D::SELECTEDBYMST);
+    if (m_enableMonitoring)
+    {
+        theClockSeeds.stop();
+        
+        m_skeletonTime = theClockSkeleton.accumulated_real_time();
+        m_splitTime    = theClockSplit.accumulated_real_time();
+        m_seedFindTime = theClockSeeds.accumulated_real_time();
+    }
     
-    double largestDistance(0.);
-    double averageDistance(0.);
+    return;
+}
     
-    // Now run the MST
-    // Basically, we loop until the MST list is the same size as the input list
-    while(hit3DList.size() < skeletonListPtr.size())
+void Cluster3D::skeletonizeCluster(ClusterParameters& clusterParameters) const
+{
+    // We keep track of 2 PCA axes, the first is the "full" PCA run over all the 3D hits in the
+    // candidate cluster. The second will be that derived from just using the "skeleton" hits.
+    reco::PrincipalComponents& fullPCA     = clusterParameters.m_fullPCA;
+    reco::PrincipalComponents& skeletonPCA = clusterParameters.m_skeletonPCA;
+    
+    // The chances of getting here and this condition not being true are probably zero... but check anyway
+    if (!fullPCA.getSvdOK()) return;
+    
+    // As tracks become more parallel to the wire plane the number of "ambiguous" 3D hits can increase
+    // rapidly. Now that we have more information we can go back through these hits and do a better job
+    // selecting "the right ones". Here we call the "medial skeleton" algorithm which uses a modification
+    // of a standard medial skeleton procedure to get the 3D hits we want
+    // But note that even this is hopeless in the worst case and, in fact, it can be a time waster
+    // So bypass when you recognize that condition
+    if (aParallelHitsCluster(fullPCA)) return;
+    
+    int nSkeletonPoints = m_skeletonAlg.FindMedialSkeleton(clusterParameters.m_hitPairListPtr);
+    
+    // If enough skeleton points then rerun pca with only those
+    if (nSkeletonPoints > 10)
     {
-        Hit3DList::iterator bestHit3DIter = hit3DList.begin();
-        double              bestDist      = 10000000.;
-        
-        // Loop through all hits currently in the list and look for closest hit not in the list
-        for(Hit3DList::iterator hit3DIter = hit3DList.begin(); hit3DIter != hit3DList.end(); hit3DIter++)
-        {
-            const reco::ClusterHit3D* hit3D = *hit3DIter;
-            
-            // For the given 3D hit, find the closest to it that is not already in the list
-            DistanceHit3DPairList& nearestList = hit3DToDistanceMap[hit3D];
-            
-            while(!nearestList.empty())
-            {
-                const reco::ClusterHit3D* hit3DToCheck = nearestList.front().second;
-                
-                if (!hit3DToCheck->bitsAreSet(reco::ClusterHit3D::SELECTEDBYMST))
-                {
-                    if (nearestList.front().first < bestDist)
-                    {
-                        bestHit3DIter = hit3DIter;
-                        bestDist      = nearestList.front().first;
-                    }
-                    
-                    break;
-                }
-                else nearestList.pop_front();
-            }
-        }
-        
-        if (bestDist > largestDistance) largestDistance = bestDist;
-        
-        averageDistance += bestDist;
+        // Now rerun the principal components axis on just those points
+        m_pcaAlg.PCAAnalysis_3D(clusterParameters.m_hitPairListPtr, skeletonPCA, true);
         
-        // Now we add the best hit not in the list to our list, keep track of the distance
-        // to the object it was closest to
-        const reco::ClusterHit3D* bestHit3D = *bestHit3DIter;                               // "best" hit already in the list
-        const reco::ClusterHit3D* nextHit3D = hit3DToDistanceMap[bestHit3D].front().second; // "next" hit we are adding to the list
-        
-        Hit3DList::iterator nextHit3DIter = hit3DList.insert(hit3DList.end(),nextHit3D);
-        
-        distanceEdgePairList.emplace_back(DistanceEdgePair(bestDist,Hit3DEdgePair(bestHit3DIter,nextHit3DIter)));
+        // If there was a failure (can that happen?) then restore the full PCA
+        if (!skeletonPCA.getSvdOK()) skeletonPCA = fullPCA;
+    }
+    
+    return;
+}
+    
+void Cluster3D::splitCluster(ClusterParameters&       clusterParameters,
+                             reco::HitPairClusterMap& hitPairClusterMap,
+                             ClusterParametersList&   clusterParametersList) const
+{
+    const reco::PrincipalComponents& fullPCA     = clusterParameters.m_fullPCA;
+    const reco::PrincipalComponents& skeletonPCA = clusterParameters.m_skeletonPCA;
+    
+    if (!fullPCA.getSvdOK() || aParallelHitsCluster(fullPCA)) return;
+    
+    // Here we can try to handle a specific case. It can happen that two tracks (think CR muons here) pass so
+    // close together at some point to get merged into one cluster. Now that we have skeletonized the hits and
+    // have run the PCA on the skeleton points we can try to divide these two tracks. The signature will be that
+    // their are a large number of total hits, that the PCA will have a large spread in two dimensions. The
+    // spread in the third dimension will be an indicator of the actual separation between the two tracks
+    // which we might try to exploit in the actual algorithm.
+    // hardwire for now to see what is going on...
+    if (skeletonPCA.getNumHitsUsed() > 1000 && skeletonPCA.getEigenValues()[1] > 100. && fabs(skeletonPCA.getEigenVectors()[2][0]) < m_parallelHitsCosAng)
+    {
+        mf::LogDebug("Cluster3D") << "--> Detected crossed axes!! Total # hits: " << fullPCA.getNumHitsUsed() <<
+            "\n    Skeleton PCA # hits: " << skeletonPCA.getNumHitsUsed() << ", eigenValues: " <<
+            skeletonPCA.getEigenValues()[0] << ", " <<skeletonPCA.getEigenValues()[1] << ", " <<skeletonPCA.getEigenValues()[2] << std::endl;
         
-        nextHit3D->setStatusBit(reco::ClusterHit3D::SELECTEDBYMST);
+        splitClustersWithHough(clusterParameters, hitPairClusterMap, clusterParametersList);
     }
     
-    averageDistance /= double(hit3DList.size());
+    // Clusters which are really separate objects joined by a few hits are split at the
+    // gaps of their minimum spanning tree
+    else if (m_enableMSTSplitting && clusterParameters.m_hitPairListPtr.size() >= m_mstMinHits)
+    {
+        splitClustersWithMST(clusterParameters, hitPairClusterMap, clusterParametersList);
+    }
     
-    double thirdDist = 2.*sqrt(clusterParameters.m_skeletonPCA.getEigenValues()[2]);
+    return;
+}
+    
+void Cluster3D::splitClustersWithMST(ClusterParameters&       clusterParameters,
+                                     reco::HitPairClusterMap& hitPairClusterMap,
+                                     ClusterParametersList&   clusterParametersList) const
+{
+    // @brief Split a cluster at the gaps in its minimum spanning tree
+    //
+    // The hits of a cluster made of separate objects which were merged because of a few stray hits
+    // (or a short distance of closest approach) are connected by a minimum spanning tree with a few
+    // long edges. The tree is built by the MinSpanTreeAlg which also cuts those edges and returns
+    // the hits of each of the resulting pieces, the largest first.
+    // Unlike splitClustersWithHough all the hits are used, not the skeleton ones: every hit has to
+    // end up in a piece, which the tree gives directly without a second pass attaching the other hits,
+    // and the sparser skeleton hits would make the gaps harder to tell from the normal hit spacing.
+    // Only the transverse scale of the cut comes from the skeleton PCA.
+    reco::HitPairListPtr&    hitPairListPtr = clusterParameters.m_hitPairListPtr;
+    reco::HitPairListPtrList hitPairListPtrList;
     
-    // Ok, find the largest distance in the iterator map
-    distanceEdgePairList.sort(DistanceEdgePairOrder());
+    if (m_minSpanTreeAlg.SplitCluster(hitPairListPtr, clusterParameters.m_skeletonPCA, hitPairListPtrList) < 2) return;
     
-    DistanceEdgePairList::iterator largestDistIter = distanceEdgePairList.begin();
+    mf::LogDebug("Cluster3D") << "--> Minimum spanning tree split cluster of " << hitPairListPtr.size() << " hits into "
+                              << hitPairListPtrList.size() << " pieces" << std::endl;
     
-    for(DistanceEdgePairList::iterator edgeIter = distanceEdgePairList.begin(); edgeIter != distanceEdgePairList.end(); edgeIter++)
+    // The fill routines below will expect to see unused 2D hits so we need to clear the
+    // status bits... and I am not sure of a better way...
+    for(const auto& hit3D : hitPairListPtr)
     {
-        if (edgeIter->first < thirdDist) break;
-        
-        largestDistIter = edgeIter;
+        for(const auto& hit2D : hit3D->getHits()) hit2D->clearStatusBits(0x1);
     }
     
-    reco::HitPairListPtr::iterator breakIter = largestDistIter->second.second;
-    reco::HitPairListPtr bestList;
+    // The largest piece stays in the original cluster
+    reco::HitPairListPtrList::iterator hitPairListIter = hitPairListPtrList.begin();
     
-    bestList.resize(std::distance(hit3DList.begin(), breakIter));
+    hitPairListPtr = *hitPairListIter++;
     
-    std::copy(hit3DList.begin(), breakIter, bestList.begin());
+    ClusterParameters originalParams(hitPairListPtr);
     
-    // Remove from the grand hit list and see what happens...
-    // The pieces below are incomplete and were really for testing only.
-    hitPairListPtr.sort();
-    bestList.sort();
+    // Now "fill" the cluster parameters but turn off the hit rejection
+    FillClusterParams(originalParams, 0., 1.);
     
-    reco::HitPairListPtr::iterator newListEnd =
-    std::set_difference(hitPairListPtr.begin(), hitPairListPtr.end(),
-                        bestList.begin(),       bestList.end(),
-                        hitPairListPtr.begin() );
+    // Overwrite original cluster parameters with our new values
+    clusterParameters.m_clusterParams = originalParams.m_clusterParams;
+    clusterParameters.m_fullPCA       = originalParams.m_fullPCA;
+    clusterParameters.m_skeletonPCA   = originalParams.m_fullPCA;
     
-    hitPairListPtr.erase(newListEnd, hitPairListPtr.end());
+    // Each of the other pieces makes a new cluster at the end of the list
+    while(hitPairListIter != hitPairListPtrList.end())
+    {
+        int newClusterKey = hitPairClusterMap.rbegin()->first + 1;
+        
+        reco::HitPairListPtr& newClusterHitList = hitPairClusterMap[newClusterKey];
+        
+        newClusterHitList.swap(*hitPairListIter++);
+        
+        clusterParametersList.push_back(ClusterParameters(newClusterHitList));
+        
+        FillClusterParams(clusterParametersList.back(), 0., 1.);
+    }
     
     return;
 }
@@ -1251,6 +1381,13 @@ void Cluster3D::splitClustersWithHough(ClusterParameters&       clusterParameter
                 std::copy_if(newClusterHitList.begin(), newClusterHitList.end(), tempHitList.begin(), CopyIfInRange(newAllowedHitRange));
 
             hitPairListPtr.insert(hitPairListPtr.end(), tempHitList.begin(), tempListEnd);
+            
+            // The two clusters now have 3D hits in common
+            if (tempListEnd != tempHitList.begin())
+            {
+                clusterParameters.m_sharedHits = true;
+                newClusterParams.m_sharedHits  = true;
+            }
         }
  
         // Of course, now we need to modify the original cluster parameters
@@ -1324,9 +1461,8 @@ void Cluster3D::ProduceArtClusters(art::Event&              evt,
         // Create id for space points
         int    spacePointID(0);
         
-        // This is the loop over candidate 3D clusters
-        // Note that it might be that the list of candidate clusters is modified by splitting
-        // So we use the following construct to make sure we get all of them
+        // This is the loop over candidate 3D clusters, any splitting has already been done
+        // by ProcessClusters so the list is final and its order sets the order of the output
         ClusterParametersList::iterator clusterParametersListItr = clusterParametersList.begin();
         
         while(clusterParametersListItr != clusterParametersList.end())
@@ -1335,8 +1471,7 @@ void Cluster3D::ProduceArtClusters(art::Event&              evt,
             ClusterParameters& clusterParameters = *clusterParametersListItr;
             
             // It should be straightforward at this point to transfer information from our vector of clusters
-            // to the larsoft objects... of course we still have some work to do first, in particular to
-            // find the candidate seeds and their seed hits
+            // to the larsoft objects, the candidate seeds and their seed hits have been found already
             
             // We keep track of 2 PCA axes, the first is the "full" PCA run over all the 3D hits in the
             // candidate cluster. The second will be that derived from just using the "skeleton" hits.
@@ -1352,43 +1487,6 @@ void Cluster3D::ProduceArtClusters(art::Event&              evt,
                 continue;
             }
             
-            // As tracks become more parallel to the wire plane the number of "ambiguous" 3D hits can increase
-            // rapidly. Now that we have more information we can go back through these hits and do a better job
-            // selecting "the right ones". Here we call the "medial skeleton" algorithm which uses a modification
-            // of a standard medial skeleton procedure to get the 3D hits we want
-            // But note that even this is hopeless in the worst case and, in fact, it can be a time waster
-            // So bypass when you recognize that condition
-            if (!aParallelHitsCluster(fullPCA))
-            {
-                int nSkeletonPoints = m_skeletonAlg.FindMedialSkeleton(clusterParameters.m_hitPairListPtr);
-            
-                // If enough skeleton points then rerun pca with only those
-                if (nSkeletonPoints > 10)
-                {
-                    // Now rerun the principal components axis on just those points
-                    m_pcaAlg.PCAAnalysis_3D(clusterParameters.m_hitPairListPtr, skeletonPCA, true);
-                
-                    // If there was a failure (can that happen?) then restore the full PCA
-                    if (!skeletonPCA.getSvdOK()) skeletonPCA = fullPCA;
-                }
-            
-                // Here we can try to handle a specific case. It can happen that two tracks (think CR muons here) pass so
-                // close together at some point to get merged into one cluster. Now that we have skeletonized the hits and
-                // have run the PCA on the skeleton points we can try to divide these two tracks. The signature will be that
-                // their are a large number of total hits, that the PCA will have a large spread in two dimensions. The
-                // spread in the third dimension will be an indicator of the actual separation between the two tracks
-                // which we might try to exploit in the actual algorithm.
-                // hardwire for now to see what is going on...
-                if (skeletonPCA.getNumHitsUsed() > 1000 && skeletonPCA.getEigenValues()[1] > 100. && fabs(skeletonPCA.getEigenVectors()[2][0]) < m_parallelHitsCosAng)
-                {
-                    mf::LogDebug("Cluster3D") << "--> Detected crossed axes!! Total # hits: " << fullPCA.getNumHitsUsed() <<
-                        "\n    Skeleton PCA # hits: " << skeletonPCA.getNumHitsUsed() << ", eigenValues: " <<
-                        skeletonPCA.getEigenValues()[0] << ", " <<skeletonPCA.getEigenValues()[1] << ", " <<skeletonPCA.getEigenValues()[2] << std::endl;
-                    
-                    splitClustersWithHough(clusterParameters, hitPairClusterMap, clusterParametersList);
-                }
-            }
-        
             // Start loop over views to build out the hit lists and the 2D cluster objects
             for(ViewToClusterParamsMap::const_iterator viewItr = clusterParameters.m_clusterParams.begin(); viewItr != clusterParameters.m_clusterParams.end(); viewItr++)
             {
@@ -1505,8 +1603,8 @@ void Cluster3D::ProduceArtClusters(art::Event&              evt,
             // Keep track of how many we have so far
             size_t numSeedsStart = artSeedVector->size();
             
-            // Call the magical algorith to do the dirty work
-            findTrackSeeds(evt, clusterParameters, hitToPtrMap, *artSeedVector, *artSeedHitAssociations);
+            // The seeds were found by ProcessClusters, convert them to art
+            ProduceArtSeeds(evt, clusterParameters, hitToPtrMap, *artSeedVector, *artSeedHitAssociations);
             
             // Right now error matrix is uniform...
             double spError[] = {1., 0., 1., 0., 0., 1.};
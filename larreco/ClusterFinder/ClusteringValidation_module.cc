@@ -38,6 +38,7 @@
 #include "lardata/Utilities/AssociationUtil.h"
 #include "lardata/RawData/ExternalTrigger.h"
 #include "larsim/MCCheater/BackTracker.h"
+#include "larreco/MCComp/MCHitTruthIndex.h"
 #include "lardata/AnalysisBase/ParticleID.h"
 #include "SimulationBase/MCParticle.h"
 #include "SimulationBase/MCTruth.h"
@@ -173,7 +174,7 @@ public:
 
   explicit ClusterAnalyser(std::string &label);
 
-  void                    Analyse(std::vector<art::Ptr<recob::Hit> > &hits, std::vector<art::Ptr<recob::Cluster> > &clusters, const art::FindManyP<recob::Hit> &fmh, int numHits);
+  void                    Analyse(std::vector<art::Ptr<recob::Hit> > &hits, std::vector<art::Ptr<recob::Cluster> > &clusters, const art::FindManyP<recob::Hit> &fmh, int numHits, const btutil::MCHitTruthIndex *truthIndex);
   TrackID                 FindTrackID(art::Ptr<recob::Hit> &hit);
   TrackID                 FindTrueTrack(std::vector<art::Ptr<recob::Hit> > &clusterHits);
   double                  FindPhotonAngle();
@@ -201,6 +202,9 @@ private:
   std::map<unsigned int,std::map<unsigned int,std::unique_ptr<ClusterCounter> > > clusterMap;
   std::map<TrackID,const simb::MCParticle*>                                       trueParticles;
 
+  // Truth of all the hits of the event (nullptr to ask the back tracker for each hit)
+  const btutil::MCHitTruthIndex *fTruthIndex = nullptr;
+
   // Services
   art::ServiceHandle<geo::Geometry> geometry;
   art::ServiceHandle<cheat::BackTracker> backtracker;
@@ -240,7 +244,9 @@ ClusteringValidation::ClusterAnalyser::ClusterAnalyser(std::string &clusterLabel
 
 }
 
-void ClusteringValidation::ClusterAnalyser::Analyse(std::vector<art::Ptr<recob::Hit> > &hits, std::vector<art::Ptr<recob::Cluster> > &clusters, const art::FindManyP<recob::Hit> &fmh, int minHits) {
+void ClusteringValidation::ClusterAnalyser::Analyse(std::vector<art::Ptr<recob::Hit> > &hits, std::vector<art::Ptr<recob::Cluster> > &clusters, const art::FindManyP<recob::Hit> &fmh, int minHits, const btutil::MCHitTruthIndex *truthIndex) {
+
+  fTruthIndex = truthIndex;
 
   // Make a map of cluster counters in TPC/plane space
   for (unsigned int tpc = 0; tpc < geometry->NTPC(0); ++tpc) {
@@ -298,6 +304,10 @@ void ClusteringValidation::ClusterAnalyser::Analyse(std::vector<art::Ptr<recob::
 }
 
 TrackID ClusteringValidation::ClusterAnalyser::FindTrackID(art::Ptr<recob::Hit> &hit) {
+  if (fTruthIndex) {
+    size_t index = fTruthIndex->Index(hit);
+    if (index != btutil::kINVALID_INDEX) return (TrackID)fTruthIndex->MainTrackID(index);
+  }
   double particleEnergy = 0;
   TrackID likelyTrackID = (TrackID)0;
   std::vector<sim::TrackIDE> trackIDs = backtracker->HitToTrackID(hit);
@@ -477,6 +487,10 @@ private:
   // Minimum hits needed to analyse a plane
   int fMinHitsInPlane;
 
+  // Back-track all the hits once per event, from the SimChannels of the back tracker
+  bool fUseTruthIndex;
+  btutil::MCHitTruthIndex fTruthIndex;
+
   // Canvas on which to save histograms
   TCanvas *fCanvas;
 
@@ -496,6 +510,7 @@ void ClusteringValidation::ClusteringValidation::reconfigure(fhicl::ParameterSet
   fMinHitsInPlane      = p.get<int>                      ("MinHitsInPlane");
   fClusterModuleLabels = p.get<std::vector<std::string> >("ClusterModuleLabels");
   fHitsModuleLabel     = p.get<std::string>              ("HitsModuleLabel");
+  fUseTruthIndex       = p.get<bool>                     ("UseTruthIndex",false);
 }
 
 void ClusteringValidation::ClusteringValidation::analyze(art::Event const &evt)
@@ -506,6 +521,14 @@ void ClusteringValidation::ClusteringValidation::analyze(art::Event const &evt)
   if (evt.getByLabel(fHitsModuleLabel,hitHandle))
     art::fill_ptr_vector(hits, hitHandle);
 
+  // Back-track the hits once for all the clusterings
+  const btutil::MCHitTruthIndex *truthIndex = nullptr;
+  art::ServiceHandle<cheat::BackTracker> backtracker;
+  if (fUseTruthIndex && !evt.isRealData() && !backtracker->SimChannels().empty()) {
+    fTruthIndex.Reset(backtracker->SimChannels(), hits);
+    truthIndex = &fTruthIndex;
+  }
+
   // Get clustering information from event
   // and give to the ClusterAnalyser to analyse
   for (auto clustering : fClusterModuleLabels) {
@@ -520,7 +543,7 @@ void ClusteringValidation::ClusteringValidation::analyze(art::Event const &evt)
     art::FindManyP<recob::Hit> fmh(clusterHandle,evt,clustering);
 
     // Analyse this particular clustering
-    clusterAnalysis.at(clustering)->Analyse(hits, clusters, fmh, fMinHitsInPlane);
+    clusterAnalysis.at(clustering)->Analyse(hits, clusters, fmh, fMinHitsInPlane, truthIndex);
 
   }
 }
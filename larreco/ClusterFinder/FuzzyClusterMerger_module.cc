@@ -95,6 +95,11 @@ namespace cluster {
     int fPSD2MinHits;
     int fPSD2MaxHits; 
     double fPSD2MinDistSqd; 
+
+    size_t fNumThreads;    ///< threads evaluating cluster pairs in each merge stage
+    bool   fBoxPrefilter;  ///< only inspect pairs with overlapping bounding boxes
+    double fBoxMargin;     ///< bounding box margin for the prefilter [cm]
+    bool   fIncrementalMerge; ///< combine statistics of merged clusters from their parts
     
     
 //     TSep1UseEP:  true
@@ -178,6 +183,11 @@ namespace cluster {
     fPSD2MinHits = p.get<int>("PSD2MinHits");
     fPSD2MaxHits = p.get<int>("PSD2MaxHits");
     fPSD2MinDistSqd = p.get<double>("PSD2MinDistSqd");
+
+    fNumThreads = p.get<size_t>("NumThreads",1);
+    fBoxPrefilter = p.get<bool>("BoxPrefilter",false);
+    fBoxMargin = p.get<double>("BoxMargin",0.);
+    fIncrementalMerge = p.get<bool>("IncrementalMerge",false);
  
  
     
@@ -185,6 +195,9 @@ namespace cluster {
    
 
     fCMerge.GetManager(0).MergeTillConverge(true);
+    fCMerge.GetManager(0).SetNumThreads(fNumThreads);
+    fCMerge.GetManager(0).SetBoxPrefilter(fBoxPrefilter,fBoxMargin);
+    fCMerge.GetManager(0).SetIncrementalMerge(fIncrementalMerge);
     //fCMerge.GetManager(0).DebugMode(::cmtool::CMergeManager::kPerIteration);
 
     // Prohibit algorithms    
@@ -219,6 +232,9 @@ namespace cluster {
     // Configure 2nd stage merging
     //auto& fCMerge.GetManager(1) = GetManager(1);
     fCMerge.GetManager(1).MergeTillConverge(true);
+    fCMerge.GetManager(1).SetNumThreads(fNumThreads);
+    fCMerge.GetManager(1).SetBoxPrefilter(fBoxPrefilter,fBoxMargin);
+    fCMerge.GetManager(1).SetIncrementalMerge(fIncrementalMerge);
     //fCMerge.GetManager(0).DebugMode(::cmtool::CMergeManager::kPerIteration);
     
     // Prohibit algorithms
@@ -13,10 +13,11 @@
 ////////////////////////////////////////////////////////////////////////
 
 #include <string>
-#include <cmath> // std::abs(), std::sqrt()
+#include <cmath> // std::abs(), std::sqrt(), std::atan(), std::isfinite()
 #include <iomanip>
 #include <vector>
 #include <array>
+#include <algorithm> // std::sort(), std::lower_bound(), std::upper_bound()
 #include <memory> // std::unique_ptr<>
 #include <utility> // std::move()
 
@@ -66,6 +67,7 @@ namespace cluster {
     double          fEndpointWindow; // tolerance for matching endpoints (in units of time samples) 
    
     bool SlopeCompatibility(double slope1,double slope2);
+    bool AngleCompatibility(double angle1,double angle2); ///< angles from atan() of the slopes
     int  EndpointCompatibility(
       float sclstartwire, float sclstarttime,
       float sclendwire,   float sclendtime,
@@ -375,6 +377,82 @@ namespace cluster{
   } // ClusterAndHitMerger::Add()
   
   
+  /// Input clusters of a view, sorted by start wire and by end wire
+  class ClusterEndsIndex {
+      public:
+    
+    /// Adds the cluster at the next position
+    void Add(recob::Cluster const& cluster)
+      {
+        size_t const pos = fNClusters++;
+        if (std::isfinite(cluster.StartWire()))
+          fStarts.emplace_back(cluster.StartWire(), pos);
+        if (std::isfinite(cluster.EndWire()))
+          fEnds.emplace_back(cluster.EndWire(), pos);
+      } // Add()
+    
+    /// Sorts the clusters; to be called after all of them have been added
+    void Sort()
+      {
+        std::sort(fStarts.begin(), fStarts.end());
+        std::sort(fEnds.begin(), fEnds.end());
+      } // Sort()
+    
+    /**
+     * @brief Collects the clusters with an end close in wire to one of the given ends
+     * @param startWire wire of the start of the reference cluster
+     * @param endWire wire of the end of the reference cluster
+     * @param window largest wire distance
+     * @param after only the clusters at positions after this one are collected
+     * @param matched clusters flagged here are skipped
+     * @param candidates (output) positions of the clusters, in increasing order
+     *
+     * A cluster is collected if its start wire is within the window from
+     * endWire, or its end wire is within the window from startWire.
+     * Clusters with non-finite end wires are never collected from that end.
+     */
+    void Candidates(
+      float startWire, float endWire, double window, size_t after,
+      std::vector<int> const& matched, std::vector<size_t>& candidates
+      ) const
+      {
+        candidates.clear();
+        Collect(fStarts, endWire, window, after, matched, candidates);
+        Collect(fEnds, startWire, window, after, matched, candidates);
+        std::sort(candidates.begin(), candidates.end());
+        candidates.erase
+          (std::unique(candidates.begin(), candidates.end()), candidates.end());
+      } // Candidates()
+    
+      private:
+    using WirePos_t = std::pair<double, size_t>; ///< (wire, position)
+    
+    size_t fNClusters = 0;
+    std::vector<WirePos_t> fStarts; ///< start wires, sorted
+    std::vector<WirePos_t> fEnds; ///< end wires, sorted
+    
+    static void Collect(
+      std::vector<WirePos_t> const& wires, float wire, double window,
+      size_t after, std::vector<int> const& matched,
+      std::vector<size_t>& candidates
+      )
+      {
+        if (!std::isfinite(wire) || !(window > 0.)) return;
+        auto const less = [](WirePos_t const& a, WirePos_t const& b)
+          { return a.first < b.first; };
+        auto iWire = std::lower_bound(wires.begin(), wires.end(),
+          WirePos_t(wire - window, 0), less);
+        auto const wend = std::upper_bound(iWire, wires.end(),
+          WirePos_t(wire + window, 0), less);
+        for (; iWire != wend; ++iWire) {
+          if ((iWire->second > after) && (matched[iWire->second] != 1))
+            candidates.push_back(iWire->second);
+        }
+      } // Collect()
+    
+  }; // class ClusterEndsIndex
+  
+  
   //-------------------------------------------------
   LineMerger::LineMerger(fhicl::ParameterSet const& pset) 
     : fClusterModuleLabel(pset.get<std::string>("ClusterModuleLabel"))
@@ -446,16 +524,30 @@ namespace cluster{
     
     art::FindManyP<recob::Hit> fmh(clusterVecHandle, evt, fClusterModuleLabel);
     
+    // EndpointCompatibility() can't match ends farther than this in wires;
+    // the margin covers the single precision of the distance
+    double const wireWindow = fEndpointWindow / std::sqrt(13.5) * (1. + 1e-4);
+    
     for(size_t i = 0; i < nViews; ++i){
 
       int clustersfound = 0; // how many merged clusters found in each plane
-      int clsnum1       = 0;
 
+      // end wires and slopes of the clusters of the view, computed once
+      ClusterEndsIndex endsIndex;
+      std::vector<double> startSlopes, endSlopes;
+      startSlopes.reserve(ClsIndices[i].size());
+      endSlopes.reserve(ClsIndices[i].size());
       for(size_t c = 0; c < ClsIndices[i].size(); ++c){
-        if(Cls_matches[i][clsnum1] == 1){
-          ++clsnum1;
-          continue;
-        }
+        recob::Cluster const& cl = clusterVecHandle->at(ClsIndices[i][c]);
+        endsIndex.Add(cl);
+        startSlopes.push_back(std::atan(double(cl.StartAngle())));
+        endSlopes.push_back(std::atan(double(cl.EndAngle())));
+      }
+      endsIndex.Sort();
+      
+      std::vector<size_t> candidates;
+      for(size_t c = 0; c < ClsIndices[i].size(); ++c){
+        if(Cls_matches[i][c] == 1) continue;
 
         // make a new cluster to put into the SuperClusters collection 
         // because we want to be able to adjust it later;
@@ -465,50 +557,62 @@ namespace cluster{
         ClusterAndHitMerger cl1(StartingCluster, fmh.at(ClsIndices[i][c]));
         const recob::Cluster::ID_t clusterID = StartingCluster.ID();
 
-        Cls_matches[i][clsnum1] = 1; 
+        Cls_matches[i][c] = 1; 
         ++clustersfound;
         
-        int clsnum2 = 0;
-        for(size_t c2 = 0; c2 < ClsIndices[i].size(); ++c2){
-
-          if(Cls_matches[i][clsnum2] == 1){
-            ++clsnum2;
-            continue;
-          }
-
-          const recob::Cluster& cl2( clusterVecHandle->at(ClsIndices[i][c2]) );
-
-          
-          // check that the slopes are the same
-          // added 13.5 ticks/wirelength in ArgoNeuT. 
-          // \todo need to make this detector agnostic
-          // would be nice to have a LArProperties function that returns ticks/wire.
-          bool sameSlope = SlopeCompatibility(cl1.StartAngle(), cl2.EndAngle())
-            || SlopeCompatibility(cl1.EndAngle(), cl2.StartAngle());
+        // all the clusters before this one are merged already; the others
+        // are tried in their order against the current cl1, which changes
+        // after each combination: only the ones with an end close in wire to
+        // the ends of cl1 can match, and they are collected again after each
+        // combination, after the last cluster combined
+        size_t after = c;
+        bool combined = true;
+        while(combined){
+          combined = false;
           
-          // check that the endpoints fall within a circular window of each other 
-          // done in place of intercept matching
-          int sameEndpoint = EndpointCompatibility(
-            cl1.StartWire(), cl1.StartTick(),
-            cl1.EndWire(),   cl1.EndTick(),
-            cl2.StartWire(), cl2.StartTick(),
-            cl2.EndWire(),   cl2.EndTick()
-            );
+          double const cl1StartSlope = std::atan(double(cl1.StartAngle()));
+          double const cl1EndSlope = std::atan(double(cl1.EndAngle()));
+          endsIndex.Candidates(cl1.StartWire(), cl1.EndWire(), wireWindow,
+            after, Cls_matches[i], candidates);
           
-          // if the slopes and end points are the same, combine the clusters
-          // note that after 1 combination cl1 is no longer what we started 
-          // with
-          if(sameSlope && (sameEndpoint != 0)) {
-            // combine the hit collections too
-            // (find the hits associated with this second cluster);
-            // take into account order when merging hits from two clusters: doc-1776
-            // if sameEndpoint is 1, the new hits come first
-            cl1.Add(cl2, fmh.at(ClsIndices[i][c2]), sameEndpoint == 1);
-            Cls_matches[i][clsnum2] = 1;
-          }
-          
-          ++clsnum2;
-        }// end loop over second cluster iterator
+          for(size_t c2: candidates){
+
+            const recob::Cluster& cl2( clusterVecHandle->at(ClsIndices[i][c2]) );
+
+            
+            // check that the slopes are the same
+            // added 13.5 ticks/wirelength in ArgoNeuT. 
+            // \todo need to make this detector agnostic
+            // would be nice to have a LArProperties function that returns ticks/wire.
+            bool sameSlope = AngleCompatibility(cl1StartSlope, endSlopes[c2])
+              || AngleCompatibility(cl1EndSlope, startSlopes[c2]);
+            
+            // check that the endpoints fall within a circular window of each other 
+            // done in place of intercept matching
+            int sameEndpoint = EndpointCompatibility(
+              cl1.StartWire(), cl1.StartTick(),
+              cl1.EndWire(),   cl1.EndTick(),
+              cl2.StartWire(), cl2.StartTick(),
+              cl2.EndWire(),   cl2.EndTick()
+              );
+            
+            // if the slopes and end points are the same, combine the clusters
+            // note that after 1 combination cl1 is no longer what we started 
+            // with
+            if(sameSlope && (sameEndpoint != 0)) {
+              // combine the hit collections too
+              // (find the hits associated with this second cluster);
+              // take into account order when merging hits from two clusters: doc-1776
+              // if sameEndpoint is 1, the new hits come first
+              cl1.Add(cl2, fmh.at(ClsIndices[i][c2]), sameEndpoint == 1);
+              Cls_matches[i][c2] = 1;
+              after = c2;
+              combined = true;
+              break;
+            }
+            
+          }// end loop over second cluster candidates
+        }// end while clusters are combined
 
         // now add the final version of cl1 to the collection of SuperClusters
         // and create the association between the super cluster and the hits
@@ -544,7 +648,6 @@ namespace cluster{
           );
         
         util::CreateAssn(*this, evt, *(SuperClusters.get()), cl1.Hits(), *(assn.get()));
-        ++clsnum1;
 
       }// end loop over first cluster iterator
     }// end loop over planes
@@ -565,11 +668,15 @@ namespace cluster{
   //checks the difference between angles of the two lines
   bool LineMerger::SlopeCompatibility(double slope1, double slope2)
   { 
-    double sl1 = atan(slope1);
-    double sl2 = atan(slope2);
-
+    return AngleCompatibility(atan(slope1), atan(slope2));
+  }
+  
+  //------------------------------------------------------------------------------------//
+  //checks the difference between two angles
+  bool LineMerger::AngleCompatibility(double angle1, double angle2)
+  { 
     //the units of fSlope are radians
-    bool comp  = std::abs(sl1-sl2) < fSlope ? true : false;
+    bool comp  = std::abs(angle1-angle2) < fSlope ? true : false;
 
     return comp;
   }
@@ -387,20 +387,14 @@ void tss::Segmentation2D::splitHitsNaive(
 		std::vector< const tss::Hit2D* > & trackHits,
 		std::vector< const tss::Hit2D* > & emHits) const
 {
-	const double rad2 = fDenseHitRadius * fDenseHitRadius;
-
 	trackHits.clear();
 	emHits.clear();
 
+	tss::HitGrid grid(inp.hits(), fDenseHitRadius);
+
 	for (const auto hx : inp.hits())
 	{
-		size_t n = 0;
-		for (const auto hy : inp.hits())
-		{
-			if (hx->Hit2DPtr() == hy->Hit2DPtr()) continue;
-
-			if (pma::Dist2(hx->Point2D(), hy->Point2D()) < rad2) n++;
-		}
+		size_t n = grid.countNeighbours(*hx, fDenseHitRadius, fDenseMinH);
 
 		if (n > fDenseMinH)
 		{
@@ -419,29 +413,23 @@ void tss::Segmentation2D::splitHitsNaive(
 		std::vector< const tss::Hit2D* > & trackHits,
 		std::vector< const tss::Hit2D* > & emHits) const
 {
-	const double rad2 = fDenseHitRadius * fDenseHitRadius;
-
 	trackHits.clear();
 	emHits.clear();
 
+	std::vector< const tss::Hit2D* > allHits;
+	for (const auto & cx : inp)
+	{
+		for (const auto hx : cx.hits()) allHits.push_back(hx);
+	}
+	tss::HitGrid grid(allHits, fDenseHitRadius);
+
 	for (const auto & cx : inp)
 	{
 		if (!cx.size()) continue;
 
 		for (const auto hx : cx.hits())
 		{
-			size_t n = 0;
-			for (const auto & cy : inp)
-			{
-				if (!cy.size()) continue;
-
-				for (const auto hy : cy.hits())
-				{
-					if (hx->Hit2DPtr() == hy->Hit2DPtr()) continue;
-
-					if (pma::Dist2(hx->Point2D(), hy->Point2D()) < rad2) n++;
-				}
-			}
+			size_t n = grid.countNeighbours(*hx, fDenseHitRadius, fDenseMinH);
 
 			if (n > fDenseMinH)
 			{
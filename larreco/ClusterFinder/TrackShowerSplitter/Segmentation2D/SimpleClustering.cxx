@@ -10,6 +10,10 @@
 
 #include "messagefacility/MessageLogger/MessageLogger.h"
 
+#include <algorithm>
+#include <map>
+#include <set>
+
 tss::Cluster2D::Cluster2D(const std::vector< const tss::Hit2D* > & hits) :
 	fDenseStart(false), fDenseEnd(false), fIsEM(false)
 {
@@ -115,6 +119,25 @@ const TVector2 tss::Cluster2D::max(void) const
 
 // ------------------------------------------------------
 
+bool tss::Cluster2D::boundingBox(TVector2 & lo, TVector2 & hi) const
+{
+	if (!fHits.size()) return false;
+
+	double xmin = fHits[0]->Point2D().X(), xmax = xmin;
+	double ymin = fHits[0]->Point2D().Y(), ymax = ymin;
+	for (size_t i = 1; i < fHits.size(); ++i)
+	{
+		const TVector2 & p = fHits[i]->Point2D();
+		if (p.X() < xmin) xmin = p.X();
+		if (p.X() > xmax) xmax = p.X();
+		if (p.Y() < ymin) ymin = p.Y();
+		if (p.Y() > ymax) ymax = p.Y();
+	}
+	lo.Set(xmin, ymin); hi.Set(xmax, ymax);
+	return true;
+}
+// ------------------------------------------------------
+
 bool tss::Cluster2D::has(const tss::Hit2D* hit) const
 {
 	for (size_t i = 0; i < fHits.size(); ++i)
@@ -160,10 +183,19 @@ double tss::Cluster2D::dist2(const tss::Cluster2D & clu) const
 {
 	if (fHits.size())
 	{
+		TVector2 lo, hi;
+		if (!clu.boundingBox(lo, hi)) return clu.dist2(fHits.front()->Point2D()); // 0, as before
+
 		double d2, min_d2 = clu.dist2(fHits.front()->Point2D());
-		for (size_t i = 1; i < fHits.size(); ++i)
+		for (size_t i = 1; (i < fHits.size()) && (min_d2 > 0.0); ++i)
 		{
-			d2 = clu.dist2(fHits[i]->Point2D());
+			// skip hits which cannot be closer than min_d2 to any hit inside the box
+			const TVector2 & p = fHits[i]->Point2D();
+			double dx = std::max(0.0, std::max(lo.X() - p.X(), p.X() - hi.X()));
+			double dy = std::max(0.0, std::max(lo.Y() - p.Y(), p.Y() - hi.Y()));
+			if (dx * dx + dy * dy >= min_d2) continue;
+
+			d2 = clu.dist2(p);
 			if (d2 < min_d2) { min_d2 = d2; }
 		}
 		return min_d2;
@@ -176,6 +208,48 @@ double tss::Cluster2D::dist2(const tss::Cluster2D & clu) const
 // ------------------------------------------------------
 // ------------------------------------------------------
 
+tss::HitGrid::HitGrid(const std::vector< const tss::Hit2D* > & hits, double cellSize) :
+	fCellSize(cellSize > 0.0 ? cellSize : 1.0)
+{
+	for (const auto h : hits)
+	{
+		fCells[cellKey(cellIndex(h->Point2D().X()), cellIndex(h->Point2D().Y()))].push_back(h);
+	}
+}
+// ------------------------------------------------------
+
+size_t tss::HitGrid::countNeighbours(const tss::Hit2D & hit, double r, size_t maxN) const
+{
+	const double r2 = r * r;
+	const TVector2 & p0 = hit.Point2D();
+
+	long long ix0 = cellIndex(p0.X() - r), ix1 = cellIndex(p0.X() + r);
+	long long iy0 = cellIndex(p0.Y() - r), iy1 = cellIndex(p0.Y() + r);
+
+	size_t n = 0;
+	for (long long ix = ix0; ix <= ix1; ++ix)
+		for (long long iy = iy0; iy <= iy1; ++iy)
+	{
+		auto cell = fCells.find(cellKey(ix, iy));
+		if (cell == fCells.end()) continue;
+
+		for (const auto h : cell->second)
+		{
+			if (h->Hit2DPtr() == hit.Hit2DPtr()) continue;
+
+			if (pma::Dist2(h->Point2D(), p0) < r2)
+			{
+				if (++n > maxN) return n;
+			}
+		}
+	}
+	return n;
+}
+// ------------------------------------------------------
+
+// ------------------------------------------------------
+// ------------------------------------------------------
+
 
 bool tss::SimpleClustering::hitsTouching(const tss::Hit2D & h1, const tss::Hit2D & h2) const
 {
@@ -217,78 +291,136 @@ bool tss::SimpleClustering::hitsTouching(const tss::Cluster2D & c1, const tss::C
 }
 // ------------------------------------------------------
 
-void tss::SimpleClustering::merge(std::vector< tss::Cluster2D > & clusters) const
+void tss::SimpleClustering::findTouching(
+	const std::vector< const tss::Hit2D* > & inp,
+	std::vector< std::vector< size_t > > & touchedBy) const
 {
-	bool merged = true;
-	while (merged)
+	// hits on each wire, sorted by the start tick
+	std::map< unsigned int, std::vector< size_t > > wireHits;
+	std::map< unsigned int, int > wireMaxLength;
+	for (size_t h = 0; h < inp.size(); ++h)
 	{
-		merged = false;
+		wireHits[inp[h]->Wire()].push_back(h);
+		int & maxLength = wireMaxLength[inp[h]->Wire()];
+		maxLength = std::max(maxLength, inp[h]->EndTick() - inp[h]->StartTick());
+	}
+	for (auto & w : wireHits)
+	{
+		std::sort(w.second.begin(), w.second.end(),
+			[&inp](size_t a, size_t b) { return inp[a]->StartTick() < inp[b]->StartTick(); });
+	}
 
-		size_t i = 0;
-		while (i < clusters.size() - 1)
+	// touchedBy[h] are the hits t with hitsTouching(t, h); the relation is not
+	// symmetric at wire 0, so it is always evaluated in this order
+	touchedBy.assign(inp.size(), std::vector< size_t >());
+	for (size_t h = 0; h < inp.size(); ++h)
+	{
+		const tss::Hit2D & hit = *(inp[h]);
+		unsigned int w0 = (hit.Wire() > 0) ? hit.Wire() - 1 : 0;
+		for (unsigned int w = w0; w <= hit.Wire() + 1; ++w)
 		{
-			size_t j = i + 1;
-			while (j < clusters.size())
+			auto wh = wireHits.find(w);
+			if (wh == wireHits.end()) continue;
+
+			// touching hits start at most one tick after the end of this hit,
+			// and end at most one tick before its start
+			const std::vector< size_t > & idxs = wh->second;
+			int firstTick = hit.StartTick() - 1 - wireMaxLength[w];
+			auto it = std::lower_bound(idxs.begin(), idxs.end(), firstTick,
+				[&inp](size_t a, int tick) { return inp[a]->StartTick() < tick; });
+			for (; (it != idxs.end()) && (inp[*it]->StartTick() <= hit.EndTick() + 1); ++it)
 			{
-				if (hitsTouching(clusters[i], clusters[j]))
-				{
-					clusters[i].hits().reserve(clusters[i].size() + clusters[i].size());
-					for (size_t h = 0; h < clusters[j].size(); ++h)
-						clusters[i].hits().push_back(clusters[j].hits()[h]);
-					clusters.erase(clusters.begin() + j);
-					merged = true;
-				}
-				else ++j;
+				if ((*it != h) && hitsTouching(*(inp[*it]), hit)) touchedBy[h].push_back(*it);
 			}
-			++i;
 		}
 	}
 }
 // ------------------------------------------------------
 
-std::vector< tss::Cluster2D > tss::SimpleClustering::run(const std::vector< tss::Hit2D > & inp) const
+std::vector< tss::Cluster2D > tss::SimpleClustering::clusterHits(const std::vector< const tss::Hit2D* > & inp) const
 {
-	std::vector< tss::Cluster2D > result;
+	// Each hit goes to the first cluster touching it, then clusters touching each other
+	// are merged, scanning for each cluster the ones following it. The touching hits
+	// are found once with findTouching, so clusters are compared without looping
+	// over all their hit pairs. Clusters are identified by their creation index.
+	std::vector< std::vector< size_t > > touchedBy;
+	findTouching(inp, touchedBy);
+
+	const size_t none = inp.size();
+	std::vector< size_t > label(inp.size(), none);
+	std::vector< std::vector< size_t > > cluHits;
 	for (size_t h = 0; h < inp.size(); ++h)
 	{
-		bool found = false;
-		for (size_t r = 0; r < result.size(); ++r)
-			if (hitsTouching(result[r], inp[h]))
+		size_t r = none;
+		for (const auto t : touchedBy[h])
 		{
-			result[r].hits().push_back(&(inp[h])); found = true; break;
+			if (label[t] < r) r = label[t]; // not yet clustered hits have label == none
 		}
-		if (!found)
+		if (r == none) { r = cluHits.size(); cluHits.push_back(std::vector< size_t >()); }
+		cluHits[r].push_back(h);
+		label[h] = r;
+	}
+
+	std::vector< bool > alive(cluHits.size(), true);
+	bool merged = true;
+	while (merged)
+	{
+		merged = false;
+
+		for (size_t i = 0; i < cluHits.size(); ++i)
 		{
-			result.push_back(tss::Cluster2D());
-			result.back().hits().push_back(&(inp[h]));
+			if (!alive[i]) continue;
+
+			// clusters following i which have a hit touching a hit of i
+			std::set< size_t > candidates;
+			for (const auto h : cluHits[i])
+				for (const auto t : touchedBy[h])
+					if (label[t] > i) candidates.insert(label[t]);
+
+			while (candidates.size())
+			{
+				size_t j = *(candidates.begin());
+				candidates.erase(candidates.begin());
+
+				// clusters before j were already checked against i
+				for (const auto h : cluHits[j])
+					for (const auto t : touchedBy[h])
+						if ((label[t] > j) && (label[t] != i)) candidates.insert(label[t]);
+
+				for (const auto h : cluHits[j]) { label[h] = i; cluHits[i].push_back(h); }
+				cluHits[j].clear();
+				alive[j] = false;
+				merged = true;
+			}
 		}
 	}
-	merge(result);
 
+	std::vector< tss::Cluster2D > result;
+	for (size_t c = 0; c < cluHits.size(); ++c)
+	{
+		if (!alive[c]) continue;
+
+		result.push_back(tss::Cluster2D());
+		result.back().hits().reserve(cluHits[c].size());
+		for (const auto h : cluHits[c]) result.back().hits().push_back(inp[h]);
+	}
 	return result;
 }
 // ------------------------------------------------------
 
-std::vector< tss::Cluster2D > tss::SimpleClustering::run(const tss::Cluster2D & inp) const
+std::vector< tss::Cluster2D > tss::SimpleClustering::run(const std::vector< tss::Hit2D > & inp) const
 {
-	std::vector< tss::Cluster2D > result;
-	for (size_t h = 0; h < inp.size(); ++h)
-	{
-		bool found = false;
-		for (size_t r = 0; r < result.size(); ++r)
-			if (hitsTouching(result[r], inp[h]))
-		{
-			result[r].hits().push_back(inp.hits()[h]); found = true; break;
-		}
-		if (!found)
-		{
-			result.push_back(tss::Cluster2D());
-			result.back().hits().push_back(inp.hits()[h]);
-		}
-	}
-	merge(result);
+	std::vector< const tss::Hit2D* > hits;
+	hits.reserve(inp.size());
+	for (size_t h = 0; h < inp.size(); ++h) hits.push_back(&(inp[h]));
 
-	return result;
+	return clusterHits(hits);
+}
+// ------------------------------------------------------
+
+std::vector< tss::Cluster2D > tss::SimpleClustering::run(const tss::Cluster2D & inp) const
+{
+	return clusterHits(inp.hits());
 }
 // ------------------------------------------------------
 
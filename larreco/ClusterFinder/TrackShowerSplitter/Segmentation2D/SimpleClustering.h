@@ -13,10 +13,14 @@
 #include "TssHit2D.h"
 #include "larreco/RecoAlg/PMAlg/Utilities.h"
 
+#include <cmath>
+#include <unordered_map>
+
 namespace tss
 {
 	struct bDistToPointLess;
 	class Cluster2D;
+	class HitGrid;
 
 	class SimpleClustering;
 }
@@ -110,6 +114,9 @@ public:
 	const TVector2 min(void) const;
 	const TVector2 max(void) const;
 
+	/// Lower and upper corner of the box enclosing all hits, false if there are no hits.
+	bool boundingBox(TVector2 & lo, TVector2 & hi) const;
+
 private:
 
 	std::vector< const tss::Hit2D* > fHits;
@@ -118,6 +125,26 @@ private:
 
 };
 
+/// Hits in square cells of a uniform grid, for the searches of close hits.
+class tss::HitGrid
+{
+public:
+
+	HitGrid(const std::vector< const tss::Hit2D* > & hits, double cellSize);
+
+	/// Count hits closer than r to the hit (not counting the hit itself); stops when the count exceeds maxN.
+	size_t countNeighbours(const tss::Hit2D & hit, double r, size_t maxN) const;
+
+private:
+
+	unsigned long long cellKey(long long ix, long long iy) const
+	{ return ((unsigned long long)ix << 32) ^ ((unsigned long long)iy & 0xFFFFFFFFULL); }
+	long long cellIndex(double x) const { return (long long)std::floor(x / fCellSize); }
+
+	double fCellSize;
+	std::unordered_map< unsigned long long, std::vector< const tss::Hit2D* > > fCells;
+};
+
 class tss::SimpleClustering
 {
 public:
@@ -131,7 +158,11 @@ public:
 
 private:
 
-	void merge(std::vector< tss::Cluster2D > & clusters) const;
+	std::vector< tss::Cluster2D > clusterHits(const std::vector< const tss::Hit2D* > & inp) const;
+
+	void findTouching(
+		const std::vector< const tss::Hit2D* > & inp,
+		std::vector< std::vector< size_t > > & touchedBy) const;
 };
 
 #endif
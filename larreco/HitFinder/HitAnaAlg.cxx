@@ -12,10 +12,13 @@
 
 #include "HitAnaAlg.h"
 
+#include <algorithm>
 #include <functional>
 #include <unordered_map>
 
-hit::HitAnaAlg::HitAnaAlg() {
+#include "larreco/RecoAlg/ParallelFor.h"
+
+hit::HitAnaAlg::HitAnaAlg() : nThreads(1) {
   wireData.NHitModules = 0;
 }
 
@@ -80,6 +83,9 @@ void hit::HitAnaAlg::SetupWireDataTree(){
 void hit::HitAnaAlg::ClearHitModules(){
   HitModuleLabels.clear();
   HitProcessingQueue.clear();
+  SortedHitOffsets.clear();
+  SortedHitStartTimes.clear();
+  SortedHitPositions.clear();
   wireData.NHitModules = 0;
 }
 
@@ -102,9 +108,182 @@ void hit::HitAnaAlg::AnalyzeWires(std::vector<recob::Wire> const& WireVector,
 				  unsigned int event, unsigned int run){
   
   InitWireData(event,run);
-  for(size_t iwire=0 ; iwire < WireVector.size(); iwire++)
-    FillWireInfo(WireVector[iwire], iwire, MCHitCollectionVector, AssocVector[iwire], ts);
+  BuildHitIndex(WireVector.size());
+  BuildMCHitIndex(MCHitCollectionVector,ts);
+
+  //the wires are analysed in blocks, each wire into its own buffers;
+  //the buffers of a block are then written to the trees in wire order
+  size_t const block_size = (nThreads>1) ? 64*nThreads : 1;
+  std::vector< std::vector<WireROIInfo> > block_rois(block_size);
+  std::vector< std::vector<HitFillList> > block_hits(block_size);
+
+  for(size_t first_wire=0; first_wire < WireVector.size(); first_wire += block_size){
+
+    size_t const n_wires = std::min(block_size, WireVector.size()-first_wire);
+
+    auto analyze_wire = [&](size_t i, size_t){
+      size_t const iwire = first_wire + i;
+      block_rois[i].clear();
+      block_hits[i].clear();
+      FillWireInfo(WireVector[iwire], iwire, MCHitCollectionVector, AssocVector[iwire], ts,
+		   block_rois[i], block_hits[i]);
+    };
+
+    util::ParallelFor(n_wires,nThreads,analyze_wire);
+
+    for(size_t i=0; i<n_wires; i++)
+      for(size_t iroi=0; iroi<block_rois[i].size(); iroi++)
+	FillTrees(block_rois[i][iroi],block_hits[i][iroi]);
+  }
+
+}
+
+void hit::HitAnaAlg::BuildHitIndex(size_t nWires){
+
+  SortedHitOffsets.assign(HitProcessingQueue.size(),std::vector<size_t>());
+  SortedHitStartTimes.assign(HitProcessingQueue.size(),std::vector<float>());
+  SortedHitPositions.assign(HitProcessingQueue.size(),std::vector<size_t>());
+
+  std::vector< std::pair<float,size_t> > wire_hits;
+  for(size_t imodule=0; imodule<HitProcessingQueue.size(); imodule++){
+
+    std::vector<recob::Hit> const& HitVector = HitProcessingQueue[imodule].first;
+    std::vector< std::vector<int> > const& AssocVector = HitProcessingQueue[imodule].second;
+    std::vector<size_t>& offsets = SortedHitOffsets[imodule];
+    std::vector<float>& start_times = SortedHitStartTimes[imodule];
+    std::vector<size_t>& positions = SortedHitPositions[imodule];
+
+    offsets.reserve(nWires+1);
+    for(size_t iwire=0; iwire<nWires; iwire++){
+      offsets.push_back(positions.size());
+      if(iwire >= AssocVector.size()) continue;
+
+      wire_hits.clear();
+      for(size_t ipos=0; ipos<AssocVector[iwire].size(); ipos++)
+	wire_hits.emplace_back(HitVector.at(AssocVector[iwire][ipos]).PeakTimeMinusRMS(),ipos);
+      std::stable_sort(wire_hits.begin(),wire_hits.end(),
+		       [](std::pair<float,size_t> const& a, std::pair<float,size_t> const& b)
+		       { return a.first < b.first; });
+
+      for(auto const& wire_hit : wire_hits){
+	start_times.push_back(wire_hit.first);
+	positions.push_back(wire_hit.second);
+      }
+    }
+    offsets.push_back(positions.size());
+  }
+
+}
+
+//positions, in the wire's hit list, of the hits that may be in [begin_wire_tdc,end_wire_tdc],
+//in the order of the list: those with begin_wire_tdc <= PeakTimeMinusRMS <= end_wire_tdc
+void hit::HitAnaAlg::FindHitsInRange(size_t hitmodule_iter, size_t WireIndex,
+				     size_t begin_wire_tdc, size_t end_wire_tdc,
+				     std::vector<size_t>& hit_positions) const{
+
+  hit_positions.clear();
+
+  std::vector<size_t> const& offsets = SortedHitOffsets.at(hitmodule_iter);
+  if(WireIndex+1 >= offsets.size()) return;
+
+  auto wire_begin = SortedHitStartTimes[hitmodule_iter].begin() + offsets[WireIndex];
+  auto wire_end   = SortedHitStartTimes[hitmodule_iter].begin() + offsets[WireIndex+1];
+
+  //same float comparisons as the ROI check in FindAndStoreHitsInRange
+  auto first = std::lower_bound(wire_begin,wire_end,(float)begin_wire_tdc);
+  auto last  = std::upper_bound(first,wire_end,(float)end_wire_tdc);
+
+  auto positions = SortedHitPositions[hitmodule_iter].begin();
+  for(auto it=first; it!=last; ++it)
+    hit_positions.push_back(positions[it-SortedHitStartTimes[hitmodule_iter].begin()]);
+  std::sort(hit_positions.begin(),hit_positions.end());
+
+}
 
+void hit::HitAnaAlg::BuildMCHitIndex(std::vector<sim::MCHitCollection> const& MCHitCollectionVector,
+				     const detinfo::DetectorClocks *ts){
+
+  SortedMCHitOffsets.clear();
+  SortedMCHitStartTicks.clear();
+  SortedMCHitPositions.clear();
+  SortedMCHitOffsets.reserve(MCHitCollectionVector.size()+1);
+
+  std::vector< std::pair<double,size_t> > collection_hits;
+  for(auto const& mchitcol : MCHitCollectionVector){
+    SortedMCHitOffsets.push_back(SortedMCHitPositions.size());
+
+    collection_hits.clear();
+    for(size_t ipos=0; ipos<mchitcol.size(); ipos++)
+      collection_hits.emplace_back(ts->TPCTDC2Tick(mchitcol[ipos].PeakTime()-mchitcol[ipos].PeakWidth()),ipos);
+    std::stable_sort(collection_hits.begin(),collection_hits.end(),
+		     [](std::pair<double,size_t> const& a, std::pair<double,size_t> const& b)
+		     { return a.first < b.first; });
+
+    for(auto const& collection_hit : collection_hits){
+      SortedMCHitStartTicks.push_back(collection_hit.first);
+      SortedMCHitPositions.push_back(collection_hit.second);
+    }
+  }
+  SortedMCHitOffsets.push_back(SortedMCHitPositions.size());
+
+}
+
+//positions, in the MC hit collection, of the MC hits that may be in [begin_wire_tdc,end_wire_tdc],
+//in the order of the collection: those with begin_wire_tdc <= start tick <= end_wire_tdc
+void hit::HitAnaAlg::FindMCHitsInRange(size_t MCHitCollectionIndex,
+				       size_t begin_wire_tdc, size_t end_wire_tdc,
+				       std::vector<size_t>& mchit_positions) const{
+
+  mchit_positions.clear();
+  if(MCHitCollectionIndex+1 >= SortedMCHitOffsets.size()) return;
+
+  auto col_begin = SortedMCHitStartTicks.begin() + SortedMCHitOffsets[MCHitCollectionIndex];
+  auto col_end   = SortedMCHitStartTicks.begin() + SortedMCHitOffsets[MCHitCollectionIndex+1];
+
+  //same double comparisons as the ROI check in FindAndStoreMCHitsInRange
+  auto first = std::lower_bound(col_begin,col_end,(double)begin_wire_tdc);
+  auto last  = std::upper_bound(first,col_end,(double)end_wire_tdc);
+
+  for(auto it=first; it!=last; ++it)
+    mchit_positions.push_back(SortedMCHitPositions[it-SortedMCHitStartTicks.begin()]);
+  std::sort(mchit_positions.begin(),mchit_positions.end());
+
+}
+
+void hit::HitAnaAlg::FillTrees(WireROIInfo& roiData, HitFillList const& roiHits){
+
+  for(auto const& module_hit : roiHits){
+    *(hitData.at(module_hit.first)) = *(module_hit.second);
+    (hitDataTree.at(module_hit.first))->Fill();
+  }
+
+  //the tree branches point to wireData; the run, event and module labels are already there
+  wireData.channel = roiData.channel;
+  wireData.plane = roiData.plane;
+  wireData.range_index = roiData.range_index;
+  wireData.range_start = roiData.range_start;
+  wireData.range_size = roiData.range_size;
+  wireData.integrated_charge = roiData.integrated_charge;
+  wireData.peak_charge = roiData.peak_charge;
+  wireData.peak_time = roiData.peak_time;
+  wireData.NHits.swap(roiData.NHits);
+  wireData.Hits_IntegratedCharge.swap(roiData.Hits_IntegratedCharge);
+  wireData.Hits_AverageCharge.swap(roiData.Hits_AverageCharge);
+  wireData.Hits_PeakCharge.swap(roiData.Hits_PeakCharge);
+  wireData.Hits_PeakTime.swap(roiData.Hits_PeakTime);
+  wireData.Hits_wAverageCharge.swap(roiData.Hits_wAverageCharge);
+  wireData.Hits_wAverageTime.swap(roiData.Hits_wAverageTime);
+  wireData.Hits_MeanMultiplicity.swap(roiData.Hits_MeanMultiplicity);
+  wireData.Hits.swap(roiData.Hits);
+  wireData.NMCHits = roiData.NMCHits;
+  wireData.MCHits_IntegratedCharge = roiData.MCHits_IntegratedCharge;
+  wireData.MCHits_AverageCharge = roiData.MCHits_AverageCharge;
+  wireData.MCHits_PeakCharge = roiData.MCHits_PeakCharge;
+  wireData.MCHits_PeakTime = roiData.MCHits_PeakTime;
+  wireData.MCHits_wAverageCharge = roiData.MCHits_wAverageCharge;
+  wireData.MCHits_wAverageTime = roiData.MCHits_wAverageTime;
+
+  wireDataTree->Fill();
 }
 
 void hit::HitAnaAlg::InitWireData(unsigned int event, unsigned int run){
@@ -117,44 +296,55 @@ void hit::HitAnaAlg::InitWireData(unsigned int event, unsigned int run){
 }
 
 void hit::HitAnaAlg::ClearWireDataHitInfo(){
-  wireData.NMCHits = 0;
-  wireData.MCHits_IntegratedCharge = 0;
-  wireData.MCHits_AverageCharge = 0;
-  wireData.MCHits_PeakCharge = -999;
-  wireData.MCHits_PeakTime = 0;
-  wireData.MCHits_wAverageCharge = 0;
-  wireData.MCHits_wAverageTime = 0;
+  ClearWireDataHitInfo(wireData);
+}
+
+void hit::HitAnaAlg::ClearWireDataHitInfo(WireROIInfo& roiData) const{
+  roiData.NMCHits = 0;
+  roiData.MCHits_IntegratedCharge = 0;
+  roiData.MCHits_AverageCharge = 0;
+  roiData.MCHits_PeakCharge = -999;
+  roiData.MCHits_PeakTime = 0;
+  roiData.MCHits_wAverageCharge = 0;
+  roiData.MCHits_wAverageTime = 0;
   
-  wireData.NHits.assign(wireData.NHitModules,0);
-  wireData.Hits_IntegratedCharge.assign(wireData.NHitModules,0);
-  wireData.Hits_AverageCharge.assign(wireData.NHitModules,0);
-  wireData.Hits_PeakCharge.assign(wireData.NHitModules,-999);
-  wireData.Hits_PeakTime.assign(wireData.NHitModules,0);
-  wireData.Hits_wAverageCharge.assign(wireData.NHitModules,0);
-  wireData.Hits_wAverageTime.assign(wireData.NHitModules,0);
-  wireData.Hits_MeanMultiplicity.assign(wireData.NHitModules,0);
-  wireData.Hits.clear(); wireData.Hits.resize(wireData.NHitModules);
+  roiData.NHits.assign(roiData.NHitModules,0);
+  roiData.Hits_IntegratedCharge.assign(roiData.NHitModules,0);
+  roiData.Hits_AverageCharge.assign(roiData.NHitModules,0);
+  roiData.Hits_PeakCharge.assign(roiData.NHitModules,-999);
+  roiData.Hits_PeakTime.assign(roiData.NHitModules,0);
+  roiData.Hits_wAverageCharge.assign(roiData.NHitModules,0);
+  roiData.Hits_wAverageTime.assign(roiData.NHitModules,0);
+  roiData.Hits_MeanMultiplicity.assign(roiData.NHitModules,0);
+  roiData.Hits.clear(); roiData.Hits.resize(roiData.NHitModules);
 }
 
 void hit::HitAnaAlg::FillWireInfo(recob::Wire const& wire, 
 				  int WireIndex,
 				  std::vector<sim::MCHitCollection> const& MCHitCollectionVector,
 				  std::vector<int> const& thisAssocVector,
-				  const detinfo::DetectorClocks *ts){
+				  const detinfo::DetectorClocks *ts,
+				  std::vector<WireROIInfo>& wireROIs,
+				  std::vector<HitFillList>& wireROIHits) const{
   
-  wireData.channel = wire.Channel();
-  wireData.plane = wire.View();
   unsigned int range_index = 0;
 
   for( auto const& range : wire.SignalROI().get_ranges() ){
 
-    wireData.range_index = range_index;
-    wireData.range_start = range.begin_index();
-    wireData.range_size = range.size();
+    wireROIs.emplace_back();
+    wireROIHits.emplace_back();
+    WireROIInfo& roiData = wireROIs.back();
+
+    roiData.channel = wire.Channel();
+    roiData.plane = wire.View();
+    roiData.NHitModules = HitModuleLabels.size();
+    roiData.range_index = range_index;
+    roiData.range_start = range.begin_index();
+    roiData.range_size = range.size();
 
-    ClearWireDataHitInfo();
+    ClearWireDataHitInfo(roiData);
 
-    ProcessROI(range, WireIndex, MCHitCollectionVector, thisAssocVector, ts);
+    ProcessROI(range, WireIndex, MCHitCollectionVector, thisAssocVector, ts, roiData, wireROIHits.back());
     range_index++;
 
   }//end loop over roi ranges
@@ -164,7 +354,7 @@ void hit::HitAnaAlg::FillWireInfo(recob::Wire const& wire,
 void hit::HitAnaAlg::ROIInfo(lar::sparse_vector<float>::datarange_t const& range,
 			     float& charge_sum,
 			     float& charge_peak,
-			     float& charge_peak_time){
+			     float& charge_peak_time) const{
 
   charge_sum=0;
   charge_peak = -999;
@@ -185,9 +375,11 @@ void hit::HitAnaAlg::ProcessROI(lar::sparse_vector<float>::datarange_t const& ra
 				int WireIndex,
 				std::vector<sim::MCHitCollection> const& MCHitCollectionVector,
 				std::vector<int> const& thisAssocVector,
-				const detinfo::DetectorClocks *ts){
+				const detinfo::DetectorClocks *ts,
+				WireROIInfo& roiData,
+				HitFillList& roiHits) const{
 
-  ROIInfo(range,wireData.integrated_charge,wireData.peak_charge,wireData.peak_time);
+  ROIInfo(range,roiData.integrated_charge,roiData.peak_charge,roiData.peak_time);
 
   //std::cout << "----------------------------------------------------------------" << std::endl;
   //std::cout << "WireIndex = " << WireIndex << std::endl;
@@ -198,59 +390,68 @@ void hit::HitAnaAlg::ProcessROI(lar::sparse_vector<float>::datarange_t const& ra
     FindAndStoreHitsInRange(HitProcessingQueue[iter].first, 
 			    HitProcessingQueue[iter].second.at(WireIndex),
 			    iter,
+			    WireIndex,
 			    range.begin_index(),
-			    range.begin_index()+range.size());
+			    range.begin_index()+range.size(),
+			    roiData,
+			    roiHits);
 
   FindAndStoreMCHitsInRange(MCHitCollectionVector,
 			    thisAssocVector,
 			    range.begin_index(),
 			    range.begin_index()+range.size(),
-			    ts);
+			    ts,
+			    roiData);
 
-  wireDataTree->Fill();
 }
 
 void hit::HitAnaAlg::FindAndStoreHitsInRange( std::vector<recob::Hit> const& HitVector,
 					      std::vector<int> const& HitsOnWire,
 					      size_t hitmodule_iter,
+					      size_t WireIndex,
 					      size_t begin_wire_tdc,
-					      size_t end_wire_tdc){
+					      size_t end_wire_tdc,
+					      WireROIInfo& roiData,
+					      HitFillList& roiHits) const{
 
-  wireData.Hits_PeakCharge[hitmodule_iter]=-999;
+  roiData.Hits_PeakCharge[hitmodule_iter]=-999;
 
-  for( auto const& hit_index : HitsOnWire){
-    recob::Hit const& thishit = HitVector.at(hit_index);
+  //only the hits starting in the ROI are looked at
+  std::vector<size_t> hit_positions;
+  FindHitsInRange(hitmodule_iter,WireIndex,begin_wire_tdc,end_wire_tdc,hit_positions);
+
+  for( auto const& hit_position : hit_positions){
+    recob::Hit const& thishit = HitVector.at(HitsOnWire[hit_position]);
 
     //check if this hit is on this ROI
     if( thishit.PeakTimeMinusRMS() < begin_wire_tdc ||
 	thishit.PeakTimePlusRMS() > end_wire_tdc)
       continue;
 
-    FillHitInfo(thishit,wireData.Hits[hitmodule_iter]);
-    wireData.NHits[hitmodule_iter]++;
-    wireData.Hits_IntegratedCharge[hitmodule_iter] += thishit.Integral();
+    FillHitInfo(thishit,roiData.Hits[hitmodule_iter]);
+    roiData.NHits[hitmodule_iter]++;
+    roiData.Hits_IntegratedCharge[hitmodule_iter] += thishit.Integral();
 
-    if(thishit.PeakAmplitude() > wireData.Hits_PeakCharge[hitmodule_iter]){
-      wireData.Hits_PeakCharge[hitmodule_iter] = thishit.PeakAmplitude();
-      wireData.Hits_PeakTime[hitmodule_iter] = thishit.PeakTime();
+    if(thishit.PeakAmplitude() > roiData.Hits_PeakCharge[hitmodule_iter]){
+      roiData.Hits_PeakCharge[hitmodule_iter] = thishit.PeakAmplitude();
+      roiData.Hits_PeakTime[hitmodule_iter] = thishit.PeakTime();
     }
 
-    wireData.Hits_wAverageCharge[hitmodule_iter] += thishit.Integral()*thishit.Integral();
-    wireData.Hits_wAverageTime[hitmodule_iter]   += thishit.Integral()*thishit.PeakTime();
-    wireData.Hits_MeanMultiplicity[hitmodule_iter] += thishit.Multiplicity();
+    roiData.Hits_wAverageCharge[hitmodule_iter] += thishit.Integral()*thishit.Integral();
+    roiData.Hits_wAverageTime[hitmodule_iter]   += thishit.Integral()*thishit.PeakTime();
+    roiData.Hits_MeanMultiplicity[hitmodule_iter] += thishit.Multiplicity();
 
-    *(hitData.at(hitmodule_iter)) = thishit;
-    (hitDataTree.at(hitmodule_iter))->Fill();
+    roiHits.emplace_back(hitmodule_iter,&thishit);
   }
 
-  wireData.Hits_AverageCharge[hitmodule_iter] = 
-    wireData.Hits_IntegratedCharge[hitmodule_iter]/wireData.NHits[hitmodule_iter];
-  wireData.Hits_wAverageCharge[hitmodule_iter] = 
-    wireData.Hits_wAverageCharge[hitmodule_iter]/wireData.Hits_IntegratedCharge[hitmodule_iter];
-  wireData.Hits_wAverageTime[hitmodule_iter] = 
-    wireData.Hits_wAverageTime[hitmodule_iter]/wireData.Hits_IntegratedCharge[hitmodule_iter];
+  roiData.Hits_AverageCharge[hitmodule_iter] = 
+    roiData.Hits_IntegratedCharge[hitmodule_iter]/roiData.NHits[hitmodule_iter];
+  roiData.Hits_wAverageCharge[hitmodule_iter] = 
+    roiData.Hits_wAverageCharge[hitmodule_iter]/roiData.Hits_IntegratedCharge[hitmodule_iter];
+  roiData.Hits_wAverageTime[hitmodule_iter] = 
+    roiData.Hits_wAverageTime[hitmodule_iter]/roiData.Hits_IntegratedCharge[hitmodule_iter];
 
-    wireData.Hits_MeanMultiplicity[hitmodule_iter] /=wireData.NHits[hitmodule_iter];
+    roiData.Hits_MeanMultiplicity[hitmodule_iter] /=roiData.NHits[hitmodule_iter];
 
 }
 
@@ -258,16 +459,22 @@ void hit::HitAnaAlg::FindAndStoreMCHitsInRange( std::vector<sim::MCHitCollection
 						std::vector<int> const& HitsOnWire,
 						size_t begin_wire_tdc,
 						size_t end_wire_tdc,
-						const detinfo::DetectorClocks *ts){
+						const detinfo::DetectorClocks *ts,
+						WireROIInfo& roiData) const{
+
+  roiData.MCHits_PeakCharge = -999;
 
-  wireData.MCHits_PeakCharge = -999;
+  //only the MC hits starting in the ROI are looked at
+  std::vector<size_t> mchit_positions;
 
   for( auto const& hit_index : HitsOnWire){
     sim::MCHitCollection const& thismchitcol = MCHitCollectionVector.at(hit_index);
 
     //let's have a map to keep track of the number of total particles
     std::unordered_map<int,unsigned int> nmchits_per_trackID_map;
-    for( auto const& thishit : thismchitcol){
+    FindMCHitsInRange(hit_index,begin_wire_tdc,end_wire_tdc,mchit_positions);
+    for( auto const& mchit_position : mchit_positions){
+      sim::MCHit const& thishit = thismchitcol[mchit_position];
 
       //std::cout << "\t************************************************************" << std::endl;
       //std::cout << "\t\tMCHit begin: " << ts->TPCTDC2Tick( thishit.PeakTime()-thishit.PeakWidth() ) << std::endl;
@@ -279,32 +486,32 @@ void hit::HitAnaAlg::FindAndStoreMCHitsInRange( std::vector<sim::MCHitCollection
 	continue;
 
       nmchits_per_trackID_map[thishit.PartTrackId()] += 1;
-      wireData.MCHits_IntegratedCharge += thishit.Charge();
+      roiData.MCHits_IntegratedCharge += thishit.Charge();
       
-      if(thishit.Charge(true) > wireData.MCHits_PeakCharge){
-	wireData.MCHits_PeakCharge = thishit.Charge(true);
-	wireData.MCHits_PeakTime   = ts->TPCTDC2Tick(thishit.PeakTime());
+      if(thishit.Charge(true) > roiData.MCHits_PeakCharge){
+	roiData.MCHits_PeakCharge = thishit.Charge(true);
+	roiData.MCHits_PeakTime   = ts->TPCTDC2Tick(thishit.PeakTime());
       }
       
-      wireData.MCHits_wAverageCharge += thishit.Charge()*thishit.Charge();
-      wireData.MCHits_wAverageTime   += thishit.Charge()*ts->TPCTDC2Tick(thishit.PeakTime());
+      roiData.MCHits_wAverageCharge += thishit.Charge()*thishit.Charge();
+      roiData.MCHits_wAverageTime   += thishit.Charge()*ts->TPCTDC2Tick(thishit.PeakTime());
 
     }
     
-    wireData.NMCHits = nmchits_per_trackID_map.size();
+    roiData.NMCHits = nmchits_per_trackID_map.size();
 
-    wireData.MCHits_AverageCharge = 
-      wireData.MCHits_IntegratedCharge/wireData.NMCHits;
-    wireData.MCHits_wAverageCharge = 
-      wireData.MCHits_wAverageCharge/wireData.MCHits_IntegratedCharge;
-    wireData.MCHits_wAverageTime = 
-      wireData.MCHits_wAverageTime/wireData.MCHits_IntegratedCharge;
+    roiData.MCHits_AverageCharge = 
+      roiData.MCHits_IntegratedCharge/roiData.NMCHits;
+    roiData.MCHits_wAverageCharge = 
+      roiData.MCHits_wAverageCharge/roiData.MCHits_IntegratedCharge;
+    roiData.MCHits_wAverageTime = 
+      roiData.MCHits_wAverageTime/roiData.MCHits_IntegratedCharge;
 
   }
   
 }
 
-void hit::HitAnaAlg::FillHitInfo(recob::Hit const& hit, std::vector<HitInfo>& HitInfoVector){
+void hit::HitAnaAlg::FillHitInfo(recob::Hit const& hit, std::vector<HitInfo>& HitInfoVector) const{
   HitInfoVector.emplace_back(hit.PeakTime(),
 			     hit.SigmaPeakTime(),
 			     hit.RMS(),
@@ -103,6 +103,9 @@ namespace hit{
 
     typedef std::pair< const std::vector<recob::Hit>& , const std::vector< std::vector<int> >& > HitAssocPair;
 
+    //hits of one ROI to write to the hit trees, as (hit module index, hit), in order
+    typedef std::vector< std::pair<size_t, recob::Hit const*> > HitFillList;
+
   public:
 
     HitAnaAlg();
@@ -123,35 +126,58 @@ namespace hit{
 			   std::string const&);
 
     void ClearHitModules();
+
+    //wires are analysed in parallel with more than one thread; the trees are
+    //filled in the same order in all cases
+    void SetNumThreads(unsigned int n) { nThreads = n; }
     
   private:
     
     void InitWireData(unsigned int, unsigned int);
     void ClearWireDataHitInfo();
+    void ClearWireDataHitInfo(WireROIInfo&) const;
 
-    void FillHitInfo(recob::Hit const&, std::vector<HitInfo>&);
+    void FillHitInfo(recob::Hit const&, std::vector<HitInfo>&) const;
 
     void FillWireInfo(recob::Wire const&, 
 		      int,
 		      std::vector<sim::MCHitCollection> const&,
 		      std::vector<int> const&,
-		      const detinfo::DetectorClocks *);
+		      const detinfo::DetectorClocks *,
+		      std::vector<WireROIInfo>&,
+		      std::vector<HitFillList>&) const;
 
     void ProcessROI(lar::sparse_vector<float>::datarange_t const&, int,
 		    std::vector<sim::MCHitCollection> const&,
 		    std::vector<int> const&,
-		    const detinfo::DetectorClocks *);
+		    const detinfo::DetectorClocks *,
+		    WireROIInfo&,
+		    HitFillList&) const;
 
     void ROIInfo(lar::sparse_vector<float>::datarange_t const&,
-		 float&,float&,float&);
+		 float&,float&,float&) const;
 
     void FindAndStoreHitsInRange(std::vector<recob::Hit> const&,
 				 std::vector<int> const&,
-				 size_t,size_t,size_t);
+				 size_t,size_t,size_t,size_t,
+				 WireROIInfo&,
+				 HitFillList&) const;
     void FindAndStoreMCHitsInRange(std::vector<sim::MCHitCollection> const&,
 				   std::vector<int> const&,
 				   size_t,size_t,
-				   const detinfo::DetectorClocks *);
+				   const detinfo::DetectorClocks *,
+				   WireROIInfo&) const;
+
+    void FillTrees(WireROIInfo&, HitFillList const&);
+
+    //per-wire index of the hits of each hit module, sorted by PeakTimeMinusRMS
+    void BuildHitIndex(size_t);
+    void FindHitsInRange(size_t,size_t,size_t,size_t,std::vector<size_t>&) const;
+
+    //index of the MC hits of each collection, sorted by start tick
+    void BuildMCHitIndex(std::vector<sim::MCHitCollection> const&,
+			 const detinfo::DetectorClocks *);
+    void FindMCHitsInRange(size_t,size_t,size_t,std::vector<size_t>&) const;
     
     WireROIInfo wireData;
     std::vector<recob::Hit*> hitData;
@@ -159,6 +185,19 @@ namespace hit{
     std::vector<std::string> HitModuleLabels;
     std::vector< HitAssocPair > HitProcessingQueue;
 
+    //for each hit module: first entry of each wire (one more at the end), and
+    //for each entry the hit start time and its position in the wire's hit list
+    std::vector< std::vector<size_t> > SortedHitOffsets;
+    std::vector< std::vector<float> > SortedHitStartTimes;
+    std::vector< std::vector<size_t> > SortedHitPositions;
+
+    //the same for the MC hit collections
+    std::vector<size_t> SortedMCHitOffsets;
+    std::vector<double> SortedMCHitStartTicks;
+    std::vector<size_t> SortedMCHitPositions;
+
+    unsigned int nThreads;
+
 
     void SetupWireDataTree();
     TTree* wireDataTree;
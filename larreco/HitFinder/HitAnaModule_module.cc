@@ -33,6 +33,7 @@
 
 #include <vector>
 #include <string>
+#include <unordered_map>
 
 #include "lardata/RecoBase/Wire.h"
 #include "lardata/RecoBase/Hit.h"
@@ -112,11 +113,18 @@ void hit::HitAnaModule::createAssocVector(std::vector<recob::Wire> const& wireVe
 					  std::vector< std::vector<int> > & WireHitAssocVector)
 {
   WireHitAssocVector.resize(wireVector.size());
+
+  //hit indices keyed on channel, in hit order, then looked up for each wire
+  std::unordered_map<raw::ChannelID_t,std::vector<int> > hitIndicesByChannel;
+  for(size_t ihit=0; ihit<hitVector.size(); ihit++)
+    hitIndicesByChannel[hitVector[ihit].Channel()].push_back(ihit);
+
   for(size_t iwire=0; iwire<wireVector.size(); iwire++){
-    for(size_t ihit=0; ihit<hitVector.size(); ihit++){
-      if(hitVector[ihit].Channel()==wireVector[iwire].Channel())
-	WireHitAssocVector[iwire].push_back(ihit);
-    }
+    auto const channelHits = hitIndicesByChannel.find(wireVector[iwire].Channel());
+    if(channelHits != hitIndicesByChannel.end())
+      WireHitAssocVector[iwire].insert(WireHitAssocVector[iwire].end(),
+				       channelHits->second.begin(),
+				       channelHits->second.end());
   }
 }
 
@@ -231,6 +239,8 @@ void hit::HitAnaModule::reconfigure(fhicl::ParameterSet const & p)
   fWireModuleLabel  = p.get< std::string              >("WireModuleLabel");
   fMCHitModuleLabel = p.get< std::string              >("MCHitModuleLabel");
 
+  analysisAlg.SetNumThreads(p.get< unsigned int             >("NumThreads",1));
+
 }
 
 DEFINE_ART_MODULE(hit::HitAnaModule)
@@ -0,0 +1,276 @@
+#ifndef MCHITTRUTHINDEX_CXX
+#define MCHITTRUTHINDEX_CXX
+
+#include "MCHitTruthIndex.h"
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+#include <limits>
+#include <type_traits>
+#include "TString.h"
+#include "lardata/DetectorInfoServices/DetectorClocksService.h"
+
+namespace btutil {
+
+  void MCHitTruthIndex::Clear()
+  {
+    _hit_id = art::ProductID();
+    _key_to_index.clear();
+    _hit_view.clear();
+    _hit_ide_offset.clear();
+    _ide_trackid.clear();
+    _ide_energy.clear();
+    _ide_frac.clear();
+    _track_id.clear();
+    _track_offset.clear();
+    _track_hit.clear();
+  }
+
+  void MCHitTruthIndex::Reset(const std::vector<const sim::SimChannel*>& simch_v,
+			      const std::vector<art::Ptr<recob::Hit> >& hit_v,
+			      const double min_energy_frac)
+  {
+    Clear();
+    _min_energy_frac = min_energy_frac;
+    if(hit_v.empty()) {
+      _hit_ide_offset.push_back(0);
+      _track_offset.push_back(0);
+      return;
+    }
+
+    _hit_id = hit_v.front().id();
+    for(size_t i=0; i<hit_v.size(); ++i) {
+      auto const& hit = hit_v[i];
+      if(hit.id() != _hit_id)
+	throw MCBTException(Form("Hits from more than one data product (hit %zu)",i));
+      if(_key_to_index.size() <= hit.key()) _key_to_index.resize(hit.key()+1,kINVALID_INDEX);
+      _key_to_index[hit.key()] = i;
+      _hit_view.push_back(hit->View());
+    }
+
+    const detinfo::DetectorClocks* ts = lar::providerFrom<detinfo::DetectorClocksService>();
+
+    // hits sorted by channel, with their TDC range
+    struct HitRange_t { raw::ChannelID_t ch; size_t index; double start, end; };
+    std::vector<HitRange_t> range_v;
+    range_v.reserve(hit_v.size());
+    for(size_t i=0; i<hit_v.size(); ++i) {
+      auto const& hit = *(hit_v[i]);
+      range_v.push_back({ hit.Channel(), i,
+	    ts->TPCTick2TDC(hit.PeakTimeMinusRMS()), ts->TPCTick2TDC(hit.PeakTimePlusRMS()) });
+    }
+    std::sort(range_v.begin(),range_v.end(),
+	      [](const HitRange_t& a, const HitRange_t& b) { return a.ch < b.ch; });
+
+    // one pass over the SimChannels: energy per (hit, track ID)
+    std::vector<std::vector<std::pair<int,float> > > hit_edep(hit_v.size());
+    for(auto const* sch : simch_v) {
+
+      auto const ch = sch->Channel();
+      auto hit_range = std::equal_range(range_v.begin(),range_v.end(),HitRange_t{ch,0,0.,0.},
+					[](const HitRange_t& a, const HitRange_t& b) { return a.ch < b.ch; });
+      if(hit_range.first == hit_range.second) continue;
+
+      auto const& tdcide = sch->TDCIDEMap();
+      typedef std::decay<decltype(tdcide)>::type::key_type tdc_t;
+      const double max_tdc = std::numeric_limits<tdc_t>::max();
+
+      for(auto it = hit_range.first; it != hit_range.second; ++it) {
+
+	if(it->end < 0 || it->start > it->end) continue;
+	auto itlow = tdcide.lower_bound((tdc_t)(std::max(0.,std::min(it->start,max_tdc))));
+	auto itup  = tdcide.upper_bound((tdc_t)(std::min(it->end,max_tdc)));
+
+	auto& edep = hit_edep[it->index];
+	for(; itlow != itup; ++itlow) {
+	  for(auto const& ide : itlow->second) {
+	    // energy not associated with a particle, as in BackTracker
+	    if(ide.trackID == sim::NoParticleId) continue;
+	    edep.emplace_back(std::abs(ide.trackID),ide.energy);
+	  }
+	}
+      }
+    }
+
+    // per hit table, sorted by track ID
+    std::vector<std::pair<int,size_t> > track_hit_v;
+    _hit_ide_offset.reserve(hit_v.size()+1);
+    for(size_t i=0; i<hit_edep.size(); ++i) {
+
+      _hit_ide_offset.push_back(_ide_trackid.size());
+
+      auto& edep = hit_edep[i];
+      std::sort(edep.begin(),edep.end(),
+		[](const std::pair<int,float>& a, const std::pair<int,float>& b) { return a.first < b.first; });
+
+      double total = 0;
+      for(auto const& e : edep) total += e.second;
+      if(total < 1.e-5) total = 1.;
+
+      for(size_t j=0; j<edep.size(); ) {
+	int const id = edep[j].first;
+	double energy = 0;
+	for(; j<edep.size() && edep[j].first == id; ++j) energy += edep[j].second;
+	_ide_trackid.push_back(id);
+	_ide_energy.push_back(energy);
+	_ide_frac.push_back(energy/total);
+	if(energy/total >= min_energy_frac) track_hit_v.emplace_back(id,i);
+      }
+      std::vector<std::pair<int,float> >().swap(edep);
+    }
+    _hit_ide_offset.push_back(_ide_trackid.size());
+
+    // track ID => hits table
+    std::sort(track_hit_v.begin(),track_hit_v.end());
+    _track_hit.reserve(track_hit_v.size());
+    for(auto const& th : track_hit_v) {
+      if(_track_id.empty() || _track_id.back() != th.first) {
+	_track_id.push_back(th.first);
+	_track_offset.push_back(_track_hit.size());
+      }
+      _track_hit.push_back(th.second);
+    }
+    _track_offset.push_back(_track_hit.size());
+  }
+
+  size_t MCHitTruthIndex::Index(const art::Ptr<recob::Hit>& hit) const
+  {
+    if(hit.id() != _hit_id || _key_to_index.size() <= hit.key()) return kINVALID_INDEX;
+    return _key_to_index[hit.key()];
+  }
+
+  bool MCHitTruthIndex::Indexed(const std::vector<art::Ptr<recob::Hit> >& hit_v) const
+  {
+    for(auto const& hit : hit_v)
+      if(Index(hit) == kINVALID_INDEX) return false;
+    return true;
+  }
+
+  size_t MCHitTruthIndex::CheckedIndex(const art::Ptr<recob::Hit>& hit) const
+  {
+    size_t const index = Index(hit);
+    if(index == kINVALID_INDEX)
+      throw MCBTException(Form("Hit %zu is not in the index",hit.key()));
+    return index;
+  }
+
+  bool MCHitTruthIndex::FromTracks(const size_t hit_index, const std::set<int>& track_ids,
+				   const double min_energy_frac) const
+  {
+    // std::set is sorted like the track IDs of each hit: one merge walk
+    auto id_it = track_ids.begin();
+    for(size_t i=_hit_ide_offset[hit_index]; i<_hit_ide_offset[hit_index+1] && id_it != track_ids.end(); ) {
+      if(_ide_trackid[i] < *id_it) ++i;
+      else if(*id_it < _ide_trackid[i]) ++id_it;
+      else if(_ide_frac[i] >= min_energy_frac) return true;
+      else { ++i; ++id_it; }
+    }
+    return false;
+  }
+
+  std::vector<sim::TrackIDE> MCHitTruthIndex::HitToTrackIDEs(const size_t hit_index) const
+  {
+    if(hit_index >= NumHits())
+      throw MCBTException(Form("Invalid hit index: %zu (%zu hits)",hit_index,NumHits()));
+
+    std::vector<sim::TrackIDE> res;
+    for(size_t i=_hit_ide_offset[hit_index]; i<_hit_ide_offset[hit_index+1]; ++i) {
+      sim::TrackIDE info;
+      info.trackID    = _ide_trackid[i];
+      info.energyFrac = _ide_frac[i];
+      info.energy     = _ide_energy[i];
+      res.push_back(info);
+    }
+    return res;
+  }
+
+  int MCHitTruthIndex::MainTrackID(const size_t hit_index) const
+  {
+    if(hit_index >= NumHits())
+      throw MCBTException(Form("Invalid hit index: %zu (%zu hits)",hit_index,NumHits()));
+
+    int id = 0;
+    float energy = 0;
+    for(size_t i=_hit_ide_offset[hit_index]; i<_hit_ide_offset[hit_index+1]; ++i) {
+      if(_ide_energy[i] > energy) {
+	energy = _ide_energy[i];
+	id = _ide_trackid[i];
+      }
+    }
+    return id;
+  }
+
+  std::pair<size_t,size_t> MCHitTruthIndex::TrackRange(const int track_id) const
+  {
+    auto it = std::lower_bound(_track_id.begin(),_track_id.end(),track_id);
+    if(it == _track_id.end() || *it != track_id) return std::make_pair(size_t(0),size_t(0));
+    size_t const t = it - _track_id.begin();
+    return std::make_pair(_track_offset[t],_track_offset[t+1]);
+  }
+
+  std::vector<size_t> MCHitTruthIndex::TrackHits(const int track_id, const geo::View_t view) const
+  {
+    auto range = TrackRange(track_id);
+    std::vector<size_t> res;
+    for(size_t i=range.first; i<range.second; ++i) {
+      if(view != geo::k3D && _hit_view[_track_hit[i]] != view) continue;
+      res.push_back(_track_hit[i]);
+    }
+    return res;
+  }
+
+  size_t MCHitTruthIndex::NumTrackHits(const int track_id, const geo::View_t view) const
+  {
+    auto range = TrackRange(track_id);
+    if(view == geo::k3D) return range.second - range.first;
+    size_t res = 0;
+    for(size_t i=range.first; i<range.second; ++i)
+      if(_hit_view[_track_hit[i]] == view) ++res;
+    return res;
+  }
+
+  std::vector<size_t> MCHitTruthIndex::TrackHits(const std::set<int>& track_ids, const geo::View_t view) const
+  {
+    std::vector<size_t> res;
+    for(auto const& id : track_ids) {
+      auto hits = TrackHits(id,view);
+      if(res.empty()) { res.swap(hits); continue; }
+      std::vector<size_t> merged;
+      merged.reserve(res.size()+hits.size());
+      std::set_union(res.begin(),res.end(),hits.begin(),hits.end(),std::back_inserter(merged));
+      res.swap(merged);
+    }
+    return res;
+  }
+
+  double MCHitTruthIndex::Purity(const std::set<int>& track_ids,
+				 const std::vector<art::Ptr<recob::Hit> >& hit_v) const
+  {
+    if(hit_v.empty()) return 0.;
+
+    // as the back tracker, any energy from the tracks makes the hit desired
+    size_t desired = 0;
+    for(auto const& hit : hit_v)
+      if(FromTracks(CheckedIndex(hit),track_ids,0.)) ++desired;
+    return desired/(1.*hit_v.size());
+  }
+
+  double MCHitTruthIndex::Efficiency(const std::set<int>& track_ids,
+				     const std::vector<art::Ptr<recob::Hit> >& hit_v,
+				     const geo::View_t view) const
+  {
+    size_t const total = TrackHits(track_ids,view).size();
+    if(!total) return 0.;
+
+    size_t desired = 0;
+    for(auto const& hit : hit_v) {
+      size_t const index = CheckedIndex(hit);
+      if(view != geo::k3D && _hit_view[index] != view) continue;
+      if(FromTracks(index,track_ids,_min_energy_frac)) ++desired;
+    }
+    return desired/(1.*total);
+  }
+
+}
+
+#endif
@@ -0,0 +1,131 @@
+/**
+ * \file MCHitTruthIndex.h
+ *
+ * \ingroup MCComp
+ *
+ * \brief Class def header for a class MCHitTruthIndex
+ *
+ */
+
+/** \addtogroup MCComp
+
+    @{*/
+#ifndef RECOTOOL_MCHITTRUTHINDEX_H
+#define RECOTOOL_MCHITTRUTHINDEX_H
+
+#include <vector>
+#include <set>
+#include "art/Persistency/Common/Ptr.h"
+#include "art/Persistency/Provenance/ProductID.h"
+#include "larcore/SimpleTypesAndConstants/geo_types.h"
+#include "larsim/Simulation/SimChannel.h"
+#include "lardata/RecoBase/Hit.h"
+#include "MCBTAlgConstants.h"
+#include "MCBTException.h"
+/**
+   \class MCHitTruthIndex
+   MCHitTruthIndex back-tracks all the hits of one event at once and keeps the
+   result, so that analysis modules can ask for the truth of hits and of hit
+   collections without going back to the SimChannels for each hit.
+
+   The hit => track ID relation is the one of cheat::BackTracker::HitToTrackID():
+   the energy deposited on the hit channel between the TDC of the peak time
+   minus and plus the RMS, summed by (absolute) track ID. It is filled with one
+   pass over the SimChannels and stored in flat arrays, sorted by track ID for
+   each hit. The track ID => hits relation keeps, for each track, the sorted
+   indices of the hits with at least the minimum energy fraction from it.
+
+   Efficiency and purity of a hit collection are computed as in
+   cheat::BackTracker::HitCollectionEfficiency() and HitCollectionPurity(),
+   with the whole indexed hit collection as the reference for the efficiency.
+   All the hits of the collection must be in the index (see Indexed()); like
+   the back tracker, hits appearing more than once are counted more than once.
+ */
+
+namespace btutil {
+
+  class MCHitTruthIndex {
+
+  public:
+
+    MCHitTruthIndex(){}
+
+    /**
+       Back-tracks all the hits, which must belong to the same data product.
+       min_energy_frac is the fraction of the hit energy a track needs to be
+       counted as the owner of a hit (BackTracker's MinHitEnergyFraction).
+     */
+    void Reset(const std::vector<const sim::SimChannel*>& simch_v,
+	       const std::vector<art::Ptr<recob::Hit> >& hit_v,
+	       const double min_energy_frac = 0.010);
+
+    /// Forgets all the hits
+    void Clear();
+
+    /// Number of hits in the index
+    size_t NumHits() const { return _hit_view.size(); }
+
+    /// Position of the hit in the index, kINVALID_INDEX if it was not indexed
+    size_t Index(const art::Ptr<recob::Hit>& hit) const;
+
+    /// Whether all the hits are in the index
+    bool Indexed(const std::vector<art::Ptr<recob::Hit> >& hit_v) const;
+
+    /// Same as cheat::BackTracker::HitToTrackID(), ordered by track ID
+    std::vector<sim::TrackIDE> HitToTrackIDEs(const size_t hit_index) const;
+
+    /// Track ID with the largest energy in the hit, 0 if there is none
+    int MainTrackID(const size_t hit_index) const;
+
+    /// Sorted indices of the hits with at least the minimum energy fraction from the track
+    std::vector<size_t> TrackHits(const int track_id, const geo::View_t view = geo::k3D) const;
+
+    /// Number of hits with at least the minimum energy fraction from the track
+    size_t NumTrackHits(const int track_id, const geo::View_t view = geo::k3D) const;
+
+    /// Fraction of the hits with energy from any of the tracks; throws if a hit is not indexed
+    double Purity(const std::set<int>& track_ids,
+		  const std::vector<art::Ptr<recob::Hit> >& hit_v) const;
+
+    /// Fraction of the indexed hits from any of the tracks that are in the hit collection;
+    /// throws if a hit of the collection is not indexed
+    double Efficiency(const std::set<int>& track_ids,
+		      const std::vector<art::Ptr<recob::Hit> >& hit_v,
+		      const geo::View_t view = geo::k3D) const;
+
+  protected:
+
+    /// Range of the entries of the track in the track => hits table
+    std::pair<size_t,size_t> TrackRange(const int track_id) const;
+
+    /// Sorted union of the hits of the tracks in the view
+    std::vector<size_t> TrackHits(const std::set<int>& track_ids, const geo::View_t view) const;
+
+    /// Position of the hit in the index; throws if it was not indexed
+    size_t CheckedIndex(const art::Ptr<recob::Hit>& hit) const;
+
+    /// Whether any of the tracks has at least min_energy_frac of the energy of the hit
+    bool FromTracks(const size_t hit_index, const std::set<int>& track_ids,
+		    const double min_energy_frac) const;
+
+    double _min_energy_frac = 0.010;
+    art::ProductID _hit_id;
+    std::vector<size_t> _key_to_index;
+
+    // per hit
+    std::vector<geo::View_t> _hit_view;
+    std::vector<size_t> _hit_ide_offset; ///< first entry of each hit in the _ide_ vectors; one more at the end
+
+    // per (hit, track ID), sorted by track ID within a hit
+    std::vector<int> _ide_trackid;
+    std::vector<float> _ide_energy;
+    std::vector<float> _ide_frac;
+
+    // track ID => hits
+    std::vector<int> _track_id;           ///< sorted track IDs
+    std::vector<size_t> _track_offset;    ///< first entry of each track in _track_hit; one more at the end
+    std::vector<size_t> _track_hit;       ///< sorted hit indices of each track
+  };
+}
+#endif
+/** @} */ // end of doxygen group
@@ -52,6 +52,7 @@ void cluster::BlurredClusteringAlg::reconfigure(fhicl::ParameterSet const& p) {
   fKernelHeight = 2 * fBlurTick*fMaxTickWidthBlur + 1;
 
   fDetProp = lar::providerFrom<detinfo::DetectorPropertiesService>();
+  fProjections.SetProviders(&*fGeom, fDetProp);
 }
 
 void cluster::BlurredClusteringAlg::CreateDebugPDF(int run, int subrun, int event) {
@@ -449,33 +450,28 @@ int cluster::BlurredClusteringAlg::FindClusters(std::vector<std::vector<double>
 
 int cluster::BlurredClusteringAlg::GlobalWire(geo::WireID const& wireID) {
 
-  double wireCentre[3];
-  fGeom->WireIDToWireGeo(wireID).GetCenter(wireCentre);
-
   double globalWire = -999;
-  if (fGeom->SignalType(wireID) == geo::kInduction) {
-    if (wireID.TPC % 2 == 0) globalWire = fGeom->WireCoordinate(wireCentre[1], wireCentre[2], wireID.Plane, 0, wireID.Cryostat);
-    else globalWire = fGeom->WireCoordinate(wireCentre[1], wireCentre[2], wireID.Plane, 1, wireID.Cryostat);
+  if (fProjections.SignalType(wireID) == geo::kInduction) {
+    globalWire = fProjections.ReferenceWireCoordinate(wireID);
   }
   else {
     // FOR COLLECTION WIRES, HARD CODE THE GEOMETRY FOR GIVEN DETECTORS
     // THIS _SHOULD_ BE TEMPORARY. GLOBAL WIRE SUPPORT IS BEING ADDED TO THE LARSOFT GEOMETRY AND SHOULD BE AVAILABLE SOON
     if (fDetector == "dune35t") {
-      unsigned int nwires = fGeom->Nwires(wireID.Plane, 0, wireID.Cryostat);
+      unsigned int nwires = fProjections.Nwires(geo::PlaneID(wireID.Cryostat, 0, wireID.Plane));
       if (wireID.TPC == 0 or wireID.TPC == 1) globalWire = wireID.Wire;
       else if (wireID.TPC == 2 or wireID.TPC == 3 or wireID.TPC == 4 or wireID.TPC == 5) globalWire = nwires + wireID.Wire;
       else if (wireID.TPC == 6 or wireID.TPC == 7) globalWire = (2*nwires) + wireID.Wire;
       else mf::LogError("BlurredClusterAlg") << "Error when trying to find a global induction plane coordinate for TPC " << wireID.TPC << " (geometry" << fDetector << ")";
     }
     else if (fDetector == "dunefd") {
-      unsigned int nwires = fGeom->Nwires(wireID.Plane, 0, wireID.Cryostat);
+      unsigned int nwires = fProjections.Nwires(geo::PlaneID(wireID.Cryostat, 0, wireID.Plane));
       // Detector geometry has four TPCs, two on top of each other, repeated along z...
       int block = wireID.TPC / 4;
       globalWire = (nwires*block) + wireID.Wire;
     }
     else {
-      if (wireID.TPC % 2 == 0) globalWire = fGeom->WireCoordinate(wireCentre[1], wireCentre[2], wireID.Plane, 0, wireID.Cryostat);
-      else globalWire = fGeom->WireCoordinate(wireCentre[1], wireCentre[2], wireID.Plane, 1, wireID.Cryostat);
+      globalWire = fProjections.ReferenceWireCoordinate(wireID);
     }
   }
 
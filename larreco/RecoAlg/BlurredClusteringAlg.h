@@ -30,6 +30,7 @@
 #include "larcore/Geometry/PlaneGeo.h"
 #include "larcore/Geometry/WireGeo.h"
 #include "larcore/Geometry/Geometry.h"
+#include "larreco/RecoAlg/PlaneProjectionTable.h"
 
 // ROOT
 #include <TTree.h>
@@ -89,6 +90,9 @@ public:
   /// Find the global wire position
   int GlobalWire(geo::WireID const& wireID);
 
+  /// Fills the plane projection table used by GlobalWire (otherwise the geometry service is asked); to be called at the beginning of each run
+  void UpdateGeometry() { fProjections.UpdateGeometry(*fGeom); }
+
   /// Applies Gaussian blur to image
   std::vector<std::vector<double> > GaussianBlur(std::vector<std::vector<double> > const& image);
 
@@ -174,6 +178,9 @@ private:
   art::ServiceHandle<geo::Geometry> fGeom;
   detinfo::DetectorProperties const* fDetProp;
 
+  // Wire geometry used for every hit
+  util::PlaneProjectionTable fProjections;
+
 };
 
 #endif
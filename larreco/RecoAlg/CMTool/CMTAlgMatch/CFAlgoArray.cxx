@@ -58,5 +58,19 @@ namespace cmtool {
     return score_result;
   }
 
+  //----------------------------------------------------------------------------------------------
+  bool CFAlgoArray::PairCompatible(const cluster::ClusterParamsAlg& prev,
+				   const cluster::ClusterParamsAlg& next) const
+  //----------------------------------------------------------------------------------------------
+  {
+    if(_mode == kSimpleAddition) return true;
+
+    for(auto const& algo : _algo_array)
+
+      if(!algo->PairCompatible(prev,next)) return false;
+
+    return true;
+  }
+
 }
 #endif
@@ -71,6 +71,13 @@ namespace cmtool {
     */
     virtual float Float(const std::vector<const cluster::ClusterParamsAlg*> &cluster);
 
+    /**
+       Prefilter: except in kSimpleAddition mode a negative return of any algorithm
+       is the result, so the pair is incompatible if any algorithm says so.
+    */
+    virtual bool PairCompatible(const cluster::ClusterParamsAlg& prev,
+				const cluster::ClusterParamsAlg& next) const;
+
     /**
        Optional function: called after each iterative approach if a manager class is
        run with verbosity level <= kPerIteration. Maybe useful for debugging.
@@ -80,6 +87,11 @@ namespace cmtool {
     /// Function to reset the algorithm instance, called together with manager's Reset()
     virtual void Reset() { for(auto const& algo : _algo_array) algo->Reset(); }
 
+    /// Reentrant only if all the algorithms are
+    virtual bool Reentrant() const
+    { for(auto const& algo : _algo_array) if(!algo->Reentrant()) return false;
+      return true; }
+
     /**
        Optional function: called at the beginning of 1st iteration. This is called per event.
      */
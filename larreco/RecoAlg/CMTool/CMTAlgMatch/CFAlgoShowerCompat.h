@@ -59,6 +59,9 @@ namespace cmtool {
     /// Function to reset the algorithm instance, called together with manager's Reset()
     virtual void Reset();
 
+    /// Float() fills the analysis tree through data members
+    virtual bool Reentrant() const { return false; }
+
     void PrintClusterInfo(const cluster::ClusterParamsAlg &c);
     
    void WriteHaxFile()
@@ -1,6 +1,8 @@
 #ifndef RECOTOOL_CFALGOTIMEOVERLAP_CXX
 #define RECOTOOL_CFALGOTIMEOVERLAP_CXX
 
+#include <algorithm>
+
 #include "CFAlgoTimeOverlap.h"
 
 namespace cmtool {
@@ -143,6 +145,32 @@ namespace cmtool {
     return (ratio > _time_ratio_cut ? ratio : -1 ); 
     
    }
+
+  //----------------------------------------------------------------------------------------------
+  bool CFAlgoTimeOverlap::PairCompatible(const cluster::ClusterParamsAlg& prev,
+					 const cluster::ClusterParamsAlg& next) const
+  //----------------------------------------------------------------------------------------------
+  {
+    // A failed time cut scales the ratio (at most 1) by 0.001 in Float():
+    // the combination is rejected for sure only if the ratio cut is not looser than that
+    if(_time_ratio_cut < 0.001) return true;
+
+    double prev_start_t = std::min(prev.GetParams().start_point.t, prev.GetParams().end_point.t);
+    double prev_end_t   = std::max(prev.GetParams().start_point.t, prev.GetParams().end_point.t);
+    double start_t      = std::min(next.GetParams().start_point.t, next.GetParams().end_point.t);
+    double end_t        = std::max(next.GetParams().start_point.t, next.GetParams().end_point.t);
+    double length       = next.GetParams().length;
+
+    // as in Float(), a previous time of 0 is replaced by the current one
+    if(prev_start_t ==0)
+      prev_start_t = start_t ;
+    if(prev_end_t ==0)
+      prev_end_t = end_t ;
+
+    return ( (start_t > (prev_start_t - _start_time_cut) && start_t < (prev_start_t + _start_time_cut))
+	     || (end_t > (prev_end_t - _start_time_cut) && end_t < (prev_end_t + _start_time_cut) )
+	     || (length >25 && start_t >(prev_start_t - 2*_start_time_cut) && start_t < (prev_start_t + 2*_start_time_cut) ) );
+  }
   
   //------------------------------
   /*
@@ -36,6 +36,10 @@ namespace cmtool {
 		and compares across planes to form matches. 
     */
     virtual float Float(const std::vector<const cluster::ClusterParamsAlg*> &clusters);
+
+    /// Prefilter: same start/end time cut as Float() between consecutive clusters
+    virtual bool PairCompatible(const cluster::ClusterParamsAlg& prev,
+				const cluster::ClusterParamsAlg& next) const;
     
     void SetStartTimeCut(float start_time) { _start_time_cut = start_time ; } 
     
@@ -1,6 +1,11 @@
 #ifndef RECOTOOL_CFALGOTIMEPROF_CXX
 #define RECOTOOL_CFALGOTIMEPROF_CXX
 
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <numeric>
+
 #include "CFAlgoTimeProf.h"
 // ROOT includes
 #include "TF1.h"
@@ -20,7 +25,18 @@ namespace cmtool {
   CFAlgoTimeProf::CFAlgoTimeProf() : CFloatAlgoBase()
   //-------------------------------------------------------
   {
+    _use_histograms  = false;
+    _first_cluster   = nullptr;
+    SetMaxWindowTime();
+  }
 
+  //--------------------------------------
+  void CFAlgoTimeProf::SetMaxWindowTime()
+  //--------------------------------------
+  {
+    ::util::GeometryUtilities geou;
+    const detinfo::DetectorProperties* detp = lar::providerFrom<detinfo::DetectorPropertiesService>();
+    _max_window_time = detp->NumberTimeSamples() * geou.TimeToCm();
   }
 
   //-------------------------------
@@ -33,7 +49,64 @@ namespace cmtool {
   void CFAlgoTimeProf::Reset()
   //-----------------------------
   {
+    _profiles.clear();
+    _first_cluster = nullptr;
+    SetMaxWindowTime();
+  }
+
+  //---------------------------------------------------------------------------------------
+  void CFAlgoTimeProf::IterationBegin(const std::vector<cluster::ClusterParamsAlg> &clusters)
+  //---------------------------------------------------------------------------------------
+  {
+    _profiles.clear();
+    _first_cluster = nullptr;
+    if(_use_histograms || clusters.empty()) return;
+
+    _profiles.resize(clusters.size());
+    for(size_t i=0; i<clusters.size(); ++i) FillProfile(clusters[i],_profiles[i]);
+    _first_cluster = &(clusters.front());
+  }
+
+  //---------------------------------------------------------------------------------------------
+  void CFAlgoTimeProf::FillProfile(const cluster::ClusterParamsAlg& cluster, TimeProfile& prof) const
+  //---------------------------------------------------------------------------------------------
+  {
+    auto const& hits = cluster.GetHitVector();
+    prof.plane = cluster.Plane();
+    prof.time.clear();
+    prof.charge.clear();
+    if(hits.empty()) return;
+
+    ::util::GeometryUtilities geou;
+    const detinfo::DetectorProperties* detp = lar::providerFrom<detinfo::DetectorPropertiesService>();
+    prof.offset = detp->GetXTicksOffset((int)(hits.front().plane),0,0) * geou.TimeToCm();
+
+    std::vector<size_t> order(hits.size());
+    std::iota(order.begin(),order.end(),0);
+    std::stable_sort(order.begin(),order.end(),
+		     [&hits](size_t a, size_t b) { return hits[a].t < hits[b].t; });
+
+    prof.time.reserve(hits.size());
+    prof.charge.reserve(hits.size());
+    double sum = 0;
+    for(auto const& index : order) {
+      sum += hits[index].charge;
+      prof.time.push_back(hits[index].t);
+      prof.charge.push_back(sum);
+    }
+  }
+
+  //------------------------------------------------------------------------------------------------
+  const CFAlgoTimeProf::TimeProfile& CFAlgoTimeProf::GetProfile(const cluster::ClusterParamsAlg* cluster,
+								 TimeProfile& scratch) const
+  //------------------------------------------------------------------------------------------------
+  {
+    if(_first_cluster && cluster >= _first_cluster && cluster < _first_cluster + _profiles.size())
+      return _profiles[cluster - _first_cluster];
 
+    // not one of the clusters seen at IterationBegin(): build it on the fly
+    FillProfile(*cluster,scratch);
+    return scratch;
   }
 
   //----------------------------------------------------------------------------------------------
@@ -45,6 +118,30 @@ namespace cmtool {
   //### need a pointer to the cluster just return -1  
     for(auto const& ptr : clusters) if(!ptr) return -1;
 
+    if(!_use_histograms) {
+
+      // same plane-pair logic as the histogram version below
+      std::array<TimeProfile,3> scratch;
+      std::array<const TimeProfile*,3> profs {{ nullptr, nullptr, nullptr }};
+      for(auto const& c : clusters) {
+	if(c->Plane() < 0 || c->Plane() > 2) continue;
+	auto const& prof = GetProfile(c,scratch[c->Plane()]);
+	if(!prof.time.empty()) profs[c->Plane()] = &prof;
+      }
+
+      float matchscore = 0;
+      float avgcounter = 0;
+      for(size_t a=0; a<profs.size(); ++a) {
+	for(size_t b=a+1; b<profs.size(); ++b) {
+	  if(!profs[a] || !profs[b]) continue;
+	  matchscore += TProfCompare(*profs[a],*profs[b]);
+	  avgcounter += 1;
+	}
+      }
+      if(avgcounter == 0) return -1;
+      return matchscore / avgcounter;
+    }
+
         std::vector<util::PxHit> hits0;
         std::vector<util::PxHit> hits1;
         std::vector<util::PxHit> hits2;
@@ -143,6 +240,60 @@ namespace cmtool {
     //else return -1.;
   }
 
+  //----------------------------------------------------------------------------------
+  void CFAlgoTimeProf::FillCumulative(const TimeProfile& prof, double shift,
+				      double tmin, double tmax,
+				      std::vector<double>& cumul) const
+  //----------------------------------------------------------------------------------
+  {
+    // bin numbering as in TAxis::FindBin(); bins are 1-based
+    cumul.assign(kNBins,0.);
+    size_t ihit = 0;
+    double q = 0;
+    for(int bin=1; bin<=kNBins; ++bin) {
+      while(ihit < prof.time.size() &&
+	    1 + int(kNBins * (prof.time[ihit] + shift - tmin) / (tmax - tmin)) <= bin)
+	q = prof.charge[ihit++];
+      cumul[bin-1] = q;
+    }
+  }
+
+  //-----------------------------------------------------------------------------------------
+  float CFAlgoTimeProf::TProfCompare(const TimeProfile& profa, const TimeProfile& profb) const
+  //-----------------------------------------------------------------------------------------
+  {
+    // Reproduces TH1::KolmogorovTest() between the two cumulative histograms
+    // built by the histogram version, with a single merge over sorted hits
+    const double time_diff = profa.offset - profb.offset;
+
+    double min_time = std::min(_max_window_time, profa.time.front());
+    double max_time = std::max(0., profa.time.back());
+    min_time = std::min(min_time, profb.time.front() + time_diff);
+    max_time = std::max(max_time, profb.time.back()  + time_diff);
+
+    // local buffers: Float() may be called by several threads at once
+    std::vector<double> cumul_a, cumul_b;
+    FillCumulative(profa, 0.,        min_time-1, max_time+1, cumul_a);
+    FillCumulative(profb, time_diff, min_time-1, max_time+1, cumul_b);
+
+    const double suma = std::accumulate(cumul_a.begin(),cumul_a.end(),0.);
+    const double sumb = std::accumulate(cumul_b.begin(),cumul_b.end(),0.);
+    if(suma == 0 || sumb == 0) return 0;
+
+    double dfmax = 0, rsuma = 0, rsumb = 0;
+    for(int i=0; i<kNBins; ++i) {
+      rsuma += cumul_a[i] / suma;
+      rsumb += cumul_b[i] / sumb;
+      dfmax = std::max(dfmax, std::abs(rsuma - rsumb));
+    }
+
+    // the histograms were scaled, so the effective entries are the unscaled sums
+    const double ks = TMath::KolmogorovProb(dfmax * std::sqrt(suma * sumb / (suma + sumb)));
+
+    if(_verbose) std::cout << ks << std::endl;
+    return ks;
+  }
+
 // Making a function to do the profile test
  float CFAlgoTimeProf::TProfCompare(std::vector<util::PxHit> hita ,std::vector<util::PxHit> hitb)
  {
@@ -14,6 +14,8 @@
 #ifndef RECOTOOL_CFALGOTIMEPROF_H
 #define RECOTOOL_CFALGOTIMEPROF_H
 
+#include <vector>
+
 #include "larreco/RecoAlg/CMTool/CMToolBase/CFloatAlgoBase.h"
 
 namespace cmtool {
@@ -45,6 +47,15 @@ namespace cmtool {
     /// Function to reset the algorithm instance, called together with manager's Reset()
     virtual void Reset();
 
+    /// Switch back to the TH1D based comparison (slow, kept for validation)
+    void UseHistograms(bool doit=true) { _use_histograms = doit; }
+
+    /**
+       Builds the cumulative time profile of every cluster once, so that Float()
+       only has to merge two pre-sorted profiles per plane pair.
+     */
+    virtual void IterationBegin(const std::vector<cluster::ClusterParamsAlg> &clusters);
+
     /**
        Optional function: called at the beginning of 1st iteration. This is called per event.
      */
@@ -55,22 +66,53 @@ namespace cmtool {
      */
     //virtual void EventEnd();
  
-    /**
-       Optional function: called at the beggining of each iterative loop.
-       This provides all clusters' information in case the algorithm need them. Note this
-       is called per iteration which may be more than once per event.
-     */
-    //virtual void IterationBegin(const std::vector<cluster::ClusterParamsAlgNew> &clusters);
-
     /**
        Optional function: called at the end of each iterative loop.
      */
     //virtual void IterationEnd();
 
    private:
-	
+
+    /// Number of time bins used to compare the cumulative profiles
+    static constexpr int kNBins = 200;
+
+    /// Cumulative charge profile of a cluster along the drift coordinate
+    struct TimeProfile {
+      int    plane  = -1;
+      double offset = 0.;          ///< plane time offset [cm]
+      std::vector<double> time;    ///< hit times in increasing order [cm]
+      std::vector<double> charge;  ///< charge of all the hits up to this one
+    };
+
+    /// Fills the profile from the hits of the cluster
+    void FillProfile(const cluster::ClusterParamsAlg& cluster, TimeProfile& prof) const;
+
+    /// Returns the cached profile of the cluster, or builds it into scratch
+    const TimeProfile& GetProfile(const cluster::ClusterParamsAlg* cluster, TimeProfile& scratch) const;
+
+    /// Cumulative charge in each of the kNBins bins spanning [tmin, tmax)
+    void FillCumulative(const TimeProfile& prof, double shift, double tmin, double tmax,
+			std::vector<double>& cumul) const;
+
+    float TProfCompare(const TimeProfile& profa, const TimeProfile& profb) const;
+
     float TProfCompare(std::vector<util::PxHit> hita ,std::vector<util::PxHit> hitb);	
 
+    /// Use the original TH1D based comparison
+    bool _use_histograms;
+
+    /// Profiles of the clusters of the current iteration, in input order
+    std::vector<TimeProfile> _profiles;
+
+    /// Address of the first input cluster (to map Float() pointers to _profiles)
+    const cluster::ClusterParamsAlg* _first_cluster;
+
+    /// Maximum time of the readout window [cm], set at construction and Reset()
+    double _max_window_time;
+
+    /// Computes _max_window_time from the detector properties
+    void SetMaxWindowTime();
+
 
     /*
 (Form("sig_a"),Form("sig_a"),nts,0,nts);
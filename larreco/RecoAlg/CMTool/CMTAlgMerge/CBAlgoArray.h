@@ -78,6 +78,11 @@ namespace cmtool {
     /// Function to set verbosity
     virtual void SetVerbose(bool doit=true)
     { for(auto &algo : _algo_array) algo->SetVerbose(doit); }
+
+    /// Reentrant only if all the algorithms are
+    virtual bool Reentrant() const
+    { for(auto const& algo : _algo_array) if(!algo->Reentrant()) return false;
+      return true; }
     
     /// Function to reset the algorithm instance ... maybe implemented via child class
     virtual void Reset();
@@ -44,6 +44,9 @@ namespace cmtool {
     /// Function to reset the algorithm instance ... maybe implemented via child class
     virtual void Reset(){}
 
+    /// Bool() depends on the number of previous calls
+    virtual bool Reentrant() const { return false; }
+
   protected:
 
     bool _flip;
@@ -40,9 +40,9 @@ namespace cmtool {
 
     double startseparation = (w_start2-w_start1)*(w_start2-w_start1) + (t_start2-t_start1)*(t_start2-t_start1);
     //convert sepration to be instead of just angle -> angle/distance^n (n=1 for now)
-    SetMaxAngleFar(_MaxAngle*(_FallOff/startseparation)); //distance^2 of 400 cm^2 taken as "standard" 
-    if ( _MaxAngleFar > 90. )
-      _MaxAngleFar = 90.;
+    float max_angle_far = _MaxAngle*(_FallOff/startseparation); //distance^2 of 400 cm^2 taken as "standard" 
+    if ( max_angle_far > 90. )
+      max_angle_far = 90.;
 
     //if either cluster has less than _minHits don't even try...
     if ( (hits1 < _minHits) or (hits2 < _minHits)
@@ -88,8 +88,8 @@ namespace cmtool {
     }
     if ( ( ( ( (separation > _MaxAngle) and (separation < 180-_MaxAngle) ) or
 	     ( (separation > 180+_MaxAngle) and (separation< 360-_MaxAngle) ) )
-	   or ( ( (separation > _MaxAngleFar) and (separation < 180-_MaxAngleFar) ) or
-		( (separation > 180+_MaxAngleFar) and (separation< 360-_MaxAngleFar) ) ) )
+	   or ( ( (separation > max_angle_far) and (separation < 180-max_angle_far) ) or
+		( (separation > 180+max_angle_far) and (separation< 360-max_angle_far) ) ) )
 	 and (hits2 > _minHits)
 	 and (len1 > _MinLen)      ){
       if (_verbose) { std::cout << "Separate! cluster 1 BIG" << std::endl << std::endl; }
@@ -108,8 +108,8 @@ namespace cmtool {
     }
     if ( ( ( ( (separation > _MaxAngle) and (separation < 180-_MaxAngle) ) or
 	     ( (separation > 180+_MaxAngle) and (separation< 360-_MaxAngle) ) )
-	   or ( ( (separation > _MaxAngleFar) and (separation < 180-_MaxAngleFar) ) or
-		( (separation > 180+_MaxAngleFar) and (separation< 360-_MaxAngleFar) ) ) )
+	   or ( ( (separation > max_angle_far) and (separation < 180-max_angle_far) ) or
+		( (separation > 180+max_angle_far) and (separation< 360-max_angle_far) ) ) )
 	 and (hits1 > _minHits)
 	 and (len2 > _MinLen)    ){
       if (_verbose) { std::cout << "Separate! cluster 2 BIG" << std::endl << std::endl; }
@@ -47,9 +47,6 @@ namespace cmtool {
     /// Set Max Angle Separation for separation
     void SetMaxAngleSep(float angle) { _MaxAngle = angle; }
 
-    /// Set Max Angle Separation for separation for far away clusters
-    void SetMaxAngleFar(float angle) { _MaxAngleFar = angle; }
-
     /// Set Distance at which cone-acceptance angle starts falling off as 1/distance. Value should be distance^2 in cm^2
     void SetStartAngleFalloff(float d) { _FallOff = d; }
 
@@ -69,7 +66,6 @@ namespace cmtool {
 
     bool _debug;
     float _MaxAngle;
-    float _MaxAngleFar;
     float _MinLen;
     float _FallOff;
     size_t _minHits;
@@ -22,14 +22,6 @@ namespace cmtool {
 
   }
 
-  //------------------------------------------------------------------------------------------
-  void CBAlgoPolyShortestDist::EventBegin(const std::vector<cluster::ClusterParamsAlg> &clusters)
-  //------------------------------------------------------------------------------------------
-  {
-    if(clusters.size())
-      tmp_min_dist = 99999;
-  }
-
   //-------------------------------
   //void CBAlgoPolyShortestDist::EventEnd()
   //-------------------------------
@@ -77,6 +69,7 @@ namespace cmtool {
 
     unsigned int npoints1 = cluster1.GetParams().PolyObject.Size();
     unsigned int npoints2 = cluster2.GetParams().PolyObject.Size();
+    double min_dist = 99999;
     //loop over points on first polygon
     for(unsigned int i = 0; i < npoints1; ++i){
       float pt1w = cluster1.GetParams().PolyObject.Point(i).first;
@@ -87,11 +80,11 @@ namespace cmtool {
 	float pt2t = cluster2.GetParams().PolyObject.Point(j).second;
 	double distsqrd = pow(pt2w-pt1w,2)+pow(pt2t-pt1t,2);
 	
-	if(distsqrd < tmp_min_dist) tmp_min_dist = distsqrd;
+	if(distsqrd < min_dist) min_dist = distsqrd;
 
 	if(_debug){
 	  std::cout<<"two polygon points dist2 is "<<distsqrd<<std::endl;
-	  std::cout<<"minimum dist was "<<tmp_min_dist<<std::endl;
+	  std::cout<<"minimum dist was "<<min_dist<<std::endl;
 	}
 	if(distsqrd<_dist_sqrd_cut)
 	  return true;
@@ -33,11 +33,6 @@ namespace cmtool {
     /// Default destructor
     virtual ~CBAlgoPolyShortestDist(){};
 
-    /**
-       Optional function: called at the beginning of 1st iteration. This is called per event.
-    */
-    virtual void EventBegin(const std::vector<cluster::ClusterParamsAlg> &clusters);
-
     /**
        Optional function: called at the end of event ... after the last merging iteration is over.
      */
@@ -88,8 +83,6 @@ namespace cmtool {
     double _dist_sqrd_cut;
 
     bool _debug;
-
-    double tmp_min_dist;
   };
 }
 #endif
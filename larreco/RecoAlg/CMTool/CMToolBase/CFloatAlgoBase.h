@@ -44,6 +44,16 @@ namespace cmtool {
       else return -1;
     }
 
+    /**
+       Optional function used by CMatchManager prefilter: return false only if Float()
+       is guaranteed to return a negative value for any combination in which cluster
+       next directly follows cluster prev (combinations are ordered by plane).
+       The default never rejects.
+    */
+    virtual bool PairCompatible(const cluster::ClusterParamsAlg& /* prev */,
+				const cluster::ClusterParamsAlg& /* next */) const
+    { return true; }
+
   };
 
 }
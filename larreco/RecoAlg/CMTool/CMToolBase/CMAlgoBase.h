@@ -73,6 +73,13 @@ namespace cmtool {
     virtual void Report()
     {return;}
 
+    /**
+       Whether Bool()/Float() can be called by several threads at once, i.e. they do not
+       modify the algorithm state. Managers call a non-reentrant algorithm serially.
+    */
+    virtual bool Reentrant() const
+    { return true; }
+
     /// Setter function for an output plot TFile pointer
     void SetAnaFile(TFile* fout) { _fout = fout; }
 
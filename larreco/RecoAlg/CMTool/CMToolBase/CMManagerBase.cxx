@@ -12,6 +12,7 @@ namespace cmtool {
     _priority_algo = nullptr;
     _min_nhits = 0;
     _merge_till_converge = false;
+    _nthreads = 1;
     Reset();
     _time_report=false;
   }
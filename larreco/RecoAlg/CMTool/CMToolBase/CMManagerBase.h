@@ -17,6 +17,7 @@
 #include <iostream>
 
 #include "CPriorityAlgoBase.h"
+#include "larreco/RecoAlg/ParallelFor.h"
 #include "TStopwatch.h"
 
 namespace cmtool {
@@ -85,6 +86,13 @@ namespace cmtool {
     /// A setter for an analysis output file
     void SetAnaFile(TFile* fout) { _fout = fout; }
 
+    /**
+       Number of threads used to run the algorithms over cluster pairs/combinations.
+       Algorithms that are not CMAlgoBase::Reentrant() are always run serially.
+       Results are always collected in the same order as with a single thread.
+    */
+    void SetNumThreads(size_t n) { _nthreads = (n ? n : 1); }
+
   protected:
 
     /// Function to compute priority
@@ -134,6 +142,9 @@ namespace cmtool {
     /// A holder for # of unique planes in the clusters, computed in ComputePriority() function
     std::set<UChar_t> _planes;
 
+    /// Number of threads used to run the algorithms
+    size_t _nthreads;
+
   };
 }
 
@@ -1,6 +1,8 @@
 #ifndef RECOTOOL_CMATCHMANAGER_CXX
 #define RECOTOOL_CMATCHMANAGER_CXX
 
+#include <algorithm>
+
 #include "CMatchManager.h"
 
 namespace cmtool {
@@ -14,6 +16,7 @@ namespace cmtool {
   {
     _match_algo = nullptr;
     _nplanes    = nplanes;
+    _prefilter  = false;
     Reset();
   }
 
@@ -153,6 +156,48 @@ namespace cmtool {
       
   }
 
+  std::vector<std::vector<std::pair<size_t,size_t> > >
+  CMatchManager::PrefilteredCombinations(const std::vector<std::vector<size_t> >& cluster_array) const
+  {
+    std::vector<std::vector<std::pair<size_t,size_t> > > result;
+
+    // Same plane-combination order as PlaneClusterCombinations()
+    for(size_t i=0; i<cluster_array.size(); ++i) {
+
+      if(cluster_array.size() < 2+i) break;
+
+      for(auto const& plane_comb : SimpleCombination(cluster_array.size(),cluster_array.size()-i)) {
+
+	// Extend the surviving tuples plane by plane; extending each tuple in
+	// increasing position keeps the lexicographic order of ClusterCombinations()
+	std::vector<std::vector<size_t> > partial(1);
+	for(size_t k=0; k<plane_comb.size(); ++k) {
+
+	  auto const& clusters = cluster_array[plane_comb[k]];
+	  std::vector<std::vector<size_t> > next;
+
+	  for(auto const& p : partial) {
+	    for(size_t pos=0; pos<clusters.size(); ++pos) {
+	      if(k && !_match_algo->PairCompatible(_in_clusters[cluster_array[plane_comb[k-1]][p.back()]],
+						   _in_clusters[clusters[pos]]))
+		continue;
+	      next.push_back(p);
+	      next.back().push_back(pos);
+	    }
+	  }
+	  partial.swap(next);
+	}
+
+	for(auto const& p : partial) {
+	  result.push_back(std::vector<std::pair<size_t,size_t> >());
+	  for(size_t k=0; k<p.size(); ++k)
+	    result.back().push_back(std::make_pair(plane_comb[k],p[k]));
+	}
+      }
+    }
+    return result;
+  }
+
   bool CMatchManager::IterationProcess()
   {
 
@@ -203,52 +248,82 @@ namespace cmtool {
 
       seed.push_back(clusters_per_plane.size());
     
-    auto const& combinations = PlaneClusterCombinations(seed);
-    
-    // Loop over combinations and call algorithm
-    for(auto const& comb : combinations) {
-
-      std::vector<const cluster::ClusterParamsAlg*> ptr_v;
-
-      std::vector<unsigned int> tmp_index_v;
-
-      tmp_index_v.reserve(comb.size());
+    std::vector<std::vector<std::pair<size_t,size_t> > > combinations;
+    if(_prefilter)
+      combinations = PrefilteredCombinations(cluster_array);
+    else
+      combinations = PlaneClusterCombinations(seed);
+
+    auto fill_combination = [&cluster_array,this](const std::vector<std::pair<size_t,size_t> >& comb,
+						   std::vector<const cluster::ClusterParamsAlg*>& ptr_v,
+						   std::vector<unsigned int>& tmp_index_v)
+      {
+	ptr_v.clear();
+	tmp_index_v.clear();
+	tmp_index_v.reserve(comb.size());
+	ptr_v.reserve(comb.size());
+	for(auto const& plane_cluster : comb) {
+	  auto const& in_cluster_index = cluster_array.at(plane_cluster.first).at(plane_cluster.second);
+	  tmp_index_v.push_back(in_cluster_index);
+	  ptr_v.push_back(&(_in_clusters.at(in_cluster_index)));
+	}
+      };
 
-      ptr_v.reserve(comb.size());
+    if(_nthreads < 2 || combinations.size() < 2 || _debug_mode <= kPerMerging || !_match_algo->Reentrant()) {
 
-      for(auto const& plane_cluster : comb) {
-	
-	auto const& in_cluster_index = cluster_array.at(plane_cluster.first).at(plane_cluster.second);
+      // Loop over combinations and call algorithm
+      for(auto const& comb : combinations) {
 
-	tmp_index_v.push_back(in_cluster_index);
+	std::vector<const cluster::ClusterParamsAlg*> ptr_v;
 
-	ptr_v.push_back(&(_in_clusters.at(in_cluster_index)));
+	std::vector<unsigned int> tmp_index_v;
 
-      }
+	fill_combination(comb,ptr_v,tmp_index_v);
 
-      if(_debug_mode <= kPerMerging){
+	if(_debug_mode <= kPerMerging){
 	
-	std::cout
-	  << "    \033[93m"
-	  << "Inspecting a pair (";
-	for(auto const& index : tmp_index_v)
-	  std::cout << index << " ";
-	std::cout<<") \033[00m" << std::flush;
+	  std::cout
+	    << "    \033[93m"
+	    << "Inspecting a pair (";
+	  for(auto const& index : tmp_index_v)
+	    std::cout << index << " ";
+	  std::cout<<") \033[00m" << std::flush;
 
-	localWatch.Start();
+	  localWatch.Start();
 
-      }
+	}
       
-      auto const& score = _match_algo->Float(ptr_v);
+	auto const& score = _match_algo->Float(ptr_v);
 
-      if(_debug_mode <= kPerMerging)
+	if(_debug_mode <= kPerMerging)
 
-	std::cout << " ... Time taken = " << localWatch.RealTime() << " [s]" << std::endl;
+	  std::cout << " ... Time taken = " << localWatch.RealTime() << " [s]" << std::endl;
 
-      if(score>0)
+	if(score>0)
 	
-	_book_keeper.Match(tmp_index_v,score);
+	  _book_keeper.Match(tmp_index_v,score);
+
+      }
+    }
+    else {
+
+      // Score in parallel, then register in the serial order
+      std::vector<float> scores(combinations.size(),-1);
+      util::ParallelFor(combinations.size(), _nthreads,
+		  [&](size_t icomb, size_t) {
+		    std::vector<const cluster::ClusterParamsAlg*> ptr_v;
+		    std::vector<unsigned int> tmp_index_v;
+		    fill_combination(combinations[icomb],ptr_v,tmp_index_v);
+		    scores[icomb] = _match_algo->Float(ptr_v);
+		  });
 
+      std::vector<const cluster::ClusterParamsAlg*> ptr_v;
+      std::vector<unsigned int> tmp_index_v;
+      for(size_t icomb=0; icomb<combinations.size(); ++icomb) {
+	if(scores[icomb] <= 0) continue;
+	fill_combination(combinations[icomb],ptr_v,tmp_index_v);
+	_book_keeper.Match(tmp_index_v,scores[icomb]);
+      }
     }
   
     if(_debug_mode <= kPerIteration) {
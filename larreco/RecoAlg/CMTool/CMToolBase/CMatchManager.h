@@ -50,6 +50,13 @@ namespace cmtool {
     /// A method to obtain book keeper
     const CMatchBookKeeper& GetBookKeeper() const { return _book_keeper; }
 
+    /**
+       Enable the prefilter: combinations containing two consecutive clusters that
+       the matching algorithm declares incompatible (CFloatAlgoBase::PairCompatible())
+       are not passed to Float(). The book keeper result is unchanged.
+    */
+    void SetPrefilter(bool doit=true) { _prefilter = doit; }
+
   protected:
     
     //
@@ -71,6 +78,10 @@ namespace cmtool {
     /// FMWK function called @ end of Process()
     virtual void EventEnd();
 
+    /// Combinations passing the prefilter, in the order of the full enumeration
+    std::vector<std::vector<std::pair<size_t,size_t> > >
+    PrefilteredCombinations(const std::vector<std::vector<size_t> >& cluster_array) const;
+
   protected:
 
     /// Book keeper instance
@@ -82,6 +93,9 @@ namespace cmtool {
     /// Number of planes
     size_t _nplanes;
 
+    /// Prefilter switch
+    bool _prefilter;
+
   };
 }
 
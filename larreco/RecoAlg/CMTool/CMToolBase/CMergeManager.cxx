@@ -1,6 +1,9 @@
 #ifndef RECOTOOL_CMERGEMANAGER_CXX
 #define RECOTOOL_CMERGEMANAGER_CXX
 
+#include <algorithm>
+#include <limits>
+
 #include "CMergeManager.h"
 
 namespace cmtool {
@@ -10,6 +13,9 @@ namespace cmtool {
     _iter_ctr=0;
     _merge_algo = nullptr;
     _separate_algo = nullptr;
+    _box_prefilter = false;
+    _box_margin = 0;
+    _incremental_merge = false;
     Reset();
   }
 
@@ -199,22 +205,17 @@ namespace cmtool {
 	  continue;
 	}
 	
-	size_t tmp_hit_counts=0;
+	std::vector<const ::cluster::ClusterParamsAlg*> tmp_clusters;
+	tmp_clusters.reserve(indexes_v.size());
 	for(auto const& index : indexes_v) 
-	  tmp_hit_counts += _tmp_merged_clusters.at(index).GetHitVector().size();
-	//std::vector<larutil::PxHit> tmp_hits;
-	std::vector<util::PxHit> tmp_hits;
-	tmp_hits.reserve(tmp_hit_counts);
-	
-	for(auto const& index : indexes_v) {
-	  for(auto const& hit : _tmp_merged_clusters.at(index).GetHitVector())
-	    tmp_hits.push_back(hit);
-	}
+	  tmp_clusters.push_back(&(_tmp_merged_clusters.at(index)));
+
 	_out_clusters.push_back(::cluster::ClusterParamsAlg());
 	(*_out_clusters.rbegin()).SetVerbose(false);
 	(*_out_clusters.rbegin()).DisableFANN();
+	(*_out_clusters.rbegin()).UseMoments(_incremental_merge);
 	
-	if((*_out_clusters.rbegin()).SetHits(tmp_hits) < 1) continue;
+	if((*_out_clusters.rbegin()).MergeHits(tmp_clusters) < 1) continue;
 	(*_out_clusters.rbegin()).FillParams(true,true,true,true,true,false);
 	(*_out_clusters.rbegin()).FillPolygon();
       }
@@ -262,8 +263,12 @@ namespace cmtool {
     //
     // Merging
     //
-    
-    // Run over clusters and execute merging algorithms
+
+    std::vector<std::vector<size_t> > neighbours;
+    if(_box_prefilter) neighbours = BoxNeighbours(in_clusters);
+
+    // Collect the pairs to inspect, in priority order
+    std::vector<std::pair<size_t,size_t> > pairs;
     for(auto citer1 = _priority.rbegin();
 	citer1 != _priority.rend();
 	++citer1) {
@@ -283,39 +288,72 @@ namespace cmtool {
 	// Skip if this combination is not meant to be compared
 	if(!(merge_flag.at((*citer2).second)) && !(merge_flag.at((*citer1).second)) ) continue;
 
+	// Skip if the clusters are too far apart
+	if(_box_prefilter) {
+	  auto const& nb = neighbours.at((*citer1).second);
+	  if(!std::binary_search(nb.begin(),nb.end(),(*citer2).second)) continue;
+	}
+
 	// Skip if this combination is not allowed to merge
 	if(!(book_keeper.MergeAllowed((*citer1).second,(*citer2).second))) continue;
 
-	if(_debug_mode <= kPerMerging){
+	pairs.push_back(std::make_pair((*citer1).second,(*citer2).second));
+
+      } // end looping over all cluster pairs for citer1
+
+    } // end looping over clusters
+
+    // Evaluate the algorithm on all pairs up front when running in parallel.
+    // A pair prohibited now stays prohibited, so only the Merge() calls below
+    // depend on the order, and they are done serially as in the single thread case.
+    std::vector<char> merge_v;
+    bool precomputed = (_nthreads > 1 && _debug_mode > kPerMerging && _merge_algo->Reentrant());
+    if(precomputed) {
+      merge_v.resize(pairs.size(),0);
+      util::ParallelFor(pairs.size(), _nthreads,
+		  [&](size_t i, size_t) {
+		    merge_v[i] = _merge_algo->Bool(in_clusters.at(pairs[i].first),
+						   in_clusters.at(pairs[i].second));
+		  });
+    }
+
+    for(size_t ipair=0; ipair<pairs.size(); ++ipair) {
+
+      auto const& index1 = pairs[ipair].first;
+      auto const& index2 = pairs[ipair].second;
+
+      // Skip if this combination is not allowed to merge anymore
+      if(!(book_keeper.MergeAllowed(index1,index2))) continue;
+
+      if(_debug_mode <= kPerMerging){
 	  
-	  std::cout
-	    << Form("    \033[93mInspecting a pair (%zu, %zu) for merging... \033[00m",(*citer1).second, (*citer2).second)
-	    << std::endl;
-	}
+	std::cout
+	  << Form("    \033[93mInspecting a pair (%zu, %zu) for merging... \033[00m",index1, index2)
+	  << std::endl;
+      }
 	
-	bool merge = _merge_algo->Bool(in_clusters.at((*citer1).second),in_clusters.at((*citer2).second));
+      bool merge = (precomputed ? merge_v[ipair] :
+		    _merge_algo->Bool(in_clusters.at(index1),in_clusters.at(index2)));
 
-	if(_debug_mode <= kPerMerging) {
+      if(_debug_mode <= kPerMerging) {
 	  
-	  if(merge) 
-	    std::cout << "    \033[93mfound to be merged!\033[00m " 
-		      << std::endl
-		      << std::endl;
+	if(merge) 
+	  std::cout << "    \033[93mfound to be merged!\033[00m " 
+		    << std::endl
+		    << std::endl;
 	  
-	  else 
-	    std::cout << "    \033[93mfound NOT to be merged...\033[00m" 
-		      << std::endl
-		      << std::endl;
+	else 
+	  std::cout << "    \033[93mfound NOT to be merged...\033[00m" 
+		    << std::endl
+		    << std::endl;
 
-	} // end looping over all sets of algorithms
+      } // end looping over all sets of algorithms
 	
-	if(merge)
-
-	  book_keeper.Merge((*citer1).second,(*citer2).second);
+      if(merge)
 
-      } // end looping over all cluster pairs for citer1
+	book_keeper.Merge(index1,index2);
 
-    } // end looping over clusters
+    } // end looping over pairs
 
     if(_debug_mode <= kPerIteration && book_keeper.GetResult().size() != in_clusters.size()) {
       
@@ -357,7 +395,9 @@ namespace cmtool {
     // Separation
     //
     
-    // Run over clusters and execute merging algorithms
+    // Same-plane pairs: separation does not depend on the order, so the
+    // algorithm can be evaluated on all of them at once
+    std::vector<std::pair<size_t,size_t> > pairs;
     for(size_t cindex1 = 0; cindex1 < in_clusters.size(); ++cindex1) {
       
       UChar_t plane1 = in_clusters.at(cindex1).Plane();
@@ -370,19 +410,35 @@ namespace cmtool {
 	
 	// Skip if this combination is not meant to be compared
 	//if(!(separate_flag.at(cindex2))) continue;
-	
+
+	pairs.push_back(std::make_pair(cindex1,cindex2));
+      }
+    }
+
+    std::vector<char> separate_v(pairs.size(),0);
+    if(_nthreads > 1 && _debug_mode > kPerMerging && _separate_algo->Reentrant())
+      util::ParallelFor(pairs.size(), _nthreads,
+		  [&](size_t i, size_t) {
+		    separate_v[i] = _separate_algo->Bool(in_clusters.at(pairs[i].first),
+							 in_clusters.at(pairs[i].second));
+		  });
+    else {
+      for(size_t ipair=0; ipair<pairs.size(); ++ipair) {
+
 	if(_debug_mode <= kPerMerging){
 	  
 	  std::cout
-	    << Form("    \033[93mInspecting a pair (%zu, %zu) for separation... \033[00m",cindex1,cindex2)
+	    << Form("    \033[93mInspecting a pair (%zu, %zu) for separation... \033[00m",
+		    pairs[ipair].first,pairs[ipair].second)
 	    << std::endl;
 	}
 	
-	bool separate = _separate_algo->Bool(in_clusters.at(cindex1),in_clusters.at(cindex2));
+	separate_v[ipair] = _separate_algo->Bool(in_clusters.at(pairs[ipair].first),
+						 in_clusters.at(pairs[ipair].second));
 	
 	if(_debug_mode <= kPerMerging) {
 	  
-	  if(separate) 
+	  if(separate_v[ipair]) 
 	    std::cout << "    \033[93mfound to be separated!\033[00m " 
 		      << std::endl
 		      << std::endl;
@@ -393,15 +449,64 @@ namespace cmtool {
 		      << std::endl;
 	  
 	} // end looping over all sets of algorithms
-	
-	if(separate)
-	  
-	  book_keeper.ProhibitMerge(cindex1,cindex2);
+      }
+    }
+
+    for(size_t ipair=0; ipair<pairs.size(); ++ipair)
+
+      if(separate_v[ipair])
 	  
-      } // end looping over all cluster pairs for citer1
-      
-    } // end looping over clusters
+	book_keeper.ProhibitMerge(pairs[ipair].first,pairs[ipair].second);
+
+  }
+
+  std::vector<std::vector<size_t> >
+  CMergeManager::BoxNeighbours(const std::vector<cluster::ClusterParamsAlg> &in_clusters) const
+  {
+    // Hit bounding box of each cluster (the polygon is a subset of the hits)
+    struct Box { double w_min, w_max, t_min, t_max; };
+    std::vector<Box> boxes;
+    boxes.reserve(in_clusters.size());
+    for(auto const& c : in_clusters) {
+      Box b;
+      b.w_min = b.t_min =  std::numeric_limits<double>::max();
+      b.w_max = b.t_max = -std::numeric_limits<double>::max();
+      for(auto const& h : c.GetHitVector()) {
+	b.w_min = std::min(b.w_min,(double)h.w);
+	b.w_max = std::max(b.w_max,(double)h.w);
+	b.t_min = std::min(b.t_min,(double)h.t);
+	b.t_max = std::max(b.t_max,(double)h.t);
+      }
+      b.w_min -= _box_margin; b.w_max += _box_margin;
+      b.t_min -= _box_margin; b.t_max += _box_margin;
+      boxes.push_back(b);
+    }
+
+    // Sweep along the wire axis, plane by plane
+    std::vector<size_t> order(in_clusters.size());
+    for(size_t i=0; i<order.size(); ++i) order[i] = i;
+    std::sort(order.begin(),order.end(),
+	      [&](size_t a, size_t b) {
+		if(in_clusters[a].Plane() != in_clusters[b].Plane())
+		  return in_clusters[a].Plane() < in_clusters[b].Plane();
+		return boxes[a].w_min < boxes[b].w_min;
+	      });
+
+    std::vector<std::vector<size_t> > neighbours(in_clusters.size());
+    for(size_t i=0; i<order.size(); ++i) {
+      auto const& b1 = boxes[order[i]];
+      for(size_t j=i+1; j<order.size(); ++j) {
+	auto const& b2 = boxes[order[j]];
+	if(in_clusters[order[i]].Plane() != in_clusters[order[j]].Plane()) break;
+	if(b2.w_min > b1.w_max) break;
+	if(b2.t_min > b1.t_max || b1.t_min > b2.t_max) continue;
+	neighbours[order[i]].push_back(order[j]);
+	neighbours[order[j]].push_back(order[i]);
+      }
+    }
+    for(auto& nb : neighbours) std::sort(nb.begin(),nb.end());
 
+    return neighbours;
   }
 
 }
@@ -52,6 +52,25 @@ namespace cmtool {
     /// A method to obtain book keeper
     const CMergeBookKeeper& GetBookKeeper() const { return _book_keeper; }
 
+    /**
+       Enable the bounding-box broad phase for merging: a pair is passed to the merge
+       algorithm only if the hit bounding boxes of the two clusters, enlarged by margin
+       [cm] on each side, overlap. The result is unchanged for algorithms that never
+       merge clusters farther apart than margin. Separation is always run on all pairs.
+    */
+    void SetBoxPrefilter(bool doit=true, double margin=0)
+    { _box_prefilter = doit; _box_margin = margin; }
+
+    /**
+       Enable incremental statistics for merged clusters: averages, eigenvalues and
+       RMS of a merged cluster are combined from the hit moments of its constituents
+       (see cluster::ClusterMoments) instead of being recomputed with TPrincipal.
+       The hits are still copied into the merged cluster, and the quantities depending
+       on the charge distribution along the axis (profile, start point, polygon) are
+       still recomputed from them, so building a merged cluster stays linear in its hits.
+    */
+    void SetIncrementalMerge(bool doit=true) { _incremental_merge = doit; }
+
   protected:
     
     //
@@ -85,6 +104,10 @@ namespace cmtool {
     void RunSeparate(const std::vector<cluster::ClusterParamsAlg > &in_clusters,
 		     CMergeBookKeeper &book_keeper) const;
 
+    /// For each cluster, sorted indexes of same-plane clusters whose enlarged bounding boxes overlap
+    std::vector<std::vector<size_t> >
+    BoxNeighbours(const std::vector<cluster::ClusterParamsAlg > &in_clusters) const;
+
   protected:
 
     /// Output clusters
@@ -107,6 +130,15 @@ namespace cmtool {
 
     std::vector<cluster::ClusterParamsAlg> _tmp_merged_clusters;
 
+    /// Bounding-box broad phase switch
+    bool _box_prefilter;
+
+    /// Margin added to the bounding boxes [cm]
+    double _box_margin;
+
+    /// Whether merged clusters are built from the moments of their constituents
+    bool _incremental_merge;
+
   };
 }
 
@@ -0,0 +1,450 @@
+/**
+ *  @file   MinSpanTreeAlg.cxx
+ *
+ *  @brief  Splits a 3D cluster at the long edges of the minimum spanning tree of its hits
+ *
+ */
+
+// Framework Includes
+#include "fhiclcpp/ParameterSet.h"
+
+#include "larreco/RecoAlg/Cluster3DAlgs/MinSpanTreeAlg.h"
+
+// std includes
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <utility>
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// implementation follows
+
+namespace {
+
+/**
+ *  @brief Disjoint sets with path halving and union by size
+ */
+class UnionFind
+{
+public:
+    UnionFind(size_t numElements) : m_parent(numElements), m_size(numElements, 1)
+    {
+        std::iota(m_parent.begin(), m_parent.end(), 0);
+    }
+
+    size_t find(size_t element)
+    {
+        while(m_parent[element] != element)
+        {
+            m_parent[element] = m_parent[m_parent[element]];
+            element           = m_parent[element];
+        }
+
+        return element;
+    }
+
+    /// Returns false if the two elements were already in the same set
+    bool unite(size_t left, size_t right)
+    {
+        left  = find(left);
+        right = find(right);
+
+        if (left == right) return false;
+
+        if (m_size[left] < m_size[right]) std::swap(left, right);
+
+        m_parent[right]  = left;
+        m_size[left]    += m_size[right];
+
+        return true;
+    }
+
+    size_t size(size_t element) {return m_size[find(element)];}
+
+private:
+    std::vector<size_t> m_parent;
+    std::vector<size_t> m_size;
+};
+
+/**
+ *  @brief An edge of the neighbour graph
+ */
+struct Edge
+{
+    double m_distance;
+    size_t m_first;
+    size_t m_second;
+
+    bool operator<(const Edge& other) const
+    {
+        if (m_distance != other.m_distance) return m_distance < other.m_distance;
+        if (m_first    != other.m_first)    return m_first    < other.m_first;
+        return m_second < other.m_second;
+    }
+};
+
+using EdgeVec = std::vector<Edge>;
+
+/**
+ *  @brief Points binned in cubic cells, searched in shells of cells of increasing distance
+ */
+class PointGrid
+{
+public:
+    PointGrid(const std::vector<double>& positions, double cellSize) :
+        m_positions(positions), m_cellSize(cellSize)
+    {
+        size_t nPoints = positions.size() / 3;
+
+        for(size_t idx = 0; idx < 3; idx++)
+        {
+            m_minPos[idx] = std::numeric_limits<double>::max();
+
+            double maxPos(-std::numeric_limits<double>::max());
+
+            for(size_t pointIdx = 0; pointIdx < nPoints; pointIdx++)
+            {
+                m_minPos[idx] = std::min(m_minPos[idx], positions[3 * pointIdx + idx]);
+                maxPos        = std::max(maxPos,        positions[3 * pointIdx + idx]);
+            }
+
+            m_nCells[idx] = int64_t((maxPos - m_minPos[idx]) / m_cellSize) + 1;
+        }
+
+        m_cellPoints.reserve(nPoints);
+
+        for(size_t pointIdx = 0; pointIdx < nPoints; pointIdx++)
+            m_cellPoints.emplace_back(cellKey(cellIndex(pointIdx, 0), cellIndex(pointIdx, 1), cellIndex(pointIdx, 2)), pointIdx);
+
+        std::sort(m_cellPoints.begin(), m_cellPoints.end());
+    }
+
+    double cellSize() const {return m_cellSize;}
+
+    /**
+     *  @brief Calls func(squared distance, other point) for the other points in the cells at distance "shell"
+     *         (in cells) from the cell of the given point
+     *
+     *  Once the shells up to n have been visited all the points closer than n times the cell size have been seen.
+     */
+    template <typename Func>
+    void forEachInShell(size_t pointIdx, int64_t shell, Func func) const
+    {
+        int64_t cell[] = {cellIndex(pointIdx, 0), cellIndex(pointIdx, 1), cellIndex(pointIdx, 2)};
+
+        for(int64_t x = std::max(int64_t(0), cell[0] - shell); x <= std::min(m_nCells[0] - 1, cell[0] + shell); x++)
+        {
+            for(int64_t y = std::max(int64_t(0), cell[1] - shell); y <= std::min(m_nCells[1] - 1, cell[1] + shell); y++)
+            {
+                // On the faces of the shell the whole z range is needed, inside only its two ends
+                if (std::abs(x - cell[0]) == shell || std::abs(y - cell[1]) == shell)
+                    visitCells(pointIdx, x, y, cell[2] - shell, cell[2] + shell, func);
+                else
+                {
+                    visitCells(pointIdx, x, y, cell[2] - shell, cell[2] - shell, func);
+                    if (shell > 0) visitCells(pointIdx, x, y, cell[2] + shell, cell[2] + shell, func);
+                }
+            }
+        }
+    }
+
+private:
+    int64_t cellIndex(size_t pointIdx, size_t coord) const
+    {
+        return int64_t((m_positions[3 * pointIdx + coord] - m_minPos[coord]) / m_cellSize);
+    }
+
+    int64_t cellKey(int64_t x, int64_t y, int64_t z) const {return (x * m_nCells[1] + y) * m_nCells[2] + z;}
+
+    /// Visits the cells from firstZ to lastZ at (x,y), which are contiguous in the sorted list
+    template <typename Func>
+    void visitCells(size_t pointIdx, int64_t x, int64_t y, int64_t firstZ, int64_t lastZ, Func& func) const
+    {
+        firstZ = std::max(int64_t(0), firstZ);
+        lastZ  = std::min(m_nCells[2] - 1, lastZ);
+
+        if (firstZ > lastZ) return;
+
+        auto first = std::lower_bound(m_cellPoints.begin(), m_cellPoints.end(), std::make_pair(cellKey(x, y, firstZ), size_t(0)));
+        auto last  = std::lower_bound(first, m_cellPoints.end(), std::make_pair(cellKey(x, y, lastZ) + 1, size_t(0)));
+
+        const double* pos = &m_positions[3 * pointIdx];
+
+        for(auto cellItr = first; cellItr != last; cellItr++)
+        {
+            size_t otherIdx = cellItr->second;
+
+            if (otherIdx == pointIdx) continue;
+
+            const double* otherPos = &m_positions[3 * otherIdx];
+            double        deltaX   = otherPos[0] - pos[0];
+            double        deltaY   = otherPos[1] - pos[1];
+            double        deltaZ   = otherPos[2] - pos[2];
+
+            func(deltaX * deltaX + deltaY * deltaY + deltaZ * deltaZ, otherIdx);
+        }
+    }
+
+    const std::vector<double>&             m_positions;
+    double                                 m_cellSize;
+    double                                 m_minPos[3];
+    int64_t                                m_nCells[3];
+    std::vector<std::pair<int64_t,size_t>> m_cellPoints;  ///< (cell key, point), sorted by cell
+};
+
+/**
+ *  @brief Graph connecting each point to its nearest neighbours closer than maxDist,
+ *         ordered by increasing length
+ */
+void buildNeighbourGraph(const PointGrid& grid, size_t nPoints, size_t numNeighbours, double maxDist, EdgeVec& edges)
+{
+    std::vector<std::pair<double,size_t>> candidates;
+
+    double maxDistSq = maxDist * maxDist;
+
+    edges.clear();
+    edges.reserve(nPoints * numNeighbours);
+
+    for(size_t pointIdx = 0; pointIdx < nPoints; pointIdx++)
+    {
+        candidates.clear();
+
+        auto addCandidate = [&candidates, maxDistSq](double distSq, size_t otherIdx)
+        {
+            if (distSq <= maxDistSq) candidates.emplace_back(distSq, otherIdx);
+        };
+
+        // Grow the search until the nearest ones are certainly found
+        for(int64_t shell = 0; ; shell++)
+        {
+            grid.forEachInShell(pointIdx, shell, addCandidate);
+
+            double reach = double(shell) * grid.cellSize();
+
+            if (reach >= maxDist) break;
+
+            if (candidates.size() >= numNeighbours)
+            {
+                std::nth_element(candidates.begin(), candidates.begin() + numNeighbours - 1, candidates.end());
+
+                if (candidates[numNeighbours - 1].first <= reach * reach) break;
+            }
+        }
+
+        // Keep only the nearest ones
+        if (candidates.size() > numNeighbours)
+        {
+            std::nth_element(candidates.begin(), candidates.begin() + numNeighbours, candidates.end());
+            candidates.resize(numNeighbours);
+        }
+
+        for(const auto& candidate : candidates)
+            edges.push_back({std::sqrt(candidate.first), std::min(pointIdx, candidate.second), std::max(pointIdx, candidate.second)});
+    }
+
+    // Order by length and drop the edges found from both ends
+    std::sort(edges.begin(), edges.end());
+
+    edges.erase(std::unique(edges.begin(), edges.end(),
+                            [](const Edge& left, const Edge& right){return left.m_first == right.m_first && left.m_second == right.m_second;}),
+                edges.end());
+}
+
+} // anonymous namespace
+
+namespace lar_cluster3d {
+
+MinSpanTreeAlg::MinSpanTreeAlg(fhicl::ParameterSet const &pset)
+{
+    reconfigure(pset);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+MinSpanTreeAlg::~MinSpanTreeAlg()
+{
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void MinSpanTreeAlg::reconfigure(fhicl::ParameterSet const &pset)
+{
+    m_numNeighbours     = pset.get<size_t>("NumNeighbours",       8   );
+    m_maxEdgeLength     = pset.get<double>("MaxEdgeLength",      20.  );
+    m_gridCellSize      = pset.get<double>("GridCellSize",        2.  );
+    m_minCutLength      = pset.get<double>("MinCutLength",        3.  );
+    m_edgeLengthFactor  = pset.get<double>("EdgeLengthFactor",   10.  );
+    m_pcaCutFactor      = pset.get<double>("PCACutFactor",        2.  );
+    m_minHitsPerCluster = pset.get<size_t>("MinHitsPerCluster",  50   );
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+size_t MinSpanTreeAlg::SplitCluster(const reco::HitPairListPtr&      hitPairList,
+                                    const reco::PrincipalComponents& pca,
+                                    reco::HitPairListPtrList&        hitPairListPtrList) const
+{
+    // Copy the positions out of the hits so the graph works on contiguous memory
+    std::vector<double> positions;
+
+    positions.reserve(3 * hitPairList.size());
+
+    for(const auto& hit3D : hitPairList)
+    {
+        positions.push_back(hit3D->getPosition()[0]);
+        positions.push_back(hit3D->getPosition()[1]);
+        positions.push_back(hit3D->getPosition()[2]);
+    }
+
+    double transScale = pca.getSvdOK() ? std::sqrt(std::max(0., double(pca.getEigenValues()[2]))) : 0.;
+
+    std::vector<size_t> pieceIndex;
+
+    size_t nPieces = PartitionPoints(positions, transScale, pieceIndex);
+
+    if (nPieces < 2) return nPieces;
+
+    // Hand out the hits, keeping their original order within each piece
+    std::vector<reco::HitPairListPtr> pieces(nPieces);
+
+    size_t hitIdx(0);
+
+    for(const auto& hit3D : hitPairList) pieces[pieceIndex[hitIdx++]].push_back(hit3D);
+
+    for(auto& piece : pieces) hitPairListPtrList.emplace_back(std::move(piece));
+
+    return nPieces;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+size_t MinSpanTreeAlg::PartitionPoints(const std::vector<double>& positions, double transScale, std::vector<size_t>& pieceIndex) const
+{
+    size_t nPoints = positions.size() / 3;
+
+    pieceIndex.assign(nPoints, 0);
+
+    if (nPoints < 2 * m_minHitsPerCluster || nPoints < 2) return 1;
+
+    // Kruskal: take the edges of the neighbour graph in order of increasing length and keep the ones
+    // joining two different trees
+    PointGrid grid(positions, m_gridCellSize);
+    EdgeVec   graphEdges;
+
+    buildNeighbourGraph(grid, nPoints, m_numNeighbours, m_maxEdgeLength, graphEdges);
+
+    UnionFind treeSets(nPoints);
+    EdgeVec   treeEdges;
+    double    sumTreeLength(0.);
+
+    treeEdges.reserve(nPoints);
+
+    for(const auto& edge : graphEdges)
+    {
+        if (!treeSets.unite(edge.m_first, edge.m_second)) continue;
+
+        treeEdges.push_back(edge);
+        sumTreeLength += edge.m_distance;
+
+        if (treeEdges.size() + 1 == nPoints) break;
+    }
+
+    if (treeEdges.empty()) return 1;
+
+    // An edge is a gap if it is long compared with both the typical hit spacing and the cluster width
+    double aveTreeLength = sumTreeLength / double(treeEdges.size());
+    double cutLength     = std::max(m_minCutLength, std::max(m_edgeLengthFactor * aveTreeLength, m_pcaCutFactor * transScale));
+
+    // Dense blobs of hits can leave the nearest neighbour graph in pieces that are closer than the cut,
+    // join them with their shortest outgoing edges (Boruvka) before looking for the gaps
+    while(treeEdges.size() + 1 < nPoints)
+    {
+        std::vector<Edge> bestEdges(nPoints, Edge{std::numeric_limits<double>::max(), 0, 0});
+
+        for(size_t pointIdx = 0; pointIdx < nPoints; pointIdx++)
+        {
+            size_t root = treeSets.find(pointIdx);
+            Edge&  best = bestEdges[root];
+
+            auto checkEdge = [&](double distSq, size_t otherIdx)
+            {
+                if (distSq > cutLength * cutLength || treeSets.find(otherIdx) == root) return;
+
+                Edge edge{std::sqrt(distSq), std::min(pointIdx, otherIdx), std::max(pointIdx, otherIdx)};
+
+                if (edge < best) best = edge;
+            };
+
+            for(int64_t shell = 0; double(shell) * grid.cellSize() < std::min(cutLength, best.m_distance); shell++)
+                grid.forEachInShell(pointIdx, shell, checkEdge);
+        }
+
+        std::sort(bestEdges.begin(), bestEdges.end());
+
+        size_t nJoined(0);
+
+        for(const auto& edge : bestEdges)
+        {
+            if (edge.m_distance == std::numeric_limits<double>::max()) break;
+
+            if (!treeSets.unite(edge.m_first, edge.m_second)) continue;
+
+            treeEdges.push_back(edge);
+            nJoined++;
+        }
+
+        if (nJoined == 0) break;
+    }
+
+    // Keep the tree edges in order of increasing length
+    std::sort(treeEdges.begin(), treeEdges.end());
+
+    UnionFind pieceSets(nPoints);
+
+    for(const auto& edge : treeEdges)
+        if (edge.m_distance <= cutLength) pieceSets.unite(edge.m_first, edge.m_second);
+
+    // Fragments too small to stand alone are put back across their shortest cut edge
+    for(const auto& edge : treeEdges)
+    {
+        if (edge.m_distance <= cutLength) continue;
+
+        if (pieceSets.size(edge.m_first) < m_minHitsPerCluster || pieceSets.size(edge.m_second) < m_minHitsPerCluster)
+            pieceSets.unite(edge.m_first, edge.m_second);
+    }
+
+    // Order the surviving pieces by decreasing size, then by their first point
+    std::vector<std::pair<size_t,size_t>> pieceRoots;   // (size, root)
+    std::vector<size_t>                   rootToPiece(nPoints, std::numeric_limits<size_t>::max());
+
+    for(size_t pointIdx = 0; pointIdx < nPoints; pointIdx++)
+    {
+        size_t root = pieceSets.find(pointIdx);
+
+        if (rootToPiece[root] != std::numeric_limits<size_t>::max() || pieceSets.size(root) < m_minHitsPerCluster) continue;
+
+        rootToPiece[root] = 0;
+        pieceRoots.emplace_back(pieceSets.size(root), root);
+    }
+
+    if (pieceRoots.size() < 2) return 1;
+
+    std::stable_sort(pieceRoots.begin(), pieceRoots.end(),
+                     [](const std::pair<size_t,size_t>& left, const std::pair<size_t,size_t>& right){return left.first > right.first;});
+
+    for(size_t piece = 0; piece < pieceRoots.size(); piece++) rootToPiece[pieceRoots[piece].second] = piece;
+
+    // Fragments with no tree edge to a piece go with the largest one
+    for(size_t pointIdx = 0; pointIdx < nPoints; pointIdx++)
+    {
+        size_t piece = rootToPiece[pieceSets.find(pointIdx)];
+
+        pieceIndex[pointIdx] = piece != std::numeric_limits<size_t>::max() ? piece : 0;
+    }
+
+    return pieceRoots.size();
+}
+
+} // namespace lar_cluster3d
@@ -0,0 +1,91 @@
+/**
+ *  @file   MinSpanTreeAlg.h
+ *
+ *  @brief  Header file to define the interface to the MinSpanTreeAlg
+ *
+ */
+#ifndef MinSpanTreeAlg_h
+#define MinSpanTreeAlg_h
+
+// Framework Includes
+#include "fhiclcpp/ParameterSet.h"
+
+// LArSoft includes
+#include "lardata/RecoObjects/Cluster3D.h"
+
+// std includes
+#include <cstddef>
+#include <vector>
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+namespace lar_cluster3d
+{
+
+/**
+ *  @brief  MinSpanTreeAlg class
+ *
+ *          Splits a 3D cluster at the gaps of the minimum spanning tree of its 3D hits. The tree is
+ *          built with Kruskal's algorithm on a sparse graph connecting each hit to its nearest neighbours,
+ *          which are found with a uniform grid so the cost scales as N log N rather than N^2. Pieces of
+ *          that graph closer than the cut length below are then joined by their shortest edges.
+ *          Tree edges longer than a threshold derived from the typical edge length and from the transverse
+ *          spread of the cluster are cut and each remaining connected piece with enough hits becomes a
+ *          candidate cluster; smaller fragments are put back with a neighbouring piece.
+ */
+class MinSpanTreeAlg
+{
+public:
+    /**
+     *  @brief  Constructor
+     *
+     *  @param  pset
+     */
+    MinSpanTreeAlg(fhicl::ParameterSet const &pset);
+
+    /**
+     *  @brief  Destructor
+     */
+    virtual ~MinSpanTreeAlg();
+
+    /**
+     *  @brief a handler for the case where the algorithm control parameters are to be reset
+     */
+    void reconfigure(fhicl::ParameterSet const &pset);
+
+    /**
+     *  @brief Split a cluster into the pieces of its minimum spanning tree
+     *
+     *  @param hitPairList        the 3D hits of the cluster, all of them are assigned to a piece
+     *  @param pca                the principal components of the cluster, its third eigenvalue sets the cut scale
+     *  @param hitPairListPtrList the output lists of hits, largest first (not filled if there is no split)
+     *
+     *  @return the number of pieces found, 1 if the cluster is not split
+     */
+    size_t SplitCluster(const reco::HitPairListPtr&      hitPairList,
+                        const reco::PrincipalComponents& pca,
+                        reco::HitPairListPtrList&        hitPairListPtrList) const;
+
+    /**
+     *  @brief Partition a set of points at the long edges of their minimum spanning tree
+     *
+     *  @param positions    the point coordinates, three per point
+     *  @param transScale   the transverse size of the point set (e.g. sqrt of the third PCA eigenvalue)
+     *  @param pieceIndex   output: the index of the piece for each point, pieces are ordered by decreasing size
+     *
+     *  @return the number of pieces
+     */
+    size_t PartitionPoints(const std::vector<double>& positions, double transScale, std::vector<size_t>& pieceIndex) const;
+
+private:
+    size_t  m_numNeighbours;     ///< Number of nearest neighbours connected to each hit
+    double  m_maxEdgeLength;     ///< Hits further apart are never connected
+    double  m_gridCellSize;      ///< Size of the cells of the grid used for the neighbour search
+    double  m_minCutLength;      ///< Tree edges shorter than this are never cut
+    double  m_edgeLengthFactor;  ///< Cut edges longer than this times the average tree edge...
+    double  m_pcaCutFactor;      ///< ...and longer than this times the transverse size of the cluster
+    size_t  m_minHitsPerCluster; ///< Minimum number of hits for a piece to become a cluster
+};
+
+} // namespace lar_cluster3d
+#endif
@@ -0,0 +1,343 @@
+/**
+ *  @file   PrincipalComponentsAccumulator.cxx
+ *
+ *  @brief  Running moments of a 3D point set and closed form 3x3 eigen decomposition
+ *
+ */
+
+#include "larreco/RecoAlg/Cluster3DAlgs/PrincipalComponentsAccumulator.h"
+
+// std includes
+#include <cmath>
+#include <algorithm>
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// implementation follows
+
+namespace {
+
+void cross(const double* a, const double* b, double* result)
+{
+    result[0] = a[1] * b[2] - a[2] * b[1];
+    result[1] = a[2] * b[0] - a[0] * b[2];
+    result[2] = a[0] * b[1] - a[1] * b[0];
+}
+
+double dot(const double* a, const double* b)
+{
+    return a[0] * b[0] + a[1] * b[1] + a[2] * b[2];
+}
+
+bool normalize(double* v)
+{
+    double mag = std::sqrt(dot(v, v));
+
+    if (!(mag > 0.)) return false;
+
+    v[0] /= mag;
+    v[1] /= mag;
+    v[2] /= mag;
+
+    return true;
+}
+
+// Any unit vector orthogonal to the unit vector v
+void orthogonal(const double* v, double* result)
+{
+    // Cross with the axis v is least aligned to
+    double axis[3] = {0.,0.,0.};
+
+    if      (std::fabs(v[0]) <= std::fabs(v[1]) && std::fabs(v[0]) <= std::fabs(v[2])) axis[0] = 1.;
+    else if (std::fabs(v[1]) <= std::fabs(v[2]))                                          axis[1] = 1.;
+    else                                                                                  axis[2] = 1.;
+
+    cross(v, axis, result);
+    normalize(result);
+}
+
+// Eigenvector of the symmetric matrix for an isolated eigenvalue
+void isolatedEigenVector(const double m[3][3], double lambda, double* v)
+{
+    double r0[3] = {m[0][0] - lambda, m[0][1],          m[0][2]         };
+    double r1[3] = {m[1][0],          m[1][1] - lambda, m[1][2]         };
+    double r2[3] = {m[2][0],          m[2][1],          m[2][2] - lambda};
+
+    // The eigenvector is orthogonal to all rows: take the best conditioned cross product
+    double c01[3], c02[3], c12[3];
+
+    cross(r0, r1, c01);
+    cross(r0, r2, c02);
+    cross(r1, r2, c12);
+
+    double d01 = dot(c01, c01);
+    double d02 = dot(c02, c02);
+    double d12 = dot(c12, c12);
+
+    const double* best = c01;
+
+    if (d02 > d01 && d02 >= d12) best = c02;
+    else if (d12 > d01)          best = c12;
+
+    std::copy(best, best + 3, v);
+
+    if (!normalize(v))
+    {
+        // Matrix is a multiple of the identity, any direction will do
+        v[0] = 1.;
+        v[1] = 0.;
+        v[2] = 0.;
+    }
+}
+
+} // anonymous namespace
+
+namespace lar_cluster3d {
+
+void PrincipalComponentsAccumulator::Clear()
+{
+    m_numPoints = 0;
+
+    std::fill(m_origin, m_origin + 3, 0.);
+    std::fill(m_sum,    m_sum    + 3, 0.);
+
+    for(auto& row : m_sumProd) std::fill(row, row + 3, 0.);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void PrincipalComponentsAccumulator::Add(double x, double y, double z)
+{
+    if (m_numPoints == 0)
+    {
+        Clear();
+        m_origin[0] = x;
+        m_origin[1] = y;
+        m_origin[2] = z;
+    }
+
+    double pos[] = {x - m_origin[0], y - m_origin[1], z - m_origin[2]};
+
+    for(int i = 0; i < 3; i++)
+    {
+        m_sum[i] += pos[i];
+
+        for(int j = i; j < 3; j++) m_sumProd[i][j] += pos[i] * pos[j];
+    }
+
+    m_numPoints++;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void PrincipalComponentsAccumulator::Remove(double x, double y, double z)
+{
+    if (m_numPoints == 0) return;
+
+    double pos[] = {x - m_origin[0], y - m_origin[1], z - m_origin[2]};
+
+    for(int i = 0; i < 3; i++)
+    {
+        m_sum[i] -= pos[i];
+
+        for(int j = i; j < 3; j++) m_sumProd[i][j] -= pos[i] * pos[j];
+    }
+
+    m_numPoints--;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void PrincipalComponentsAccumulator::Add(const PrincipalComponentsAccumulator& other)
+{
+    if (other.m_numPoints == 0) return;
+
+    if (m_numPoints == 0)
+    {
+        *this = other;
+        return;
+    }
+
+    // Move the other sums to our origin: p - o = (p - o') + s, with s = o' - o
+    double shift[] = {other.m_origin[0] - m_origin[0], other.m_origin[1] - m_origin[1], other.m_origin[2] - m_origin[2]};
+    double n(other.m_numPoints);
+
+    for(int i = 0; i < 3; i++)
+    {
+        for(int j = i; j < 3; j++)
+            m_sumProd[i][j] += other.m_sumProd[i][j] + shift[i] * other.m_sum[j] + shift[j] * other.m_sum[i] + n * shift[i] * shift[j];
+    }
+
+    for(int i = 0; i < 3; i++) m_sum[i] += other.m_sum[i] + n * shift[i];
+
+    m_numPoints += other.m_numPoints;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void PrincipalComponentsAccumulator::GetMean(double mean[3]) const
+{
+    for(int i = 0; i < 3; i++)
+        mean[i] = m_numPoints > 0 ? m_origin[i] + m_sum[i] / double(m_numPoints) : 0.;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void PrincipalComponentsAccumulator::GetCovariance(double covariance[3][3], const double* center) const
+{
+    double n(m_numPoints);
+
+    // Deviations are measured from c, given relative to our origin
+    double c[3];
+
+    if (center) for(int i = 0; i < 3; i++) c[i] = center[i] - m_origin[i];
+    else        for(int i = 0; i < 3; i++) c[i] = n > 0. ? m_sum[i] / n : 0.;
+
+    double scale = n > 1. ? 1. / (n - 1.) : 0.;
+
+    for(int i = 0; i < 3; i++)
+    {
+        for(int j = i; j < 3; j++)
+        {
+            double sum = m_sumProd[i][j] - c[i] * m_sum[j] - c[j] * m_sum[i] + n * c[i] * c[j];
+
+            covariance[i][j] = covariance[j][i] = sum * scale;
+        }
+    }
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+bool PrincipalComponentsAccumulator::Decompose(double eigenValues[3], double eigenVectors[3][3], const double* center) const
+{
+    if (m_numPoints < 2) return false;
+
+    double covariance[3][3];
+
+    GetCovariance(covariance, center);
+
+    SymmetricEigen3x3(covariance, eigenValues, eigenVectors);
+
+    return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void SymmetricEigen3x3(const double m[3][3], double eigenValues[3], double eigenVectors[3][3])
+{
+    // Eigenvalues from the characteristic polynomial, written in terms of B = (A - qI)/p
+    double offDiag = m[0][1] * m[0][1] + m[0][2] * m[0][2] + m[1][2] * m[1][2];
+    double q       = (m[0][0] + m[1][1] + m[2][2]) / 3.;
+    double diag    = (m[0][0] - q) * (m[0][0] - q) + (m[1][1] - q) * (m[1][1] - q) + (m[2][2] - q) * (m[2][2] - q);
+    double p       = std::sqrt((diag + 2. * offDiag) / 6.);
+
+    if (!(p > 0.))
+    {
+        // Multiple of the identity
+        for(int i = 0; i < 3; i++)
+        {
+            eigenValues[i] = std::max(q, 0.);
+
+            for(int j = 0; j < 3; j++) eigenVectors[i][j] = (i == j) ? 1. : 0.;
+        }
+
+        return;
+    }
+
+    double b[3][3];
+
+    for(int i = 0; i < 3; i++)
+        for(int j = 0; j < 3; j++) b[i][j] = (m[i][j] - (i == j ? q : 0.)) / p;
+
+    double detB = b[0][0] * (b[1][1] * b[2][2] - b[1][2] * b[2][1])
+                - b[0][1] * (b[1][0] * b[2][2] - b[1][2] * b[2][0])
+                + b[0][2] * (b[1][0] * b[2][1] - b[1][1] * b[2][0]);
+    double r    = std::min(1., std::max(-1., detB / 2.));
+    double phi  = std::acos(r) / 3.;
+
+    double lambda[3];
+
+    lambda[0] = q + 2. * p * std::cos(phi);
+    lambda[2] = q + 2. * p * std::cos(phi + 2. * M_PI / 3.);
+    lambda[1] = 3. * q - lambda[0] - lambda[2];
+
+    // Start from the vector of the eigenvalue farthest from the other two
+    int isolated = (lambda[0] - lambda[1] >= lambda[1] - lambda[2]) ? 0 : 2;
+
+    double v[3];
+
+    isolatedEigenVector(m, lambda[isolated], v);
+
+    // Now solve the 2x2 problem in the plane orthogonal to it
+    double u[3], w[3];
+
+    orthogonal(v, u);
+    cross(v, u, w);
+
+    double mu[3], mw[3];
+
+    for(int i = 0; i < 3; i++)
+    {
+        mu[i] = m[i][0] * u[0] + m[i][1] * u[1] + m[i][2] * u[2];
+        mw[i] = m[i][0] * w[0] + m[i][1] * w[1] + m[i][2] * w[2];
+    }
+
+    double auu   = dot(u, mu);
+    double aww   = dot(w, mw);
+    double auw   = dot(u, mw);
+    double theta = 0.5 * std::atan2(2. * auw, auu - aww);
+    double cosT  = std::cos(theta);
+    double sinT  = std::sin(theta);
+
+    // Larger and smaller eigenvalue of the 2x2 block
+    double big[3], small[3];
+
+    for(int i = 0; i < 3; i++)
+    {
+        big[i]   =  cosT * u[i] + sinT * w[i];
+        small[i] = -sinT * u[i] + cosT * w[i];
+    }
+
+    double lambdaBig   = cosT * cosT * auu + sinT * sinT * aww + 2. * sinT * cosT * auw;
+    double lambdaSmall = auu + aww - lambdaBig;
+
+    const double* vecs[3];
+
+    if (isolated == 0)
+    {
+        lambda[1] = lambdaBig;
+        lambda[2] = lambdaSmall;
+        vecs[0]   = v;
+        vecs[1]   = big;
+        vecs[2]   = small;
+    }
+    else
+    {
+        lambda[0] = lambdaBig;
+        lambda[1] = lambdaSmall;
+        vecs[0]   = big;
+        vecs[1]   = small;
+        vecs[2]   = v;
+    }
+
+    // Guard the ordering against rounding for nearly degenerate eigenvalues
+    int order[] = {0, 1, 2};
+
+    std::sort(order, order + 3, [&lambda](int left, int right){return lambda[left] > lambda[right];});
+
+    for(int i = 0; i < 3; i++)
+    {
+        eigenValues[i] = std::max(lambda[order[i]], 0.);
+
+        std::copy(vecs[order[i]], vecs[order[i]] + 3, eigenVectors[i]);
+    }
+
+    // Make the basis right handed
+    double check[3];
+
+    cross(eigenVectors[0], eigenVectors[1], check);
+
+    if (dot(check, eigenVectors[2]) < 0.)
+        for(int j = 0; j < 3; j++) eigenVectors[2][j] = -eigenVectors[2][j];
+}
+
+} // namespace lar_cluster3d
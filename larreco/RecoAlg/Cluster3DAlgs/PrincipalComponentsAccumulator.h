@@ -0,0 +1,96 @@
+/**
+ *  @file   PrincipalComponentsAccumulator.h
+ *
+ *  @brief  Running moments of a 3D point set and a closed form eigen decomposition
+ *          of their covariance, used by the principal components analysis of the 3D clustering
+ *
+ */
+#ifndef PrincipalComponentsAccumulator_h
+#define PrincipalComponentsAccumulator_h
+
+// std includes
+#include <cstddef>
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+namespace lar_cluster3d
+{
+
+/**
+ *  @brief  Accumulates the first and second moments of a set of 3D points
+ *
+ *  Points can be added and removed (downdating) one at a time and two accumulators can be combined,
+ *  so that the covariance of a modified point set costs O(1) per changed point instead of a new pass
+ *  over all the points. Moments are kept relative to the first point added to limit the loss of
+ *  precision of the raw sums.
+ */
+class PrincipalComponentsAccumulator
+{
+public:
+    PrincipalComponentsAccumulator() { Clear(); }
+
+    /**
+     *  @brief Removes all points
+     */
+    void Clear();
+
+    /**
+     *  @brief Adds a point
+     */
+    void Add(double x, double y, double z);
+
+    /**
+     *  @brief Removes a point previously added
+     */
+    void Remove(double x, double y, double z);
+
+    /**
+     *  @brief Adds all the points of another accumulator
+     */
+    void Add(const PrincipalComponentsAccumulator& other);
+
+    size_t NumPoints() const {return m_numPoints;}
+
+    /**
+     *  @brief Returns the average position of the points
+     */
+    void GetMean(double mean[3]) const;
+
+    /**
+     *  @brief Returns the sample covariance matrix (normalised to N-1)
+     *
+     *  @param  center  the point the deviations are measured from; the average position if nullptr
+     */
+    void GetCovariance(double covariance[3][3], const double* center = nullptr) const;
+
+    /**
+     *  @brief Eigen decomposition of the covariance matrix
+     *
+     *  Eigenvalues are returned in decreasing order and eigenVectors[i] is the unit vector for
+     *  eigenValues[i]; the three vectors form a right handed basis. The result is the same as
+     *  a singular value decomposition of the covariance up to the sign of the vectors.
+     *
+     *  @return false if fewer than two points are present
+     */
+    bool Decompose(double eigenValues[3], double eigenVectors[3][3], const double* center = nullptr) const;
+
+private:
+    size_t m_numPoints;     ///< number of points
+    double m_origin[3];     ///< reference point (first point added)
+    double m_sum[3];        ///< sum of the coordinates relative to m_origin
+    double m_sumProd[3][3]; ///< sum of products of the coordinates relative to m_origin
+};
+
+/**
+ *  @brief Closed form eigen decomposition of a real symmetric 3x3 matrix
+ *
+ *  The eigenvalues are found from the characteristic polynomial with the trigonometric method,
+ *  the vector of the most isolated eigenvalue from cross products of the rows of (A - lambda I)
+ *  and the other two by solving the 2x2 problem in the orthogonal plane, which keeps the basis
+ *  orthonormal also for (nearly) degenerate eigenvalues.
+ *  Eigenvalues are sorted in decreasing order, negative rounding residuals are set to zero.
+ */
+void SymmetricEigen3x3(const double matrix[3][3], double eigenValues[3], double eigenVectors[3][3]);
+
+} // namespace lar_cluster3d
+#endif
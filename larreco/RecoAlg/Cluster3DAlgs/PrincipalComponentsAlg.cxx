@@ -53,6 +53,7 @@ void PrincipalComponentsAlg::reconfigure(fhicl::ParameterSet const &pset)
     art::ServiceHandle<geo::Geometry>            geometry;
     
     m_parallel = pset.get<double>("ParallelLines", 0.00001);
+    m_useAnalyticPCA = pset.get<bool>("UseAnalyticPCA", false);
     m_geometry = &*geometry;
     m_detector = lar::providerFrom<detinfo::DetectorPropertiesService>();
 }
@@ -172,7 +173,12 @@ void PrincipalComponentsAlg::PCAAnalysis(const reco::HitPairListPtr& hitPairVect
     // First attempt to refine it using only 2D information
     reco::PrincipalComponents pcaLoop = pca;
 
-    PCAAnalysis_2D(hitPairVector, pcaLoop);
+    // The wire geometry of the 2D hits does not change during the iterations
+    Hit2DGeometry geometry;
+    
+    fillHit2DGeometry(hitPairVector, geometry);
+
+    PCAAnalysis_2D(hitPairVector, geometry, pcaLoop, false);
     
     // If valid result then go to next steps
     if (pcaLoop.getSvdOK())
@@ -202,7 +208,7 @@ void PrincipalComponentsAlg::PCAAnalysis(const reco::HitPairListPtr& hitPairVect
             while(maxIterations-- && numRejHits > 0 && totalRejects < maxRejects)
             {
                 // Run the PCA
-                PCAAnalysis_2D(hitPairVector, pcaLoop, true);
+                PCAAnalysis_2D(hitPairVector, geometry, pcaLoop, true);
                 
                 maxRange = sclFctr * 0.5*(3.*sqrt(pcaLoop.getEigenValues()[1])+pcaLoop.getAveHitDoca());
                 
@@ -223,72 +229,107 @@ void PrincipalComponentsAlg::PCAAnalysis(const reco::HitPairListPtr& hitPairVect
 }
     
 void PrincipalComponentsAlg::PCAAnalysis_3D(const reco::HitPairListPtr& hitPairVector, reco::PrincipalComponents& pca, bool skeletonOnly) const
+{
+    PrincipalComponentsAccumulator moments;
+    
+    PCAAnalysis_3D(hitPairVector, pca, moments, skeletonOnly);
+    
+    return;
+}
+    
+void PrincipalComponentsAlg::PCAAnalysis_3D(const reco::HitPairListPtr&     hitPairVector,
+                                            reco::PrincipalComponents&      pca,
+                                            PrincipalComponentsAccumulator& moments,
+                                            bool                            skeletonOnly) const
 {
     // We want to run a PCA on the input TkrVecPoints...
     // The steps are:
-    // 1) do a mean normalization of the input vec points
-    // 2) compute the covariance matrix
-    // 3) run the SVD
+    // 1) accumulate the moments of the input vec points (a single pass)
+    // 2) compute the mean normalized covariance matrix
+    // 3) run the eigen decomposition
     // 4) extract the eigen vectors and values
     // see what happens
-    
-    // Run through the HitPairList and get the mean position of all the hits
-    double meanPos[] = {0.,0.,0.};
-    int    numPairsInt(0);
+    moments.Clear();
     
     for (const auto& hit : hitPairVector)
     {
         if (skeletonOnly && !((hit->getStatusBits() & 0x10000000) == 0x10000000)) continue;
         
-        meanPos[0] += hit->getPosition()[0];
-        meanPos[1] += hit->getPosition()[1];
-        meanPos[2] += hit->getPosition()[2];
-        numPairsInt++;
+        moments.Add(hit->getPosition()[0], hit->getPosition()[1], hit->getPosition()[2]);
     }
     
-    double numPairs = double(numPairsInt);
+    PCAAnalysis_add3DHits(reco::HitPairListPtr(), pca, moments);
     
-    meanPos[0] /= numPairs;
-    meanPos[1] /= numPairs;
-    meanPos[2] /= numPairs;
+    return;
+}
     
-    // Define elements of our covariance matrix
-    double xi2  = 0.;
-    double xiyi = 0.;
-    double xizi = 0.;
-    double yi2  = 0.;
-    double yizi = 0.;
-    double zi2  = 0.;
+void PrincipalComponentsAlg::PCAAnalysis_add3DHits(const reco::HitPairListPtr&     newHitList,
+                                                   reco::PrincipalComponents&      pca,
+                                                   PrincipalComponentsAccumulator& moments) const
+{
+    // Update the moments with the new hits, the decomposition is all that is left to do
+    for (const auto& hit : newHitList)
+        moments.Add(hit->getPosition()[0], hit->getPosition()[1], hit->getPosition()[2]);
     
-    // Back through the hits to build the matrix
-    for (const auto& hit : hitPairVector)
+    int    numPairsInt(moments.NumPoints());
+    double meanPos[3];
+    
+    moments.GetMean(meanPos);
+    
+    double                                  recobEigenVals[3];
+    reco::PrincipalComponents::EigenVectors recobEigenVecs;
+    
+    if (decompose(moments, nullptr, recobEigenVals, recobEigenVecs))
     {
-        if (skeletonOnly && !((hit->getStatusBits() & 0x10000000) == 0x10000000)) continue;
+        // Store away
+        pca = reco::PrincipalComponents(true, numPairsInt, recobEigenVals, recobEigenVecs, meanPos);
+    }
+    else
+    {
+        pca = reco::PrincipalComponents();
+    }
+    
+    return;
+}
+    
+bool PrincipalComponentsAlg::decompose(const PrincipalComponentsAccumulator&    moments,
+                                       const double*                            center,
+                                       double                                   recobEigenVals[3],
+                                       reco::PrincipalComponents::EigenVectors& recobEigenVecs) const
+{
+    recobEigenVecs.clear();
+    
+    if (m_useAnalyticPCA)
+    {
+        double eigenVecs[3][3];
         
-        double x = hit->getPosition()[0] - meanPos[0];
-        double y = hit->getPosition()[1] - meanPos[1];
-        double z = hit->getPosition()[2] - meanPos[2];
+        if (!moments.Decompose(recobEigenVals, eigenVecs, center))
+        {
+            mf::LogDebug("Cluster3D") << "PCA decompose failure, numPairs = " << moments.NumPoints() << std::endl;
+            return false;
+        }
         
-        xi2  += x * x;
-        xiyi += x * y;
-        xizi += x * z;
-        yi2  += y * y;
-        yizi += y * z;
-        zi2  += z * z;
+        for(const auto& eigenVec : eigenVecs) recobEigenVecs.push_back(std::vector<double>(eigenVec, eigenVec + 3));
+        
+        return true;
     }
     
-    // Create the actual matrix
+    double numPairs(moments.NumPoints());
+    
+    if (numPairs < 2.)
+    {
+        mf::LogDebug("Cluster3D") << "PCA decompose failure, numPairs = " << numPairs << std::endl;
+        return false;
+    }
+    
+    // Create the actual matrix, already scaled by number of pairs
+    double   covariance[3][3];
     TMatrixD sigma(3, 3);
     
-    sigma(0,0) = xi2;
-    sigma(0,1) = sigma(1,0) = xiyi;
-    sigma(0,2) = sigma(2,0) = xizi;
-    sigma(1,1) = yi2;
-    sigma(1,2) = sigma(2,1) = yizi;
-    sigma(2,2) = zi2;
+    moments.GetCovariance(covariance, center);
     
-    // Scale by number of pairs
-    sigma *= (1./(numPairs - 1.));
+    for(int i = 0; i < 3; i++)
+        for(int j = 0; j < 3; j++) sigma(i,j) = covariance[i][j];
     
     // Set up the SVD
     TDecompSVD rootSVD(sigma);
@@ -312,130 +353,133 @@ void PrincipalComponentsAlg::PCAAnalysis_3D(const reco::HitPairListPtr& hitPairV
         TVectorD eigenVals = rootSVD.GetSig();
         TMatrixD eigenVecs = rootSVD.GetU();
         
-        // Get the eigen values
-        double recobEigenVals[] = {eigenVals[0], eigenVals[1], eigenVals[2]};
-        
-        // Grab the principle axes
-        reco::PrincipalComponents::EigenVectors recobEigenVecs;
-        std::vector<double> tempVec;
-        
-        // Get the first column vector
-        tempVec.push_back(eigenVecs(0, 0));
-        tempVec.push_back(eigenVecs(1, 0));
-        tempVec.push_back(eigenVecs(2, 0));
-        recobEigenVecs.push_back(tempVec);
-        
-        // Now the second
-        tempVec.clear();
-        tempVec.push_back(eigenVecs(0, 1));
-        tempVec.push_back(eigenVecs(1, 1));
-        tempVec.push_back(eigenVecs(2, 1));
-        recobEigenVecs.push_back(tempVec);
-        
-        // And the last
-        tempVec.clear();
-        tempVec.push_back(eigenVecs(0, 2));
-        tempVec.push_back(eigenVecs(1, 2));
-        tempVec.push_back(eigenVecs(2, 2));
-        recobEigenVecs.push_back(tempVec);
-        
-        // Store away
-        pca = reco::PrincipalComponents(svdOk, numPairsInt, recobEigenVals, recobEigenVecs, meanPos);
+        // Get the eigen values, and the principle axes as the column vectors
+        for(int i = 0; i < 3; i++)
+        {
+            recobEigenVals[i] = eigenVals[i];
+            recobEigenVecs.push_back(std::vector<double>({eigenVecs(0, i), eigenVecs(1, i), eigenVecs(2, i)}));
+        }
     }
-    else
+    
+    return svdOk;
+}
+    
+void PrincipalComponentsAlg::PCAAnalysis_2D(const reco::HitPairListPtr& hitPairVector, reco::PrincipalComponents& pca, bool updateAvePos) const
+{
+    Hit2DGeometry geometry;
+    
+    fillHit2DGeometry(hitPairVector, geometry);
+    
+    PCAAnalysis_2D(hitPairVector, geometry, pca, updateAvePos);
+    
+    return;
+}
+    
+void PrincipalComponentsAlg::fillHit2DGeometry(const reco::HitPairListPtr& hitPairVector, Hit2DGeometry& geometry) const
+{
+    size_t nHits2D(0);
+    
+    for (const auto& hit3D : hitPairVector) nHits2D += hit3D->getHits().size();
+    
+    for (auto* vec : {&geometry.wirePosX, &geometry.wirePosY, &geometry.wirePosZ, &geometry.wireDirX, &geometry.wireDirY, &geometry.wireDirZ})
     {
-        pca = reco::PrincipalComponents();
+        vec->clear();
+        vec->reserve(nHits2D);
+    }
+    
+    for (const auto& hit3D : hitPairVector)
+    {
+        for (const auto& hit : hit3D->getHits())
+        {
+            // Get this wire's geometry object
+            const geo::WireID&  hitID     = hit->getHit().WireID();
+            const geo::WireGeo& wire_geom = m_geometry->WireIDToWireGeo(hitID);
+            
+            // From this, get the parameters of the line for the wire
+            double wirePosArr[3] = {0.,0.,0.};
+            wire_geom.GetCenter(wirePosArr);
+            
+            TVector3 wireDirVec(wire_geom.Direction());
+            
+            // Correct the wire position in x to set to correspond to the drift time
+            geometry.wirePosX.push_back(m_detector->ConvertTicksToX(hit->getHit().PeakTime(), hitID.Plane, hitID.TPC, hitID.Cryostat));
+            geometry.wirePosY.push_back(wirePosArr[1]);
+            geometry.wirePosZ.push_back(wirePosArr[2]);
+            geometry.wireDirX.push_back(wireDirVec[0]);
+            geometry.wireDirY.push_back(wireDirVec[1]);
+            geometry.wireDirZ.push_back(wireDirVec[2]);
+        }
     }
     
     return;
 }
     
-void PrincipalComponentsAlg::PCAAnalysis_2D(const reco::HitPairListPtr& hitPairVector, reco::PrincipalComponents& pca, bool updateAvePos) const
+void PrincipalComponentsAlg::PCAAnalysis_2D(const reco::HitPairListPtr& hitPairVector,
+                                            const Hit2DGeometry&        geometry,
+                                            reco::PrincipalComponents&  pca,
+                                            bool                        updateAvePos) const
 {
     // Once an axis has been found our goal is to refine it by using only the 2D hits
     // We'll get 3D information for each of these by using the axis as a reference and use
     // the point of closest approach as the 3D position
-    
-    // Define elements of our covariance matrix
-    double xi2(0.);
-    double xiyi(0.);
-    double xizi(0.);
-    double yi2(0.);
-    double yizi(0.);
-    double zi2(0.);
+    PrincipalComponentsAccumulator moments;
     
     double   aveHitDoca(0.);
-    TVector3 avePosUpdate(0.,0.,0.);
     int      nHits(0);
     
     // Recover existing line parameters for current cluster
-    const reco::PrincipalComponents& inputPca      = pca;
-    TVector3                         avePosition(inputPca.getAvePosition()[0], inputPca.getAvePosition()[1], inputPca.getAvePosition()[2]);
-    TVector3                         axisDirVec(inputPca.getEigenVectors()[0][0], inputPca.getEigenVectors()[0][1], inputPca.getEigenVectors()[0][2]);
+    const reco::PrincipalComponents& inputPca    = pca;
+    double                           avePosition[] = {inputPca.getAvePosition()[0], inputPca.getAvePosition()[1], inputPca.getAvePosition()[2]};
+    double                           axisDirVec[]  = {inputPca.getEigenVectors()[0][0], inputPca.getEigenVectors()[0][1], inputPca.getEigenVectors()[0][2]};
     
-    // We double loop here so we can use this method for both the first time through
-    // and a second time through where we re-calculate the mean position
-    // So, we need to keep track of the poca which we do with a double vector
-    std::vector<TVector3> hitPosVec;
+    // Index of the current 2D hit in the geometry arrays
+    size_t hitIdx(0);
     
     // Outer loop over 3D hits
     for (const auto& hit3D : hitPairVector)
     {
+        size_t nextHit3DIdx = hitIdx + hit3D->getHits().size();
+        
         // Inner loop over 2D hits
         for (const auto& hit : hit3D->getHits())
         {
+            size_t idx = hitIdx++;
+            
             // Step one is to set up to determine the point of closest approach of this 2D hit to
             // the cluster's current axis.
-            // Get this wire's geometry object
-            const geo::WireID&  hitID     = hit->getHit().WireID();
-            const geo::WireGeo& wire_geom = m_geometry->WireIDToWireGeo(hitID);
+            double wirePos[]    = {geometry.wirePosX[idx], geometry.wirePosY[idx], geometry.wirePosZ[idx]};
+            double wireDirVec[] = {geometry.wireDirX[idx], geometry.wireDirY[idx], geometry.wireDirZ[idx]};
             
-            // From this, get the parameters of the line for the wire
-            double wirePosArr[3] = {0.,0.,0.};
-            wire_geom.GetCenter(wirePosArr);
-
-            TVector3 wireCenter(wirePosArr[0], wirePosArr[1], wirePosArr[2]);
-            TVector3 wireDirVec(wire_geom.Direction());
+            // Compute the wire plane normal for this view, (1,0,0) x wireDir
+            // This gives a normal vector in +z for a Y wire
+            double planeNormal[] = {0., -wireDirVec[2], wireDirVec[1]};
             
-            // Correct the wire position in x to set to correspond to the drift time
-            double hitPeak(hit->getHit().PeakTime());
-            
-            TVector3 wirePos(m_detector->ConvertTicksToX(hitPeak, hitID.Plane, hitID.TPC, hitID.Cryostat), wireCenter[1], wireCenter[2]);
-            
-            // Compute the wire plane normal for this view
-            TVector3 xAxis(1.,0.,0.);
-            TVector3 planeNormal = xAxis.Cross(wireDirVec);   // This gives a normal vector in +z for a Y wire
-
-            double docaInPlane(wirePos[0] - avePosition[0]);
             double arcLenToPlane(0.);
-            double cosAxisToPlaneNormal = axisDirVec.Dot(planeNormal);
+            double cosAxisToPlaneNormal = axisDirVec[0] * planeNormal[0] + axisDirVec[1] * planeNormal[1] + axisDirVec[2] * planeNormal[2];
             
-            TVector3 axisPlaneIntersection = wirePos;
-            TVector3 hitPosTVec            = wirePos;
+            double hitPosTVec[] = {wirePos[0], wirePos[1], wirePos[2]};
             
             if (fabs(cosAxisToPlaneNormal) > 0.)
             {
-                TVector3 deltaPos = wirePos - avePosition;
+                double deltaPos[] = {wirePos[0] - avePosition[0], wirePos[1] - avePosition[1], wirePos[2] - avePosition[2]};
                 
-                arcLenToPlane         = deltaPos.Dot(planeNormal) / cosAxisToPlaneNormal;
-                axisPlaneIntersection = avePosition + arcLenToPlane * axisDirVec;
-                docaInPlane           = wirePos[0] - axisPlaneIntersection[0];
+                arcLenToPlane = (deltaPos[0] * planeNormal[0] + deltaPos[1] * planeNormal[1] + deltaPos[2] * planeNormal[2]) / cosAxisToPlaneNormal;
                 
-                TVector3 axisToInter  = axisPlaneIntersection - wirePos;
-                double   arcLenToDoca = axisToInter.Dot(wireDirVec);
+                double arcLenToDoca(0.);
                 
-                hitPosTVec += arcLenToDoca * wireDirVec;
+                for(int i = 0; i < 3; i++) arcLenToDoca += (avePosition[i] + arcLenToPlane * axisDirVec[i] - wirePos[i]) * wireDirVec[i];
+                for(int i = 0; i < 3; i++) hitPosTVec[i] += arcLenToDoca * wireDirVec[i];
             }
-
+            
             // Get a vector from the wire position to our cluster's current average position
-            TVector3 wVec = avePosition - wirePos;
+            double wVec[] = {avePosition[0] - wirePos[0], avePosition[1] - wirePos[1], avePosition[2] - wirePos[2]};
             
             // Get the products we need to compute the arc lengths to the distance of closest approach
-            double a(axisDirVec.Dot(axisDirVec));
-            double b(axisDirVec.Dot(wireDirVec));
-            double c(wireDirVec.Dot(wireDirVec));
-            double d(axisDirVec.Dot(wVec));
-            double e(wireDirVec.Dot(wVec));
+            double a(axisDirVec[0] * axisDirVec[0] + axisDirVec[1] * axisDirVec[1] + axisDirVec[2] * axisDirVec[2]);
+            double b(axisDirVec[0] * wireDirVec[0] + axisDirVec[1] * wireDirVec[1] + axisDirVec[2] * wireDirVec[2]);
+            double c(wireDirVec[0] * wireDirVec[0] + wireDirVec[1] * wireDirVec[1] + wireDirVec[2] * wireDirVec[2]);
+            double d(axisDirVec[0] * wVec[0]       + axisDirVec[1] * wVec[1]       + axisDirVec[2] * wVec[2]);
+            double e(wireDirVec[0] * wVec[0]       + wireDirVec[1] * wVec[1]       + wireDirVec[2] * wVec[2]);
             
             double den(a*c - b*b);
             double arcLen1(0.);
@@ -454,36 +498,19 @@ void PrincipalComponentsAlg::PCAAnalysis_2D(const reco::HitPairListPtr& hitPairV
             }
             
             // Now get the hit position we'll use for the pca analysis
-            //double hitPos[]  = {wirePos[0]     + arcLen2 * wireDirVec[0],
-            //                    wirePos[1]     + arcLen2 * wireDirVec[1],
-            //                    wirePos[2]     + arcLen2 * wireDirVec[2]};
-            //double axisPos[] = {avePosition[0] + arcLen1 * axisDirVec[0],
-            //                    avePosition[1] + arcLen1 * axisDirVec[1],
-            //                    avePosition[2] + arcLen1 * axisDirVec[2]};
-            TVector3 hitPos  = wirePos + arcLen2 * wireDirVec;
-            TVector3 axisPos = avePosition + arcLen1 * axisDirVec;
-            double   deltaX  = hitPos[0] - axisPos[0];
-            double   deltaY  = hitPos[1] - axisPos[1];
-            double   deltaZ  = hitPos[2] - axisPos[2];
-            double   doca2   = deltaX*deltaX + deltaY*deltaY + deltaZ*deltaZ;
-            double   doca    = sqrt(doca2);
+            double doca2(0.);
+            
+            for(int i = 0; i < 3; i++)
+            {
+                double delta = (wirePos[i] + arcLen2 * wireDirVec[i]) - (avePosition[i] + arcLen1 * axisDirVec[i]);
+                
+                doca2 += delta * delta;
+            }
+            
+            double docaInPlane = sqrt(doca2);
             
-            docaInPlane = doca;
-
             aveHitDoca += fabs(docaInPlane);
-
-            //TVector3 deltaPos  = hitPos - hitPosTVec;
-            //double   deltaDoca = doca - docaInPlane;
             
-            //if (fabs(deltaPos[0]) > 1. || fabs(deltaPos[1]) > 1. || fabs(deltaPos[2]) > 1. || fabs(deltaDoca) > 2.)
-            //{
-            //    std::cout << "**************************************************************************************" << std::endl;
-            //    std::cout << "Diff in doca: " << deltaPos[0] << "," << deltaPos[1] << "," << deltaPos[2] << ", deltaDoca: " << deltaDoca << std::endl;
-            //    std::cout << "-- HitPosTVec: " << hitPosTVec[0] << "," << hitPosTVec[1] << "," << hitPosTVec[2] << std::endl;
-            //    std::cout << "-- hitPos:     " << hitPos[0] << "," << hitPos[1] << "," << hitPos[2] << std::endl;
-            //    std::cout << "-- WirePos:    " << wirePos[0] << "," << wirePos[1] << "," << wirePos[2] << std::endl;
-            //}
-
             // Set the hit's doca and arclen
             hit->setDocaToAxis(fabs(docaInPlane));
             hit->setArcLenToPoca(arcLenToPlane);
@@ -494,115 +521,29 @@ void PrincipalComponentsAlg::PCAAnalysis_2D(const reco::HitPairListPtr& hitPairV
             {
                 continue;
             }
-
-            //hitPosTVec = hitPos;
             
-            avePosUpdate += hitPosTVec;
-            
-            hitPosVec.push_back(hitPosTVec);
+            moments.Add(hitPosTVec[0], hitPosTVec[1], hitPosTVec[2]);
             
             nHits++;
         }
+        
+        hitIdx = nextHit3DIdx;
     }
     
-    // Get updated average position
-    avePosUpdate[0] /= double(nHits);
-    avePosUpdate[1] /= double(nHits);
-    avePosUpdate[2] /= double(nHits);
-    
     // Get the average hit doca
     aveHitDoca /= double(nHits);
     
-    if (updateAvePos)
-    {
-        avePosition = avePosUpdate;
-    }
-    
-    // Now loop through the hits and build out the covariance matrix
-    for(auto& hitPos : hitPosVec)
-    {
-        // And increment the values in the covariance matrix
-        double x = hitPos[0] - avePosition[0];
-        double y = hitPos[1] - avePosition[1];
-        double z = hitPos[2] - avePosition[2];
-            
-        xi2  += x * x;
-        xiyi += x * y;
-        xizi += x * z;
-        yi2  += y * y;
-        yizi += y * z;
-        zi2  += z * z;
-    }
-    
-    // Accumulation done, now do the actual work
-               
-    // Create the actual matrix
-    TMatrixD sigma(3, 3);
-               
-    sigma(0,0) = xi2;
-    sigma(0,1) = sigma(1,0) = xiyi;
-    sigma(0,2) = sigma(2,0) = xizi;
-    sigma(1,1) = yi2;
-    sigma(1,2) = sigma(2,1) = yizi;
-    sigma(2,2) = zi2;
-               
-    // Scale by number of pairs
-    sigma *= (1./(nHits - 1.));
-               
-    // Set up the SVD
-    TDecompSVD rootSVD(sigma);
-               
-    // run the decomposition
-    bool svdOk(false);
+    // Get updated average position
+    if (updateAvePos) moments.GetMean(avePosition);
     
-    try
-    {
-        svdOk = rootSVD.Decompose();
-    }
-    catch(...)
-    {
-        svdOk = false;
-        mf::LogDebug("Cluster3D") << "PCA decompose failure, nhits = " << nHits << std::endl;
-    }
+    // The covariance is computed with respect to the (possibly updated) average position
+    double                                  recobEigenVals[3];
+    reco::PrincipalComponents::EigenVectors recobEigenVecs;
     
-    if (svdOk)
+    if (decompose(moments, avePosition, recobEigenVals, recobEigenVecs))
     {
-        // Extract results
-        TVectorD eigenVals = rootSVD.GetSig();
-        TMatrixD eigenVecs = rootSVD.GetU();
-                   
-        // Get the eigen values
-        double recobEigenVals[] = {eigenVals[0], eigenVals[1], eigenVals[2]};
-                   
-        // Grab the principle axes
-        reco::PrincipalComponents::EigenVectors recobEigenVecs;
-        std::vector<double> tempVec;
-                   
-        // Get the first column vector
-        tempVec.push_back(eigenVecs(0, 0));
-        tempVec.push_back(eigenVecs(1, 0));
-        tempVec.push_back(eigenVecs(2, 0));
-        recobEigenVecs.push_back(tempVec);
-                   
-        // Now the second
-        tempVec.clear();
-        tempVec.push_back(eigenVecs(0, 1));
-        tempVec.push_back(eigenVecs(1, 1));
-        tempVec.push_back(eigenVecs(2, 1));
-        recobEigenVecs.push_back(tempVec);
-                   
-        // And the last
-        tempVec.clear();
-        tempVec.push_back(eigenVecs(0, 2));
-        tempVec.push_back(eigenVecs(1, 2));
-        tempVec.push_back(eigenVecs(2, 2));
-        recobEigenVecs.push_back(tempVec);
-        
-        // Save the average position
-        double avePosToSave[] = {avePosition[0],avePosition[1],avePosition[2]};
-        
         // Store away
-        pca = reco::PrincipalComponents(svdOk, nHits, recobEigenVals, recobEigenVecs, avePosToSave, aveHitDoca);
+        pca = reco::PrincipalComponents(true, nHits, recobEigenVals, recobEigenVecs, avePosition, aveHitDoca);
     }
     else
     {
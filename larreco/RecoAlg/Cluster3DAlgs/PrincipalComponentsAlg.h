@@ -15,6 +15,7 @@
 #include "larcore/Geometry/Geometry.h"
 #include "lardata/DetectorInfoServices/DetectorPropertiesService.h"
 #include "lardata/RecoObjects/Cluster3D.h"
+#include "larreco/RecoAlg/Cluster3DAlgs/PrincipalComponentsAccumulator.h"
 
 // Root
 #include "TVector3.h"
@@ -24,6 +25,7 @@
 #include <functional>
 #include <iostream>
 #include <memory>
+#include <vector>
 
 
 //------------------------------------------------------------------------------------------------------------------------------------------
@@ -61,6 +63,18 @@ public:
     
     void PCAAnalysis_3D(const reco::HitPairListPtr& hitPairList, reco::PrincipalComponents& pca, bool skeletonOnly = false)               const;
     
+    /**
+     *  @brief Run the 3D analysis and also return the moments of the hits used, for later updates
+     */
+    void PCAAnalysis_3D(const reco::HitPairListPtr& hitPairList, reco::PrincipalComponents& pca,
+                        PrincipalComponentsAccumulator& moments, bool skeletonOnly = false)                                              const;
+    
+    /**
+     *  @brief Update a 3D analysis by adding hits to the moments of a previous PCAAnalysis_3D call
+     */
+    void PCAAnalysis_add3DHits(const reco::HitPairListPtr& newHitList, reco::PrincipalComponents& pca,
+                               PrincipalComponentsAccumulator& moments)                                                                 const;
+    
     void PCAAnalysis_2D(const reco::HitPairListPtr& hitPairVector, reco::PrincipalComponents& pca, bool updateAvePos = false)             const;
     
     void PCAAnalysis_calc3DDocas(const reco::HitPairListPtr& hitPairVector, const reco::PrincipalComponents& pca)                         const;
@@ -74,6 +88,29 @@ public:
     
 
 private:
+    /**
+     *  @brief Wire geometry of the 2D hits of a cluster, in the order they are visited
+     *
+     *  Positions are corrected in x for the hit drift time. The 2D refinement loop revisits the same
+     *  hits several times, so the geometry service is only queried once per analysis.
+     */
+    struct Hit2DGeometry
+    {
+        std::vector<double> wirePosX, wirePosY, wirePosZ;
+        std::vector<double> wireDirX, wireDirY, wireDirZ;
+    };
+    
+    void fillHit2DGeometry(const reco::HitPairListPtr& hitPairVector, Hit2DGeometry& geometry)                                           const;
+    
+    void PCAAnalysis_2D(const reco::HitPairListPtr& hitPairVector, const Hit2DGeometry& geometry,
+                        reco::PrincipalComponents& pca, bool updateAvePos)                                                                const;
+    
+    /**
+     *  @brief Eigen decomposition of the covariance of the accumulated points (deviations from center, or from the mean)
+     */
+    bool decompose(const PrincipalComponentsAccumulator& moments, const double* center,
+                   double eigenValues[3], reco::PrincipalComponents::EigenVectors& eigenVectors)                                        const;
+    
     /**
      *  @brief This is used to get the poca, doca and arclen along cluster axis to 2D hit
      */
@@ -86,6 +123,7 @@ private:
                             double&                   doca);
     
     double                                 m_parallel;  ///< means lines are parallel
+    bool                                   m_useAnalyticPCA; ///< closed form eigen decomposition instead of TDecompSVD
     
     geo::Geometry*                         m_geometry;  // pointer to the Geometry service
     const detinfo::DetectorProperties*    m_detector;  // Pointer to the detector properties
@@ -0,0 +1,197 @@
+/** ****************************************************************************
+ * @file   ClusterMoments.cxx
+ * @brief  Mergeable hit statistics of a 2D cluster - implementation
+ * @see    ClusterMoments.h
+ *
+ * ****************************************************************************/
+
+// our header
+#include "larreco/RecoAlg/ClusterRecoUtil/ClusterMoments.h"
+
+// C/C++ standard library
+#include <cmath> // std::sqrt()
+#include <algorithm> // std::sort(), std::lower_bound()
+
+
+namespace {
+
+  /// Combines the mean and sum of squared deviations of two samples
+  void CombineMoments(
+    double nA, double& meanA, double& m2A,
+    double nB, double meanB, double m2B
+  ) {
+    double const n = nA + nB;
+    double const delta = meanB - meanA;
+    meanA += delta * nB / n;
+    m2A += m2B + delta * delta * nA * nB / n;
+  } // CombineMoments()
+
+} // local namespace
+
+
+namespace cluster {
+
+  //----------------------------------------------------------------------------
+  void ClusterMoments::Clear() {
+    fN = 0;
+    fSumQ = fSumADC = fSumQW = fSumQT = 0.;
+    fMeanW = fMeanT = fMeanQ = fMeanADC = 0.;
+    fM2W = fM2T = fM2WT = fM2Q = fM2ADC = 0.;
+    fWireHits.clear();
+  } // ClusterMoments::Clear()
+
+
+  //----------------------------------------------------------------------------
+  void ClusterMoments::Add(util::PxHit const& hit) {
+    AddHitMoments(hit);
+
+    auto iWire = std::lower_bound(fWireHits.begin(), fWireHits.end(),
+      std::make_pair(hit.w, 0U));
+    if ((iWire != fWireHits.end()) && (iWire->first == hit.w)) ++(iWire->second);
+    else fWireHits.emplace(iWire, hit.w, 1U);
+
+  } // ClusterMoments::Add()
+
+
+  //----------------------------------------------------------------------------
+  void ClusterMoments::AddHitMoments(util::PxHit const& hit) {
+    ++fN;
+    double const n = fN;
+
+    fSumQ += hit.charge;
+    fSumADC += hit.sumADC;
+    fSumQW += hit.w * hit.charge;
+    fSumQT += hit.t * hit.charge;
+
+    // one-pass (Welford) update of averages and deviations
+    double const dw = hit.w - fMeanW;
+    double const dt = hit.t - fMeanT;
+    fMeanW += dw / n;
+    fMeanT += dt / n;
+    fM2W += dw * (hit.w - fMeanW);
+    fM2T += dt * (hit.t - fMeanT);
+    fM2WT += dw * (hit.t - fMeanT);
+
+    double const dq = hit.charge - fMeanQ;
+    fMeanQ += dq / n;
+    fM2Q += dq * (hit.charge - fMeanQ);
+
+    double const da = hit.sumADC - fMeanADC;
+    fMeanADC += da / n;
+    fM2ADC += da * (hit.sumADC - fMeanADC);
+
+  } // ClusterMoments::AddHitMoments()
+
+
+  //----------------------------------------------------------------------------
+  void ClusterMoments::Fill(std::vector<util::PxHit> const& hits) {
+    Clear();
+
+    // the wires are collected and sorted in one go
+    std::vector<double> wires;
+    wires.reserve(hits.size());
+    for (auto const& hit: hits) {
+      wires.push_back(hit.w);
+      AddHitMoments(hit);
+    } // for
+
+    std::sort(wires.begin(), wires.end());
+    for (double w: wires) {
+      if (!fWireHits.empty() && (fWireHits.back().first == w))
+        ++(fWireHits.back().second);
+      else fWireHits.emplace_back(w, 1U);
+    } // for
+
+  } // ClusterMoments::Fill()
+
+
+  //----------------------------------------------------------------------------
+  void ClusterMoments::Merge(ClusterMoments const& other) {
+    if (other.fN == 0) return;
+    if (fN == 0) {
+      *this = other;
+      return;
+    }
+
+    double const nA = fN, nB = other.fN;
+    double const n = nA + nB;
+
+    // the covariance term needs the deviations before the update of the means
+    fM2WT += other.fM2WT
+      + (other.fMeanW - fMeanW) * (other.fMeanT - fMeanT) * nA * nB / n;
+    CombineMoments(nA, fMeanW, fM2W, nB, other.fMeanW, other.fM2W);
+    CombineMoments(nA, fMeanT, fM2T, nB, other.fMeanT, other.fM2T);
+    CombineMoments(nA, fMeanQ, fM2Q, nB, other.fMeanQ, other.fM2Q);
+    CombineMoments(nA, fMeanADC, fM2ADC, nB, other.fMeanADC, other.fM2ADC);
+
+    fN += other.fN;
+    fSumQ += other.fSumQ;
+    fSumADC += other.fSumADC;
+    fSumQW += other.fSumQW;
+    fSumQT += other.fSumQT;
+
+    // merge of the two sorted wire lists
+    std::vector<std::pair<double, unsigned int>> wireHits;
+    wireHits.reserve(fWireHits.size() + other.fWireHits.size());
+    auto iA = fWireHits.cbegin(), iB = other.fWireHits.cbegin();
+    auto const endA = fWireHits.cend(), endB = other.fWireHits.cend();
+    while ((iA != endA) || (iB != endB)) {
+      if ((iB == endB) || ((iA != endA) && (iA->first < iB->first)))
+        wireHits.push_back(*(iA++));
+      else if ((iA == endA) || (iB->first < iA->first))
+        wireHits.push_back(*(iB++));
+      else {
+        wireHits.emplace_back(iA->first, iA->second + iB->second);
+        ++iA;
+        ++iB;
+      }
+    } // while
+    fWireHits = std::move(wireHits);
+
+  } // ClusterMoments::Merge()
+
+
+  //----------------------------------------------------------------------------
+  double ClusterMoments::RMSCharge() const
+    { return fN? std::sqrt(fM2Q / fN): 0.; }
+
+  double ClusterMoments::RMSADC() const
+    { return fN? std::sqrt(fM2ADC / fN): 0.; }
+
+  double ClusterMoments::RMSW() const
+    { return fN? std::sqrt(fM2W / fN): 0.; }
+
+  double ClusterMoments::RMST() const
+    { return fN? std::sqrt(fM2T / fN): 0.; }
+
+  double ClusterMoments::ChargeWeightedW() const
+    { return (fSumQ != 0.)? fSumQW / fSumQ: fMeanW; }
+
+  double ClusterMoments::ChargeWeightedT() const
+    { return (fSumQ != 0.)? fSumQT / fSumQ: fMeanT; }
+
+
+  //----------------------------------------------------------------------------
+  std::size_t ClusterMoments::MultiHitWires() const {
+    std::size_t n = 0;
+    for (auto const& wire: fWireHits) if (wire.second > 1) ++n;
+    return n;
+  } // ClusterMoments::MultiHitWires()
+
+
+  //----------------------------------------------------------------------------
+  std::pair<double, double> ClusterMoments::EigenValues() const {
+    // eigenvalues of the symmetric matrix [ [ a, b ], [ b, c ] ];
+    // the normalisation (N) cancels in the ratio to the trace
+    double const a = fM2W, b = fM2WT, c = fM2T;
+    double const trace = a + c;
+    if (trace <= 0.) return { 0., 0. };
+    double const halfDiff = (a - c) / 2.;
+    double const root = std::sqrt(halfDiff * halfDiff + b * b);
+    double const l1 = trace / 2. + root;
+    double const l2 = trace / 2. - root;
+    return { l1 / trace, l2 / trace };
+  } // ClusterMoments::EigenValues()
+
+
+} // namespace cluster
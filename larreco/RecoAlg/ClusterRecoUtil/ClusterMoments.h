@@ -0,0 +1,109 @@
+/** ****************************************************************************
+ * @file   ClusterMoments.h
+ * @brief  Mergeable hit statistics of a 2D cluster
+ * @see    ClusterMoments.cxx, ClusterParamsAlg.h
+ *
+ * ****************************************************************************/
+
+#ifndef CLUSTERMOMENTS_H
+#define CLUSTERMOMENTS_H
+
+// C/C++ standard library
+#include <vector>
+#include <utility> // std::pair<>
+#include <cstddef> // std::size_t
+
+// LArSoft libraries
+#include "lardata/Utilities/PxUtils.h"
+
+
+namespace cluster {
+
+  /**
+   * @brief Means and (co)variances of the hit coordinates and charges of a cluster
+   *
+   * The moments of the union of two clusters are obtained by combining the
+   * moments of the two clusters, without looping over their hits again.
+   * Second moments are kept about the mean (pairwise update formulae), which
+   * is numerically safer than raw sums of squares.
+   * They provide the quantities of ClusterParamsAlg::GetAverages() and the
+   * hit RMS of ClusterParamsAlg::GetRoughAxis().
+   *
+   * The number of hits on each wire is kept too (sorted by wire), so that
+   * merging costs as much as the number of wires rather than hits.
+   */
+  class ClusterMoments {
+      public:
+
+    ClusterMoments() { Clear(); }
+
+    /// Removes all the hits
+    void Clear();
+
+    /// Adds a single hit
+    void Add(util::PxHit const& hit);
+
+    /// Replaces the content with the moments of the specified hits
+    void Fill(std::vector<util::PxHit> const& hits);
+
+    /// Adds the moments of another set of hits (disjoint from this one)
+    void Merge(ClusterMoments const& other);
+
+    /// Number of hits
+    std::size_t N() const { return fN; }
+
+    /// @{
+    /// @name Charge and summed ADC
+    double SumCharge() const { return fSumQ; }
+    double MeanCharge() const { return fMeanQ; }
+    double RMSCharge() const;
+    double SumADC() const { return fSumADC; }
+    double MeanADC() const { return fMeanADC; }
+    double RMSADC() const;
+    /// @}
+
+    /// @{
+    /// @name Position (w = wire coordinate, t = time coordinate)
+    double MeanW() const { return fMeanW; }
+    double MeanT() const { return fMeanT; }
+    double RMSW() const;
+    double RMST() const;
+    double ChargeWeightedW() const;
+    double ChargeWeightedT() const;
+    /// @}
+
+    /// Number of wires with at least one hit
+    std::size_t NWires() const { return fWireHits.size(); }
+
+    /// Number of wires with more than one hit
+    std::size_t MultiHitWires() const;
+
+    /**
+     * @brief Eigenvalues of the (w, t) covariance, normalised to their sum
+     * @return principal and secondary eigenvalue
+     *
+     * This is what TPrincipal returns for the same hits without the "N"
+     * (normalisation to the variances) option.
+     */
+    std::pair<double, double> EigenValues() const;
+
+      private:
+    std::size_t fN; ///< number of hits
+    double fSumQ, fSumADC, fSumQW, fSumQT; ///< plain sums
+    double fMeanW, fMeanT, fMeanQ, fMeanADC; ///< averages
+    /// sums of squared (or product of) deviations from the averages
+    double fM2W, fM2T, fM2WT, fM2Q, fM2ADC;
+
+    /// Number of hits on each wire (by wire coordinate), sorted by wire
+    std::vector<std::pair<double, unsigned int>> fWireHits;
+
+    /// Adds a hit to all the moments except the wire counts
+    void AddHitMoments(util::PxHit const& hit);
+
+
+  }; // class ClusterMoments
+
+} // namespace cluster
+
+
+#endif // CLUSTERMOMENTS_H
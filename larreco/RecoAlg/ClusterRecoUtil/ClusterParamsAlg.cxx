@@ -28,6 +28,7 @@ namespace cluster{
     fGSer=nullptr;
     enableFANN = false;
     verbose=true;
+    fUseMoments = false;
     Initialize();
   }
 
@@ -46,6 +47,7 @@ namespace cluster{
     fGSer=nullptr;
     enableFANN = false;
     verbose=true;
+    fUseMoments = false;
     SetHits(inhitlist);
   }
 
@@ -115,6 +117,46 @@ namespace cluster{
 //     
 //   }
 
+  int ClusterParamsAlg::MergeHits
+    (const std::vector<const ClusterParamsAlg*> &clusters)
+  {
+    size_t nHits = 0;
+    for(auto const* cluster : clusters) nHits += cluster->GetNHits();
+
+    std::vector<util::PxHit> hits;
+    hits.reserve(nHits);
+    for(auto const* cluster : clusters)
+      hits.insert(hits.end(),
+        cluster->GetHitVector().begin(), cluster->GetHitVector().end());
+
+    ClusterMoments moments;
+    if(fUseMoments) {
+      for(auto const* cluster : clusters) {
+        if(cluster->fHasMoments) moments.Merge(cluster->fMoments);
+        else {
+          ClusterMoments clusterMoments;
+          clusterMoments.Fill(cluster->GetHitVector());
+          moments.Merge(clusterMoments);
+        }
+      } // for clusters
+    }
+
+    int res = SetHits(hits);
+    if(fUseMoments && !fHitVector.empty()) {
+      fMoments = std::move(moments);
+      fHasMoments = true;
+    }
+    return res;
+  }
+
+  const ClusterMoments& ClusterParamsAlg::GetMoments() {
+    if(!fHasMoments) {
+      fMoments.Fill(fHitVector);
+      fHasMoments = true;
+    }
+    return fMoments;
+  }
+
   void ClusterParamsAlg::SetPlane(int p) {
     fPlane = p;
     for(auto& h : fHitVector) h.plane = p;
@@ -225,6 +267,9 @@ namespace cluster{
 
     fHitVector.clear();
 
+    fHasMoments = false;
+    fMoments.Clear();
+
     fParams.Clear();
     
     // Initialize the neural network:
@@ -284,6 +329,33 @@ namespace cluster{
     TStopwatch localWatch;
     localWatch.Start();
 
+    if(fUseMoments) {
+      const ClusterMoments& moments = GetMoments();
+
+      fParams.N_Hits = moments.N();
+      fParams.sum_charge = moments.SumCharge();
+      fParams.mean_charge = moments.MeanCharge();
+      fParams.rms_charge = moments.RMSCharge();
+      fParams.sum_ADC = moments.SumADC();
+      fParams.mean_ADC = moments.MeanADC();
+      fParams.rms_ADC = moments.RMSADC();
+      fParams.N_Wires = moments.NWires();
+      fParams.multi_hit_wires = moments.MultiHitWires();
+      fParams.mean_x = moments.MeanW();
+      fParams.mean_y = moments.MeanT();
+      fParams.charge_wgt_x = moments.ChargeWeightedW();
+      fParams.charge_wgt_y = moments.ChargeWeightedT();
+
+      std::pair<double, double> eigenvalues = moments.EigenValues();
+      fParams.eigenvalue_principal = eigenvalues.first;
+      fParams.eigenvalue_secondary = eigenvalues.second;
+
+      fFinishedGetAverages = true;
+      fTimeRecord_ProcName.push_back("GetAverages");
+      fTimeRecord_ProcTime.push_back(localWatch.RealTime());
+      return;
+    }
+
     TPrincipal fPrincipal(2,"D");
 
     fParams.N_Hits = fHitVector.size();
@@ -389,9 +461,12 @@ namespace cluster{
 
     for (auto& hit : fHitVector){
       // First, abuse this loop to calculate rms in x and y
-      rmsx += pow(fParams.mean_x - hit.w, 2)/fParams.N_Hits;
-      rmsy += pow(fParams.mean_y - hit.t, 2)/fParams.N_Hits;
-      rmsq += pow(fParams.mean_charge - hit.charge, 2)/fParams.N_Hits;
+      // (with moments in use, they come ready)
+      if (!fUseMoments) {
+        rmsx += pow(fParams.mean_x - hit.w, 2)/fParams.N_Hits;
+        rmsy += pow(fParams.mean_y - hit.t, 2)/fParams.N_Hits;
+        rmsq += pow(fParams.mean_charge - hit.charge, 2)/fParams.N_Hits;
+      }
       //if charge is above avg_charge
       // std::cout << "This hit has charge " <<  hit . charge << "\n";
        
@@ -404,9 +479,17 @@ namespace cluster{
       }//for high charge
     }//For hh loop
 
-    fParams.rms_x = sqrt(rmsx);
-    fParams.rms_y = sqrt(rmsy);
-    fParams.RMS_charge = sqrt(rmsq);
+    if (fUseMoments) {
+      const ClusterMoments& moments = GetMoments();
+      fParams.rms_x = moments.RMSW();
+      fParams.rms_y = moments.RMST();
+      fParams.RMS_charge = moments.RMSCharge();
+    }
+    else {
+      fParams.rms_x = sqrt(rmsx);
+      fParams.rms_y = sqrt(rmsy);
+      fParams.RMS_charge = sqrt(rmsq);
+    }
     
     fParams.N_Hits_HC = ncw;
     //Looking for the slope and intercept of the line above avg_charge hits
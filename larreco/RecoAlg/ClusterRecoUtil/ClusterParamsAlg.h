@@ -23,6 +23,7 @@
 //--- LArSoft include ---//
 #include "lardata/Utilities/GeometryUtilities.h"
 #include "ClusterParams.h"
+#include "ClusterMoments.h"
 #include "CRUException.h"
 
 //#include "LArUtilManager.hh"
@@ -66,6 +67,32 @@ namespace cluster {
 
     int SetHits(const std::vector<util::PxHit> &);
 
+    /**
+     * @brief Sets the hits to the union of the hits of other clusters
+     * @param clusters the clusters to be merged (all hits are copied)
+     * @return the same as SetHits()
+     *
+     * If moments are in use (UseMoments()), the moments of the merged cluster
+     * are combined from the ones of the input clusters instead of being
+     * recomputed from the hits.
+     * This only saves the GetAverages() pass: the hits are still copied and
+     * FillParams() still loops over them for the other parameters, so the
+     * cost of a merge stays linear in the number of hits.
+     */
+    int MergeHits(const std::vector<const ClusterParamsAlg*> &clusters);
+
+    /**
+     * @brief Computes averages and spreads from mergeable hit moments
+     *
+     * When enabled, GetAverages() and the RMS part of GetRoughAxis() use a
+     * ClusterMoments object instead of looping over the hits and using
+     * TPrincipal. The moments are kept and reused by MergeHits().
+     */
+    void UseMoments(bool yes=true) { fUseMoments = yes; }
+
+    /// Returns the hit moments, computing them if needed
+    const ClusterMoments& GetMoments();
+
     void SetRefineDirectionQMin(double qmin){ fQMinRefDir = qmin; }
 
     void SetVerbose(bool yes=true){ verbose = yes;}
@@ -329,6 +356,10 @@ namespace cluster {
     bool fFinishedTrackShowerSep;
     bool fFinishedGetEndCharges;
 
+    bool fUseMoments; ///< whether to use fMoments for averages and RMS
+    bool fHasMoments; ///< whether fMoments describes the current hits
+    ClusterMoments fMoments; ///< moments of the hits in fHitVector
+
     double fRough2DSlope;        // slope 
     double fRough2DIntercept;    // slope 
     util::PxPoint fRoughBeginPoint;
@@ -1,5 +1,8 @@
 #include "Polygon2D.h"
 
+#include <algorithm>
+#include <limits>
+
 //------------------------------------------------
 float FindSlope( const std::pair<float,float> &p1, 
 		 const std::pair<float,float> &p2 )
@@ -53,6 +56,7 @@ Polygon2D::Polygon2D(const Polygon2D &poly1, const Polygon2D &poly2)
   if ( !(poly1.PolyOverlap(poly2)) ){
     std::vector< std::pair<float,float> > nullpoint;
     vertices = nullpoint;
+    UpdateGeometry();
     return;
   }
 
@@ -89,9 +93,69 @@ Polygon2D::Polygon2D(const Polygon2D &poly1, const Polygon2D &poly2)
   }//for all segments in poly1
   
   vertices = IntersectionPoints;
+  UpdateGeometry();
   return;
 }
 
+//-------------------------------
+void Polygon2D::UpdateGeometry()
+{
+  bbox_min = std::make_pair(  std::numeric_limits<float>::max(),  std::numeric_limits<float>::max() );
+  bbox_max = std::make_pair( -std::numeric_limits<float>::max(), -std::numeric_limits<float>::max() );
+  for (auto const& v : vertices){
+    bbox_min.first  = std::min(bbox_min.first,  v.first);
+    bbox_min.second = std::min(bbox_min.second, v.second);
+    bbox_max.first  = std::max(bbox_max.first,  v.first);
+    bbox_max.second = std::max(bbox_max.second, v.second);
+  }
+
+  //convex if all the turns go the same way
+  //and the boundary winds only once (x and y change direction twice)
+  orientation = 0;
+  unsigned int n = vertices.size();
+  if (n < 3) return;
+
+  int turn = 0;
+  int xflips = 0, yflips = 0;
+  int xdir = 0, ydir = 0, xdir0 = 0, ydir0 = 0;
+  for (unsigned int i=0; i<n; i++){
+    auto const& a = vertices[i];
+    auto const& b = vertices[(i+1)%n];
+    auto const& c = vertices[(i+2)%n];
+    double cross = ((double)b.first-a.first)*((double)c.second-b.second)
+      - ((double)b.second-a.second)*((double)c.first-b.first);
+    int sign = (cross > 0) - (cross < 0);
+    if (sign){
+      if (turn && sign != turn) return;
+      turn = sign;
+    }
+    int dx = (b.first > a.first) - (b.first < a.first);
+    int dy = (b.second > a.second) - (b.second < a.second);
+    if (dx){
+      if (!xdir0) xdir0 = dx;
+      else if (dx != xdir) xflips++;
+      xdir = dx;
+    }
+    if (dy){
+      if (!ydir0) ydir0 = dy;
+      else if (dy != ydir) yflips++;
+      ydir = dy;
+    }
+  }
+  //close the loop
+  if (xdir && xdir != xdir0) xflips++;
+  if (ydir && ydir != ydir0) yflips++;
+  if (turn && xflips <= 2 && yflips <= 2)
+    orientation = turn;
+}
+
+//-----------------------------------------------------------------
+bool Polygon2D::BoundingBoxOverlap(const Polygon2D &poly2) const
+{
+  return ( bbox_min.first  <= poly2.bbox_max.first  and poly2.bbox_min.first  <= bbox_max.first and
+	   bbox_min.second <= poly2.bbox_max.second and poly2.bbox_min.second <= bbox_max.second );
+}
+
 //---------------------------
 float Polygon2D::Area() const
 {
@@ -156,6 +220,8 @@ std::pair<float,float> Polygon2D::Project(const std::pair<float,float> &p,
 
   std::pair<float,float> range(10000,0);
   std::pair<float,float> ptmp;
+  const float cos_theta = cos(theta);
+  const float sin_theta = sin(theta);
 
   for (unsigned int i=0; i<vertices.size(); i++){
     //Translation
@@ -166,7 +232,7 @@ std::pair<float,float> Polygon2D::Project(const std::pair<float,float> &p,
     //on the projection of that vertex on the line we are considering
     // +x direction is from vertex in consideration (vertex 'i' in loop) to next vertex
     //now find the x-coordinate of that vertex after it is rotated such that edge is now + x axis
-    float xnew = (ptmp.first)*cos(theta) + (ptmp.second)*sin(theta);
+    float xnew = (ptmp.first)*cos_theta + (ptmp.second)*sin_theta;
     //finally calculate range of projection on x-axis: look at every x position and compare it to range
      if ( xnew < range.first )
       range.first = xnew;
@@ -230,10 +296,46 @@ bool Polygon2D::PolyOverlapSegments(const Polygon2D &poly2) const
   if ( (this->Contained(poly2)) or (poly2.Contained(*this)) ){
     return true;
   }
-  //loop over the two polygons checking wehther
-  //two segments ever intersect
-  for (unsigned int i=0; i<this->Size(); i++){
-    for (unsigned int j=0; j<poly2.Size(); j++){
+  //disjoint bounding boxes: no segment can cross
+  if ( !(this->BoundingBoxOverlap(poly2)) )
+    return false;
+
+  //check whether two segments ever intersect:
+  //only edges inside the other polygon's bounding box can,
+  //and they are swept along x so that only pairs overlapping in x are tested
+  struct Edge {
+    float xmin, xmax, ymin, ymax;
+    unsigned int index;
+    bool first;   ///< edge of this polygon (else of poly2)
+  };
+  std::vector<Edge> edges;
+  edges.reserve(this->Size() + poly2.Size());
+  for (int ipoly=0; ipoly<2; ipoly++){
+    const Polygon2D& poly  = (ipoly == 0) ? *this : poly2;
+    const Polygon2D& other = (ipoly == 0) ? poly2 : *this;
+    for (unsigned int i=0; i<poly.Size(); i++){
+      Edge e;
+      e.xmin = std::min(poly.Point(i).first,  poly.Point(i+1).first);
+      e.xmax = std::max(poly.Point(i).first,  poly.Point(i+1).first);
+      e.ymin = std::min(poly.Point(i).second, poly.Point(i+1).second);
+      e.ymax = std::max(poly.Point(i).second, poly.Point(i+1).second);
+      if ( e.xmax < other.bbox_min.first  or e.xmin > other.bbox_max.first or
+	   e.ymax < other.bbox_min.second or e.ymin > other.bbox_max.second )
+	continue;
+      e.index = i;
+      e.first = (ipoly == 0);
+      edges.push_back(e);
+    }
+  }
+  std::sort(edges.begin(), edges.end(),
+	    [](const Edge& a, const Edge& b) { return a.xmin < b.xmin; });
+
+  for (unsigned int k=0; k<edges.size(); k++){
+    for (unsigned int l=k+1; l<edges.size() and edges[l].xmin <= edges[k].xmax; l++){
+      if (edges[l].first == edges[k].first) continue;
+      if (edges[l].ymin > edges[k].ymax or edges[k].ymin > edges[l].ymax) continue;
+      unsigned int i = edges[k].first ? edges[k].index : edges[l].index;
+      unsigned int j = edges[k].first ? edges[l].index : edges[k].index;
       if (SegmentOverlap( this->Point(i).first, this->Point(i).second,
 			  this->Point(i+1).first, this->Point(i+1).second,
 			  poly2.Point(j).first, poly2.Point(j).second,
@@ -247,6 +349,26 @@ bool Polygon2D::PolyOverlapSegments(const Polygon2D &poly2) const
 
 //--------------------------------------------------------------------
 bool Polygon2D::PointInside(const std::pair<float,float> &point) const
+{
+
+  //outside the bounding box the ray below crosses the polygon
+  //an even number of times
+  if ( point.first  < bbox_min.first  or point.first  > bbox_max.first or
+       point.second < bbox_min.second or point.second > bbox_max.second )
+    return false;
+
+  //convex polygon: binary search, unless the point is on the boundary
+  if (orientation){
+    int inside = ConvexPointInside(point);
+    if (inside >= 0) return (inside == 1);
+  }
+
+  return RayPointInside(point);
+
+}
+
+//-----------------------------------------------------------------------
+bool Polygon2D::RayPointInside(const std::pair<float,float> &point) const
 {
 
   //any ray originating at point will cross polygon
@@ -267,10 +389,47 @@ bool Polygon2D::PointInside(const std::pair<float,float> &point) const
   
 }
 
+//--------------------------------------------------------------------------
+int Polygon2D::ConvexPointInside(const std::pair<float,float> &point) const
+{
+
+  //signed area of (o,a,point), positive if point is on the inner side of o->a
+  auto side = [this, &point](const std::pair<float,float> &o, const std::pair<float,float> &a) {
+    return orientation * ( ((double)a.first-o.first)*((double)point.second-o.second)
+			   - ((double)a.second-o.second)*((double)point.first-o.first) );
+  };
+
+  //fan of triangles from vertex 0: find the wedge containing the point
+  unsigned int n = vertices.size();
+  double first = side(vertices[0], vertices[1]);
+  double last  = side(vertices[0], vertices[n-1]);
+  if (first < 0 or last > 0) return 0;
+  if (first == 0 or last == 0) return -1;
+
+  unsigned int lo = 1, hi = n-1;
+  while (hi - lo > 1){
+    unsigned int mid = (lo + hi) / 2;
+    if (side(vertices[0], vertices[mid]) > 0) lo = mid;
+    else hi = mid;
+  }
+
+  double edge = side(vertices[lo], vertices[hi]);
+  if (edge > 0) return 1;
+  if (edge < 0) return 0;
+  return -1;
+
+}
+
 //-----------------------------------------------------
 bool Polygon2D::Contained(const Polygon2D &poly2) const
 {
 
+  //a vertex of poly2 outside the bounding box cannot be inside
+  if ( poly2.Size() and
+       ( poly2.bbox_min.first  < bbox_min.first  or poly2.bbox_max.first  > bbox_max.first or
+	 poly2.bbox_min.second < bbox_min.second or poly2.bbox_max.second > bbox_max.second ) )
+    return false;
+
  //loop over poly2 checking wehther
   //points of poly2 all inside poly1
   for (unsigned int i=0; i<poly2.Size(); i++){
@@ -314,4 +473,6 @@ void Polygon2D::UntanglePolygon()
     }//second loop
   }//first loop
 
+  UpdateGeometry();
+
 }
@@ -30,6 +30,11 @@
 //n-1 = last ordered vertex (n=size of polygon)
 //n   = first vertex again
 //>n  = invalid...return error message
+//
+//the axis-aligned bounding box and the convexity of the polygon are
+//computed once when the vertices are set: they are used to skip the
+//edge-by-edge tests for polygons/points far apart, and convex polygons
+//answer point queries with a binary search over the vertex fan
 
 //\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/
 //                BEGIN POLYGON CLASS               //
@@ -38,14 +43,30 @@ class Polygon2D{
   
 private:
   std::vector< std::pair<float,float> > vertices;
+  std::pair<float,float> bbox_min;   ///< lower corner of the bounding box
+  std::pair<float,float> bbox_max;   ///< upper corner of the bounding box
+  int orientation;                   ///< +1 (-1): convex, counterclockwise (clockwise); 0: not convex
+
+  /// Compute bounding box and convexity from the vertices
+  void UpdateGeometry();
+
+  /// Point test for convex polygons: 1 inside, 0 outside, -1 on (or too close to) the boundary
+  int ConvexPointInside(const std::pair<float,float> &point) const;
+
+  /// Ray-crossing point test, valid for any polygon
+  bool RayPointInside(const std::pair<float,float> &point) const;
   
  public:
 
-  Polygon2D() { }
-  Polygon2D(const std::vector< std::pair<float,float> > &points) { vertices = points; }
+  Polygon2D() { UpdateGeometry(); }
+  Polygon2D(const std::vector< std::pair<float,float> > &points) { vertices = points; UpdateGeometry(); }
   Polygon2D(const Polygon2D &poly1, const Polygon2D &poly2); /// Create Intersection Polygon
   unsigned int Size() const { return vertices.size(); } 
   const std::pair<float,float>& Point(unsigned int p) const; 
+  const std::pair<float,float>& BoundingBoxMin() const { return bbox_min; }
+  const std::pair<float,float>& BoundingBoxMax() const { return bbox_max; }
+  bool IsConvex() const { return orientation != 0; }
+  bool BoundingBoxOverlap(const Polygon2D &poly2) const;
   std::pair<float,float> Project(const std::pair<float,float>&,float) const;
   float Area() const;
   float Perimeter() const;
@@ -44,6 +44,9 @@ namespace trkf{
 
   CosmicTrackerAlg::CosmicTrackerAlg(fhicl::ParameterSet const& pset){
     this->reconfigure(pset);
+    // get the providers once, so that copies of the algorithm can run in other threads
+    larprop = lar::providerFrom<detinfo::LArPropertiesService>();
+    detprop = lar::providerFrom<detinfo::DetectorPropertiesService>();
   }
 
   //---------------------------------------------------------------------
@@ -83,8 +86,6 @@ namespace trkf{
 
   //---------------------------------------------------------------------
   void CosmicTrackerAlg::TrackTrajectory(std::vector<art::Ptr<recob::Hit> >&fHits){
-    
-    detprop = lar::providerFrom<detinfo::DetectorPropertiesService>();
 
 /*
     // Track hit X and WireIDs in each plane
@@ -189,6 +190,18 @@ namespace trkf{
 	++idir;
       }
     }
+    //MakeSPT only needs the projections on the planes with hits
+    std::vector<std::vector<std::vector<bool>>> hitPlane(geom->Ncryostats());
+    for (size_t cstat = 0; cstat < geom->Ncryostats(); ++cstat){
+      hitPlane[cstat].resize(geom->Cryostat(cstat).NTPC());
+      for (size_t tpc = 0; tpc < geom->Cryostat(cstat).NTPC(); ++tpc){
+	hitPlane[cstat][tpc].resize(geom->Cryostat(cstat).TPC(tpc).Nplanes(), false);
+      }
+    }
+    for (size_t i = 0; i<fHits.size(); ++i){
+      const geo::WireID& wireid = fHits[i]->WireID();
+      hitPlane[wireid.Cryostat][wireid.TPC][wireid.Plane] = true;
+    }
     vw.clear();
     vt.clear();
     vtraj.clear();
@@ -205,6 +218,7 @@ namespace trkf{
 	vt[cstat][tpc].resize(tpcgeom.Nplanes());
 	vtraj[cstat][tpc].resize(tpcgeom.Nplanes());
 	for (size_t plane = 0; plane < tpcgeom.Nplanes(); ++plane){
+	  if (!hitPlane[cstat][tpc][plane]) continue;
 	  for (size_t i = 0; i< trajPos.size(); ++i){
 	    double wirecord = geom->WireCoordinate(trajPos[i].Y(),
 						   trajPos[i].Z(),
@@ -227,9 +241,6 @@ namespace trkf{
   //---------------------------------------------------------------------
   void CosmicTrackerAlg::Track3D(std::vector<art::Ptr<recob::Hit> >&fHits){
 
-    larprop = lar::providerFrom<detinfo::LArPropertiesService>();
-    detprop = lar::providerFrom<detinfo::DetectorPropertiesService>();
-
     //save time/hit information along track trajectory
     std::vector<std::map<int,double> > vtimemap(3);
     std::vector<std::map<int,art::Ptr<recob::Hit> > > vhitmap(3);
@@ -478,9 +489,6 @@ namespace trkf{
 
   //---------------------------------------------------------------------
   void CosmicTrackerAlg::MakeSPT(std::vector<art::Ptr<recob::Hit> >&fHits){
-    
-    larprop = lar::providerFrom<detinfo::LArPropertiesService>();
-    detprop = lar::providerFrom<detinfo::DetectorPropertiesService>();
 
     double timetick = detprop->SamplingRate()*1e-3;    //time sample in us
     double Efield_drift = detprop->Efield(0);  // Electric Field in the drift region in kV/cm
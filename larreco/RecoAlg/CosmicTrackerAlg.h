@@ -32,6 +32,8 @@ namespace trkf
 
     void reconfigure(fhicl::ParameterSet const& pset);
 
+    //results are kept in the data members below; copies of the algorithm
+    //can run SPTReco at the same time in different threads
     void SPTReco(std::vector<art::Ptr<recob::Hit> >&fHits);
 
     //trajectory position and direction returned by TrackTrajectoryAlg
@@ -64,7 +66,7 @@ namespace trkf
     // track trajectory for a track under construction
     TrackTrajectoryAlg fTrackTrajectoryAlg;
 
-    //projection of trajectory points on wire planes
+    //projection of trajectory points on the wire planes with hits
     std::vector<std::vector<std::vector<std::vector<double>>>> vw;
     std::vector<std::vector<std::vector<std::vector<double>>>> vt;
     std::vector<std::vector<std::vector<std::vector<unsigned int>>>> vtraj;
@@ -37,6 +37,7 @@
 #include <map>
 #include <cmath>
 #include <vector>
+#include <algorithm>
 #include <iostream>
 #include <fstream>
 #include <cstdlib>
@@ -91,14 +92,18 @@ void DisambigAlg::RunDisambig(   art::Handle< std::vector<recob::Hit> > ChannelH
   fAPAToDHits.clear();
   fDisambigHits.clear();
   fChanTimeToWid.clear();
-  fHasBeenDisambiged.clear();
+  fAPAToUVTimeIndex.clear();
+  fAPAToZTimeIndex.clear();
+
+  const detinfo::DetectorProperties* detprop = lar::providerFrom<detinfo::DetectorPropertiesService>();
+  fTimeOffsetMargin = 2 * std::max( std::abs(detprop->TimeOffsetU()),
+                                    std::max( std::abs(detprop->TimeOffsetV()), std::abs(detprop->TimeOffsetZ()) ) );
 
 
   std::vector< art::Ptr<recob::Hit> >  ChHits;
   art::fill_ptr_vector(ChHits, ChannelHits);
 
 
-  fHasBeenDisambiged.clear();
   unsigned int skipNoise(0);
   // Map hits by channel/APA, initialize the disambiguation status map
   for( size_t h = 0; h < ChHits.size(); h++ ){
@@ -119,13 +124,15 @@ void DisambigAlg::RunDisambig(   art::Handle< std::vector<recob::Hit> > ChannelH
       fAPAToZHits[apa].push_back(hit);
       continue;
     } else if ( view==geo::kU || view==geo::kV ){
-      std::pair<double,double> ChanTime( hit->Channel()*1., hit->PeakTime()*1. );
-      this->fHasBeenDisambiged[apa][ChanTime] = false;
       fChannelToHits[ hit->Channel() ].push_back( hit );
       fAPAToUVHits[apa].push_back(hit);
     }
   }
 
+  // Time sorted copies of the hits for the time overlap searches
+  for( auto const& apaHits : fAPAToZHits ) fAPAToZTimeIndex[apaHits.first].Fill(apaHits.second);
+  for( auto const& apaHits : fAPAToUVHits ) fAPAToUVTimeIndex[apaHits.first].Fill(apaHits.second);
+
   if(skipNoise>0)
     mf::LogWarning("DisambigAlg")<<"\nSkipped "<< skipNoise <<" induction noise hits using the BackTracker.\n"
 				 <<"This is only to temporarily deal with the excessive amount of noise due to the bad deconvolution.\n"; 
@@ -205,8 +212,7 @@ void DisambigAlg::MakeDisambigHit( art::Ptr<recob::Hit> hit,
 					  unsigned int apa )
 { 
 
-  std::pair<double,double> ChanTime( hit->Channel()*1., hit->PeakTime()*1. );
-  if( fHasBeenDisambiged[apa][ChanTime] ) return; 
+  if( this->HasBeenDisambiged(hit) ) return; 
 
   if( !wid.isValid ){ 
     mf::LogWarning("InvalidWireID") << "wid is invalid, hit not being made\n";
@@ -214,14 +220,89 @@ void DisambigAlg::MakeDisambigHit( art::Ptr<recob::Hit> hit,
     
   std::pair<art::Ptr<recob::Hit>,geo::WireID> Dhit(hit, wid);
   fAPAToDHits[apa].push_back(Dhit);
-  fHasBeenDisambiged[apa][ChanTime] = true;
-  fChanTimeToWid[ChanTime] = wid;
+  fChanTimeToWid[ ChanTime_t(hit->Channel(), hit->PeakTime()) ] = wid;
   return;
   
 }
 
 
 
+//----------------------------------------------------------
+//----------------------------------------------------------
+void DisambigAlg::HitTimeIndex::Fill( std::vector< art::Ptr< recob::Hit > > const& hitVec )
+{
+
+  hits = hitVec;
+  std::stable_sort( hits.begin(), hits.end(), 
+		    [](art::Ptr<recob::Hit> const& a, art::Ptr<recob::Hit> const& b)
+		    { return a->PeakTimeMinusRMS() < b->PeakTimeMinusRMS(); } );
+  startTimes.resize(hits.size());
+  maxLength = 0.;
+  for(size_t h=0; h<hits.size(); h++){
+    startTimes[h] = hits[h]->PeakTimeMinusRMS();
+    maxLength = std::max( maxLength, hits[h]->PeakTimePlusRMS() - startTimes[h] );
+  }
+
+}
+
+
+
+//----------------------------------------------------------
+//----------------------------------------------------------
+std::pair<size_t, size_t> DisambigAlg::HitTimeIndex::Range( double tMin, double tMax ) const
+{
+
+  // A hit ending after tMin starts after tMin - maxLength
+  size_t first = std::lower_bound( startTimes.begin(), startTimes.end(), tMin - maxLength ) - startTimes.begin();
+  size_t last  = std::upper_bound( startTimes.begin(), startTimes.end(), tMax ) - startTimes.begin();
+  return std::make_pair( first, std::max(first, last) );
+
+}
+
+
+
+//----------------------------------------------------------
+//----------------------------------------------------------
+std::vector< DisambigAlg::WireZChans > const& DisambigAlg::ChannelWireZChans( raw::ChannelID_t chan )
+{
+
+  auto cached = fChanToWireZChans.find(chan);
+  if( cached != fChanToWireZChans.end() ) return cached->second;
+
+  std::vector< WireZChans >& wireZChans = fChanToWireZChans[chan];
+  unsigned int apa(0), apacryo(0);
+  fAPAGeo.ChannelToAPA(chan, apa, apacryo);
+
+  std::vector<geo::WireID> hitwids = geom->ChannelToWire(chan);
+  for(size_t w=0; w<hitwids.size(); w++){
+    geo::WireID wid = hitwids[w];
+
+    double xyzStart[3] = {0.};  double xyzEnd[3] = {0.};
+    geom->WireEndPoints(wid.Cryostat, wid.TPC, wid.Plane, wid.Wire, xyzStart, xyzEnd);
+    unsigned int side(wid.TPC%2), cryo(wid.Cryostat);
+    double zminPos(xyzStart[2]), zmaxPos(xyzEnd[2]);
+
+    // get appropriate x and y with tpc center
+    TVector3 tpcCenter(0,0,0);
+    unsigned int tpc = 2*apa + side - cryo*geom->NTPC(); // apa number does not reset per cryo
+    tpcCenter = geom->Cryostat(cryo).TPC(tpc).LocalToWorld(tpcCenter);
+      
+    // get channel range
+    TVector3 Min(tpcCenter); Min[2] = zminPos;
+    TVector3 Max(tpcCenter); Max[2] = zmaxPos;
+    WireZChans wzc;
+    wzc.wid = wid;
+    wzc.zMinChan = geom->NearestChannel( Min, 2, tpc, cryo );
+    wzc.zMaxChan = geom->NearestChannel( Max, 2, tpc, cryo );
+    wireZChans.push_back(wzc);
+  }
+
+  return wireZChans;
+
+}
+
+
+
 //----------------------------------------------------------
 //----------------------------------------------------------
   bool DisambigAlg::HitsOverlapInTime( art::Ptr<recob::Hit> hitA, 
@@ -252,38 +333,29 @@ void DisambigAlg::MakeDisambigHit( art::Ptr<recob::Hit> hit,
 void DisambigAlg::TrivialDisambig( unsigned int apa )
 {
 
+  const HitTimeIndex& zIndex = fAPAToZTimeIndex[apa];
+
   // Loop through ambiguous hits (U/V) in this APA
   for( size_t h=0; h<fAPAToUVHits[apa].size(); h++ ){
     const art::Ptr<recob::Hit> hit = fAPAToUVHits[apa][h];
     raw::ChannelID_t chan = hit->Channel();
     unsigned int peakT = hit->PeakTime();
 
-    std::vector<geo::WireID> hitwids = geom->ChannelToWire(chan);
-    std::vector<bool> IsReasonableWid(hitwids.size(),false);
-    unsigned short nPossibleWids(0);
-    for(size_t w=0; w<hitwids.size(); w++){
-      geo::WireID wid = hitwids[w];
-
-      double xyzStart[3] = {0.};  double xyzEnd[3] = {0.};
-      geom->WireEndPoints(wid.Cryostat, wid.TPC, wid.Plane, wid.Wire, xyzStart, xyzEnd);
-      unsigned int side(wid.TPC%2), cryo(wid.Cryostat);
-      double zminPos(xyzStart[2]), zmaxPos(xyzEnd[2]);
+    // only the Z hits close in time can overlap this one
+    std::pair<size_t, size_t> zRange = zIndex.Range( hit->PeakTimeMinusRMS() - fTimeOffsetMargin,
+						     hit->PeakTimePlusRMS() + fTimeOffsetMargin );
 
-      // get appropriate x and y with tpc center
-      TVector3 tpcCenter(0,0,0);
-      unsigned int tpc = 2*apa + side - cryo*geom->NTPC(); // apa number does not reset per cryo
-      tpcCenter = geom->Cryostat(cryo).TPC(tpc).LocalToWorld(tpcCenter);
-      
-      // get channel range
-      TVector3 Min(tpcCenter); Min[2] = zminPos;
-      TVector3 Max(tpcCenter); Max[2] = zmaxPos;
-      raw::ChannelID_t ZminChan = geom->NearestChannel( Min, 2, tpc, cryo );
-      raw::ChannelID_t ZmaxChan = geom->NearestChannel( Max, 2, tpc, cryo );
+    std::vector< WireZChans > const& wireZChans = this->ChannelWireZChans(chan);
+    std::vector<bool> IsReasonableWid(wireZChans.size(),false);
+    unsigned short nPossibleWids(0);
+    for(size_t w=0; w<wireZChans.size(); w++){
+      raw::ChannelID_t ZminChan = wireZChans[w].zMinChan;
+      raw::ChannelID_t ZmaxChan = wireZChans[w].zMaxChan;
       
-      for( size_t z=0; z < fAPAToZHits[apa].size(); z++ ){
-	raw::ChannelID_t chan = fAPAToZHits[apa][z]->Channel();
+      for( size_t z=zRange.first; z < zRange.second; z++ ){
+	raw::ChannelID_t chan = zIndex.hits[z]->Channel();
 	if( chan <= ZminChan || ZmaxChan <= chan ) continue;
-	art::Ptr<recob::Hit> zhit = fAPAToZHits[apa][z];
+	art::Ptr<recob::Hit> zhit = zIndex.hits[z];
 
 // 	try{ bt->HitToXYZ(zhit); }
 // 	catch(...){ 
@@ -308,8 +380,8 @@ void DisambigAlg::TrivialDisambig( unsigned int apa )
 				       << peakT << " in APA " << apa << " on channel " << hit->Channel(); 
     }
     else if(nPossibleWids==1){
-      for(size_t d=0; d<hitwids.size(); d++) 
-	if(IsReasonableWid[d]) this->MakeDisambigHit( hit, hitwids[d], apa );
+      for(size_t d=0; d<wireZChans.size(); d++) 
+	if(IsReasonableWid[d]) this->MakeDisambigHit( hit, wireZChans[d].wid, apa );
     }
     else if(nPossibleWids==2){
       ///\ todo: Add mechanism to at least eliminate the wids that aren't even possible, for the benefit of future methods
@@ -350,17 +422,18 @@ unsigned int DisambigAlg::MakeCloseHits( int ext, geo::WireID Dwid, double Dmin,
   raw::ChannelID_t chan = (raw::ChannelID_t)(tempchan);
 
   // There may just be no hits
-  if( fChannelToHits.count(chan) == 0 ) return 0;
+  auto chanHits = fChannelToHits.find(chan);
+  if( chanHits == fChannelToHits.end() ) return 0;
 
   // There are close channel hits, so for each
   unsigned int apa(0), cryo(0);
   fAPAGeo.ChannelToAPA(chan, apa, cryo);
   unsigned int MakeCount(0);
-  for(size_t i=0; i<fChannelToHits[chan].size(); i++){
-    art::Ptr< recob::Hit > closeHit = fChannelToHits[chan][i];
+  std::vector< WireZChans > const& wids = this->ChannelWireZChans(chan);
+  for(size_t i=0; i<chanHits->second.size(); i++){
+    art::Ptr< recob::Hit > closeHit = chanHits->second[i];
     double st = closeHit->PeakTimeMinusRMS();
     double et = closeHit->PeakTimePlusRMS();
-    std::vector<geo::WireID> wids = geom->ChannelToWire(chan);
 
     if( !(Dmin <= st && st <= Dmax) && !(Dmin <= et && et <= Dmax) ) continue;
 
@@ -368,14 +441,13 @@ unsigned int DisambigAlg::MakeCloseHits( int ext, geo::WireID Dwid, double Dmin,
     // Found hit with window overlapping given range, 
     // now find the only reasonable wireID.
     for(size_t w=0; w<wids.size(); w++){ 
-      if( wids[w].TPC != Dwid.TPC ) continue;
-      if( (int)(wids[w].Wire)-(int)(Dwid.Wire) != ext ) continue;    
+      if( wids[w].wid.TPC != Dwid.TPC ) continue;
+      if( (int)(wids[w].wid.Wire)-(int)(Dwid.Wire) != ext ) continue;    
 
       // In this case, we have a unique wireID.
       // Check to see if it has already been made - if so, do not incriment count
-      std::pair<double,double> ChanTime( closeHit->Channel()*1., closeHit->PeakTime()*1. );
-      if( !fHasBeenDisambiged[apa][ChanTime] ){ 
-	this->MakeDisambigHit(closeHit, wids[w], apa); 
+      if( !this->HasBeenDisambiged(closeHit) ){ 
+	this->MakeDisambigHit(closeHit, wids[w].wid, apa); 
 	MakeCount++;
 	//std::cout << "     Close hit found on channel " << chan << ", time " << st<<"-"<<et << "... \n";
 	//std::cout << " ... giving it wireID ("<< Dwid.Cryostat <<"," << Dwid.TPC 
@@ -410,12 +482,12 @@ void DisambigAlg::Crawl( unsigned int apa )
     
     // Look for any disambiguated hit ... 
     for(size_t h=0; h < hits.size(); h++){
-      std::pair<double,double> ChanTime( hits[h]->Channel()*1., hits[h]->PeakTime()*1. );
-      if( !fHasBeenDisambiged[apa][ChanTime] ) continue;
+      auto Dhit = fChanTimeToWid.find( ChanTime_t(hits[h]->Channel(), hits[h]->PeakTime()) );
+      if( Dhit == fChanTimeToWid.end() ) continue;
       double stD = hits[h]->PeakTimePlusRMS(-1.);
       double etD = hits[h]->PeakTimePlusRMS(+1.);
       double hitWindow = etD - stD;
-      geo::WireID Dwid = fChanTimeToWid[ChanTime];
+      geo::WireID Dwid = Dhit->second;
             
       // ... and if any neighboring-channel hits are close enough in time,
       // extend the disambiguation to the neighboring wire.      
@@ -709,42 +781,43 @@ unsigned int DisambigAlg::CompareViews( unsigned int apa )
 {
 
   unsigned int nDisambiguations(0);
+  const HitTimeIndex& uvIndex = fAPAToUVTimeIndex[apa];
 
   // loop through all hits that are still ambiguous
   for(size_t h=0; h < fAPAToUVHits[apa].size(); h++){
     art::Ptr<recob::Hit>      ambighit  = fAPAToUVHits[apa][h];
     raw::ChannelID_t          ambigchan = ambighit->Channel();
-    std::pair<double,double>  ambigChanTime(ambigchan*1.,ambighit->PeakTime());
-    if( fHasBeenDisambiged[apa][ambigChanTime] ) continue;
+    if( this->HasBeenDisambiged(ambighit) ) continue;
     geo::View_t               view      = ambighit->View();
-    std::vector<geo::WireID>  ambigwids = geom->ChannelToWire(ambigchan);
+    std::vector< WireZChans > const& ambigwids = this->ChannelWireZChans(ambigchan);
     std::vector<unsigned int> widDcounts  (ambigwids.size(), 0);
     std::vector<unsigned int> widAcounts  (ambigwids.size(), 0);
 
-
+    std::pair<size_t, size_t> timeRange = uvIndex.Range( ambighit->PeakTimeMinusRMS() - fTimeOffsetMargin,
+							 ambighit->PeakTimePlusRMS() + fTimeOffsetMargin );
 
     // loop through hits in the other view which are close in time
-    for(size_t i=0; i < fAPAToUVHits[apa].size(); i++){
-      art::Ptr<recob::Hit> hit = fAPAToUVHits[apa][i];
+    for(size_t i=timeRange.first; i < timeRange.second; i++){
+      art::Ptr<recob::Hit> hit = uvIndex.hits[i];
       if(hit->View()==view || !this->HitsOverlapInTime(ambighit, hit)) continue;
 
       // An other-view-hit overlaps in time, see what 
       // wids of the ambiguous hit's channels it overlaps
       raw::ChannelID_t          chan = hit->Channel();
-      std::vector<geo::WireID>  wids = geom->ChannelToWire(chan);
-      std::pair<double,double>  ChanTime(chan*1.,hit->PeakTime());
+      auto                      Dhit = fChanTimeToWid.find( ChanTime_t(chan, hit->PeakTime()) );
       geo::WireIDIntersection   widIntersect; // only so we can use the function
-      if( fHasBeenDisambiged[apa][ChanTime] ){
+      if( Dhit != fChanTimeToWid.end() ){
 	for(size_t a=0; a<ambigwids.size(); a++)
-	  if( ambigwids[a].TPC == fChanTimeToWid[ChanTime].TPC  &&
-	      geom->WireIDsIntersect(ambigwids[a], fChanTimeToWid[ChanTime], widIntersect) ) widDcounts[a]++;
+	  if( ambigwids[a].wid.TPC == Dhit->second.TPC  &&
+	      geom->WireIDsIntersect(ambigwids[a].wid, Dhit->second, widIntersect) ) widDcounts[a]++;
       } else {
 	// still might be able to glean disambiguation 
 	// from the ambiguous hits at this time
+	std::vector< WireZChans > const& wids = this->ChannelWireZChans(chan);
       	for(size_t a=0; a<ambigwids.size(); a++)
 	  for(size_t w=0; w<wids.size(); w++)
-	    if( ambigwids[a].TPC == wids[w].TPC  &&
-		geom->WireIDsIntersect(ambigwids[a], wids[w], widIntersect) ) widAcounts[a]++;
+	    if( ambigwids[a].wid.TPC == wids[w].wid.TPC  &&
+		geom->WireIDsIntersect(ambigwids[a].wid, wids[w].wid, widIntersect) ) widAcounts[a]++;
       }
     } // end loop through close-time hits
 
@@ -756,7 +829,7 @@ unsigned int DisambigAlg::CompareViews( unsigned int apa )
     for(size_t a=0; a<widAcounts.size(); a++) Acount += widAcounts[a];
     for(size_t d=0; d<widDcounts.size(); d++){
       if( Dcount == widDcounts[d] && Dcount>0 && Acount==0 ){ 
-	this->MakeDisambigHit(ambighit, ambigwids[d], apa);
+	this->MakeDisambigHit(ambighit, ambigwids[d].wid, apa);
 	nDisambiguations++;  } }
     for(size_t a=0; a<widAcounts.size(); a++){
       if( Acount == widAcounts[a] && Acount==1 ){
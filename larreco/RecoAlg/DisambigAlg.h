@@ -6,6 +6,8 @@
 #define DisambigAlg_H
 #include <vector>
 #include <map>
+#include <unordered_map>
+#include <utility>
 #include <cmath>
 #include <iostream>
 #include <stdint.h>
@@ -75,21 +77,55 @@ namespace apa{
     const detinfo::DetectorProperties*           detprop;
     art::ServiceHandle<cheat::BackTracker> bt;                     ///< For *TEMPORARY* monitering of potential problems
 
+    /// Hits of one view sorted by the start of their time window, for time interval queries
+    struct HitTimeIndex {
+      std::vector< art::Ptr< recob::Hit > > hits;
+      std::vector< double >                 startTimes; ///< PeakTimeMinusRMS of the sorted hits
+      double                                maxLength = 0.; ///< Longest hit time window
+      
+      void Fill( std::vector< art::Ptr< recob::Hit > > const& hitVec );
+      /// Range [first, last) of the hits which may have a window touching [tMin, tMax]
+      std::pair<size_t, size_t> Range( double tMin, double tMax ) const;
+    };
+
+    /// A wire of a wrapped channel and the collection channels it may cross
+    struct WireZChans {
+      geo::WireID      wid;
+      raw::ChannelID_t zMinChan;
+      raw::ChannelID_t zMaxChan;
+    };
+
+    /// Key of a U/V hit in the disambiguation bookkeeping: its channel and peak time
+    typedef std::pair< raw::ChannelID_t, float > ChanTime_t;
+    struct ChanTimeHash {
+      size_t operator()( ChanTime_t const& ct ) const
+        { return std::hash<raw::ChannelID_t>()(ct.first) * 0x9E3779B1 ^ std::hash<float>()(ct.second); }
+    };
+
     // Hits organization
-    std::map< raw::ChannelID_t, std::vector< art::Ptr< recob::Hit > > > fChannelToHits; 
+    std::unordered_map< raw::ChannelID_t, std::vector< art::Ptr< recob::Hit > > > fChannelToHits; 
     std::map< unsigned int, std::vector< art::Ptr< recob::Hit > > >    fAPAToUVHits, fAPAToZHits; 
     std::map< unsigned int, std::vector< art::Ptr< recob::Hit > > >    fAPAToHits; 
                                                                    ///\ todo: Channel/APA to hits can be done in a unified way
     std::map< unsigned int, std::vector< art::Ptr< recob::Hit > > >    fAPAToEndPHits;
     std::map< unsigned int, std::vector< std::pair<art::Ptr<recob::Hit>, geo::WireID> > >  fAPAToDHits;
                                                                    ///< Hold the disambiguations per APA
+    std::map< unsigned int, HitTimeIndex >                             fAPAToUVTimeIndex, fAPAToZTimeIndex;
+    double                                                             fTimeOffsetMargin;
+                                    ///< Largest shift of a hit window by the view time offsets in HitsOverlapInTime
+
+    // Geometry lookup, filled on first use of each channel and kept for the job
+    std::unordered_map< raw::ChannelID_t, std::vector< WireZChans > >   fChanToWireZChans;
+    std::vector< WireZChans > const& ChannelWireZChans( raw::ChannelID_t chan );
+                                    ///< Wires of a U/V channel with the range of collection channels they cross
 
 
 
     // data/function to keep track of disambiguation along the way
-    std::map<std::pair<double,double>, geo::WireID>                      fChanTimeToWid;
+    std::unordered_map< ChanTime_t, geo::WireID, ChanTimeHash >         fChanTimeToWid;
                                     ///< If a hit is disambiguated, map its chan and peak time to the chosen wireID
-    std::map< unsigned int, std::map<std::pair<double,double>, bool> >   fHasBeenDisambiged;
+    bool          HasBeenDisambiged( art::Ptr<recob::Hit> const& hit ) const
+                    { return fChanTimeToWid.count( ChanTime_t(hit->Channel(), hit->PeakTime()) ) > 0; }
                                     ///< Convenient way to keep track of disambiguation so far
     void          MakeDisambigHit( art::Ptr<recob::Hit> hit, 
 				   geo::WireID, 
@@ -10,6 +10,8 @@
 
 #include "larreco/RecoAlg/EMShowerAlg.h"
 
+std::mutex shower::EMShowerAlg::fPMAMutex;
+
 shower::EMShowerAlg::EMShowerAlg(fhicl::ParameterSet const& pset) : fDetProp(lar::providerFrom<detinfo::DetectorPropertiesService>()),
 								    fShowerEnergyAlg(pset.get<fhicl::ParameterSet>("ShowerEnergyAlg")),
 								    fCalorimetryAlg(pset.get<fhicl::ParameterSet>("CalorimetryAlg")),
@@ -28,6 +30,8 @@ shower::EMShowerAlg::EMShowerAlg(fhicl::ParameterSet const& pset) : fDetProp(lar
   fDebug = pset.get<int>("Debug",0);
   fDetector = pset.get<std::string>("Detector","dune35t");
 
+  fProjections.SetProviders(&*fGeom, fDetProp);
+
   hTrueDirection = tfs->make<TH1I>("trueDir","",2,0,2);
 
 }
@@ -270,7 +274,7 @@ std::vector<int> shower::EMShowerAlg::CheckShowerPlanes(std::vector<std::vector<
 TVector3 shower::EMShowerAlg::Construct3DPoint(art::Ptr<recob::Hit> const& hit1, art::Ptr<recob::Hit> const& hit2) {
 
   // x is average of the two x's
-  double x = (fDetProp->ConvertTicksToX(hit1->PeakTime(), hit1->WireID().planeID()) + fDetProp->ConvertTicksToX(hit2->PeakTime(), hit2->WireID().planeID())) / (double)2;
+  double x = (fProjections.TicksToX(hit1->PeakTime(), hit1->WireID().planeID()) + fProjections.TicksToX(hit2->PeakTime(), hit2->WireID().planeID())) / (double)2;
 
   // y and z got from the wire interections
   geo::WireIDIntersection intersection;
@@ -322,7 +326,11 @@ std::unique_ptr<recob::Track> shower::EMShowerAlg::ConstructTrack(std::vector<ar
   }
 
   TVector3 trackStart = Construct3DPoint(track1.at(0), track2.at(0));
-  pma::Track3D* pmatrack = fProjectionMatchingAlg.buildSegment(track1, track2, trackStart);
+  pma::Track3D* pmatrack = nullptr;
+  {
+    std::lock_guard<std::mutex> lock(fPMAMutex);
+    pmatrack = fProjectionMatchingAlg.buildSegment(track1, track2, trackStart);
+  }
 
   if (!pmatrack) {
     mf::LogInfo("EMShowerAlg") << "Skipping this event because not enough hits in two views";
@@ -433,7 +441,7 @@ double shower::EMShowerAlg::FinddEdx(std::vector<art::Ptr<recob::Hit> > const& t
   for (std::vector<art::Ptr<recob::Hit> >::const_iterator trackHitIt = trackHits.begin(); trackHitIt != trackHits.end(); ++trackHitIt) {
     if (totalDistance + pitch < fdEdxTrackLength) {
       totalDistance += pitch;
-      totalCharge += (*trackHitIt)->Integral();
+      totalCharge += HitCharge(*trackHitIt);
       avHitTime += (*trackHitIt)->PeakTime();
       ++nHits;
     }
@@ -822,7 +830,11 @@ recob::Shower shower::EMShowerAlg::MakeShower(art::PtrVector<recob::Hit> const&
     //std::cout<<"vertex "<<xyz[0]<<" "<<xyz[1]<<" "<<xyz[2]<<std::endl;
     //for (auto const&hit : initialTrackHits[pl0]) std::cout<<*hit<<std::endl;
     //for (auto const&hit : initialTrackHits[pl1]) std::cout<<*hit<<std::endl;
-    pma::Track3D* pmatrack = fProjectionMatchingAlg.buildSegment(initialTrackHits[pl0], initialTrackHits[pl1]);
+    pma::Track3D* pmatrack = nullptr;
+    {
+      std::lock_guard<std::mutex> lock(fPMAMutex);
+      pmatrack = fProjectionMatchingAlg.buildSegment(initialTrackHits[pl0], initialTrackHits[pl1]);
+    }
     //std::cout<<pmatrack->size()<<std::endl;
     //pma::Track3D* pmatrack = fProjectionMatchingAlg.buildSegment(alltrackhits);
     std::vector<TVector3> spts;
@@ -1002,45 +1014,59 @@ std::map<int,std::vector<art::Ptr<recob::Hit> > > shower::EMShowerAlg::OrderShow
 
     // First, order the hits along the shower
     // Then we need to see if this is correct or if we need to swap the order
-    std::vector<art::Ptr<recob::Hit> > showerHits = showerHitsIt->second;
+    std::vector<art::Ptr<recob::Hit> > const& showerHits = showerHitsIt->second;
 
     // Find a rough shower 'direction' and centre
     TVector2 direction = ShowerDirection(showerHits);
 
+    // Positions of the hits in cm, looked up once
+    std::vector<TVector2> hitPositions;
+    hitPositions.reserve(showerHits.size());
+    for (std::vector<art::Ptr<recob::Hit> >::const_iterator showerHitIt = showerHits.begin(); showerHitIt != showerHits.end(); ++showerHitIt)
+      hitPositions.push_back(HitPosition(*showerHitIt));
+
     // Bin the hits into discreet chunks
+    // (segment, hit) pairs sorted by segment keep the hits of each segment in their shower order
     int nShowerSegments = 5;
-    double lengthOfShower = (HitPosition(showerHits.back()) - HitPosition(showerHits.front())).Mod();
+    double lengthOfShower = (hitPositions.back() - hitPositions.front()).Mod();
     double lengthOfSegment = lengthOfShower / (double)nShowerSegments;
-    std::map<int,std::vector<art::Ptr<recob::Hit> > > showerSegments;
-    std::map<int,double> segmentCharge;
-    for (std::vector<art::Ptr<recob::Hit> >::iterator showerHitIt = showerHits.begin(); showerHitIt != showerHits.end(); ++showerHitIt) {
-      showerSegments[(int)(HitPosition(*showerHitIt)-HitPosition(showerHits.front())).Mod() / lengthOfSegment].push_back(*showerHitIt);
-      segmentCharge[(int)(HitPosition(*showerHitIt)-HitPosition(showerHits.front())).Mod() / lengthOfSegment] += (*showerHitIt)->Integral();
+    std::vector<std::pair<int,size_t> > showerSegments;
+    showerSegments.reserve(showerHits.size());
+    for (size_t hit = 0; hit < hitPositions.size(); ++hit) {
+      int segment = lengthOfSegment > 0 ? (int)((int)(hitPositions[hit]-hitPositions.front()).Mod() / lengthOfSegment) : 0;
+      showerSegments.push_back(std::make_pair(segment, hit));
     }
+    std::stable_sort(showerSegments.begin(), showerSegments.end(),
+		     [](std::pair<int,size_t> const& a, std::pair<int,size_t> const& b) { return a.first < b.first; });
 
-    TGraph* graph = new TGraph();
+    TGraph* graph = makeDirectionPlot ? new TGraph() : nullptr;
     std::vector<std::pair<int,double> > binVsRMS;
 
     // Loop over the bins to find the distribution of hits as the shower progresses
-    for (std::map<int,std::vector<art::Ptr<recob::Hit> > >::iterator showerSegmentIt = showerSegments.begin(); showerSegmentIt != showerSegments.end(); ++showerSegmentIt) {
+    for (size_t segmentBegin = 0, segmentEnd = 0; segmentBegin < showerSegments.size(); segmentBegin = segmentEnd) {
+
+      int segment = showerSegments[segmentBegin].first;
+      while (segmentEnd < showerSegments.size() and showerSegments[segmentEnd].first == segment)
+	++segmentEnd;
 
       // Get the mean position of the hits in this bin
       TVector2 meanPosition(0,0);
-      for (std::vector<art::Ptr<recob::Hit> >::iterator hitInSegmentIt = showerSegmentIt->second.begin(); hitInSegmentIt != showerSegmentIt->second.end(); ++hitInSegmentIt)
-	meanPosition += HitPosition(*hitInSegmentIt);
-      meanPosition /= (double)showerSegmentIt->second.size();
+      for (size_t hitInSegment = segmentBegin; hitInSegment != segmentEnd; ++hitInSegment)
+	meanPosition += hitPositions[showerSegments[hitInSegment].second];
+      meanPosition /= (double)(segmentEnd - segmentBegin);
 
       // Get the RMS of this bin
       std::vector<double> distanceToAxisBin;
-      for (std::vector<art::Ptr<recob::Hit> >::iterator hitInSegmentIt = showerSegmentIt->second.begin(); hitInSegmentIt != showerSegmentIt->second.end(); ++hitInSegmentIt) {
-	TVector2 proj = (HitPosition(*hitInSegmentIt) - meanPosition).Proj(direction) + meanPosition;
-	distanceToAxisBin.push_back((HitPosition(*hitInSegmentIt) - proj).Mod());
+      for (size_t hitInSegment = segmentBegin; hitInSegment != segmentEnd; ++hitInSegment) {
+	TVector2 const& position = hitPositions[showerSegments[hitInSegment].second];
+	TVector2 proj = (position - meanPosition).Proj(direction) + meanPosition;
+	distanceToAxisBin.push_back((position - proj).Mod());
       }
 
       double RMSBin = TMath::RMS(distanceToAxisBin.begin(), distanceToAxisBin.end());
       if (makeDirectionPlot)
-	graph->SetPoint(graph->GetN(), showerSegmentIt->first, RMSBin);//*segmentCharge.at(showerSegmentIt->first));
-      binVsRMS.push_back(std::make_pair(showerSegmentIt->first, RMSBin));
+	graph->SetPoint(graph->GetN(), segment, RMSBin);
+      binVsRMS.push_back(std::make_pair(segment, RMSBin));
 
     }
 
@@ -1185,8 +1211,8 @@ void shower::EMShowerAlg::OrderShowerHits(std::vector<art::Ptr<recob::Hit> > con
   if (hit0.isNull()||hit1.isNull()) return;
   TVector2 coord0 = TVector2(hit0->WireID().Wire, hit0->PeakTime());
   TVector2 coord1 = TVector2(hit1->WireID().Wire, hit1->PeakTime());
-  TVector2 coordvtx = TVector2(fGeom->WireCoordinate(xyz[1], xyz[2], hit0->WireID().planeID()),
-			       fDetProp->ConvertXToTicks(xyz[0],  hit0->WireID().planeID()));
+  TVector2 coordvtx = TVector2(fProjections.WireCoordinate(xyz[1], xyz[2], hit0->WireID().planeID()),
+			       fProjections.XToTicks(xyz[0],  hit0->WireID().planeID()));
 //  std::cout<<coord0.X()<<" "<<coord0.Y()<<std::endl;
 //  std::cout<<coord1.X()<<" "<<coord1.Y()<<std::endl;
 //  std::cout<<coordvtx.X()<<" "<<coordvtx.Y()<<std::endl;
@@ -1270,14 +1296,95 @@ void shower::EMShowerAlg::FindInitialTrackHits(std::vector<art::Ptr<recob::Hit>
 }
 
 
+void shower::EMShowerAlg::UpdateGeometry() {
+
+  fProjections.UpdateGeometry(*fGeom);
+
+}
+
+void shower::EMShowerAlg::UpdateDetectorProperties() {
+
+  fProjections.UpdateDetectorProperties(*fDetProp);
+
+}
+
+void shower::EMShowerAlg::CacheHitPositions(std::vector<art::Ptr<recob::Hit> > const& hits) {
+
+  ClearHitCache();
+  if (hits.empty())
+    return;
+
+  // The cache is indexed by pointer key, so it can only hold the hits from one collection
+  fHitCacheID = hits.front().id();
+  size_t maxKey = 0;
+  for (std::vector<art::Ptr<recob::Hit> >::const_iterator hit = hits.begin(); hit != hits.end(); ++hit)
+    if (hit->id() == fHitCacheID)
+      maxKey = std::max(maxKey, hit->key());
+
+  fHitCached.assign(maxKey+1, 0);
+  fHitGlobalWire.resize(maxKey+1);
+  fHitTick.resize(maxKey+1);
+  fHitWireCm.resize(maxKey+1);
+  fHitDriftCm.resize(maxKey+1);
+  fHitCharge.resize(maxKey+1);
+
+  for (std::vector<art::Ptr<recob::Hit> >::const_iterator hit = hits.begin(); hit != hits.end(); ++hit) {
+    if (hit->id() != fHitCacheID or fHitCached[hit->key()])
+      continue;
+    size_t const key = hit->key();
+    TVector2 const coord = HitCoordinates(*hit);
+    TVector2 const pos = HitPosition(coord, (*hit)->WireID().planeID());
+    fHitGlobalWire[key] = coord.X();
+    fHitTick[key] = coord.Y();
+    fHitWireCm[key] = pos.X();
+    fHitDriftCm[key] = pos.Y();
+    fHitCharge[key] = (*hit)->Integral();
+    fHitCached[key] = 1;
+  }
+
+}
+
+void shower::EMShowerAlg::ClearHitCache() {
+
+  fHitCacheID = art::ProductID();
+  fHitCached.clear();
+  fHitGlobalWire.clear();
+  fHitTick.clear();
+  fHitWireCm.clear();
+  fHitDriftCm.clear();
+  fHitCharge.clear();
+
+}
+
+bool shower::EMShowerAlg::IsHitCached(art::Ptr<recob::Hit> const& hit) const {
+
+  return hit.id() == fHitCacheID and hit.key() < fHitCached.size() and fHitCached[hit.key()];
+
+}
+
+double shower::EMShowerAlg::HitCharge(art::Ptr<recob::Hit> const& hit) const {
+
+  if (IsHitCached(hit))
+    return fHitCharge[hit.key()];
+
+  return hit->Integral();
+
+}
+
 TVector2 shower::EMShowerAlg::HitCoordinates(art::Ptr<recob::Hit> const& hit) {
 
+  if (IsHitCached(hit))
+    return TVector2(fHitGlobalWire[hit.key()], fHitTick[hit.key()]);
+
   return TVector2(GlobalWire(hit->WireID()), hit->PeakTime());
 
 }
 
 TVector2 shower::EMShowerAlg::HitPosition(art::Ptr<recob::Hit> const& hit) {
 
+  if (IsHitCached(hit))
+    return TVector2(fHitWireCm[hit.key()], fHitDriftCm[hit.key()]);
+
   geo::PlaneID planeID = hit->WireID().planeID();
 
   return HitPosition(HitCoordinates(hit), planeID);
@@ -1286,40 +1393,35 @@ TVector2 shower::EMShowerAlg::HitPosition(art::Ptr<recob::Hit> const& hit) {
 
 TVector2 shower::EMShowerAlg::HitPosition(TVector2 const& pos, geo::PlaneID planeID) {
 
-  return TVector2(pos.X() * fGeom->WirePitch(planeID),
-		  fDetProp->ConvertTicksToX(pos.Y(), planeID));
+  return TVector2(pos.X() * fProjections.WirePitch(planeID),
+		  fProjections.TicksToX(pos.Y(), planeID));
 
 }
 
 double shower::EMShowerAlg::GlobalWire(const geo::WireID& wireID) {
 
-  double wireCentre[3];
-  fGeom->WireIDToWireGeo(wireID).GetCenter(wireCentre);
-
   double globalWire = -999;
-  if (fGeom->SignalType(wireID) == geo::kInduction) {
-    if (wireID.TPC % 2 == 0) globalWire = fGeom->WireCoordinate(wireCentre[1], wireCentre[2], wireID.Plane, 0, wireID.Cryostat);
-    else globalWire = fGeom->WireCoordinate(wireCentre[1], wireCentre[2], wireID.Plane, 1, wireID.Cryostat);
+  if (fProjections.SignalType(wireID) == geo::kInduction) {
+    globalWire = fProjections.ReferenceWireCoordinate(wireID);
   }
   else {
     // FOR COLLECTION WIRES, HARD CODE THE GEOMETRY FOR GIVEN DETECTORS
     // THIS _SHOULD_ BE TEMPORARY. GLOBAL WIRE SUPPORT IS BEING ADDED TO THE LARSOFT GEOMETRY AND SHOULD BE AVAILABLE SOON
     if (fDetector == "dune35t") {
-      unsigned int nwires = fGeom->Nwires(wireID.Plane, 0, wireID.Cryostat);
+      unsigned int nwires = fProjections.Nwires(geo::PlaneID(wireID.Cryostat, 0, wireID.Plane));
       if (wireID.TPC == 0 or wireID.TPC == 1) globalWire = wireID.Wire;
       else if (wireID.TPC == 2 or wireID.TPC == 3 or wireID.TPC == 4 or wireID.TPC == 5) globalWire = nwires + wireID.Wire;
       else if (wireID.TPC == 6 or wireID.TPC == 7) globalWire = (2*nwires) + wireID.Wire;
       else mf::LogError("BlurredClusterAlg") << "Error when trying to find a global induction plane coordinate for TPC " << wireID.TPC << " (geometry" << fDetector << ")";
     }
     else if (fDetector == "dune10kt") {
-      unsigned int nwires = fGeom->Nwires(wireID.Plane, 0, wireID.Cryostat);
+      unsigned int nwires = fProjections.Nwires(geo::PlaneID(wireID.Cryostat, 0, wireID.Plane));
       // Detector geometry has four TPCs, two on top of each other, repeated along z...
       int block = wireID.TPC / 4;
       globalWire = (nwires*block) + wireID.Wire;
     }
     else {
-      if (wireID.TPC % 2 == 0) globalWire = fGeom->WireCoordinate(wireCentre[1], wireCentre[2], wireID.Plane, 0, wireID.Cryostat);
-      else globalWire = fGeom->WireCoordinate(wireCentre[1], wireCentre[2], wireID.Plane, 1, wireID.Cryostat);
+      globalWire = fProjections.ReferenceWireCoordinate(wireID);
     }
   }
 
@@ -1353,8 +1455,8 @@ TVector2 shower::EMShowerAlg::ShowerCentre(const std::vector<art::Ptr<recob::Hit
   double totalCharge = 0;
   for (std::vector<art::Ptr<recob::Hit> >::const_iterator hit = showerHits.begin(); hit != showerHits.end(); ++hit) {
     pos = HitPosition(*hit);
-    chargePoint += (*hit)->Integral() * pos;
-    totalCharge += (*hit)->Integral();
+    chargePoint += HitCharge(*hit) * pos;
+    totalCharge += HitCharge(*hit);
   }
   TVector2 centre = chargePoint / totalCharge;
 
@@ -1389,8 +1491,9 @@ TVector2 shower::EMShowerAlg::Project3DPointOntoPlane(TVector3 const& point, geo
   else
     tpc = 0;
 
-  TVector2 wireTickPos = TVector2(fGeom->WireCoordinate(point.Y(), point.Z(), planeID.Plane, tpc % 2, 0),
-				  fDetProp->ConvertXToTicks(point.X(), planeID.Plane, tpc % 2, 0));
+  geo::PlaneID const refPlaneID(0, tpc % 2, planeID.Plane);
+  TVector2 wireTickPos = TVector2(fProjections.WireCoordinate(point.Y(), point.Z(), refPlaneID),
+				  fProjections.XToTicks(point.X(), refPlaneID));
 
   //return wireTickPos;
   return HitPosition(wireTickPos, planeID);
@@ -42,11 +42,14 @@
 #include "larreco/RecoAlg/PMAlg/PmaTrack3D.h"
 #include "larreco/RecoAlg/PMAlg/Utilities.h"
 #include "larreco/RecoAlg/ShowerEnergyAlg.h"
+#include "larreco/RecoAlg/PlaneProjectionTable.h"
 
 // C++
 #include <iostream>
 #include <map>
 #include <iterator>
+#include <algorithm>
+#include <mutex>
 
 // ROOT
 #include "TVector2.h"
@@ -132,6 +135,19 @@ public:
   /// <Tingjun to document>
   bool isCleanShower(std::vector<art::Ptr<recob::Hit> > const& hits);
 
+  /// Fills the plane projection table from the geometry (otherwise the services are asked for each hit); to be called at the beginning of each run
+  void UpdateGeometry();
+
+  /// Refreshes the tick to drift distance conversion of the plane projection table; to be called for each event
+  void UpdateDetectorProperties();
+
+  /// Projects the given hits once and keeps their wire/tick and cm coordinates and charge for the rest of the event.
+  /// HitCoordinates and HitPosition use the cache for these hits; the cache must not be filled while showers are being made.
+  void CacheHitPositions(std::vector<art::Ptr<recob::Hit> > const& hits);
+
+  /// Empties the hit projection cache
+  void ClearHitCache();
+
 private:
 
   /// Takes the shower hits in all views and ensure the ordering is consistent
@@ -158,6 +174,12 @@ private:
   /// Find the global wire position
   double GlobalWire(const geo::WireID& wireID);
 
+  /// Return whether the projections of this hit are in the cache
+  bool IsHitCached(art::Ptr<recob::Hit> const& hit) const;
+
+  /// Return the charge of this hit
+  double HitCharge(art::Ptr<recob::Hit> const& hit) const;
+
   /// Return the coordinates of this hit in global wire/tick space
   TVector2 HitCoordinates(art::Ptr<recob::Hit> const& hit);
 
@@ -205,6 +227,9 @@ private:
   detinfo::DetectorProperties const* fDetProp;
   art::ServiceHandle<art::TFileService> tfs;
 
+  // Geometry and drift conversions used for every hit
+  util::PlaneProjectionTable fProjections;
+
   // Algs used by this class
   shower::ShowerEnergyAlg fShowerEnergyAlg;
   calo::CalorimetryAlg fCalorimetryAlg;
@@ -213,6 +238,17 @@ private:
   int fDebug;
   std::string fDetector;
 
+  // Projections of the hits of the event, indexed by the key of the hit pointer
+  art::ProductID fHitCacheID;
+  std::vector<char> fHitCached;
+  std::vector<double> fHitGlobalWire, fHitTick;
+  std::vector<double> fHitWireCm, fHitDriftCm;
+  std::vector<double> fHitCharge;
+
+  // The projection matching code is not shown to be reentrant: serialise its use across all the
+  // instances, since parallel shower making gives each thread its own algorithm
+  static std::mutex fPMAMutex;
+
 
 
   // tmp
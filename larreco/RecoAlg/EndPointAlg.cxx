@@ -26,6 +26,8 @@ extern "C" {
 #include <fstream>
 #include <math.h>
 #include <algorithm>
+#include <map>
+#include <set>
 
 #include "TMath.h"
 
@@ -47,6 +49,135 @@ extern "C" {
 #include "larcore/Geometry/TPCGeo.h"
 #include "larcore/Geometry/PlaneGeo.h"
 
+namespace {
+
+  /// (wire, time bin) map stored in tiles of fixed size, allocated only where used
+  class TiledMap {
+  public:
+    static constexpr int kWires = 16;  ///< wires in a tile
+    static constexpr int kBins  = 64;  ///< time bins in a tile
+    static constexpr int kCells = kWires*kBins;
+    static constexpr int kHalo  = 3;   ///< half size of the 7x7 windows
+    static constexpr int kPatchWires = kWires + 2*kHalo;
+    static constexpr int kPatchBins  = kBins + 2*kHalo;
+
+    typedef std::pair<int, int> TileID_t; ///< (wire, time bin) of the tile, in units of tiles
+
+    /// The tile, nullptr if it was never created
+    const double* Tile(TileID_t const& id) const
+      {
+	auto it = fTiles.find(id);
+	return (it == fTiles.end())? nullptr: it->second.data();
+      }
+
+    /// The tile, created with all the cells at 0 if needed
+    double* MakeTile(TileID_t const& id)
+      {
+	auto& tile = fTiles[id];
+	if(tile.empty()) tile.resize(kCells, 0.);
+	return tile.data();
+      }
+
+    bool HasTile(TileID_t const& id) const { return fTiles.count(id) > 0; }
+
+    double& Cell(int wire, int bin)
+      { return MakeTile(TileID_t(wire/kWires, bin/kBins))[(wire%kWires)*kBins + bin%kBins]; }
+
+    double Value(int wire, int bin) const
+      {
+	const double* tile = Tile(TileID_t(wire/kWires, bin/kBins));
+	return tile? tile[(wire%kWires)*kBins + bin%kBins]: 0.;
+      }
+
+    /// Copies the tile with its halo into patch, kPatchWires rows of kPatchBins;
+    /// the coordinates are clamped to the map, as for the dense map
+    void Gather(TileID_t const& id, int nWires, int nBins, std::vector<double>& patch) const
+      {
+	patch.assign(kPatchWires*kPatchBins, 0.);
+	for(int r = 0; r < kPatchWires; ++r){
+	  const int wire = std::min(std::max(id.first*kWires - kHalo + r, 0), nWires - 1);
+	  const double* tile = nullptr;
+	  int tileBin = -1;
+	  for(int c = 0; c < kPatchBins; ++c){
+	    const int bin = std::min(std::max(id.second*kBins - kHalo + c, 0), nBins - 1);
+	    if(bin/kBins != tileBin){
+	      tileBin = bin/kBins;
+	      tile = Tile(TileID_t(wire/kWires, tileBin));
+	    }
+	    if(tile) patch[r*kPatchBins + c] = tile[(wire%kWires)*kBins + bin%kBins];
+	  }
+	}
+      }
+
+  private:
+    std::map<TileID_t, std::vector<double> > fTiles;
+  }; // class TiledMap
+
+  //-----------------------------------------------------------------------------
+  // Adds the convolution of the patch with the 7x7 window to the tile.
+  // Each cell sums the window cells in the same order as the dense map; the
+  // inner loop runs along the time bins of a wire and can be vectorised.
+  void ConvolutePatch(std::vector<double> const& patch, const double* weight, double* tile)
+  {
+    int n = 0;
+    for(int i = 0; i < 7; ++i){
+      for(int j = 0; j < 7; ++j, ++n){
+	const double wn = weight[n];
+	for(int dw = 0; dw < TiledMap::kWires; ++dw){
+	  const double* in  = patch.data() + (dw + i)*TiledMap::kPatchBins + j;
+	  double*       out = tile + dw*TiledMap::kBins;
+	  for(int dt = 0; dt < TiledMap::kBins; ++dt) out[dt] += wn*in[dt];
+	}
+      }
+    }
+  }
+
+  //-----------------------------------------------------------------------------
+  // Harris cornerness of the tile from the patches of the two gradients
+  void CornernessPatch(std::vector<double> const& patchA, std::vector<double> const& patchB,
+		       const double* weight, double* tile)
+  {
+    std::vector<double> AA(TiledMap::kCells, 0.), BB(TiledMap::kCells, 0.), CC(TiledMap::kCells, 0.);
+    int n = 0;
+    for(int i = 0; i < 7; ++i){
+      for(int j = 0; j < 7; ++j, ++n){
+	const double wn = weight[n];
+	for(int dw = 0; dw < TiledMap::kWires; ++dw){
+	  const int offset = (dw + i)*TiledMap::kPatchBins + j;
+	  const double* a = patchA.data() + offset;
+	  const double* b = patchB.data() + offset;
+	  double* aa = AA.data() + dw*TiledMap::kBins;
+	  double* bb = BB.data() + dw*TiledMap::kBins;
+	  double* cc = CC.data() + dw*TiledMap::kBins;
+	  for(int dt = 0; dt < TiledMap::kBins; ++dt){
+	    aa[dt] += wn*(a[dt]*a[dt]);
+	    bb[dt] += wn*(b[dt]*b[dt]);
+	    cc[dt] += wn*a[dt]*b[dt];
+	  }
+	}
+      }
+    }
+    for(int k = 0; k < TiledMap::kCells; ++k)
+      tile[k] = ((AA[k] + BB[k]) > 0)? (AA[k]*BB[k] - CC[k]*CC[k])/(AA[k] + BB[k]): 0.;
+  }
+
+  //-----------------------------------------------------------------------------
+  // The dense map has no gradient on its border: clears those cells of the tile
+  // (and the ones beyond the map)
+  void ClearBorder(TiledMap::TileID_t const& id, int nWires, int nBins, double* tile)
+  {
+    for(int dw = 0; dw < TiledMap::kWires; ++dw){
+      const int wire = id.first*TiledMap::kWires + dw;
+      for(int dt = 0; dt < TiledMap::kBins; ++dt){
+	const int bin = id.second*TiledMap::kBins + dt;
+	if(wire < 1 || wire >= nWires - 1 || bin < 1 || bin >= nBins - 1)
+	  tile[dw*TiledMap::kBins + dt] = 0.;
+      }
+    }
+  }
+
+} // local namespace
+
 //-----------------------------------------------------------------------------
 cluster::EndPointAlg::EndPointAlg(fhicl::ParameterSet const& pset) 
 {
@@ -67,6 +198,7 @@ void cluster::EndPointAlg::reconfigure(fhicl::ParameterSet const& p)
   fWindow        = p.get< int    >("Window");
   fThreshold     = p.get< double >("Threshold");
   fSaveVertexMap = p.get< int    >("SaveVertexMap");
+  fSparseTiles   = p.get< bool   >("SparseTiles", false);
 }
 
 //-----------------------------------------------------------------------------
@@ -132,6 +264,188 @@ void cluster::EndPointAlg::VSSaveBMPFile(const char *fileName, unsigned char *pi
   bmpFile.write((const char *)pix, dx*dy);
 }
 
+//-----------------------------------------------------------------------------
+// Same cornerness as the dense map in EndPoint(), but only the tiles that can
+// contribute to the cells with a hit are filled: the memory and the time
+// follow the area covered by the hits instead of the size of the plane.
+void cluster::EndPointAlg::SparseCornerness(std::vector<MapHit>          const& hit,
+					    unsigned int                        numberwires,
+					    unsigned int                        numbertimesamples,
+					    std::vector<CornerCandidate>      & candidates)
+{
+  typedef TiledMap::TileID_t TileID_t;
+
+  //gaussian window definitions, as in EndPoint()
+  double  w[49] = {0.};
+  double wx[49] = {0.};
+  double wy[49] = {0.};
+  int ctr = 0;
+  for(int i = -3; i < 4; ++i){
+    for(int j = 3; j > -4; --j){
+      w[ctr] = Gaussian(i, j, fGsigma);
+      wx[ctr] = GaussianDerivativeX(i,j);
+      wy[ctr] = GaussianDerivativeY(i,j);
+      ++ctr;
+    }
+  }
+
+  candidates.clear();
+  const int nWires = numberwires;
+  const unsigned int ticksPerBin = numbertimesamples / fTimeBins;
+  const float TicksPerBin = ticksPerBin;
+  const int nWireTiles = (nWires + TiledMap::kWires - 1) / TiledMap::kWires;
+  const int nBinTiles  = (fTimeBins + TiledMap::kBins - 1) / TiledMap::kBins;
+
+  // pixelization of the hits; bins out of the map are dropped
+  TiledMap hitMap;
+  for(auto const& h : hit){
+    const float center = h.peakTime, sigma = h.rms;
+    const int iFirstBin = int((center - 3*sigma) / TicksPerBin),
+      iLastBin = int((center + 3*sigma) / TicksPerBin);
+    for(int iBin = std::max(iFirstBin, 0); iBin <= std::min(iLastBin, fTimeBins - 1); ++iBin){
+      const float bin_center = iBin * TicksPerBin;
+      hitMap.Cell(h.wire, iBin) += Gaussian(bin_center, center, sigma);
+    }
+  }
+
+  // cells coinciding with a hit, with the first hit matching each
+  std::map<std::pair<int, int>, size_t> cells;
+  for(size_t i = 0; i < hit.size(); ++i){
+    const int wire = hit[i].wire;
+    if(wire < 1 || wire >= nWires - 1) continue;
+    const float peak = hit[i].peakTime, rms = hit[i].rms;
+    int first = 1, last = fTimeBins - 2;
+    if(ticksPerBin > 0){
+      first = std::max(first, int(std::floor((peak - rms) / ticksPerBin)) - 1);
+      last  = std::min(last,  int(std::ceil ((peak + rms) / ticksPerBin)) + 1);
+    }
+    for(int timebin = first; timebin <= last; ++timebin){
+      // as recob::Hit::TimeDistanceAsRMS()
+      const float time = timebin*ticksPerBin;
+      if(std::abs((time - peak) / rms) < 1.)
+	cells.emplace(std::make_pair(wire, timebin), i);
+    }
+  }
+
+  // tiles of the cornerness, and of the gradients around them that see some hit
+  std::set<TileID_t> cornerTiles, gradientTiles;
+  for(auto const& cell : cells)
+    cornerTiles.emplace(cell.first.first / TiledMap::kWires, cell.first.second / TiledMap::kBins);
+
+  auto nearHits = [&](TileID_t const& id){
+    for(int tw = id.first - 1; tw <= id.first + 1; ++tw)
+      for(int tb = id.second - 1; tb <= id.second + 1; ++tb)
+	if(hitMap.HasTile(TileID_t(tw, tb))) return true;
+    return false;
+  };
+  for(auto const& id : cornerTiles){
+    for(int tw = std::max(id.first - 1, 0); tw <= std::min(id.first + 1, nWireTiles - 1); ++tw){
+      for(int tb = std::max(id.second - 1, 0); tb <= std::min(id.second + 1, nBinTiles - 1); ++tb){
+	if(nearHits(TileID_t(tw, tb))) gradientTiles.emplace(tw, tb);
+      }
+    }
+  }
+
+  // Gaussian derivative convolution
+  TiledMap gradA, gradB;
+  std::vector<double> patch;
+  for(auto const& id : gradientTiles){
+    hitMap.Gather(id, nWires, fTimeBins, patch);
+    double* tileA = gradA.MakeTile(id);
+    double* tileB = gradB.MakeTile(id);
+    ConvolutePatch(patch, wx, tileA);
+    ConvolutePatch(patch, wy, tileB);
+    ClearBorder(id, nWires, fTimeBins, tileA);
+    ClearBorder(id, nWires, fTimeBins, tileB);
+  }
+
+  // Gaussian smoothing convolution and cornerness
+  TiledMap cornerness;
+  std::vector<double> patchB;
+  for(auto const& id : cornerTiles){
+    gradA.Gather(id, nWires, fTimeBins, patch);
+    gradB.Gather(id, nWires, fTimeBins, patchB);
+    CornernessPatch(patch, patchB, w, cornerness.MakeTile(id));
+  }
+
+  for(auto const& cell : cells){
+    const double value = cornerness.Value(cell.first.first, cell.first.second);
+    if(value > 0)
+      candidates.push_back({ (unsigned int) cell.first.first, cell.first.second, value, cell.second });
+  }
+}
+
+//-----------------------------------------------------------------------------
+// End points of one view from the sparse map, with the same selection and
+// non-maximal suppression as the dense map in EndPoint(): the candidates are
+// scanned in the same order, so both give the same end points.
+void cluster::EndPointAlg::SparseEndPoints(std::vector< art::Ptr<recob::Hit> > const& hit,
+					   geo::View_t                                view,
+					   unsigned int                               numberwires,
+					   unsigned int                               numbertimesamples,
+					   std::vector<recob::EndPoint2D>           & vtxcol,
+					   std::vector< art::PtrVector<recob::Hit> > & vtxHitsOut)
+{
+  art::ServiceHandle<geo::Geometry> geom;
+  const detinfo::DetectorProperties* detp = lar::providerFrom<detinfo::DetectorPropertiesService>();
+
+  std::vector<MapHit> mapHits;
+  mapHits.reserve(hit.size());
+  for(auto const& h : hit) mapHits.push_back({ h->WireID().Wire, h->PeakTime(), h->RMS() });
+
+  std::vector<CornerCandidate> candidates;
+  SparseCornerness(mapHits, numberwires, numbertimesamples, candidates);
+
+  std::vector<double> Cornerness2;
+  for(auto const& c : candidates) Cornerness2.push_back(c.cornerness);
+  std::sort(Cornerness2.rbegin(), Cornerness2.rend());
+
+  // non-maximal suppression window, as in EndPoint()
+  double drifttick  = detp->DriftVelocity(detp->Efield(),detp->Temperature());
+  drifttick *= detp->SamplingRate()*1.e-3;
+  double wirepitch  = geom->WirePitch(0,1,0);
+  double corrfactor = drifttick/wirepitch;
+  const int wireWindow = (int)((fWindow*(numbertimesamples/fTimeBins)*corrfactor)+.5);
+
+  art::PtrVector<recob::Hit> vHits;
+  for(int vertexnum = 0; vertexnum < fMaxCorners && (unsigned int)vertexnum < Cornerness2.size(); ++vertexnum){
+    auto best = std::find_if(candidates.begin(), candidates.end(),
+			     [&](CornerCandidate const& c)
+			     { return c.cornerness == Cornerness2[vertexnum] && c.cornerness > 0.; });
+    if(best == candidates.end()) continue;
+
+    //thresholding
+    if(best->cornerness < (fThreshold*Cornerness2[0]))
+      vertexnum = fMaxCorners;
+    vHits.push_back(hit[best->hitIndex]);
+
+    // get the total charge from the associated hits
+    double totalQ = 0.;
+    for(size_t vh = 0; vh < vHits.size(); ++vh) totalQ += vHits[vh]->Integral();
+
+    recob::EndPoint2D endpoint(hit[best->hitIndex]->PeakTime(),
+			       hit[best->hitIndex]->WireID(),
+			       best->cornerness,
+			       vtxcol.size(),
+			       view,
+			       totalQ);
+    vtxcol.push_back(endpoint);
+    vtxHitsOut.push_back(vHits);
+    vHits.clear();
+
+    // same window and condition as for the dense map (with an unsigned wire there too)
+    const unsigned int wire = best->wire;
+    const int timebin = best->timebin;
+    for(auto& c : candidates){
+      const int wireout = c.wire, timebinout = c.timebin;
+      if(wireout < (int)wire-wireWindow || wireout > (int)wire+wireWindow) continue;
+      if(timebinout < timebin-fWindow || timebinout > timebin+fWindow) continue;
+      if(std::sqrt(pow(wire-wireout,2)+pow(timebin-timebinout,2))<fWindow)//circular window 
+	c.cornerness = 0;
+    }
+  }
+}
+
 //......................................................
 size_t cluster::EndPointAlg::EndPoint(const art::PtrVector<recob::Cluster>           & clusIn, 
 				      std::vector<recob::EndPoint2D>		     & vtxcol,
@@ -198,6 +512,13 @@ size_t cluster::EndPointAlg::EndPoint(const art::PtrVector<recob::Cluster>
 			       << numbertimesamples << " " 
 			       << fTimeBins;
     
+    // only the cells with a hit can become end points: the sparse map is
+    // computed around them (the vertex map image needs the dense map)
+    if(fSparseTiles && (int)wid.Plane != fSaveVertexMap){
+      SparseEndPoints(hit, view, numberwires, numbertimesamples, vtxcol, vtxHitsOut);
+      continue;
+    }
+    
     std::vector < std::vector < double > > MatrixAsum(numberwires);
     std::vector < std::vector < double > > MatrixBsum(numberwires);
     std::vector < std::vector < double > > hit_map(numberwires); //the map of hits 
@@ -13,6 +13,7 @@
 #include "art/Persistency/Common/Ptr.h" 
 #include "art/Persistency/Common/PtrVector.h" 
 #include "TMath.h"
+#include "larcore/SimpleTypesAndConstants/geo_types.h"
 #include <vector>
 #include <string>
 
@@ -39,9 +40,40 @@ namespace cluster {
 		    std::vector< art::PtrVector<recob::Hit> >      & vtxHitsOut,
 		    art::Event                                const& evt,
 		    std::string                               const& label);
+
+    /// Position of a hit on the map of a view
+    struct MapHit {
+      unsigned int wire;
+      float        peakTime;
+      float        rms;
+    };
+
+    /// Cell of the map where an end point can be found, with the first hit on it
+    struct CornerCandidate {
+      unsigned int wire;
+      int          timebin;
+      double       cornerness;
+      size_t       hitIndex;
+    };
+
+    /// Cornerness of the cells of the map with a hit, computed only in the
+    /// tiles around the hits; the values are the same as the ones of the dense
+    /// map of EndPoint(). The candidates are sorted by wire, then time bin.
+    void SparseCornerness(std::vector<MapHit>          const& hit,
+			  unsigned int                        numberwires,
+			  unsigned int                        numbertimesamples,
+			  std::vector<CornerCandidate>      & candidates);
     
   private:
 
+    /// Sparse end points of one view, with the same selection as EndPoint()
+    void SparseEndPoints(std::vector< art::Ptr<recob::Hit> > const& hit,
+			 geo::View_t                                view,
+			 unsigned int                               numberwires,
+			 unsigned int                               numbertimesamples,
+			 std::vector<recob::EndPoint2D>           & vtxcol,
+			 std::vector< art::PtrVector<recob::Hit> > & vtxHitsOut);
+
     double Gaussian(int x, int y, double sigma);
     double GaussianDerivativeX(int x, int y);
     double GaussianDerivativeY(int x, int y);
@@ -54,6 +86,7 @@ namespace cluster {
     int          fWindow;
     double       fThreshold;
     int          fSaveVertexMap;
+    bool         fSparseTiles;  ///< compute the map only in tiles around the hits
   };
     
 }
@@ -238,7 +238,8 @@ void cluster::HoughBaseAlg::reconfigure(fhicl::ParameterSet const& pset)
 }
 
 //------------------------------------------------------------------------------
-cluster::HoughTransform::HoughTransform()
+template <typename DISTMAP>
+cluster::BasicHoughTransform<DISTMAP>::BasicHoughTransform()
 {  
   //m_accum=NULL;
 }
@@ -253,13 +254,57 @@ size_t cluster::HoughBaseAlg::Transform(
   std::vector<protoTrack>                  *linesFound
   )
 {
+  /// Get the random number generator
+  art::ServiceHandle<art::RandomNumberGenerator> rng;
+
+  return DoTransform<HoughTransform>(hits, fpointId_to_clusterId, clusterId, nClusters, linesFound,
+                                     rng->getEngine(),
+                                     *lar::providerFrom<geo::Geometry>(),
+                                     *lar::providerFrom<detinfo::DetectorPropertiesService>(),
+                                     *lar::providerFrom<lariov::ChannelStatusService>(),
+                                     fSaveAccumulator);
+}
+
+
+//------------------------------------------------------------------------------
+size_t cluster::HoughBaseAlg::Transform(
+  std::vector<art::Ptr<recob::Hit> > const& hits,
+  std::vector<unsigned int>                *fpointId_to_clusterId,
+  unsigned int                              clusterId,
+  unsigned int                             *nClusters,
+  std::vector<protoTrack>                  *linesFound,
+  CLHEP::HepRandomEngine                   &engine,
+  geo::GeometryCore                   const&geom,
+  detinfo::DetectorProperties         const&detprop,
+  lariov::ChannelStatusProvider       const&channelStatus
+  )
+{
+  return DoTransform<ConcurrentHoughTransform>(hits, fpointId_to_clusterId, clusterId, nClusters, linesFound,
+                                               engine, geom, detprop, channelStatus, false);
+}
+
+
+//------------------------------------------------------------------------------
+template <typename TRANSFORM>
+size_t cluster::HoughBaseAlg::DoTransform(
+  std::vector<art::Ptr<recob::Hit> > const& hits,
+  std::vector<unsigned int>                *fpointId_to_clusterId,
+  unsigned int                              clusterId, // The id of the cluster we are examining
+  unsigned int                             *nClusters,
+  std::vector<protoTrack>                  *linesFound,
+  CLHEP::HepRandomEngine                   &engine,
+  geo::GeometryCore                   const&geometry,
+  detinfo::DetectorProperties         const&detectorProperties,
+  lariov::ChannelStatusProvider       const&channelStatusProvider,
+  bool                                      saveAccumulator
+  )
+{
 
   int nClustersTemp = *nClusters;
   
-  geo::GeometryCore const* geom = lar::providerFrom<geo::Geometry>();
-  const detinfo::DetectorProperties* detprop = lar::providerFrom<detinfo::DetectorPropertiesService>();
-  lariov::ChannelStatusProvider const* channelStatus
-    = lar::providerFrom<lariov::ChannelStatusService>();
+  geo::GeometryCore const* geom = &geometry;
+  const detinfo::DetectorProperties* detprop = &detectorProperties;
+  lariov::ChannelStatusProvider const* channelStatus = &channelStatusProvider;
 
   //  uint32_t     channel = hits[0]->Channel();
   unsigned int wire    = 0;
@@ -372,7 +417,7 @@ size_t cluster::HoughBaseAlg::Transform(
 
   mf::LogInfo("HoughBaseAlg") << "dealing with " << hits.size() << " hits";
   
-  HoughTransform c;
+  TRANSFORM c;
 
   ///Init specifies the size of the two-dimensional accumulator 
   ///(based on the arguments, number of wires and number of time samples). 
@@ -399,9 +444,6 @@ size_t cluster::HoughBaseAlg::Transform(
 
   unsigned int randInd;
 
-  /// Get the random number generator
-  art::ServiceHandle<art::RandomNumberGenerator> rng;
-  CLHEP::HepRandomEngine & engine = rng -> getEngine();
   CLHEP::RandFlat flat(engine);
   TStopwatch w;
   //float timeTotal = 0;
@@ -756,7 +798,7 @@ size_t cluster::HoughBaseAlg::Transform(
 
   // saves a bitmap image of the accumulator (useful for debugging), 
   // with scaling based on the maximum cell value
-  if(fSaveAccumulator){   
+  if(saveAccumulator){   
     unsigned char *outPix = new unsigned char [accDx*accDy];
     //finds the maximum cell in the accumulator for image scaling
     int cell, pix = 0, maxCell = 0;
@@ -786,21 +828,24 @@ size_t cluster::HoughBaseAlg::Transform(
 
 
 //------------------------------------------------------------------------------
-cluster::HoughTransform::~HoughTransform()
+template <typename DISTMAP>
+cluster::BasicHoughTransform<DISTMAP>::~BasicHoughTransform()
 {
 }
 
 
 //------------------------------------------------------------------------------
-inline int cluster::HoughTransform::GetCell(int row, int col) const {
+template <typename DISTMAP>
+inline int cluster::BasicHoughTransform<DISTMAP>::GetCell(int row, int col) const {
   return m_accum[row][col];
-} // cluster::HoughTransform::GetCell()
+} // cluster::BasicHoughTransform<>::GetCell()
 
 
 //------------------------------------------------------------------------------
 // returns a vector<int> where the first is the overall maximum,
 // the second is the max x value, and the third is the max y value.
-inline std::array<int, 3> cluster::HoughTransform::AddPointReturnMax(int x, int y)
+template <typename DISTMAP>
+inline std::array<int, 3> cluster::BasicHoughTransform<DISTMAP>::AddPointReturnMax(int x, int y)
 {
   if ((x > (int) m_dx) || (y > (int) m_dy) || x<0.0 || y<0.0) {
     std::array<int, 3> max;
@@ -813,7 +858,8 @@ inline std::array<int, 3> cluster::HoughTransform::AddPointReturnMax(int x, int
 
 
 //------------------------------------------------------------------------------
-inline bool cluster::HoughTransform::SubtractPoint(int x, int y)
+template <typename DISTMAP>
+inline bool cluster::BasicHoughTransform<DISTMAP>::SubtractPoint(int x, int y)
 {
   if ((x > (int) m_dx) || (y > (int) m_dy) || x<0.0 || y<0.0)
     return false;
@@ -823,7 +869,38 @@ inline bool cluster::HoughTransform::SubtractPoint(int x, int y)
 
 
 //------------------------------------------------------------------------------
-void cluster::HoughTransform::Init(unsigned int dx, 
+namespace {
+  
+  void SetNodeChunkSize(cluster::HoughBulkDistancesMap_t const*)
+  {
+    typedef cluster::HoughBulkDistancesMap_t DistancesMap_t;
+    
+    // set the custom allocator for nodes to allocate large chunks of nodes;
+    // one node is 40 bytes plus the size of the counters block.
+    // The math over there sets a bit less than 10 MiB per chunk.
+    // to find out the right type name to put here, comment out this line
+    // (it will suppress some noise), set bDebug to true in
+    // lardata/Utilities/BulkAllocator.h and run this module;
+    // all BulkAllocator instances will advertise that they are being created,
+    // mentioning their referring type. You can also simplyfy it by using the
+    // available typedefs, like here:
+    lar::BulkAllocator<
+      std::_Rb_tree_node
+        <std::pair<const DistancesMap_t::Key_t, DistancesMap_t::CounterBlock_t>>
+      >::SetChunkSize(
+      10 * ((1048576 / (40 + sizeof(DistancesMap_t::CounterBlock_t))) & ~0x1FFU)
+      );
+  } // SetNodeChunkSize(bulk)
+  
+  // the standard allocator has nothing to set up
+  void SetNodeChunkSize(cluster::HoughBaseMap_t const*) {}
+  
+} // local namespace
+
+
+//------------------------------------------------------------------------------
+template <typename DISTMAP>
+void cluster::BasicHoughTransform<DISTMAP>::Init(unsigned int dx, 
                                    unsigned int dy, 
                                    float rhores,
                                    unsigned int numACells)
@@ -832,21 +909,7 @@ void cluster::HoughTransform::Init(unsigned int dx,
   m_rhoResolutionFactor = rhores;
   
   m_accum.clear();
-  // set the custom allocator for nodes to allocate large chunks of nodes;
-  // one node is 40 bytes plus the size of the counters block.
-  // The math over there sets a bit less than 10 MiB per chunk.
-  // to find out the right type name to put here, comment out this line
-  // (it will suppress some noise), set bDebug to true in
-  // lardata/Utilities/BulkAllocator.h and run this module;
-  // all BulkAllocator instances will advertise that they are being created,
-  // mentioning their referring type. You can also simplyfy it by using the
-  // available typedefs, like here:
-  lar::BulkAllocator<
-    std::_Rb_tree_node
-      <std::pair<const DistancesMap_t::Key_t, DistancesMap_t::CounterBlock_t>>
-    >::SetChunkSize(
-    10 * ((1048576 / (40 + sizeof(DistancesMap_t::CounterBlock_t))) & ~0x1FFU)
-    );
+  SetNodeChunkSize((DistancesMap_t const*) nullptr);
   
   //m_accum.resize(m_numAngleCells);
   m_numAccumulated = 0;   
@@ -876,20 +939,22 @@ void cluster::HoughTransform::Init(unsigned int dx,
 
 
 //------------------------------------------------------------------------------
-void cluster::HoughTransform::GetEquation
+template <typename DISTMAP>
+void cluster::BasicHoughTransform<DISTMAP>::GetEquation
   (float row, float col, float &rho, float &theta) const
 {
   theta = (TMath::Pi()*row)/m_numAngleCells;
   rho   = (col - (m_rowLength/2.))/m_rhoResolutionFactor;
-} // cluster::HoughTransform::GetEquation()
+} // cluster::BasicHoughTransform<>::GetEquation()
 
 //------------------------------------------------------------------------------
-int cluster::HoughTransform::GetMax(int &xmax, int &ymax) const
+template <typename DISTMAP>
+int cluster::BasicHoughTransform<DISTMAP>::GetMax(int &xmax, int &ymax) const
 {
   int maxVal = -1;
   for(unsigned int i = 0; i < m_accum.size(); i++){
     
-    DistancesMap_t::PairValue_t max_counter = m_accum[i].get_max(maxVal);
+    typename DistancesMap_t::PairValue_t max_counter = m_accum[i].get_max(maxVal);
     if (max_counter.second > maxVal) {
       maxVal = max_counter.second;
       xmax = i;
@@ -903,7 +968,8 @@ int cluster::HoughTransform::GetMax(int &xmax, int &ymax) const
 //------------------------------------------------------------------------------
 // returns a vector<int> where the first is the overall maximum,
 // the second is the max x value, and the third is the max y value.
-std::array<int, 3> cluster::HoughTransform::DoAddPointReturnMax
+template <typename DISTMAP>
+std::array<int, 3> cluster::BasicHoughTransform<DISTMAP>::DoAddPointReturnMax
   (int x, int y, bool bSubtract /* = false */)
 {
   std::array<int, 3> max;
@@ -980,7 +1046,7 @@ std::array<int, 3> cluster::HoughTransform::DoAddPointReturnMax
       distMap.decrement(first_dist, end_dist);
     }
     else {
-      DistancesMap_t::PairValue_t max_counter
+      typename DistancesMap_t::PairValue_t max_counter
         = distMap.increment_and_get_max(first_dist, end_dist, max_val);
       
       if (max_counter.second > max_val) {
@@ -1002,7 +1068,7 @@ std::array<int, 3> cluster::HoughTransform::DoAddPointReturnMax
   //mf::LogVerbatim("HoughBaseAlg") << "Add point says xmax: " << *xmax << " ymax: " << *ymax << std::endl;
 
   return max;
-} // cluster::HoughTransform::DoAddPointReturnMax()
+} // cluster::BasicHoughTransform<>::DoAddPointReturnMax()
 
 
 //------------------------------------------------------------------------------
@@ -140,6 +140,10 @@
 #include "lardata/Utilities/CountersMap.h"
 
 namespace art { class Event; }
+namespace CLHEP { class HepRandomEngine; }
+namespace geo { class GeometryCore; }
+namespace detinfo { class DetectorProperties; }
+namespace lariov { class ChannelStatusProvider; }
 
 namespace recob { 
   class Hit;
@@ -470,11 +474,32 @@ namespace cluster {
   
 #define FC_DEVELOP 0
   
-  class HoughTransform {
+  /// rho -> # hits (for convenience)
+  typedef HoughTransformCounters<int, signed char, 64> HoughBaseMap_t;
+  
+  /// Special allocator for large chunks of pairs (turns out map won't use it)
+  typedef lar::BulkAllocator<HoughBaseMap_t::allocator_type::value_type>
+    HoughBulkPairAllocator_t;
+  
+  /// Type of map distance (discretized) =># hits,
+  /// #hits stored in counters allocated in blocks
+  typedef HoughTransformCounters<int, signed char, 64, HoughBulkPairAllocator_t>
+    HoughBulkDistancesMap_t;
+  
+  /**
+   * @brief Accumulator of the Hough transform
+   * @tparam DISTMAP type of map distance (discretized) => # hits
+   *
+   * The BulkAllocator behind HoughTransform is shared by all the accumulators
+   * and is not thread-safe: accumulators of transforms running concurrently
+   * are ConcurrentHoughTransform, which use the standard allocator.
+   */
+  template <typename DISTMAP>
+  class BasicHoughTransform {
   public:
     
-    HoughTransform();
-    ~HoughTransform();
+    BasicHoughTransform();
+    ~BasicHoughTransform();
      
     void Init
       (unsigned int dx, unsigned int dy, float rhores, unsigned int numACells);
@@ -495,17 +520,8 @@ namespace cluster {
 
   private:
     
-    /// rho -> # hits (for convenience)
-    typedef HoughTransformCounters<int, signed char, 64> BaseMap_t;
-    
-    /// Special allocator for large chunks of pairs (turns out map won't use it)
-    typedef lar::BulkAllocator<BaseMap_t::allocator_type::value_type>
-      BulkPairAllocator_t;
-    
-    /// Type of map distance (discretized) =># hits,
-    /// #hits stored in counters allocated in blocks
-    typedef HoughTransformCounters<int, signed char, 64, BulkPairAllocator_t>
-      DistancesMap_t;
+    /// Type of map distance (discretized) =># hits
+    typedef DISTMAP DistancesMap_t;
     
     /// Type of the Hough transform (angle, distance) map with custom allocator
     typedef std::vector<DistancesMap_t> HoughImage_t;
@@ -527,7 +543,13 @@ namespace cluster {
     std::array<int,3> DoAddPointReturnMax(int x, int y, bool bSubtract = false);
 
 
-  }; // class HoughTransform  
+  }; // class BasicHoughTransform
+  
+  /// Accumulator with the counters from the BulkAllocator
+  typedef BasicHoughTransform<HoughBulkDistancesMap_t> HoughTransform;
+  
+  /// Accumulator with the counters from the standard allocator, for concurrent transforms
+  typedef BasicHoughTransform<HoughBaseMap_t> ConcurrentHoughTransform;
 
 
 
@@ -565,6 +587,28 @@ namespace cluster {
                      unsigned int clusterId, // The id of the cluster we are examining
                      unsigned int *nClusters,
                      std::vector<protoTrack> *protoTracks);
+
+    /**
+     * @brief Same as above, but can be run concurrently
+     * @param engine random engine, different for each concurrent call
+     * @param geom geometry
+     * @param detprop detector properties
+     * @param channelStatus channel status
+     *
+     * The services are passed by the caller, the accumulator does not use the
+     * shared BulkAllocator and the accumulator bitmap is never saved.
+     * Concurrent calls must not share fpointId_to_clusterId, nClusters or
+     * protoTracks.
+     */
+    size_t Transform(std::vector<art::Ptr<recob::Hit> > const& hits,
+                     std::vector<unsigned int>     *fpointId_to_clusterId,
+                     unsigned int clusterId,
+                     unsigned int *nClusters,
+                     std::vector<protoTrack> *protoTracks,
+                     CLHEP::HepRandomEngine& engine,
+                     geo::GeometryCore const& geom,
+                     detinfo::DetectorProperties const& detprop,
+                     lariov::ChannelStatusProvider const& channelStatus);
     
     
     // interface to look for lines only on a set of hits,without slope and totalQ arrays
@@ -596,6 +640,19 @@ namespace cluster {
 
   private:
 
+    /// Transform() of the hits of one cluster with the accumulator TRANSFORM
+    template <typename TRANSFORM>
+    size_t DoTransform(std::vector<art::Ptr<recob::Hit> > const& hits,
+                       std::vector<unsigned int>     *fpointId_to_clusterId,
+                       unsigned int clusterId,
+                       unsigned int *nClusters,
+                       std::vector<protoTrack> *protoTracks,
+                       CLHEP::HepRandomEngine& engine,
+                       geo::GeometryCore const& geom,
+                       detinfo::DetectorProperties const& detprop,
+                       lariov::ChannelStatusProvider const& channelStatus,
+                       bool saveAccumulator);
+
     int    fMaxLines;                      ///< Max number of lines that can be found 
     int    fMinHits;                       ///< Min number of hits in the accumulator to consider 
                                            ///< (number of hits required to be considered a line).
@@ -14,6 +14,7 @@
 
 cluster::MergeClusterAlg::MergeClusterAlg(fhicl::ParameterSet const& pset) {
   this->reconfigure(pset);
+  fProjections.SetProviders(&*fGeom, nullptr);
   fTree = tfs->make<TTree>("MatchingVariables","MatchingVariables");
   fTree->Branch("Angle",&fAngle);
   fTree->Branch("Eigenvalue",&fEigenvalue);
@@ -152,17 +153,12 @@ double cluster::MergeClusterAlg::GlobalWire(geo::WireID const& wireID) {
 
   /// Find the global wire position
 
-  double wireCentre[3];
-  fGeom->WireIDToWireGeo(wireID).GetCenter(wireCentre);
-
   double globalWire;
-  if (fGeom->SignalType(wireID) == geo::kInduction) {
-    if (wireID.TPC % 2 == 0) globalWire = fGeom->WireCoordinate(wireCentre[1], wireCentre[2], wireID.Plane, 0, wireID.Cryostat);
-    else globalWire = fGeom->WireCoordinate(wireCentre[1], wireCentre[2], wireID.Plane, 1, wireID.Cryostat);
+  if (fProjections.SignalType(wireID) == geo::kInduction) {
+    globalWire = fProjections.ReferenceWireCoordinate(wireID);
   }
   else {
-    if (wireID.TPC % 2 == 0) globalWire = wireID.Wire + ((wireID.TPC/2) * fGeom->Nwires(wireID.Plane, 0, wireID.Cryostat));
-    else globalWire = wireID.Wire + ((int)(wireID.TPC/2) * fGeom->Nwires(wireID.Plane, 1, wireID.Cryostat));
+    globalWire = wireID.Wire + ((wireID.TPC/2) * fProjections.Nwires(geo::PlaneID(wireID.Cryostat, wireID.TPC % 2, wireID.Plane)));
   }
 
   return globalWire;
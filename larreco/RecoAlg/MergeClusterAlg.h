@@ -42,6 +42,7 @@
 #include "lardata/RecoBase/Vertex.h"
 #include "lardata/RecoBase/Shower.h"
 #include "lardata/Utilities/AssociationUtil.h"
+#include "larreco/RecoAlg/PlaneProjectionTable.h"
 
 #include "TTree.h"
 #include "TPrincipal.h"
@@ -65,6 +66,7 @@ public:
   double   FindMinSeparation(art::PtrVector<recob::Hit> const &cluster1, art::PtrVector<recob::Hit> const &cluster2);
   double   FindProjectedWidth(TVector2 const& centre1, TVector2 const& start1, TVector2 const& end1, TVector2 const& centre2, TVector2 const& start2, TVector2 const& end2);
   double   GlobalWire(geo::WireID const& wireID);
+  void     UpdateGeometry() { fProjections.UpdateGeometry(*fGeom); } ///< fills the wire table used by GlobalWire; call at each run
   TVector2 HitCoordinates(art::Ptr<recob::Hit> const& hit);
   int      MergeClusters(std::vector<art::PtrVector<recob::Hit> > const &planeClusters, std::vector<art::PtrVector<recob::Hit> > &clusters);
   void     reconfigure(fhicl::ParameterSet const& p);
@@ -80,6 +82,7 @@ private:
   // Create geometry and detector property handle
   art::ServiceHandle<geo::Geometry> fGeom;
   const detinfo::DetectorProperties* fDetProp;
+  util::PlaneProjectionTable fProjections;
   art::ServiceHandle<art::TFileService> tfs;
   art::ServiceHandle<cheat::BackTracker> backtracker;
 
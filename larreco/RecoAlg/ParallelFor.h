@@ -0,0 +1,65 @@
+/**
+ * @file   ParallelFor.h
+ * @brief  Runs a function over a range of independent items on a few threads
+ *
+ * Reconstruction algorithms process many independent items (cluster pairs,
+ * showers, wires...) and write each result in its own slot; this helper hands
+ * the items out to a pool of threads. The results do not depend on the number
+ * of threads as long as the function writes only to the slot of its item and
+ * to the state owned by its thread.
+ */
+
+#ifndef PARALLELFOR_H
+#define PARALLELFOR_H 1
+
+// C/C++ standard libraries
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <thread>
+#include <vector>
+
+
+namespace util {
+
+  /**
+   * @brief Calls func(index, thread) for each index in [0, n)
+   * @param n number of items
+   * @param nThreads maximum number of threads, including the calling one
+   * @param func function called for each item
+   *
+   * The items are handed out one at a time, in order, to up to nThreads
+   * threads; thread is the number of the thread running the item, from 0 to
+   * nThreads - 1, and 0 is the calling thread. With nThreads less than 2 all
+   * the items are processed in order by the calling thread.
+   * After the first exception no new item is started; the exception is
+   * rethrown once all the threads have stopped.
+   */
+  template <typename Func>
+  void ParallelFor(size_t n, size_t nThreads, Func func) {
+
+    std::atomic<size_t> next(0);
+    std::atomic<bool> failed(false);
+    std::exception_ptr error;
+
+    auto worker = [&](size_t thread) {
+      size_t index;
+      while (!failed && (index = next++) < n) {
+        try { func(index, thread); }
+        catch (...) { if (!failed.exchange(true)) error = std::current_exception(); }
+      }
+    };
+
+    std::vector<std::thread> threads;
+    for (size_t thread = 1; thread < nThreads && thread < n; ++thread)
+      threads.emplace_back(worker, thread);
+    worker(0);
+    for (auto& thread: threads) thread.join();
+
+    if (error) std::rethrow_exception(error);
+
+  } // ParallelFor()
+
+} // namespace util
+
+#endif // PARALLELFOR_H
@@ -0,0 +1,129 @@
+/**
+ * @file   PlaneProjectionTable.cxx
+ * @brief  Per-run tables of the wire plane projections used by 2D reconstruction
+ * @see    PlaneProjectionTable.h
+ */
+
+// our header
+#include "larreco/RecoAlg/PlaneProjectionTable.h"
+
+// LArSoft libraries
+#include "larcore/Geometry/GeometryCore.h"
+#include "larcore/Geometry/WireGeo.h"
+#include "lardata/DetectorInfo/DetectorProperties.h"
+
+// Framework libraries
+#include "cetlib/exception.h"
+
+
+//------------------------------------------------------------------------------
+size_t util::PlaneProjectionTable::PlaneIndex(geo::PlaneID const& planeID) const {
+
+  if (planeID.Cryostat + 1 < fCryostatFirstTPC.size()) {
+    size_t const tpcIndex = fCryostatFirstTPC[planeID.Cryostat] + planeID.TPC;
+    if (tpcIndex < fCryostatFirstTPC[planeID.Cryostat+1]) {
+      size_t const planeIndex = fTPCFirstPlane[tpcIndex] + planeID.Plane;
+      if (planeIndex < fTPCFirstPlane[tpcIndex+1]) return planeIndex;
+    }
+  }
+
+  throw cet::exception("PlaneProjectionTable")
+    << "plane C:" << planeID.Cryostat << " T:" << planeID.TPC << " P:" << planeID.Plane
+    << " is not in the table" << (HasGeometry()? "": " (geometry not loaded)") << "\n";
+
+} // util::PlaneProjectionTable::PlaneIndex()
+
+
+//------------------------------------------------------------------------------
+double util::PlaneProjectionTable::WirePitch(geo::PlaneID const& planeID) const {
+
+  if (!HasGeometry()) return GeometryProvider().WirePitch(planeID);
+  return fPitch[PlaneIndex(planeID)];
+
+} // util::PlaneProjectionTable::WirePitch()
+
+
+//------------------------------------------------------------------------------
+geo::SigType_t util::PlaneProjectionTable::SignalType(geo::PlaneID const& planeID) const {
+
+  if (!HasGeometry()) return GeometryProvider().SignalType(planeID);
+  return fSignalType[PlaneIndex(planeID)];
+
+} // util::PlaneProjectionTable::SignalType()
+
+
+//------------------------------------------------------------------------------
+unsigned int util::PlaneProjectionTable::Nwires(geo::PlaneID const& planeID) const {
+
+  if (!HasGeometry()) return GeometryProvider().Nwires(planeID.Plane, planeID.TPC, planeID.Cryostat);
+  return fNwires[PlaneIndex(planeID)];
+
+} // util::PlaneProjectionTable::Nwires()
+
+
+//------------------------------------------------------------------------------
+double util::PlaneProjectionTable::WireCoordinate(double y, double z, geo::PlaneID const& planeID) const {
+
+  if (!HasGeometry()) return GeometryProvider().WireCoordinate(y, z, planeID.Plane, planeID.TPC, planeID.Cryostat);
+  size_t const plane = PlaneIndex(planeID);
+  return fWireCoordY[plane] * y + fWireCoordZ[plane] * z + fWireCoordOffset[plane];
+
+} // util::PlaneProjectionTable::WireCoordinate()
+
+
+//------------------------------------------------------------------------------
+double util::PlaneProjectionTable::ReferenceWireCoordinate(geo::WireID const& wireID) const {
+
+  if (!HasGeometry()) {
+    geo::GeometryCore const& geom = GeometryProvider();
+    double wireCentre[3];
+    geom.WireIDToWireGeo(wireID).GetCenter(wireCentre);
+    return geom.WireCoordinate(wireCentre[1], wireCentre[2], wireID.Plane, wireID.TPC % 2, wireID.Cryostat);
+  }
+  return fRefWireCoordinate[fWireOffset[PlaneIndex(wireID)] + wireID.Wire];
+
+} // util::PlaneProjectionTable::ReferenceWireCoordinate()
+
+
+//------------------------------------------------------------------------------
+double util::PlaneProjectionTable::TicksToX(double ticks, geo::PlaneID const& planeID) const {
+
+  if (!HasDetectorProperties()) return DetPropProvider().ConvertTicksToX(ticks, planeID);
+  size_t const plane = PlaneIndex(planeID);
+  return fTickToXOffset[plane] + fTickToXScale[plane] * ticks;
+
+} // util::PlaneProjectionTable::TicksToX()
+
+
+//------------------------------------------------------------------------------
+double util::PlaneProjectionTable::XToTicks(double x, geo::PlaneID const& planeID) const {
+
+  if (!HasDetectorProperties()) return DetPropProvider().ConvertXToTicks(x, planeID);
+  size_t const plane = PlaneIndex(planeID);
+  return (x - fTickToXOffset[plane]) / fTickToXScale[plane];
+
+} // util::PlaneProjectionTable::XToTicks()
+
+
+//------------------------------------------------------------------------------
+geo::GeometryCore const& util::PlaneProjectionTable::GeometryProvider() const {
+
+  if (!fGeom) {
+    throw cet::exception("PlaneProjectionTable")
+      << "geometry table not filled and no geometry provider set\n";
+  }
+  return *fGeom;
+
+} // util::PlaneProjectionTable::GeometryProvider()
+
+
+//------------------------------------------------------------------------------
+detinfo::DetectorProperties const& util::PlaneProjectionTable::DetPropProvider() const {
+
+  if (!fDetProp) {
+    throw cet::exception("PlaneProjectionTable")
+      << "drift table not filled and no detector properties provider set\n";
+  }
+  return *fDetProp;
+
+} // util::PlaneProjectionTable::DetPropProvider()
@@ -0,0 +1,223 @@
+/**
+ * @file   PlaneProjectionTable.h
+ * @brief  Per-run tables of the wire plane projections used by 2D reconstruction
+ * @see    PlaneProjectionTable.cxx
+ *
+ * Hit positions are converted between (wire, tick) and (cm, cm) for every hit,
+ * often many times, by 2D reconstruction algorithms. Each conversion asks the
+ * geometry and the detector properties services. This table keeps the results
+ * that do not change within a run in flat arrays indexed by plane and wire.
+ */
+
+#ifndef PLANEPROJECTIONTABLE_H
+#define PLANEPROJECTIONTABLE_H 1
+
+// C/C++ standard libraries
+#include <cstddef>
+#include <limits>
+#include <vector>
+
+// LArSoft libraries
+#include "larcore/SimpleTypesAndConstants/geo_types.h"
+
+namespace geo { class GeometryCore; }
+namespace detinfo { class DetectorProperties; }
+
+
+namespace util {
+
+  /** **************************************************************************
+   * @brief Flat tables of the projections of all the wire planes
+   *
+   * The table has two parts, filled separately:
+   * - geometry (UpdateGeometry()): the pitch, signal type and number of wires
+   *   of each plane, the coefficients of the wire coordinate as a linear
+   *   function of (y, z), and, for each wire, the wire coordinate of its centre
+   *   in the "reference" TPC (TPC number modulo 2) of its cryostat, which is
+   *   the global wire used by the 2D shower algorithms;
+   * - drift (UpdateDetectorProperties()): the tick to x conversion of each
+   *   plane, x = offset + scale * tick.
+   *
+   * The geometry part is meant to be filled at the beginning of each run, the
+   * drift part, which is cheap, at each event. Once filled, all the methods
+   * are const and can be called from several threads.
+   *
+   * While a part is not filled, the queries are forwarded to the providers set
+   * with SetProviders(), so that an algorithm works the same whether its
+   * module fills the table or not; without providers they throw.
+   *
+   * The update methods are templates so that they can be used with any class
+   * with the same interface as geo::GeometryCore (resp.
+   * detinfo::DetectorProperties), like the mock providers of the unit test.
+   */
+  class PlaneProjectionTable {
+  public:
+
+    /// Sets the providers used while the table is not filled (either may be null)
+    void SetProviders(geo::GeometryCore const* geom, detinfo::DetectorProperties const* detprop)
+      { fGeom = geom; fDetProp = detprop; }
+
+    /// Fills the per-plane and per-wire geometry tables; clears the drift part
+    template <typename Geometry>
+    void UpdateGeometry(Geometry const& geom);
+
+    /// Fills the tick to x conversion of each plane (needs the geometry part)
+    template <typename DetectorProperties>
+    void UpdateDetectorProperties(DetectorProperties const& detprop);
+
+    /// Whether the geometry part of the table has been filled
+    bool HasGeometry() const { return !fPitch.empty(); }
+
+    /// Whether the drift part of the table has been filled
+    bool HasDetectorProperties() const { return fHasDetectorProperties; }
+
+    /// Index of the plane in the flat tables; throws if the plane is unknown
+    size_t PlaneIndex(geo::PlaneID const& planeID) const;
+
+    /// Wire pitch of the plane [cm]
+    double WirePitch(geo::PlaneID const& planeID) const;
+
+    /// Signal type of the plane
+    geo::SigType_t SignalType(geo::PlaneID const& planeID) const;
+
+    /// Number of wires in the plane
+    unsigned int Nwires(geo::PlaneID const& planeID) const;
+
+    /// Wire coordinate of the point (y, z) in the plane (same as GeometryCore::WireCoordinate)
+    double WireCoordinate(double y, double z, geo::PlaneID const& planeID) const;
+
+    /// Wire coordinate of the centre of the wire in the plane with the same number of TPC (number modulo 2);
+    /// NaN if that plane does not exist
+    double ReferenceWireCoordinate(geo::WireID const& wireID) const;
+
+    /// Drift coordinate [cm] of the tick in the plane
+    double TicksToX(double ticks, geo::PlaneID const& planeID) const;
+
+    /// Tick of the drift coordinate [cm] in the plane
+    double XToTicks(double x, geo::PlaneID const& planeID) const;
+
+  private:
+
+    // providers used while the table is not filled
+    geo::GeometryCore const* fGeom = nullptr;
+    detinfo::DetectorProperties const* fDetProp = nullptr;
+
+    // locating the planes
+    std::vector<size_t> fCryostatFirstTPC;  ///< index of the first TPC of each cryostat; one more entry at the end
+    std::vector<size_t> fTPCFirstPlane;     ///< index of the first plane of each TPC; one more entry at the end
+
+    // per plane
+    std::vector<double> fPitch;
+    std::vector<geo::SigType_t> fSignalType;
+    std::vector<unsigned int> fNwires;
+    std::vector<size_t> fWireOffset;        ///< index of the first wire of each plane in the per-wire table
+    std::vector<double> fWireCoordY;        ///< wire coordinate = fWireCoordY * y + fWireCoordZ * z + fWireCoordOffset
+    std::vector<double> fWireCoordZ;
+    std::vector<double> fWireCoordOffset;
+    bool fHasDetectorProperties = false;
+    std::vector<double> fTickToXOffset;     ///< x = fTickToXOffset + fTickToXScale * tick
+    std::vector<double> fTickToXScale;
+
+    // per wire
+    std::vector<double> fRefWireCoordinate;
+
+    /// Provider of the geometry, throws if not set
+    geo::GeometryCore const& GeometryProvider() const;
+
+    /// Provider of the detector properties, throws if not set
+    detinfo::DetectorProperties const& DetPropProvider() const;
+
+  }; // class PlaneProjectionTable
+
+} // namespace util
+
+
+//------------------------------------------------------------------------------
+template <typename Geometry>
+void util::PlaneProjectionTable::UpdateGeometry(Geometry const& geom) {
+
+  fCryostatFirstTPC.clear();
+  fTPCFirstPlane.clear();
+  fPitch.clear();
+  fSignalType.clear();
+  fNwires.clear();
+  fWireOffset.clear();
+  fWireCoordY.clear();
+  fWireCoordZ.clear();
+  fWireCoordOffset.clear();
+  fRefWireCoordinate.clear();
+  fHasDetectorProperties = false;
+  fTickToXOffset.clear();
+  fTickToXScale.clear();
+
+  // planes
+  for (unsigned int cryo = 0; cryo < geom.Ncryostats(); ++cryo) {
+    fCryostatFirstTPC.push_back(fTPCFirstPlane.size());
+    for (unsigned int tpc = 0; tpc < geom.NTPC(cryo); ++tpc) {
+      fTPCFirstPlane.push_back(fPitch.size());
+      for (unsigned int plane = 0; plane < geom.Nplanes(tpc, cryo); ++plane) {
+        geo::PlaneID const planeID(cryo, tpc, plane);
+        fPitch.push_back(geom.WirePitch(planeID));
+        fSignalType.push_back(geom.SignalType(planeID));
+        fNwires.push_back(geom.Nwires(plane, tpc, cryo));
+        fWireOffset.push_back(fRefWireCoordinate.size());
+        fRefWireCoordinate.resize(fRefWireCoordinate.size() + fNwires.back());
+
+        // the wire coordinate is linear in y and z
+        double const offset = geom.WireCoordinate(0., 0., plane, tpc, cryo);
+        fWireCoordOffset.push_back(offset);
+        fWireCoordY.push_back(geom.WireCoordinate(1., 0., plane, tpc, cryo) - offset);
+        fWireCoordZ.push_back(geom.WireCoordinate(0., 1., plane, tpc, cryo) - offset);
+      }
+    }
+  }
+  fCryostatFirstTPC.push_back(fTPCFirstPlane.size());
+  fTPCFirstPlane.push_back(fPitch.size());
+
+  // wires
+  for (unsigned int cryo = 0; cryo < geom.Ncryostats(); ++cryo) {
+    for (unsigned int tpc = 0; tpc < geom.NTPC(cryo); ++tpc) {
+      unsigned int const refTPC = tpc % 2;
+      for (unsigned int plane = 0; plane < geom.Nplanes(tpc, cryo); ++plane) {
+        size_t const planeIndex = PlaneIndex(geo::PlaneID(cryo, tpc, plane));
+        bool const hasReference = refTPC < geom.NTPC(cryo) && plane < geom.Nplanes(refTPC, cryo);
+        for (unsigned int wire = 0; wire < fNwires[planeIndex]; ++wire) {
+          double wireCentre[3];
+          geom.WireIDToWireGeo(geo::WireID(cryo, tpc, plane, wire)).GetCenter(wireCentre);
+          fRefWireCoordinate[fWireOffset[planeIndex] + wire] = hasReference
+            ? geom.WireCoordinate(wireCentre[1], wireCentre[2], plane, refTPC, cryo)
+            : std::numeric_limits<double>::quiet_NaN();
+        }
+      }
+    }
+  }
+
+} // util::PlaneProjectionTable::UpdateGeometry()
+
+
+//------------------------------------------------------------------------------
+template <typename DetectorProperties>
+void util::PlaneProjectionTable::UpdateDetectorProperties(DetectorProperties const& detprop) {
+
+  if (!HasGeometry()) return;
+
+  // the conversion is linear; the scale is taken over a long interval to limit rounding
+  double const ticks = 1000.;
+  fTickToXOffset.resize(fPitch.size());
+  fTickToXScale.resize(fPitch.size());
+  for (size_t cryo = 0; cryo + 1 < fCryostatFirstTPC.size(); ++cryo) {
+    for (size_t tpc = 0; tpc < fCryostatFirstTPC[cryo+1] - fCryostatFirstTPC[cryo]; ++tpc) {
+      size_t const tpcIndex = fCryostatFirstTPC[cryo] + tpc;
+      for (size_t plane = 0; plane < fTPCFirstPlane[tpcIndex+1] - fTPCFirstPlane[tpcIndex]; ++plane) {
+        geo::PlaneID const planeID(cryo, tpc, plane);
+        size_t const planeIndex = fTPCFirstPlane[tpcIndex] + plane;
+        fTickToXOffset[planeIndex] = detprop.ConvertTicksToX(0., planeID);
+        fTickToXScale[planeIndex] = (detprop.ConvertTicksToX(ticks, planeID) - fTickToXOffset[planeIndex]) / ticks;
+      }
+    }
+  }
+  fHasDetectorProperties = true;
+
+} // util::PlaneProjectionTable::UpdateDetectorProperties()
+
+#endif // PLANEPROJECTIONTABLE_H
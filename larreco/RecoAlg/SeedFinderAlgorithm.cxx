@@ -9,6 +9,7 @@
 #include <vector>
 #include <stdint.h>
 #include <iostream>
+#include <algorithm>
 
 #include "messagefacility/MessageLogger/MessageLogger.h"
 #include "art/Framework/Principal/Event.h"
@@ -172,7 +173,10 @@ namespace trkf {
         //    2: point thrown but unused
         //    3: flag to terminate seed finding
         
-        std::vector<char> PointStatus(spts.size(),0);
+        SpacePointStatus PointStatus(spts.size());
+        
+        // Hits which may have status 2 (every hit with status 2 is in here)
+        std::vector<int> SeedHits;
         
         std::vector<std::map<geo::View_t, std::vector<int> > > WhichHitsPerSeed;
         
@@ -198,11 +202,11 @@ namespace trkf {
                     for(size_t iH=0; iH!=HitsPerSpacePoint.at(PointsUsed.at(iP)).size(); ++iH)
                     {
                         int UsedHitID = HitsPerSpacePoint.at(PointsUsed.at(iP)).at(iH);
-                        HitStatus[UsedHitID] = 2;
+                        SetHitStatus(HitStatus, SeedHits, UsedHitID, 2);
                     }
                 }
-                PointStatus[PointsUsed.at(0)] = 1;
-                ConsolidateSeed(TheSeed, HitsFlat, HitStatus, OrgHits, false);
+                PointStatus.Set(PointsUsed.at(0), 1);
+                ConsolidateSeed(TheSeed, HitsFlat, HitStatus, SeedHits, OrgHits, false);
                 
             }
             
@@ -210,23 +214,18 @@ namespace trkf {
             {
                 if(fRefits>0)
                 {
-                    std::vector<char> HitStatusGood;
+                    // Only hits with status 2 change in a refit, so only those are saved
+                    std::vector<int> SeedHitsGood;
                     recob::Seed      SeedGood;
                     for(size_t r=0; r!=(unsigned int)fRefits; ++r)
                     {
                         double PrevLength = TheSeed.GetLength();
                         
+                        CompactSeedHits(HitStatus, SeedHits);
                         SeedGood =      TheSeed;
-                        HitStatusGood = HitStatus;
+                        SeedHitsGood =  SeedHits;
                         
-                        std::vector<int> PresentHitList;
-                        for(size_t iH=0; iH!=HitStatus.size(); ++iH)
-                        {
-                            if(HitStatus[iH]==2)
-                            {
-                                PresentHitList.push_back(iH);
-                            }
-                        }
+                        std::vector<int> PresentHitList(SeedHits);
                         double pt[3], dir[3], err[3];
                         
                         TheSeed.GetPoint(pt,err);
@@ -256,14 +255,14 @@ namespace trkf {
                         
                         
                         if(TheSeed.IsValid())
-                            ConsolidateSeed(TheSeed, HitsFlat, HitStatus, OrgHits, fExtendSeeds);
+                            ConsolidateSeed(TheSeed, HitsFlat, HitStatus, SeedHits, OrgHits, fExtendSeeds);
                         
                         // if we accidentally invalidated the seed, go back to the old one and escape
                         else
                         {
                             // If we invalidated the seed, go back one interaction
                             //  and kill the loop
-                            HitStatus = HitStatusGood;
+                            RestoreSeedHits(HitStatus, SeedHits, SeedHitsGood);
                             TheSeed   = SeedGood;
                             break;
                         }
@@ -283,20 +282,20 @@ namespace trkf {
                 WhichHitsPerSeed.push_back(std::map<geo::View_t, std::vector<int> >());
                 
                 art::PtrVector<recob::Hit> HitsWithThisSeed;
-                for(size_t iH=0; iH!=HitStatus.size(); ++iH)
+                CompactSeedHits(HitStatus, SeedHits);
+                for(size_t i=0; i!=SeedHits.size(); ++i)
                 {
-                    if(HitStatus.at(iH)==2)
+                    int iH = SeedHits[i];
+                    WhichHitsPerSeed.at(WhichHitsPerSeed.size()-1)[HitsFlat[iH]->View()].push_back(iH);
+                    HitsWithThisSeed.push_back(HitsFlat.at(iH));
+                    HitStatus.at(iH)=1;
+                    
+                    for(size_t iSP=0; iSP!=SpacePointsPerHit.at(iH).size(); ++iSP)
                     {
-                        WhichHitsPerSeed.at(WhichHitsPerSeed.size()-1)[HitsFlat[iH]->View()].push_back(iH);
-                        HitsWithThisSeed.push_back(HitsFlat.at(iH));
-                        HitStatus.at(iH)=1;
-                        
-                        for(size_t iSP=0; iSP!=SpacePointsPerHit.at(iH).size(); ++iSP)
-                        {
-                            PointStatus[SpacePointsPerHit.at(iH).at(iSP)] = 1;
-                        }
+                        PointStatus.Set(SpacePointsPerHit.at(iH).at(iSP), 1);
                     }
                 }
+                SeedHits.clear();
                 
                 
                 // Record that we used this set of hits with this seed in the return catalogue
@@ -309,19 +308,13 @@ namespace trkf {
             else
             {
                 // If it was not a good seed, throw out the top SP and try again
-                PointStatus.at(PointsUsed.at(0))=2;
-            }
-            
-            int TotalSPsUsed=0;
-            for(size_t i=0; i!=PointStatus.size(); ++i)
-            {
-                if(PointStatus[i]!=0) TotalSPsUsed++;
+                PointStatus.Set(PointsUsed.at(0), 2);
             }
             
-            if((int(spts.size()) - TotalSPsUsed) < fMinPointsInSeed)
+            if((int(spts.size()) - PointStatus.NUsed) < fMinPointsInSeed)
                 KeepChopping=false;
             
-            if((PointStatus[0]==3)||(PointStatus.size()==0)) KeepChopping=false;
+            if((PointStatus.Status.size()==0)||(PointStatus.Status[0]==3)) KeepChopping=false;
             
             PointsUsed.clear();
             
@@ -342,6 +335,7 @@ namespace trkf {
                 ListAllHits.push_back(i);
                 HitStatus[i]=2;
             }
+            SeedHits = ListAllHits;
             TVector3 SeedCenter(    0, 0, 0 );
             TVector3 SeedDirection( 0, 0, 0 );
             
@@ -369,16 +363,12 @@ namespace trkf {
             
             if(!ThrowOutSeed)
             {
-                ConsolidateSeed(TheSeed, HitsFlat, HitStatus, OrgHits, false);
+                ConsolidateSeed(TheSeed, HitsFlat, HitStatus, SeedHits, OrgHits, false);
                 
                 // Now we have consolidated, grab the right
                 //  hits to find the RMS and refitted direction
-                ListAllHits.clear();
-                for(size_t i=0; i!=HitStatus.size(); ++i)
-                {
-                    if(HitStatus.at(i)==2)
-                        ListAllHits.push_back(i);
-                }
+                CompactSeedHits(HitStatus, SeedHits);
+                ListAllHits = SeedHits;
                 std::vector<int>  HitsPerView;
                 GetCenterAndDirection(HitsFlat, ListAllHits, SeedCenter, SeedDirection, ViewRMS, HitsPerView);
                 
@@ -423,7 +413,6 @@ namespace trkf {
         // Tidy up
         SpacePointsPerHit.clear();
         HitsPerSpacePoint.clear();
-        PointStatus.clear();
         OrgHits.clear();
         HitStatus.clear();
         
@@ -444,11 +433,68 @@ namespace trkf {
     
     
     
+    //------------------------------------------------------------
+    SeedFinderAlgorithm::SpacePointStatus::SpacePointStatus(size_t NPoints)
+    : Status(NPoints,0)
+    , Lower(NPoints)
+    , Upper(NPoints)
+    , Top(int(NPoints)-1)
+    , NUsed(0)
+    {
+        for(int i=0; i!=int(NPoints); ++i)
+        {
+            Lower[i] = i-1;
+            Upper[i] = i+1;
+        }
+    }
+    
+    //------------------------------------------------------------
+    void SeedFinderAlgorithm::SpacePointStatus::Set(int Point, char NewStatus)
+    {
+        if((Status.at(Point)==0)&&(NewStatus!=0))
+        {
+            // unlink from the list of unused points
+            if(Lower[Point]>=0) Upper[Lower[Point]] = Upper[Point];
+            if(Upper[Point]<int(Status.size())) Lower[Upper[Point]] = Lower[Point];
+            else Top = Lower[Point];
+            NUsed++;
+        }
+        Status[Point] = NewStatus;
+    }
+    
+    //------------------------------------------------------------
+    void SeedFinderAlgorithm::SetHitStatus(std::vector<char>& HitStatus, std::vector<int>& SeedHits, int Hit, char NewStatus)
+    {
+        if((NewStatus==2)&&(HitStatus[Hit]!=2)) SeedHits.push_back(Hit);
+        HitStatus[Hit] = NewStatus;
+    }
+    
+    //------------------------------------------------------------
+    void SeedFinderAlgorithm::CompactSeedHits(std::vector<char> const& HitStatus, std::vector<int>& SeedHits)
+    {
+        std::sort(SeedHits.begin(), SeedHits.end());
+        SeedHits.erase(std::unique(SeedHits.begin(), SeedHits.end()), SeedHits.end());
+        SeedHits.erase(std::remove_if(SeedHits.begin(), SeedHits.end(),
+                                      [&HitStatus](int Hit) { return HitStatus[Hit]!=2; }),
+                       SeedHits.end());
+    }
+    
+    //------------------------------------------------------------
+    void SeedFinderAlgorithm::RestoreSeedHits(std::vector<char>& HitStatus, std::vector<int>& SeedHits, std::vector<int> const& SeedHitsGood)
+    {
+        for(size_t iH=0; iH!=SeedHits.size(); ++iH)
+            if(HitStatus[SeedHits[iH]]==2) HitStatus[SeedHits[iH]]=0;
+        for(size_t iH=0; iH!=SeedHitsGood.size(); ++iH)
+            HitStatus[SeedHitsGood[iH]]=2;
+        SeedHits = SeedHitsGood;
+    }
+    
     //------------------------------------------------------------
     // Latest extendseed method
     //
     
     void SeedFinderAlgorithm::ConsolidateSeed(recob::Seed& TheSeed, art::PtrVector<recob::Hit> const& HitsFlat, std::vector<char>& HitStatus,
+                                              std::vector<int>& SeedHits,
                                               std::vector< std::vector< std::vector<int> > >& OrgHits, bool Extend)
     {
         
@@ -460,25 +506,24 @@ namespace trkf {
         int NHitsThisSeed=0;
         
         double MinS = 1000, MaxS=-1000;
-        for(size_t i=0; i!=HitStatus.size(); ++i)
+        CompactSeedHits(HitStatus, SeedHits);
+        for(size_t iSH=0; iSH!=SeedHits.size(); ++iSH)
         {
-            if(HitStatus.at(i)==2)
+            size_t i = SeedHits[iSH];
+            double disp, s;
+            GetHitDistAndProj(TheSeed, HitsFlat.at(i),disp, s);
+            if(fabs(s)>1.2)
             {
-                double disp, s;
-                GetHitDistAndProj(TheSeed, HitsFlat.at(i),disp, s);
-                if(fabs(s)>1.2)
-                {
-                    // This hit is not rightfully part of this seed, toss it.
-                    HitStatus[i]=0;
-                }
-                else
-                {
-                    NHitsThisSeed++;
-                    
-                    if(s<MinS) MinS = s;
-                    if(s>MaxS) MaxS = s;
-                    HitsInThisSeed[HitsFlat.at(i)->View()][HitsFlat.at(i)->Channel()].push_back(i);
-                }
+                // This hit is not rightfully part of this seed, toss it.
+                HitStatus[i]=0;
+            }
+            else
+            {
+                NHitsThisSeed++;
+                
+                if(s<MinS) MinS = s;
+                if(s>MaxS) MaxS = s;
+                HitsInThisSeed[HitsFlat.at(i)->View()][HitsFlat.at(i)->Channel()].push_back(i);
             }
         }
         
@@ -518,7 +563,7 @@ namespace trkf {
                         {
                             NHitsThisSeed++;
                             
-                            HitStatus[OrgHits[View][c].at(h)]=2;
+                            SetHitStatus(HitStatus, SeedHits, OrgHits[View][c].at(h), 2);
                             
                             HitsInThisSeed[View][c].push_back(OrgHits[View][c].at(h));
                         }
@@ -699,7 +744,7 @@ namespace trkf {
                 for(size_t i=0; i!=ToAddPositiveS[n].size(); ++i)
                 {
                     if(ToAddPositiveS[n].at(i)<ExtendPositiveS)
-                        HitStatus[ToAddPositiveH[n].at(i)]=2;
+                        SetHitStatus(HitStatus, SeedHits, ToAddPositiveH[n].at(i), 2);
                     else
                         HitStatus[ToAddPositiveH[n].at(i)]=0;
                 }
@@ -707,7 +752,7 @@ namespace trkf {
                 for(size_t i=0; i!=ToAddNegativeS[n].size(); ++i)
                 {
                     if(ToAddNegativeS[n].at(i)>ExtendNegativeS)
-                        HitStatus[ToAddNegativeH[n].at(i)]=2;
+                        SetHitStatus(HitStatus, SeedHits, ToAddNegativeH[n].at(i), 2);
                     else
                         HitStatus[ToAddNegativeH[n].at(i)]=0;
                 }
@@ -766,7 +811,7 @@ namespace trkf {
     // Try to find one seed at the high Z end of a set of spacepoints
     //
     
-    recob::Seed  SeedFinderAlgorithm::FindSeedAtEnd(std::vector<recob::SpacePoint> const& Points, std::vector<char>& PointStatus, std::vector<int>& PointsInRange, art::PtrVector<recob::Hit> const& HitsFlat, std::vector< std::vector< std::vector<int> > >& OrgHits)
+    recob::Seed  SeedFinderAlgorithm::FindSeedAtEnd(std::vector<recob::SpacePoint> const& Points, SpacePointStatus& PointStatus, std::vector<int>& PointsInRange, art::PtrVector<recob::Hit> const& HitsFlat, std::vector< std::vector< std::vector<int> > >& OrgHits)
     {
         // This pointer will be returned later
         recob::Seed ReturnSeed;
@@ -777,27 +822,20 @@ namespace trkf {
         // Clear output vector
         PointsInRange.clear();
         
-        // Loop through hits looking for highest Z seedable point
+        // The highest Z seedable point is the top of the unused list
         TVector3 HighestZPoint;
-        bool NoPointFound=true;
-        int counter = Points.size()-1;
-        while((NoPointFound==true)&&(counter>=0))
+        bool NoPointFound=(PointStatus.Top<0);
+        if(!NoPointFound)
         {
-            if(PointStatus[counter]==0)
-            {
-                HighestZPoint = TVector3(Points.at(counter).XYZ()[0],
-                                         Points.at(counter).XYZ()[1],
-                                         Points.at(counter).XYZ()[2]);
-                NoPointFound=false;
-            }
-            else
-                counter--;
+            HighestZPoint = TVector3(Points.at(PointStatus.Top).XYZ()[0],
+                                     Points.at(PointStatus.Top).XYZ()[1],
+                                     Points.at(PointStatus.Top).XYZ()[2]);
         }
-        if(NoPointFound)
+        else if(PointStatus.Status.size()>0)
         {
             // We didn't find a high point at all
             //  - let the algorithm know to give up.
-            PointStatus[0]=3;
+            PointStatus.Set(0, 3);
         }
         
         // Now we have the high Z point, loop through collecting
@@ -806,25 +844,22 @@ namespace trkf {
         
         double TwiceLength = 2.0*fInitSeedLength;
         
-        for(int index=Points.size()-1; index!=-1; --index)
+        for(int index=PointStatus.Top; index!=-1; index=PointStatus.Lower[index])
         {
-            if(PointStatus[index]==0)
+            // first check z, then check total distance
+            //  (much faster, since most will be out of range in z anyway)
+            if( ( HighestZPoint[2] - Points.at(index).XYZ()[2] ) < TwiceLength)
             {
-                // first check z, then check total distance
-                //  (much faster, since most will be out of range in z anyway)
-                if( ( HighestZPoint[2] - Points.at(index).XYZ()[2] ) < TwiceLength)
+                double DistanceToHighZ =pow(
+                                            pow(HighestZPoint[1]-Points.at(index).XYZ()[1],2) +
+                                            pow(HighestZPoint[2]-Points.at(index).XYZ()[2],2),0.5 );
+                if( DistanceToHighZ < TwiceLength)
                 {
-                    double DistanceToHighZ =pow(
-                                                pow(HighestZPoint[1]-Points.at(index).XYZ()[1],2) +
-                                                pow(HighestZPoint[2]-Points.at(index).XYZ()[2],2),0.5 );
-                    if( DistanceToHighZ < TwiceLength)
-                    {
-                        PointsInRange.push_back(index);
-                        PointsUsed.push_back(Points.at(index));
-                    }
+                    PointsInRange.push_back(index);
+                    PointsUsed.push_back(Points.at(index));
                 }
-                else break;
             }
+            else break;
         }
         
         TVector3 SeedCenter(    0, 0, 0 );
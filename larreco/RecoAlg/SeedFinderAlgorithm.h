@@ -69,6 +69,35 @@ namespace trkf {
 
 
     
+    //----------------------
+    // Internal book keeping, public for the unit test
+    //----------------------
+
+    struct SpacePointStatus
+    {
+      SpacePointStatus(size_t NPoints);
+      void Set(int Point, char NewStatus);
+                                    // Set the status of a point, taking it off the unused list if needed
+
+      std::vector<char> Status;     // 0: unused, 1: used in seed, 2: thrown but unused, 3: terminate flag
+      std::vector<int>  Lower;      // For each unused point, the next unused point below it (-1 if none)
+      std::vector<int>  Upper;      // For each unused point, the next unused point above it (size if none)
+      int               Top;        // Highest unused point (-1 if none)
+      int               NUsed;      // Number of points with non-zero status
+    };
+                                    // The points are sorted in z, so the unused ones can be walked
+                                    //  from high z without visiting the used ones.
+
+    static void                 SetHitStatus(std::vector<char>& HitStatus, std::vector<int>& SeedHits, int Hit, char NewStatus);
+                                    // Set the status of a hit, keeping track of the hits which may be in the current seed (status 2)
+
+    static void                 CompactSeedHits(std::vector<char> const& HitStatus, std::vector<int>& SeedHits);
+                                    // Sort the list of possible seed hits, leaving only those with status 2
+
+    static void                 RestoreSeedHits(std::vector<char>& HitStatus, std::vector<int>& SeedHits, std::vector<int> const& SeedHitsGood);
+                                    // Go back to the seed hits saved before a refit. Hits which got status 2 since
+                                    //  had status 0 before.
+
   private:
 
     //----------------------
@@ -83,7 +112,7 @@ namespace trkf {
    
 
 
-    recob::Seed                 FindSeedAtEnd(std::vector<recob::SpacePoint> const&, std::vector<char>&, std::vector<int>&,
+    recob::Seed                 FindSeedAtEnd(std::vector<recob::SpacePoint> const&, SpacePointStatus&, std::vector<int>&,
 					      art::PtrVector<recob::Hit> const& HitsFlat, std::vector< std::vector< std::vector<int> > >& OrgHits);
                                     // Find one seed at high Z from the spacepoint collection given. Latter arguments are 
                                     //  for internal book keeping.
@@ -99,6 +128,7 @@ namespace trkf {
 
   
     void                        ConsolidateSeed(recob::Seed& TheSeed, art::PtrVector<recob::Hit> const&, std::vector<char>& HitStatus,
+						std::vector<int>& SeedHits,
 						std::vector< std::vector< std::vector<int> > >& OrgHits, bool Extend);
 
     void                        GetHitDistAndProj( recob::Seed const& ASeed,  art::Ptr<recob::Hit> const& AHit, double& disp, double& s);
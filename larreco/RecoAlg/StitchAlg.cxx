@@ -16,6 +16,7 @@
 
 // C/C++ standard libraries
 #include <time.h>
+#include <algorithm>
 #include <cmath>
 #include <iostream>
 #include <fstream>
@@ -59,16 +60,21 @@ void trkf::StitchAlg::FindHeadsAndTails( const art::Event& EvtArg, const std::st
  fHT.clear();
 
   EvtArg.getByLabel(trackModuleLabelArg,ftListHandle);
+  FindHeadsAndTails(*ftListHandle);
+}
 
+void trkf::StitchAlg::FindHeadsAndTails( const std::vector<recob::Track>& tracks )
+{
     // An element of fh and ft for each outer track. Keep the cos and sep parameters of the match and a string that indicates whether it's the second track's head or tail that gives the match, along with ii, jj, the indices of the outer and inner tracks.
     ft.clear(); 
     fh.clear();
 
-    int ntrack = ftListHandle->size();
+    int ntrack = tracks.size();
     //    std::cout << "StitchAlg.FindHeadsAndTails: Number of tracks in " << ntrack << std::endl;
+    FillEndpointGrid(tracks);
+    std::vector<int> nearTracks;
     for(int ii = 0; ii < ntrack; ++ii) {
-      art::Ptr<recob::Track> ptrack1(ftListHandle, ii);
-      const recob::Track& track1 = *ptrack1;
+      const recob::Track& track1 = tracks[ii];
       const TVector3 start1(track1.Vertex());
       const TVector3 end1(track1.End());
       const TVector3 start1Dir(track1.VertexDirection());
@@ -85,9 +91,20 @@ void trkf::StitchAlg::FindHeadsAndTails( const art::Event& EvtArg, const std::st
       bool tail(false);
       std::vector<art::Ptr <recob::Track> >::iterator ith, itt;
 
-      for(int jj = ii+1; jj < ntrack; ++jj) {
-	art::Ptr<recob::Track> ptrack2(ftListHandle, jj);
-	const recob::Track& track2 = *ptrack2;
+      // Only tracks with an endpoint within fSepTol of the head or tail of track1 can match it.
+      // The conflict checks at the end of the loop are still made as if all the later tracks were looked at.
+      nearTracks.clear();
+      TracksNear(start1, ii+1, nearTracks);
+      TracksNear(end1, ii+1, nearTracks);
+      std::sort(nearTracks.begin(), nearTracks.end());
+      nearTracks.erase(std::unique(nearTracks.begin(), nearTracks.end()), nearTracks.end());
+      int jjPrev = ii;
+
+      for(size_t in = 0; in < nearTracks.size(); ++in) {
+	int jj = nearTracks[in];
+	RepeatConflictChecks(headvv, tailvv, ii, jj - jjPrev - 1);
+	jjPrev = jj;
+	const recob::Track& track2 = tracks[jj];
 	const TVector3& start2(track2.Vertex());
 	const TVector3& end2(track2.End());
 	const TVector3& start2Dir(track2.VertexDirection());
@@ -188,58 +205,11 @@ void trkf::StitchAlg::FindHeadsAndTails( const art::Event& EvtArg, const std::st
 
 	// We've been careful to pick the best jj match for this iith track head and tail.
 	// Now we need to be sure that for the jjth track head/tail we don't have two ii trks.
-	if (headvv.size())
-	  {
-	    int otrk = std::get<2>(headvv.back()); // jj'th track for this iith trk
-	    // H or T of this jj'th trk we're matched to.
-	    std::string sotrkht(std::get<0>(headvv.back()));
-	    for (int kk=0;kk<ii;++kk)
-	      {
-		if (std::get<2>(fh.at(kk)) == otrk && !sotrkht.compare(std::get<0>(fh.at(kk)) ) )
-		  {
-		    // check matching sep and pick the best one. Either erase this
-		    // headvv (and it'll get null settings later below) or null out 
-		    // the parameters in fh.
-		    if (std::get<4>(headvv.back()) < std::get<4>(fh.at(kk)) && std::get<4>(headvv.back())!=0.0)
-		      {
-			auto tupTmp2 = std::make_tuple(std::string("NA"),kk,-12,0.0,0.0);
-			fh.at(kk) = tupTmp2;
-		      }
-		    else if (std::get<4>(headvv.back())!=0.0)
-		      {
-			headvv.pop_back();
-			break;
-		      }
-		  }
-	      }
-	  }
-	if (tailvv.size())
-	  {
-	    int otrk = std::get<2>(tailvv.back());  // jj'th track for this iith trk
-	    // H or T of this jj'th trk we're matched to.
-	    std::string sotrkht(std::get<0>(tailvv.back()));
-	    for (int kk=0;kk<ii;++kk)
-	      {
-		if (std::get<2>(ft.at(kk)) == otrk && !sotrkht.compare(std::get<0>(ft.at(kk)) ) )
-		  {
-		    // check matching sep and pick the best one. erase either this
-		    // tailvv or null out the parameters in ft.
-		    if (std::get<4>(tailvv.back()) < std::get<4>(ft.at(kk)) && std::get<4>(tailvv.back())!=0.0)
-		      {
-			auto tupTmp2 = std::make_tuple(std::string("NA"),kk,-12,0.0,0.0);
-			ft.at(kk) = tupTmp2;
-		      }
-		    else if (std::get<4>(tailvv.back())!=0.0)
-		      {
-			tailvv.pop_back();
-			break;
-		      }
-		  }
-	      }
-	  }
-
+	ResolveConflicts(headvv, fh, ii);
+	ResolveConflicts(tailvv, ft, ii);
 
       } // jj
+      RepeatConflictChecks(headvv, tailvv, ii, ntrack - jjPrev - 1);
       
       
       auto tupTmp2 = std::make_tuple(std::string("NA"),ii,-12,0.0,0.0);
@@ -256,6 +226,90 @@ void trkf::StitchAlg::FindHeadsAndTails( const art::Event& EvtArg, const std::st
 
 }
 
+void trkf::StitchAlg::FillEndpointGrid(const std::vector<recob::Track>& tracks)
+{
+  fEndpointGrid.clear();
+  if (fSepTol <= 0.) return; // nothing can match
+
+  for (size_t ii = 0; ii < tracks.size(); ++ii)
+    {
+      const recob::Track& track = tracks[ii];
+      for (const TVector3& pos : { track.Vertex(), track.End() })
+	{
+	  // a track end that is not finite does not match anything
+	  if (!std::isfinite(pos.X()) || !std::isfinite(pos.Y()) || !std::isfinite(pos.Z())) continue;
+	  auto key = std::make_tuple((long long)std::floor(pos.X()/fSepTol),
+				     (long long)std::floor(pos.Y()/fSepTol),
+				     (long long)std::floor(pos.Z()/fSepTol));
+	  std::vector<int>& cell = fEndpointGrid[key];
+	  if (cell.empty() || cell.back() != (int)ii) cell.push_back(ii);
+	}
+    }
+}
+
+void trkf::StitchAlg::TracksNear(const TVector3& pos, int first, std::vector<int>& trks) const
+{
+  if (fEndpointGrid.empty()) return;
+  if (!std::isfinite(pos.X()) || !std::isfinite(pos.Y()) || !std::isfinite(pos.Z())) return;
+
+  // look at the cells touched by a cube slightly larger than the separation tolerance
+  const double sep = 1.001*fSepTol;
+  const long long ix0 = std::floor((pos.X()-sep)/fSepTol), ix1 = std::floor((pos.X()+sep)/fSepTol);
+  const long long iy0 = std::floor((pos.Y()-sep)/fSepTol), iy1 = std::floor((pos.Y()+sep)/fSepTol);
+  const long long iz0 = std::floor((pos.Z()-sep)/fSepTol), iz1 = std::floor((pos.Z()+sep)/fSepTol);
+  for (long long ix = ix0; ix <= ix1; ++ix)
+    for (long long iy = iy0; iy <= iy1; ++iy)
+      for (long long iz = iz0; iz <= iz1; ++iz)
+	{
+	  auto cell = fEndpointGrid.find(std::make_tuple(ix, iy, iz));
+	  if (cell == fEndpointGrid.end()) continue;
+	  for (int trk : cell->second)
+	    if (trk >= first) trks.push_back(trk);
+	}
+}
+
+bool trkf::StitchAlg::ResolveConflicts(std::vector<HTMatch_t>& vv, std::vector<HTMatch_t>& f, int ii)
+{
+  if (!vv.size()) return false;
+
+  bool changed(false);
+  int otrk = std::get<2>(vv.back()); // jj'th track for this iith trk
+  // H or T of this jj'th trk we're matched to.
+  std::string sotrkht(std::get<0>(vv.back()));
+  for (int kk=0;kk<ii;++kk)
+    {
+      if (std::get<2>(f.at(kk)) == otrk && !sotrkht.compare(std::get<0>(f.at(kk)) ) )
+	{
+	  // check matching sep and pick the best one. Either erase this
+	  // vv (and it'll get null settings later) or null out
+	  // the parameters in f.
+	  if (std::get<4>(vv.back()) < std::get<4>(f.at(kk)) && std::get<4>(vv.back())!=0.0)
+	    {
+	      auto tupTmp2 = std::make_tuple(std::string("NA"),kk,-12,0.0,0.0);
+	      f.at(kk) = tupTmp2;
+	      changed = true;
+	    }
+	  else if (std::get<4>(vv.back())!=0.0)
+	    {
+	      vv.pop_back();
+	      return true;
+	    }
+	}
+    }
+  return changed;
+}
+
+void trkf::StitchAlg::RepeatConflictChecks(std::vector<HTMatch_t>& headvv, std::vector<HTMatch_t>& tailvv, int ii, int n)
+{
+  // the checks were made once for each track; once they change nothing they never will
+  for (int i = 0; i < n; ++i)
+    {
+      bool changed = ResolveConflicts(headvv, fh, ii);
+      changed = ResolveConflicts(tailvv, ft, ii) || changed;
+      if (!changed) break;
+    }
+}
+
 void trkf::StitchAlg::FirstStitch(const std::vector<art::PtrVector <recob::Track>>::iterator itvvArg, const std::vector <recob::Track>::iterator itvArg)
 {    
     // take the vector of tracks, walk through each track's vectors of xyz, dxdydz, etc 
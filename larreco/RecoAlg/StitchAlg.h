@@ -7,6 +7,9 @@
 #define STITCHALG_H
 
 // C/C++ standard libraries
+#include <map>
+#include <string>
+#include <tuple>
 #include <vector>
 
 // art libraries
@@ -34,24 +37,40 @@ class StitchAlg
 
   void reconfigure(fhicl::ParameterSet const& pset) ;
 
+  typedef std::tuple <std::string, int, int, double, double> HTMatch_t;
+
   void FindHeadsAndTails( const art::Event& e, const std::string& t);
+  // Matches the heads and tails of the tracks; FindHeadsAndTails(e, t) calls it on the tracks of the event
+  void FindHeadsAndTails( const std::vector<recob::Track>& tracks);
   void FirstStitch(const std::vector<art::PtrVector <recob::Track>>::iterator itvvArg, const std::vector <recob::Track>::iterator itvArg);
   void WalkStitch();
   bool CommonComponentStitch();
 
   void GetTrackComposites(std::vector <art::PtrVector <recob::Track> > & c) { c = fTrackComposite;};
   void GetTracks(std::vector <recob::Track>& t) { t = fTrackVec ;};
+  void GetHeadsAndTails(std::vector <HTMatch_t>& h, std::vector <HTMatch_t>& t) const { h = fh; t = ft; };
 
   art::Handle< std::vector< recob::Track > > ftListHandle;
 
  private:
 
+  // Bins the head and tail of every track in cubes of side fSepTol
+  void FillEndpointGrid(const std::vector<recob::Track>& tracks);
+  // Adds the tracks from first on with an endpoint that may be within fSepTol of pos
+  void TracksNear(const TVector3& pos, int first, std::vector<int>& trks) const;
+  // Resolves a conflict between the match of track ii and the ones of tracks kk < ii in f; true if anything changed
+  bool ResolveConflicts(std::vector<HTMatch_t>& vv, std::vector<HTMatch_t>& f, int ii);
+  // Repeats ResolveConflicts for head and tail as for n tracks that do not match track ii
+  void RepeatConflictChecks(std::vector<HTMatch_t>& headvv, std::vector<HTMatch_t>& tailvv, int ii, int n);
+
   std::vector <std::tuple <std::string, int, int, double, double> > fh;
   std::vector <std::tuple <std::string, int, int, double, double> > ft;
   int ftNo;
   double fCosAngTol;
   double fSepTol;
 
+  std::map <std::tuple <long long, long long, long long>, std::vector<int> > fEndpointGrid;
+
 
   std::vector <art::PtrVector <recob::Track> > fTrackComposite;
   std::vector <recob::Track> fTrackVec;
@@ -15,12 +15,138 @@ extern "C" {
 #include <stdint.h>
 #include <iostream>
 #include <iomanip>
+#include <array>
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include <mutex>
 
 #include "messagefacility/MessageLogger/MessageLogger.h"
 
 #include "larreco/RecoAlg/VertexFitAlg.h"
 
 
+namespace {
+
+  // Geometry factors and hits of one vertex fit. The hits of all the tracks
+  // are stored in flat arrays.
+  struct VtxFitData {
+    double WirePitch;
+    std::array<double, 3> OrthY;
+    std::array<double, 3> OrthZ;
+    std::array<double, 3> FirstWire;
+    std::vector<unsigned short> Track;
+    std::vector<unsigned short> Plane;
+    std::vector<double> Wire;
+    std::vector<double> HitX;
+    std::vector<double> HitXErr;
+  };
+
+  /////////////////////////////////////////
+  double VtxFitChisq(VtxFitData const& fd, std::vector<double> const& par,
+                     std::vector<double>* JtJ, std::vector<double>* Jtr)
+  {
+    // Returns the chisq (not divided by the DoF) of the parameters par, which are
+    // the vertex position followed by the Y, Z direction of each track. The residuals
+    // are the ones of fcnVtxPos. If JtJ and Jtr are given, they are filled with
+    // J^T J and J^T r where J is the derivative of the residuals r with respect to par
+    
+    const unsigned short npars = par.size();
+    if(JtJ) {
+      JtJ->assign(npars * npars, 0);
+      Jtr->assign(npars, 0);
+    }
+    
+    double chisq = 0;
+    // indices and values of the non-zero derivatives of one residual
+    std::array<unsigned short, 5> index;
+    std::array<double, 5> grad;
+    
+    for(unsigned int iht = 0; iht < fd.HitX.size(); ++iht) {
+      unsigned short ipl = fd.Plane[iht];
+      unsigned short indx = 3 + 2 * fd.Track[iht];
+      double DirY = par[indx];
+      double DirZ = par[indx + 1];
+      double vWire = par[1] * fd.OrthY[ipl] + par[2] * fd.OrthZ[ipl] - fd.FirstWire[ipl];
+      double DirU = fd.WirePitch * (DirY * fd.OrthY[ipl] + DirZ * fd.OrthZ[ipl]);
+      double dU = fd.WirePitch * (fd.Wire[iht] - vWire);
+      double dX;
+      index = {{0, 1, 2, indx, (unsigned short)(indx + 1)}};
+      grad = {{1, 0, 0, 0, 0}};
+      if(std::abs(DirU) < 1E-3 || std::abs(dU) < 1E-3) {
+        // vertex is on the wire
+        dX = par[0] - fd.HitX[iht];
+      } else {
+        double arg = 1 - DirY * DirY - DirZ * DirZ;
+        if(arg < 0) arg = 0;
+        double DirX = sqrt(arg);
+        if(fd.HitX[iht] < par[0]) DirX = -DirX;
+        dX = par[0] + (dU * DirX / DirU) - fd.HitX[iht];
+        // derivatives with respect to the vertex Y, Z (through dU)
+        grad[1] = -fd.WirePitch * fd.OrthY[ipl] * DirX / DirU;
+        grad[2] = -fd.WirePitch * fd.OrthZ[ipl] * DirX / DirU;
+        // and the direction (through DirX and DirU). DirX is held at 0 when the
+        // direction components are out of the physical range
+        double dDirXdY = 0, dDirXdZ = 0;
+        if(arg > 1E-12) {
+          dDirXdY = -DirY / DirX;
+          dDirXdZ = -DirZ / DirX;
+        }
+        grad[3] = dU * (dDirXdY * DirU - DirX * fd.WirePitch * fd.OrthY[ipl]) / (DirU * DirU);
+        grad[4] = dU * (dDirXdZ * DirU - DirX * fd.WirePitch * fd.OrthZ[ipl]) / (DirU * DirU);
+      }
+      double res = dX / fd.HitXErr[iht];
+      chisq += res * res;
+      if(!JtJ) continue;
+      for(unsigned short ii = 0; ii < 5; ++ii) {
+        double gi = grad[ii] / fd.HitXErr[iht];
+        if(gi == 0) continue;
+        (*Jtr)[index[ii]] += gi * res;
+        for(unsigned short jj = 0; jj < 5; ++jj) {
+          (*JtJ)[index[ii] * npars + index[jj]] += gi * grad[jj] / fd.HitXErr[iht];
+        } // jj
+      } // ii
+    } // iht
+    
+    return chisq;
+  } // VtxFitChisq
+
+  /////////////////////////////////////////
+  bool CholeskyDecompose(std::vector<double>& mat, unsigned short n)
+  {
+    // In place Cholesky decomposition of the symmetric n x n matrix mat.
+    // The lower triangle is replaced by L. Returns false if mat is not positive definite
+    for(unsigned short ii = 0; ii < n; ++ii) {
+      for(unsigned short jj = 0; jj <= ii; ++jj) {
+        double sum = mat[ii * n + jj];
+        for(unsigned short kk = 0; kk < jj; ++kk) sum -= mat[ii * n + kk] * mat[jj * n + kk];
+        if(ii == jj) {
+          if(!(sum > 0)) return false;
+          mat[ii * n + ii] = sqrt(sum);
+        } else {
+          mat[ii * n + jj] = sum / mat[jj * n + jj];
+        }
+      } // jj
+    } // ii
+    return true;
+  } // CholeskyDecompose
+
+  /////////////////////////////////////////
+  void CholeskySolve(std::vector<double> const& L, unsigned short n, std::vector<double>& vec)
+  {
+    // Solves L L^T x = vec in place
+    for(unsigned short ii = 0; ii < n; ++ii) {
+      for(unsigned short kk = 0; kk < ii; ++kk) vec[ii] -= L[ii * n + kk] * vec[kk];
+      vec[ii] /= L[ii * n + ii];
+    }
+    for(unsigned short ii = n; ii-- > 0;) {
+      for(unsigned short kk = ii + 1; kk < n; ++kk) vec[ii] -= L[kk * n + ii] * vec[kk];
+      vec[ii] /= L[ii * n + ii];
+    }
+  } // CholeskySolve
+
+} // namespace
+
 namespace trkf{
 
   VertexFitMinuitStruct VertexFitAlg::fVtxFitMinStr;
@@ -84,16 +210,223 @@ namespace trkf{
 
   /////////////////////////////////////////
   
+  VertexFitAlg::FitGeometry VertexFitAlg::GetFitGeometry(geo::WireID const& wid) const
+  {
+    FitGeometry fitGeom;
+    fitGeom.NPlanes = geom->Cryostat(wid.Cryostat).TPC(wid.TPC).Nplanes();
+    fitGeom.WirePitch = geom->WirePitch(wid);
+    for(unsigned int ipl = 0; ipl < fitGeom.NPlanes && ipl < 3; ++ipl) {
+      fitGeom.FirstWire[ipl] = -geom->WireCoordinate(0, 0, ipl, wid.TPC, wid.Cryostat);
+      fitGeom.OrthY[ipl] = geom->WireCoordinate(1, 0, ipl, wid.TPC, wid.Cryostat) + fitGeom.FirstWire[ipl];
+      fitGeom.OrthZ[ipl] = geom->WireCoordinate(0, 1, ipl, wid.TPC, wid.Cryostat) + fitGeom.FirstWire[ipl];
+    }
+    return fitGeom;
+  } // GetFitGeometry()
+
+  /////////////////////////////////////////
+  
   void VertexFitAlg::VertexFit(std::vector<std::vector<geo::WireID>> const& hitWID,
                                std::vector<std::vector<double>> const& hitX,
                                std::vector<std::vector<double>> const& hitXErr,
                                TVector3& VtxPos, TVector3& VtxPosErr,
                                std::vector<TVector3>& TrkDir, std::vector<TVector3>& TrkDirErr,
                                float& ChiDOF) const
+  {
+    if(fUseMinuit) {
+      VertexFitMinuit(hitWID, hitX, hitXErr, VtxPos, VtxPosErr, TrkDir, TrkDirErr, ChiDOF);
+      return;
+    }
+
+    // assume failure
+    ChiDOF = 9999;
+    
+    // the geometry is the one of the TPC of the first hit
+    if(hitWID.empty() || hitWID[0].empty()) return;
+    VertexFit(GetFitGeometry(hitWID[0][0]), hitWID, hitX, hitXErr, VtxPos, VtxPosErr, TrkDir, TrkDirErr, ChiDOF);
+  } // VertexFit()
+
+  /////////////////////////////////////////
+  
+  void VertexFitAlg::VertexFit(FitGeometry const& fitGeom,
+                               std::vector<std::vector<geo::WireID>> const& hitWID,
+                               std::vector<std::vector<double>> const& hitX,
+                               std::vector<std::vector<double>> const& hitXErr,
+                               TVector3& VtxPos, TVector3& VtxPosErr,
+                               std::vector<TVector3>& TrkDir, std::vector<TVector3>& TrkDirErr,
+                               float& ChiDOF)
+  {
+    // The passed set of hit WireIDs, X positions and X errors associated with a Track
+    // are fitted to a vertex position VtxPos. The fitted track direction vectors trkDir, TrkDirErr
+    // and ChiDOF are returned to the calling routine. The chisq is the one of fcnVtxPos and
+    // the errors are defined as in the Minuit fit (chisq/DOF increase of 1)
+    
+    // assume failure
+    ChiDOF = 9999;
+    
+    // need at least hits for two tracks
+    if(hitX.size() < 2) return;
+    if(hitX.size() != hitWID.size()) return;
+    if(hitX.size() != hitXErr.size()) return;
+    if(hitX.size() != TrkDir.size()) return;
+    
+    // number of variables = 3 for the vertex position + 2 * number of track directions
+    const unsigned short ntrks = hitX.size();
+    const unsigned short npars = 3 + 2 * ntrks;
+    unsigned int npts = 0, itk, iht;
+    for(itk = 0; itk < ntrks; ++itk) {
+      if(hitWID[itk].size() != hitX[itk].size() || hitXErr[itk].size() != hitX[itk].size()) return;
+      npts += hitX[itk].size();
+    }
+    
+    if(npts < ntrks) return;
+    
+    VtxFitData fd;
+    
+    if(fitGeom.NPlanes > 3) return;
+    
+    fd.WirePitch = fitGeom.WirePitch;
+    fd.FirstWire = fitGeom.FirstWire;
+    fd.OrthY = fitGeom.OrthY;
+    fd.OrthZ = fitGeom.OrthZ;
+    
+    fd.Track.reserve(npts);
+    fd.Plane.reserve(npts);
+    fd.Wire.reserve(npts);
+    fd.HitX.reserve(npts);
+    fd.HitXErr.reserve(npts);
+    for(itk = 0; itk < ntrks; ++itk) {
+      for(iht = 0; iht < hitX[itk].size(); ++iht) {
+        // a zero error would give an infinite chisq
+        if(!(hitXErr[itk][iht] > 0)) return;
+        fd.Track.push_back(itk);
+        fd.Plane.push_back(hitWID[itk][iht].Plane);
+        fd.Wire.push_back(hitWID[itk][iht].Wire);
+        fd.HitX.push_back(hitX[itk][iht]);
+        fd.HitXErr.push_back(hitXErr[itk][iht]);
+      } // iht
+    } // itk
+    
+    double dof = (double)npts - (double)npars;
+    if(dof < 1) return;
+    
+    // starting parameters: vertex position and the Y, Z track directions
+    std::vector<double> par(npars);
+    for(unsigned short ipar = 0; ipar < 3; ++ipar) par[ipar] = VtxPos[ipar];
+    for(itk = 0; itk < ntrks; ++itk) {
+      par[3 + 2 * itk] = TrkDir[itk](1);
+      par[4 + 2 * itk] = TrkDir[itk](2);
+    }
+    
+    std::vector<double> JtJ, Jtr, mat(npars * npars), step(npars), trial(npars);
+    double chisq = VtxFitChisq(fd, par, &JtJ, &Jtr);
+    bool fitOK = std::isfinite(chisq);
+    
+    // Levenberg-Marquardt iterations
+    double lambda = 1E-3;
+    for(unsigned short iter = 0; fitOK && iter < 100; ++iter) {
+      mat = JtJ;
+      for(unsigned short ii = 0; ii < npars; ++ii) mat[ii * npars + ii] += lambda * std::max(JtJ[ii * npars + ii], 1E-9);
+      if(!CholeskyDecompose(mat, npars)) {
+        lambda *= 10;
+        if(lambda > 1E10) break;
+        continue;
+      }
+      for(unsigned short ii = 0; ii < npars; ++ii) step[ii] = -Jtr[ii];
+      CholeskySolve(mat, npars, step);
+      // the Minuit fit has the same limits on the directions
+      for(unsigned short ii = 0; ii < npars; ++ii) {
+        trial[ii] = par[ii] + step[ii];
+        if(ii > 2) trial[ii] = std::max(-1.05, std::min(1.05, trial[ii]));
+      }
+      double newChisq = VtxFitChisq(fd, trial, nullptr, nullptr);
+      if(!(newChisq < chisq)) {
+        lambda *= 10;
+        if(lambda > 1E10) break;
+        continue;
+      }
+      par = trial;
+      bool converged = (chisq - newChisq) < 1E-6 * dof;
+      chisq = VtxFitChisq(fd, par, &JtJ, &Jtr);
+      lambda = std::max(lambda / 10, 1E-9);
+      if(converged) break;
+    } // iter
+    
+    // parameter errors from the covariance matrix, scaled to a unit change of chisq/DOF
+    mat = JtJ;
+    if(!fitOK || !CholeskyDecompose(mat, npars)) {
+      mf::LogVerbatim("VertexFitAlg")<<"VertexFit failed, using Minuit";
+      VertexFitMinuit(fitGeom, hitWID, hitX, hitXErr, VtxPos, VtxPosErr, TrkDir, TrkDirErr, ChiDOF);
+      return;
+    }
+    std::vector<double> parerr(npars);
+    for(unsigned short ii = 0; ii < npars; ++ii) {
+      std::fill(step.begin(), step.end(), 0);
+      step[ii] = 1;
+      CholeskySolve(mat, npars, step);
+      parerr[ii] = sqrt(dof * std::max(step[ii], 0.));
+    }
+    
+    ChiDOF = chisq / dof;
+    
+    // return the vertex position and errors
+    for(unsigned short ipar = 0; ipar < 3; ++ipar) {
+      VtxPos[ipar] = par[ipar];
+      VtxPosErr[ipar] = parerr[ipar];
+    }
+    // return the track directions and the direction errors if applicable
+    bool returnTrkDirErrs = (TrkDirErr.size() == TrkDir.size());
+    for(itk = 0; itk < ntrks; ++itk) {
+      unsigned short ipar = 3 + 2 * itk;
+      double arg = 1 - par[ipar] * par[ipar] - par[ipar + 1] * par[ipar + 1];
+      if(arg < 0) arg = 0;
+      TrkDir[itk](0) = sqrt(arg);
+      TrkDir[itk](1) = par[ipar];
+      TrkDir[itk](2) = par[ipar + 1];
+      if(returnTrkDirErrs) {
+        double errY = parerr[ipar] / par[ipar];
+        double errZ = parerr[ipar + 1] / par[ipar + 1];
+        TrkDirErr[itk](0) = sqrt(arg * (errY * errY + errZ * errZ));
+        TrkDirErr[itk](1) = parerr[ipar];
+        TrkDirErr[itk](2) = parerr[ipar + 1];
+      }
+    } // itk
+
+  } // VertexFit()
+
+  /////////////////////////////////////////
+  
+  void VertexFitAlg::VertexFitMinuit(std::vector<std::vector<geo::WireID>> const& hitWID,
+                               std::vector<std::vector<double>> const& hitX,
+                               std::vector<std::vector<double>> const& hitXErr,
+                               TVector3& VtxPos, TVector3& VtxPosErr,
+                               std::vector<TVector3>& TrkDir, std::vector<TVector3>& TrkDirErr,
+                               float& ChiDOF) const
+  {
+    // assume failure
+    ChiDOF = 9999;
+    
+    // the geometry is the one of the TPC of the first hit
+    if(hitWID.empty() || hitWID[0].empty()) return;
+    VertexFitMinuit(GetFitGeometry(hitWID[0][0]), hitWID, hitX, hitXErr, VtxPos, VtxPosErr, TrkDir, TrkDirErr, ChiDOF);
+  } // VertexFitMinuit()
+
+  /////////////////////////////////////////
+  
+  void VertexFitAlg::VertexFitMinuit(FitGeometry const& fitGeom,
+                               std::vector<std::vector<geo::WireID>> const& hitWID,
+                               std::vector<std::vector<double>> const& hitX,
+                               std::vector<std::vector<double>> const& hitXErr,
+                               TVector3& VtxPos, TVector3& VtxPosErr,
+                               std::vector<TVector3>& TrkDir, std::vector<TVector3>& TrkDirErr,
+                               float& ChiDOF)
   {
     // The passed set of hit WireIDs, X positions and X errors associated with a Track
     // are fitted to a vertex position VtxPos. The fitted track direction vectors trkDir, TrkDirErr
     // and ChiDOF are returned to the calling routine
+    
+    // fVtxFitMinStr and the Minuit callback are shared by all the instances
+    static std::mutex minuitMutex;
+    std::lock_guard<std::mutex> lock(minuitMutex);
 
     // assume failure
     ChiDOF = 9999;
@@ -111,24 +444,19 @@ namespace trkf{
     for(itk = 0; itk < ntrks; ++itk) npts += hitX[itk].size();
     
     if(npts < ntrks) return;
+    if(hitWID[0].empty()) return;
     
     // Get the cryostat and tpc from the first hit
-    unsigned int cstat, tpc, nplanes, ipl, iht;
-    cstat = hitWID[0][0].Cryostat;
-    tpc = hitWID[0][0].TPC;
-    nplanes = geom->Cryostat(cstat).TPC(tpc).Nplanes();
-    
-    fVtxFitMinStr.Cstat = cstat;
-    fVtxFitMinStr.TPC = tpc;
-    fVtxFitMinStr.NPlanes = nplanes;
-    fVtxFitMinStr.WirePitch = geom->WirePitch(hitWID[0][0]);
+    unsigned int iht;
+    fVtxFitMinStr.Cstat = hitWID[0][0].Cryostat;
+    fVtxFitMinStr.TPC = hitWID[0][0].TPC;
+    fVtxFitMinStr.NPlanes = fitGeom.NPlanes;
+    fVtxFitMinStr.WirePitch = fitGeom.WirePitch;
 
     // Put geometry conversion factors into the struct
-    for(ipl = 0; ipl < nplanes; ++ipl) {
-      fVtxFitMinStr.FirstWire[ipl] = -geom->WireCoordinate(0, 0, ipl, tpc, cstat);
-      fVtxFitMinStr.OrthY[ipl] = geom->WireCoordinate(1, 0, ipl, tpc, cstat) + fVtxFitMinStr.FirstWire[ipl];
-      fVtxFitMinStr.OrthZ[ipl] = geom->WireCoordinate(0, 1, ipl, tpc, cstat) + fVtxFitMinStr.FirstWire[ipl];
-    }
+    fVtxFitMinStr.FirstWire = fitGeom.FirstWire;
+    fVtxFitMinStr.OrthY = fitGeom.OrthY;
+    fVtxFitMinStr.OrthZ = fitGeom.OrthZ;
     // and the vertex starting position
     fVtxFitMinStr.VtxPos = VtxPos;
 
@@ -241,6 +569,6 @@ namespace trkf{
     
     delete gMin;
 
-  } // VertexFit()
+  } // VertexFitMinuit()
 
 } // namespace trkf
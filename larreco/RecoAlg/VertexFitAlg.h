@@ -12,6 +12,7 @@
 
 #include <math.h>
 #include <algorithm>
+#include <array>
 #include <vector>
 
 // LArSoft includes
@@ -29,6 +30,11 @@ namespace trkf {
   class VertexFitAlg {
     public:
 
+    // Fits the vertex position and the track directions at the vertex with a
+    // Levenberg-Marquardt minimisation using analytic derivatives. All the fit
+    // data is local to the call so several vertices may be fitted concurrently.
+    // The Minuit fit is used instead if SetUseMinuit(true) was called, or if
+    // this one fails.
     void VertexFit(std::vector<std::vector<geo::WireID>> const& hitWID,
                       std::vector<std::vector<double>> const& hitX,
                       std::vector<std::vector<double>> const& hitXErr,
@@ -36,6 +42,46 @@ namespace trkf {
                       std::vector<TVector3>& TrkDir, std::vector<TVector3>& TrkDirErr,
                       float& ChiDOF) const;
 
+    // The original fit with TMinuit, kept for validation. It uses the static
+    // fVtxFitMinStr so calls are serialized.
+    void VertexFitMinuit(std::vector<std::vector<geo::WireID>> const& hitWID,
+                      std::vector<std::vector<double>> const& hitX,
+                      std::vector<std::vector<double>> const& hitXErr,
+                      TVector3& VtxPos, TVector3& VtxPosErr,
+                      std::vector<TVector3>& TrkDir, std::vector<TVector3>& TrkDirErr,
+                      float& ChiDOF) const;
+
+    void SetUseMinuit(bool useMinuit) { fUseMinuit = useMinuit; }
+
+    // Geometry factors of the wire planes of the TPC of the vertex. The wire
+    // coordinate of the point (Y, Z) in plane ipl is
+    // Y * OrthY[ipl] + Z * OrthZ[ipl] - FirstWire[ipl]
+    struct FitGeometry {
+      unsigned short NPlanes;
+      double WirePitch;
+      std::array<double, 3> OrthY;
+      std::array<double, 3> OrthZ;
+      std::array<double, 3> FirstWire;
+    };
+
+    // The two fits above with the geometry factors given instead of taken from
+    // the geometry service of the TPC of the first hit
+    static void VertexFit(FitGeometry const& fitGeom,
+                      std::vector<std::vector<geo::WireID>> const& hitWID,
+                      std::vector<std::vector<double>> const& hitX,
+                      std::vector<std::vector<double>> const& hitXErr,
+                      TVector3& VtxPos, TVector3& VtxPosErr,
+                      std::vector<TVector3>& TrkDir, std::vector<TVector3>& TrkDirErr,
+                      float& ChiDOF);
+
+    static void VertexFitMinuit(FitGeometry const& fitGeom,
+                      std::vector<std::vector<geo::WireID>> const& hitWID,
+                      std::vector<std::vector<double>> const& hitX,
+                      std::vector<std::vector<double>> const& hitXErr,
+                      TVector3& VtxPos, TVector3& VtxPosErr,
+                      std::vector<TVector3>& TrkDir, std::vector<TVector3>& TrkDirErr,
+                      float& ChiDOF);
+
     // Variables for minuit.
     static VertexFitMinuitStruct fVtxFitMinStr;
     
@@ -43,7 +89,12 @@ namespace trkf {
 
     private:
 
+    // Geometry factors of the TPC of the given wire
+    FitGeometry GetFitGeometry(geo::WireID const& wid) const;
+
     art::ServiceHandle<geo::Geometry> geom;
+    
+    bool fUseMinuit = false;
 
     
   }; // class VertexFitAlg
@@ -13,16 +13,25 @@
 #include <iterator> // std::back_inserter()
 #include <algorithm> // std::remove_if()
 #include <functional> // std::mem_fn()
+#include <map>
+
+// CLHEP libraries
+#include "CLHEP/Random/RandFlat.h"
+#include "CLHEP/Random/JamesRandom.h"
 
 // ART and support libraries
 #include "messagefacility/MessageLogger/MessageLogger.h"
 #include "fhiclcpp/ParameterSet.h" 
 #include "art/Framework/Principal/Event.h"
 #include "art/Framework/Principal/Handle.h"
+#include "art/Framework/Services/Optional/RandomNumberGenerator.h"
 
 // LArSoft libraries
 #include "larcore/SimpleTypesAndConstants/geo_types.h"
+#include "larcore/CoreUtils/ServiceUtil.h" // lar::providerFrom<>()
 #include "larevt/Filters/ChannelFilter.h"
+#include "larevt/CalibrationDBI/Interface/ChannelStatusService.h"
+#include "larevt/CalibrationDBI/Interface/ChannelStatusProvider.h"
 #include "lardata/DetectorInfoServices/DetectorPropertiesService.h"
 #include "larreco/RecoAlg/fuzzyClusterAlg.h"
 #include "lardata/RecoBase/Hit.h"
@@ -43,6 +52,23 @@ namespace {
   template <typename T>
   inline constexpr T norm(T a, T b) { return std::sqrt(sumsq(a, b)); }
 
+  // Lower bound of the distance between two segments, from their bounding
+  // boxes, minus a margin for rounding; no bound (0) if a coordinate is not finite
+  double BoxDistance(double a0, double a1, double b0, double b1,
+                     double c0, double c1, double d0, double d1)
+  {
+    if(!std::isfinite(a0 + a1 + b0 + b1 + c0 + c1 + d0 + d1)) return 0.;
+    double const gap0 = std::max(std::min(c0, d0) - std::max(a0, b0), std::min(a0, b0) - std::max(c0, d0));
+    double const gap1 = std::max(std::min(c1, d1) - std::max(a1, b1), std::min(a1, b1) - std::max(c1, d1));
+    return std::max(gap0, gap1) - 1e-6;
+  }
+
+  // Lower bound of fuzzyClusterAlg::HoughLineDistance() between two lines
+  double LineBoxDistance(const protoTrack& a, const protoTrack& b)
+  {
+    return BoxDistance(a.pMin0, a.pMin1, a.pMax0, a.pMax1, b.pMin0, b.pMin1, b.pMax0, b.pMax1);
+  }
+
 } // local namespace
 
 
@@ -150,11 +176,11 @@ void cluster::fuzzyClusterAlg::reconfigure(fhicl::ParameterSet const& p)
   fVertexLinesCutoff              = p.get< double >("VertexLinesCutoff"              );
   fRunHough                       = p.get< bool   >("RunHough"                       );
   fGenerateHoughLinesOnly         = p.get< bool   >("GenerateHoughLinesOnly"         );
+  fNumThreads                     = p.get< unsigned int >("NumThreads", 1            );
   fHBAlg.reconfigure(p.get< fhicl::ParameterSet >("HoughBaseAlg"));
   fDBScan.reconfigure(p.get< fhicl::ParameterSet >("DBScanAlg"));
 }
 
-
 //----------------------------------------------------------
 void cluster::fuzzyClusterAlg::InitFuzzy(std::vector<art::Ptr<recob::Hit> >& allhits, 
 					 std::set<uint32_t>                  badChannels)
@@ -303,23 +329,18 @@ void cluster::fuzzyClusterAlg::run_fuzzy_cluster(const std::vector<art::Ptr<reco
   // list of lines
   std::vector<protoTrack> protoTracksFound;
   if(nClustersTemp > 0 && fRunHough)
-    for (unsigned int i = 0; i <= (unsigned int)nClustersTemp-1; ++i){
-      LOG_DEBUG("fuzzyClusterAlg")
-        << "Running Hough transform on protocluster " << i;
-      fHBAlg.Transform(allhits, &fpointId_to_clusterId, i, &nClusters, &protoTracksFound);
-    }
+    TransformRegions(allhits, nClustersTemp, &nClusters, &protoTracksFound);
 
-  // Determine the shower likeness of lines
+  // Determine the shower likeness of lines; each line only writes its own
   std::vector<showerCluster> showerClusters; 
   std::vector<trackCluster>  trackClusters; 
-  double totalBkgDistCharge;
-  double fMaxDistance;
-  double distance;
-  double peakTimePerpMin;
-  double peakTimePerpMax;
-  for(auto protoTracksFoundItr = protoTracksFound.begin(); protoTracksFoundItr < protoTracksFound.end(); ++protoTracksFoundItr){
-    totalBkgDistCharge = 0;
-    fMaxDistance = 0.1;
+  util::ParallelFor(protoTracksFound.size(), fNumThreads, [&](size_t iLine, size_t){
+    auto protoTracksFoundItr = protoTracksFound.begin() + iLine;
+    double totalBkgDistCharge = 0;
+    double fMaxDistance = 0.1;
+    double distance;
+    double peakTimePerpMin;
+    double peakTimePerpMax;
     for(auto hitsItr = allhits.cbegin(); hitsItr != allhits.cend(); ++hitsItr){
       /// Veto the hit if it already belongs to a line, proto tracks (Hough lines) are added after the fuzzy clusters
       //if(fpointId_to_clusterId.at(hitsItr-allhits.cbegin()) < nClustersTemp)
@@ -340,7 +361,9 @@ void cluster::fuzzyClusterAlg::run_fuzzy_cluster(const std::vector<art::Ptr<reco
     }/// end loop over hits
     protoTracksFoundItr->showerLikeness = totalBkgDistCharge/(double)protoTracksFoundItr->hits.size();
     //std::cout << "showerLikeness: " << totalBkgDistCharge/(double)protoTracksFoundItr->hits.size() << std::endl;
+  });/// end loop over lines found
 
+  for(auto protoTracksFoundItr = protoTracksFound.begin(); protoTracksFoundItr < protoTracksFound.end(); ++protoTracksFoundItr){
     if(protoTracksFoundItr->showerLikeness > fShowerLikenessCut)
       showerClusters.push_back(showerCluster(*protoTracksFoundItr));
     else
@@ -415,20 +438,27 @@ void cluster::fuzzyClusterAlg::run_fuzzy_cluster(const std::vector<art::Ptr<reco
 
 
   // Reassign the merged lines
+  // The renumbering is the same sequence of (old, new) cluster numbers for
+  // every hit, so the result only depends on the number the hit starts with
+  std::vector<std::pair<unsigned int, unsigned int> > renumbering;
+  for(auto trackClustersItr = trackClusters.begin(); trackClustersItr != trackClusters.end(); ++trackClustersItr){
+    for(auto protoTracksFoundItr = trackClustersItr->clusterProtoTracks.begin(); protoTracksFoundItr < trackClustersItr->clusterProtoTracks.end(); ++protoTracksFoundItr)
+      renumbering.emplace_back(protoTracksFoundItr->oldClusterNumber, protoTracksFoundItr->clusterNumber);
+  }
+  for(auto showerClustersItr = showerClusters.begin(); showerClustersItr != showerClusters.end(); ++showerClustersItr){
+    for(auto protoTracksFoundItr = showerClustersItr->clusterProtoTracks.begin(); protoTracksFoundItr < showerClustersItr->clusterProtoTracks.end(); ++protoTracksFoundItr)
+      renumbering.emplace_back(protoTracksFoundItr->oldClusterNumber, protoTracksFoundItr->clusterNumber);
+  }
+  std::map<unsigned int, unsigned int> reassigned;
   for(auto fpointId_to_clusterIdItr = fpointId_to_clusterId.begin(); fpointId_to_clusterIdItr != fpointId_to_clusterId.end(); ++fpointId_to_clusterIdItr){
-    for(auto trackClustersItr = trackClusters.begin(); trackClustersItr != trackClusters.end(); ++trackClustersItr){
-      for(auto protoTracksFoundItr = trackClustersItr->clusterProtoTracks.begin(); protoTracksFoundItr < trackClustersItr->clusterProtoTracks.end(); ++protoTracksFoundItr){
-        if(*fpointId_to_clusterIdItr == (unsigned int)protoTracksFoundItr->oldClusterNumber)
-          *fpointId_to_clusterIdItr = protoTracksFoundItr->clusterNumber;
-      }
-    }
-    for(auto showerClustersItr = showerClusters.begin(); showerClustersItr != showerClusters.end(); ++showerClustersItr){
-      for(auto protoTracksFoundItr = showerClustersItr->clusterProtoTracks.begin(); protoTracksFoundItr < showerClustersItr->clusterProtoTracks.end(); ++protoTracksFoundItr){
-        if(*fpointId_to_clusterIdItr == (unsigned int)protoTracksFoundItr->oldClusterNumber){
-          *fpointId_to_clusterIdItr = protoTracksFoundItr->clusterNumber;
-        }
-      }
+    auto reassignedItr = reassigned.find(*fpointId_to_clusterIdItr);
+    if(reassignedItr == reassigned.end()){
+      unsigned int clusterId = *fpointId_to_clusterIdItr;
+      for(auto const& renumber : renumbering)
+        if(clusterId == renumber.first) clusterId = renumber.second;
+      reassignedItr = reassigned.emplace(*fpointId_to_clusterIdItr, clusterId).first;
     }
+    *fpointId_to_clusterIdItr = reassignedItr->second;
   }
 
 
@@ -456,30 +486,33 @@ void cluster::fuzzyClusterAlg::run_fuzzy_cluster(const std::vector<art::Ptr<reco
   std::vector< art::Ptr<recob::Hit> > unclusteredhits;
   std::vector<unsigned int> unclusteredhitsToAllhits;
   int nDBClusters = 0;
-  bool unclustered;
-  double p0;
-  double p1;
-  double minDistanceShower;
   // double minDistanceTrack;
   if(fDoFuzzyRemnantMerge && !fGenerateHoughLinesOnly){
-    for(auto allhitsItr = allhits.cbegin(); allhitsItr != allhits.cend(); ++allhitsItr){
-      unclustered = true;
+    // each hit only writes its own cluster number
+    util::ParallelFor(allhits.size(), fNumThreads, [&](size_t iHit, size_t){
+      auto allhitsItr = allhits.cbegin() + iHit;
+      bool unclustered = true;
       // nClusters is the number of fuzzy clusters we found, we only assign hits to lines here
       // if they are not already part of hough lines
       if(fpointId_to_clusterId.at(allhitsItr-allhits.begin()) >= (unsigned int) nClustersTemp 
          && fpointId_to_clusterId.at(allhitsItr-allhits.begin()) < nClusters ){
         unclustered = false;
-        continue;
+        return;
       }
       int ip = (*allhitsItr)->WireID().Plane;
-      p0 = ((*allhitsItr)->WireID().Wire)*fWirePitch[ip];
-      p1 = (*allhitsItr)->PeakTime()*tickToDist;
+      double p0 = ((*allhitsItr)->WireID().Wire)*fWirePitch[ip];
+      double p1 = (*allhitsItr)->PeakTime()*tickToDist;
+      double distance;
 
       // First try to group it with a shower-like cluster
-      minDistanceShower = 999999;
+      double minDistanceShower = 999999;
       for(auto showerClustersItr = showerClusters.begin(); showerClustersItr != showerClusters.end(); ++showerClustersItr){
         for(auto protoTracksItr = showerClustersItr->clusterProtoTracks.begin(); protoTracksItr < showerClustersItr->clusterProtoTracks.end(); ++protoTracksItr){
           
+          // too far from the bounding box of the line
+          if(BoxDistance(p0, p1, p0, p1, protoTracksItr->pMin0, protoTracksItr->pMin1, protoTracksItr->pMax0, protoTracksItr->pMax1) > fFuzzyRemnantMergeCutoff)
+            continue;
+
           distance = PointSegmentDistance( p0, p1, protoTracksItr->pMin0, protoTracksItr->pMin1, protoTracksItr->pMax0, protoTracksItr->pMax1);
 
           if(distance > fFuzzyRemnantMergeCutoff)
@@ -498,7 +531,7 @@ void cluster::fuzzyClusterAlg::run_fuzzy_cluster(const std::vector<art::Ptr<reco
       }
       
       if(!unclustered)
-        continue;
+        return;
       
       // Failing to group it with a shower-like cluster, try with a track-like cluster
       // minDistanceTrack = 999999;
@@ -522,11 +555,16 @@ void cluster::fuzzyClusterAlg::run_fuzzy_cluster(const std::vector<art::Ptr<reco
 
 
       if(unclustered){
-        unclusteredhitsToAllhits.push_back(allhitsItr-allhits.begin());
-        unclusteredhits.push_back(*allhitsItr);
         fpointId_to_clusterId.at(allhitsItr-allhits.begin()) = kNOISE_CLUSTER;
       }
       
+    });
+
+    for(auto allhitsItr = allhits.cbegin(); allhitsItr != allhits.cend(); ++allhitsItr){
+      if(fpointId_to_clusterId.at(allhitsItr-allhits.begin()) == kNOISE_CLUSTER){
+        unclusteredhitsToAllhits.push_back(allhitsItr-allhits.begin());
+        unclusteredhits.push_back(*allhitsItr);
+      }
     }
 
     // Setup DBSCAN for noise and extra hits
@@ -588,6 +626,71 @@ void cluster::fuzzyClusterAlg::run_fuzzy_cluster(const std::vector<art::Ptr<reco
 
 
 
+//----------------------------------------------------------
+// Each region draws from its own engine, seeded in region order from the
+// job's one, so the lines found do not depend on the number of threads. Each
+// region is transformed on its own hits, with its lines numbered from 1; they
+// are then renumbered in region order.
+void cluster::fuzzyClusterAlg::TransformRegions(const std::vector<art::Ptr<recob::Hit> >& allhits,
+                                                unsigned int nRegions,
+                                                unsigned int *nClusters,
+                                                std::vector<protoTrack> *protoTracksFound)
+{
+  // hits of each region
+  std::vector<std::vector<unsigned int> > regionHits(nRegions);
+  for(size_t i = 0; i < fpointId_to_clusterId.size(); ++i){
+    if(fpointId_to_clusterId[i] < nRegions)
+      regionHits[fpointId_to_clusterId[i]].push_back(i);
+  }
+
+  art::ServiceHandle<art::RandomNumberGenerator> rng;
+  CLHEP::RandFlat flat(rng->getEngine());
+  std::vector<long> seeds(nRegions);
+  for(auto& seed : seeds)
+    seed = flat.fireInt(900000000L);
+
+  // services are not available in the other threads
+  geo::GeometryCore const& geom = *lar::providerFrom<geo::Geometry>();
+  detinfo::DetectorProperties const& detprop = *lar::providerFrom<detinfo::DetectorPropertiesService>();
+  lariov::ChannelStatusProvider const& channelStatus = *lar::providerFrom<lariov::ChannelStatusService>();
+
+  std::vector<std::vector<unsigned int> > regionClusterIds(nRegions);
+  std::vector<std::vector<protoTrack> > regionLines(nRegions);
+  ForEachRegion(seeds, fNumThreads, [&](size_t region, CLHEP::HepRandomEngine& engine){
+    if(regionHits[region].empty())
+      return;
+    LOG_DEBUG("fuzzyClusterAlg")
+      << "Running Hough transform on protocluster " << region;
+    std::vector<art::Ptr<recob::Hit> > hits;
+    hits.reserve(regionHits[region].size());
+    for(auto i : regionHits[region])
+      hits.push_back(allhits[i]);
+    regionClusterIds[region].assign(hits.size(), 0);
+    unsigned int nRegionClusters = 1;
+    fHBAlg.Transform(hits, &regionClusterIds[region], 0, &nRegionClusters, &regionLines[region],
+                     engine, geom, detprop, channelStatus);
+  });
+
+  for(unsigned int region = 0; region < nRegions; ++region){
+    // line n of the region becomes cluster offset + n
+    unsigned int const offset = *nClusters - 1;
+    for(size_t i = 0; i < regionHits[region].size(); ++i){
+      if(regionClusterIds[region][i] > 0)
+        fpointId_to_clusterId[regionHits[region][i]] = offset + regionClusterIds[region][i];
+    }
+    for(auto& line : regionLines[region]){
+      line.clusterNumber += offset;
+      line.oldClusterNumber += offset;
+      line.iMinWire = regionHits[region][(size_t) line.iMinWire];
+      line.iMaxWire = regionHits[region][(size_t) line.iMaxWire];
+      protoTracksFound->push_back(std::move(line));
+    }
+    *nClusters += regionLines[region].size();
+  }
+}
+
+
+
 // Merges based on the distance between line segments
 bool cluster::fuzzyClusterAlg::mergeShowerTrackClusters(showerCluster *showerClusterI,
 						        trackCluster *trackClusterJ,
@@ -649,6 +752,10 @@ bool cluster::fuzzyClusterAlg::mergeShowerTrackClusters(showerCluster *showerClu
                showerClusterProtoTrackItr != showerClusterI->clusterProtoTracks.end();
                ++showerClusterProtoTrackItr){ 
 
+        // the bounding boxes are already too far apart
+        if(LineBoxDistance(*trackClusterProtoTrackItr, *showerClusterProtoTrackItr) >= fShowerTrackClusterMergeCutoff)
+          continue;
+
         double segmentDistance = HoughLineDistance(trackClusterProtoTrackItr->pMin0,trackClusterProtoTrackItr->pMin1,
                                                    trackClusterProtoTrackItr->pMax0,trackClusterProtoTrackItr->pMax1, 
           					   showerClusterProtoTrackItr->pMin0,showerClusterProtoTrackItr->pMin1,
@@ -898,6 +1005,10 @@ bool cluster::fuzzyClusterAlg::mergeTrackClusters(unsigned int clusIndexStart,
                trackClustersToMergeProtoTrackItr != trackClustersToMergeItr->clusterProtoTracks.end();
                ++trackClustersToMergeProtoTrackItr){ 
 
+        // the bounding boxes are already too far apart
+        if(LineBoxDistance(*trackClustersClusIndexStartProtoTrackItr, *trackClustersToMergeProtoTrackItr) >= fTrackClusterMergeCutoff)
+          continue;
+
         double segmentDistance = HoughLineDistance(trackClustersClusIndexStartProtoTrackItr->pMin0,trackClustersClusIndexStartProtoTrackItr->pMin1,
                                                    trackClustersClusIndexStartProtoTrackItr->pMax0,trackClustersClusIndexStartProtoTrackItr->pMax1, 
           					   trackClustersToMergeProtoTrackItr->pMin0,trackClustersToMergeProtoTrackItr->pMin1,
@@ -1257,6 +1368,10 @@ bool cluster::fuzzyClusterAlg::mergeShowerClusters(unsigned int clusIndexStart,
         if(showerClustersToMergeProtoTrackItr->clusterNumber == showerClustersClusIndexStartProtoTrackItr->clusterNumber)
           continue;
 
+        // the bounding boxes are already too far apart
+        if(LineBoxDistance(*showerClustersClusIndexStartProtoTrackItr, *showerClustersToMergeProtoTrackItr) >= fShowerClusterMergeCutoff)
+          continue;
+
 
         double segmentDistance = HoughLineDistance(showerClustersClusIndexStartProtoTrackItr->pMin0,showerClustersClusIndexStartProtoTrackItr->pMin1,
                                                    showerClustersClusIndexStartProtoTrackItr->pMax0,showerClustersClusIndexStartProtoTrackItr->pMax1, 
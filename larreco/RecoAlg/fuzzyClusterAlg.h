@@ -10,11 +10,13 @@
 // ART and support libraries
 #include "art/Framework/Services/Registry/ServiceHandle.h"
 #include "art/Persistency/Common/Ptr.h"
+#include "CLHEP/Random/JamesRandom.h"
 
 // LArSoft libraries
 #include "larcore/Geometry/Geometry.h"
 #include "larreco/RecoAlg/HoughBaseAlg.h"
 #include "larreco/RecoAlg/DBScanAlg.h"
+#include "larreco/RecoAlg/ParallelFor.h"
 
 namespace fhicl { class ParameterSet; }
 
@@ -52,6 +54,11 @@ namespace cluster {
    //double **data = NULL;
    std::vector<std::vector<double>> data;
 
+    /// Calls transform(region, engine) for each region on up to nThreads threads, with an
+    /// engine seeded with seeds[region]: the result does not depend on the number of threads
+    template <typename Func>
+    static void ForEachRegion(std::vector<long> const& seeds, unsigned int nThreads, Func transform);
+
 
 
 
@@ -91,11 +98,19 @@ namespace cluster {
     int    fMaxVertexLines;                ///< Max number of line end points allowed in a Hough line merge region for a merge to happen
     double  fVertexLinesCutoff;             ///< Size of the vertex region to count up lines for fMaxVertexLines 
 
+    unsigned int fNumThreads;               ///< Number of threads for the Hough transform of the regions and the loops over lines and hits
+
+
 
 
 
 
 
+    /// Runs the Hough transform on each of the nRegions regions, on up to fNumThreads threads
+    void TransformRegions(const std::vector<art::Ptr<recob::Hit> >& allhits,
+        unsigned int nRegions,
+        unsigned int *nClusters,
+        std::vector<protoTrack> *protoTracksFound);
 
     void mergeHoughLinesBySegment(unsigned int k,
         std::vector<protoTrack> *protoTracks, 
@@ -177,6 +192,15 @@ namespace cluster {
   }; // class fuzzyClusterAlg
     
 
+  //----------------------------------------------------------
+  template <typename Func>
+  void fuzzyClusterAlg::ForEachRegion(std::vector<long> const& seeds, unsigned int nThreads, Func transform)
+  {
+    util::ParallelFor(seeds.size(), nThreads, [&](size_t region, size_t){
+      CLHEP::HepJamesRandom engine(seeds[region]);
+      transform(region, engine);
+    });
+  }
 
 
 
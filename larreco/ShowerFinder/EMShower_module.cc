@@ -12,6 +12,7 @@
 // Framework includes:
 #include "art/Framework/Core/ModuleMacros.h"
 #include "art/Framework/Principal/Event.h"
+#include "art/Framework/Principal/Run.h"
 #include "fhiclcpp/ParameterSet.h"
 #include "art/Framework/Principal/Handle.h"
 #include "art/Persistency/Common/Ptr.h"
@@ -38,6 +39,10 @@
 #include "lardata/RecoBase/Shower.h"
 #include "lardata/RecoBase/PFParticle.h"
 #include "larreco/RecoAlg/EMShowerAlg.h"
+#include "larreco/RecoAlg/ParallelFor.h"
+
+// C++ includes
+#include <memory>
 
 // ROOT includes
 #include "TPrincipal.h"
@@ -58,14 +63,33 @@ public:
 
   EMShower(fhicl::ParameterSet const& pset);
 
+  void beginRun(art::Run& run);
   void produce(art::Event& evt);
   void reconfigure(fhicl::ParameterSet const& p);
 
 private:
 
+  /// Everything needed to make one shower, and the shower made
+  struct ShowerCandidate {
+    int showerNum = -1;
+    art::PtrVector<recob::Hit> hits;
+    art::PtrVector<recob::Cluster> clusters;
+    art::PtrVector<recob::Track> tracks;
+    art::PtrVector<recob::SpacePoint> spacePoints;
+    art::Ptr<recob::Vertex> vertex; // pfparticle mode only
+    bool made = false;
+    int iok = 0;
+    recob::Shower shower;
+  };
+
+  /// The shower algorithm used by the given thread (0 is the module's own)
+  EMShowerAlg& ShowerAlg(size_t thread) { return thread == 0? fEMShowerAlg: *fThreadEMShowerAlgs[thread-1]; }
+
   std::string fHitsModuleLabel, fClusterModuleLabel, fTrackModuleLabel, fPFParticleModuleLabel;
   EMShowerAlg fEMShowerAlg;
   bool fSaveNonCompleteShowers;
+  size_t fNumThreads;
+  std::vector<std::unique_ptr<EMShowerAlg> > fThreadEMShowerAlgs; ///< algorithms of the threads after the first
 
   art::ServiceHandle<geo::Geometry> fGeom;
   detinfo::DetectorProperties const* fDetProp = lar::providerFrom<detinfo::DetectorPropertiesService>();
@@ -77,6 +101,9 @@ private:
 
 shower::EMShower::EMShower(fhicl::ParameterSet const& pset) : fEMShowerAlg(pset.get<fhicl::ParameterSet>("EMShowerAlg")) {
   this->reconfigure(pset);
+  // the algorithm keeps per-shower state (calorimetry, energy), so each thread has its own
+  for (size_t thread = 1; thread < fNumThreads; ++thread)
+    fThreadEMShowerAlgs.emplace_back(new EMShowerAlg(pset.get<fhicl::ParameterSet>("EMShowerAlg")));
   produces<std::vector<recob::Shower> >();
   produces<art::Assns<recob::Shower, recob::Hit> >();
   produces<art::Assns<recob::Shower, recob::Cluster> >();
@@ -92,10 +119,22 @@ void shower::EMShower::reconfigure(fhicl::ParameterSet const& p) {
   fSaveNonCompleteShowers = p.get<bool>       ("SaveNonCompleteShowers","true");
   fShower = p.get<int>("Shower",-1);
   fPlane = p.get<int>("Plane",-1);
+  fNumThreads = p.get<size_t>("NumThreads",1);
+  // the debug printout of the algorithm is only readable from a single thread
+  if (p.get<fhicl::ParameterSet>("EMShowerAlg").get<int>("Debug",0) > 0) fNumThreads = 1;
+  if (fNumThreads < 1) fNumThreads = 1;
+}
+
+void shower::EMShower::beginRun(art::Run&) {
+  for (size_t thread = 0; thread <= fThreadEMShowerAlgs.size(); ++thread)
+    ShowerAlg(thread).UpdateGeometry();
 }
 
 void shower::EMShower::produce(art::Event& evt) {
 
+  for (size_t thread = 0; thread <= fThreadEMShowerAlgs.size(); ++thread)
+    ShowerAlg(thread).UpdateDetectorProperties();
+
   // Output -- showers and associations with hits and clusters
   std::unique_ptr<std::vector<recob::Shower> > showers(new std::vector<recob::Shower>);
   std::unique_ptr<art::Assns<recob::Shower, recob::Cluster> > clusterAssociations(new art::Assns<recob::Shower, recob::Cluster>);
@@ -185,20 +224,25 @@ void shower::EMShower::produce(art::Event& evt) {
     }
   }
 
-  // Make output larsoft products
+  // Collect the hits, clusters, tracks and space points of each shower
+  std::vector<ShowerCandidate> candidates;
+  std::unique_ptr<art::FindManyP<recob::Vertex> > fmv;
+  if (pfpHandle.isValid())
+    fmv.reset(new art::FindManyP<recob::Vertex>(pfpHandle, evt, fPFParticleModuleLabel));
   int showerNum = 0;
   for (std::vector<std::vector<int> >::iterator newShower = newShowers.begin(); newShower != newShowers.end(); ++newShower, ++showerNum) {
 
     if (showerNum != fShower and fShower != -1) continue;
 
-    // New shower
-    std::cout << std::endl << "Start shower " << showerNum << std::endl;
+    candidates.push_back(ShowerCandidate());
+    ShowerCandidate& candidate = candidates.back();
+    candidate.showerNum = showerNum;
 
     // New associations
-    art::PtrVector<recob::Hit> showerHits;
-    art::PtrVector<recob::Cluster> showerClusters;
-    art::PtrVector<recob::Track> showerTracks;
-    art::PtrVector<recob::SpacePoint> showerSpacePoints;
+    art::PtrVector<recob::Hit>& showerHits = candidate.hits;
+    art::PtrVector<recob::Cluster>& showerClusters = candidate.clusters;
+    art::PtrVector<recob::Track>& showerTracks = candidate.tracks;
+    art::PtrVector<recob::SpacePoint>& showerSpacePoints = candidate.spacePoints;
 
     std::vector<int> associatedTracks;
 
@@ -243,46 +287,87 @@ void shower::EMShower::produce(art::Event& evt) {
 	    showerSpacePoints.push_back(*spacePointsIt);
 	}
       }
+      std::vector<art::Ptr<recob::Vertex> > vertices = fmv->at(pfParticles[newShower-newShowers.begin()]);
+      if (vertices.size())
+	candidate.vertex = vertices[0];
     }
 
+    // Pointers are resolved lazily: do it here, before they are shared between threads
+    for (art::PtrVector<recob::Hit>::const_iterator showerHit = showerHits.begin(); showerHit != showerHits.end(); ++showerHit)
+      showerHit->get();
+    if (candidate.vertex.isNonnull())
+      candidate.vertex.get();
+
+  }
+
+  // Project all the shower hits once for the whole event
+  std::vector<art::Ptr<recob::Hit> > allShowerHits;
+  for (std::vector<ShowerCandidate>::const_iterator candidate = candidates.begin(); candidate != candidates.end(); ++candidate)
+    allShowerHits.insert(allShowerHits.end(), candidate->hits.begin(), candidate->hits.end());
+  size_t const nThreads = std::min(fThreadEMShowerAlgs.size() + 1, std::max(candidates.size(), (size_t) 1));
+  for (size_t thread = 0; thread < nThreads; ++thread)
+    ShowerAlg(thread).CacheHitPositions(allShowerHits);
+
+  // Make the showers; they are independent of each other
+  util::ParallelFor(candidates.size(), nThreads, [&](size_t idx, size_t thread) {
+
+    ShowerCandidate& candidate = candidates[idx];
+    EMShowerAlg& emShowerAlg = ShowerAlg(thread);
+
+    // New shower
+    mf::LogInfo("EMShower") << "Start shower " << candidate.showerNum;
+
     if (!pfpHandle.isValid()) {
 
       // Find the track at the start of the shower
       std::unique_ptr<recob::Track> initialTrack;
       std::map<int,std::vector<art::Ptr<recob::Hit> > > initialTrackHits;
-      fEMShowerAlg.FindInitialTrack(showerHits, initialTrack, initialTrackHits, fPlane);
+      emShowerAlg.FindInitialTrack(candidate.hits, initialTrack, initialTrackHits, fPlane);
+
+      // Make shower object
+      candidate.shower = emShowerAlg.MakeShower(candidate.hits, initialTrack, initialTrackHits);
+      candidate.made = true;
+    }
+
+    else if (candidate.vertex.isNonnull()) { // pfParticle
+      candidate.shower = emShowerAlg.MakeShower(candidate.hits, candidate.vertex, candidate.iok);
+      candidate.made = true;
+    }
+
+  });
 
-      // Make shower object and associations
-      recob::Shower shower = fEMShowerAlg.MakeShower(showerHits, initialTrack, initialTrackHits);
-      shower.set_id(showerNum);
+  for (size_t thread = 0; thread < nThreads; ++thread)
+    ShowerAlg(thread).ClearHitCache();
+
+  // Make output larsoft products, in the order of the showers
+  for (std::vector<ShowerCandidate>::iterator candidate = candidates.begin(); candidate != candidates.end(); ++candidate) {
+
+    if (!candidate->made) continue;
+
+    if (!pfpHandle.isValid()) {
+      recob::Shower& shower = candidate->shower;
+      shower.set_id(candidate->showerNum);
       if ( fSaveNonCompleteShowers or (!fSaveNonCompleteShowers and shower.ShowerStart() != TVector3(0,0,0)) ) {
 	showers->push_back(shower);
-	util::CreateAssn(*this, evt, *(showers.get()), showerHits,        *(hitAssociations.get()));
-	util::CreateAssn(*this, evt, *(showers.get()), showerClusters,    *(clusterAssociations.get()));
-	util::CreateAssn(*this, evt, *(showers.get()), showerTracks,      *(trackAssociations.get()));
-	util::CreateAssn(*this, evt, *(showers.get()), showerSpacePoints, *(spacePointAssociations.get()));
+	util::CreateAssn(*this, evt, *(showers.get()), candidate->hits,        *(hitAssociations.get()));
+	util::CreateAssn(*this, evt, *(showers.get()), candidate->clusters,    *(clusterAssociations.get()));
+	util::CreateAssn(*this, evt, *(showers.get()), candidate->tracks,      *(trackAssociations.get()));
+	util::CreateAssn(*this, evt, *(showers.get()), candidate->spacePoints, *(spacePointAssociations.get()));
       }
       else
-	mf::LogInfo("EMShower") << "Discarding shower " << showerNum << " due to incompleteness (SaveNonCompleteShowers == false)";
+	mf::LogInfo("EMShower") << "Discarding shower " << candidate->showerNum << " due to incompleteness (SaveNonCompleteShowers == false)";
     }
 
     else { // pfParticle
-      art::FindManyP<recob::Vertex> fmv(pfpHandle, evt, fPFParticleModuleLabel);
-      std::vector<art::Ptr<recob::Vertex> > vertices = fmv.at(pfParticles[newShower-newShowers.begin()]);
-      if (vertices.size()) {
-	int iok = 0;
-	recob::Shower shower = fEMShowerAlg.MakeShower(showerHits, vertices[0], iok);
-	//shower.set_id(showerNum);
-	if (iok==0) {
-	  showers->push_back(shower);
-	  showers->back().set_id(showers->size()-1);
-	  util::CreateAssn(*this, evt, *(showers.get()), showerHits,        *(hitAssociations.get()));
-	  util::CreateAssn(*this, evt, *(showers.get()), showerClusters,    *(clusterAssociations.get()));
-	  util::CreateAssn(*this, evt, *(showers.get()), showerTracks,      *(trackAssociations.get()));
-	  util::CreateAssn(*this, evt, *(showers.get()), showerSpacePoints, *(spacePointAssociations.get()));
-	}
+      //shower.set_id(showerNum);
+      if (candidate->iok==0) {
+	showers->push_back(candidate->shower);
+	showers->back().set_id(showers->size()-1);
+	util::CreateAssn(*this, evt, *(showers.get()), candidate->hits,        *(hitAssociations.get()));
+	util::CreateAssn(*this, evt, *(showers.get()), candidate->clusters,    *(clusterAssociations.get()));
+	util::CreateAssn(*this, evt, *(showers.get()), candidate->tracks,      *(trackAssociations.get()));
+	util::CreateAssn(*this, evt, *(showers.get()), candidate->spacePoints, *(spacePointAssociations.get()));
       }
-
     }
 
   }
@@ -63,6 +63,8 @@ private:
   ::showerreco::ShowerRecoManager  fManager;
   ::showerreco::ShowerRecoAlg     *fShowerAlgo;
   ::calo::CalorimetryAlg          *fCaloAlgo;
+  /// Calorimetry algorithms of the threads reconstructing showers, besides fCaloAlgo
+  std::vector<std::unique_ptr< ::calo::CalorimetryAlg> > fThreadCaloAlgos;
   ::cmtool::CPAlgoArray           *fCPAlgoArray;
   ::cmtool::CPAlgoNHits           *fCPAlgoNHits;
   ::cmtool::CPAlgoIgnoreTracks    *fCPAlgoIgnoreTracks;
@@ -96,11 +98,19 @@ ShowerReco3D::ShowerReco3D(fhicl::ParameterSet const & p)
 
   fManager.MatchManager().AddPriorityAlgo(fCPAlgoArray);
   fManager.MatchManager().AddMatchAlgo(fCFAlgoTimeOverlap);
+  fManager.MatchManager().SetNumThreads(p.get<size_t>("MatchNumThreads",1));
+  fManager.MatchManager().SetPrefilter(p.get<bool>("MatchPrefilter",false));
 
   fShowerAlgo->Verbose(p.get<bool>("Verbosity"));
   fShowerAlgo->SetUseArea(p.get<bool>("UseArea"));
   fShowerAlgo->setEcorrection(p.get<bool>("ApplyMCEnergyCorrection"));
-  fShowerAlgo->CaloAlgo(fCaloAlgo);
+  // one calorimetry algorithm for each thread reconstructing showers
+  std::vector< ::calo::CalorimetryAlg*> caloAlgos(1,fCaloAlgo);
+  for(size_t i=1; i<p.get<size_t>("NumThreads",1); ++i) {
+    fThreadCaloAlgos.emplace_back(new ::calo::CalorimetryAlg(p.get< fhicl::ParameterSet >("CalorimetryAlg")));
+    caloAlgos.push_back(fThreadCaloAlgos.back().get());
+  }
+  fShowerAlgo->CaloAlgos(caloAlgos);
 
   fManager.Algo(fShowerAlgo);
 
@@ -18,7 +18,8 @@ namespace showerreco {
   }
 
 
-  ::recob::Shower ShowerRecoAlg::RecoOneShower(const std::vector< ::showerreco::ShowerCluster_t>& clusters)
+  ::recob::Shower ShowerRecoAlg::RecoOneShower(const std::vector< ::showerreco::ShowerCluster_t>& clusters,
+					       ::calo::CalorimetryAlg& caloAlg)
   {
     
     ::recob::Shower result;
@@ -140,22 +141,22 @@ namespace showerreco {
 	  //double dEdx_sub;
 	  // double dEdx_MIP;
 	  
-	  //    dEdx_new = fCaloAlg->dEdx_AREA(theHit, newpitch );
-	  //Bcorr_half = 2.*fCaloAlg->dEdx_AREA(theHit->Charge()/2.,theHit->PeakTime(), newpitch, plane); ; 
-	  //dEdx_sub = fCaloAlg->dEdx_AREA(theHit->Charge()-PION_CORR,theHit->PeakTime(), newpitch, plane); ; 
-	  // dEdx_MIP = fCaloAlg->dEdx_AREA_forceMIP(theHit, newpitch ); 
+	  //    dEdx_new = caloAlg.dEdx_AREA(theHit, newpitch );
+	  //Bcorr_half = 2.*caloAlg.dEdx_AREA(theHit->Charge()/2.,theHit->PeakTime(), newpitch, plane); ; 
+	  //dEdx_sub = caloAlg.dEdx_AREA(theHit->Charge()-PION_CORR,theHit->PeakTime(), newpitch, plane); ; 
+	  // dEdx_MIP = caloAlg.dEdx_AREA_forceMIP(theHit, newpitch ); 
 	  if(!fUseArea)
 	    {
-	      dEdx_new = fCaloAlg->dEdx_AMP(theHit.peak / newpitch, theHit.t / fGSer->TimeToCm(), theHit.plane);
-	      hitElectrons = fCaloAlg->ElectronsFromADCPeak(theHit.peak, plane);
+	      dEdx_new = caloAlg.dEdx_AMP(theHit.peak / newpitch, theHit.t / fGSer->TimeToCm(), theHit.plane);
+	      hitElectrons = caloAlg.ElectronsFromADCPeak(theHit.peak, plane);
 	    }
 	  else
 	    {
-	      dEdx_new = fCaloAlg->dEdx_AREA(theHit.charge / newpitch, theHit.t / fGSer->TimeToCm(), theHit.plane);
-	      hitElectrons = fCaloAlg->ElectronsFromADCArea(theHit.charge, plane);
+	      dEdx_new = caloAlg.dEdx_AREA(theHit.charge / newpitch, theHit.t / fGSer->TimeToCm(), theHit.plane);
+	      hitElectrons = caloAlg.ElectronsFromADCArea(theHit.charge, plane);
 	    }
 
-	  hitElectrons *= fCaloAlg->LifetimeCorrection(theHit.t / fGSer->TimeToCm());
+	  hitElectrons *= caloAlg.LifetimeCorrection(theHit.t / fGSer->TimeToCm());
 	  
 	  totEnergy += hitElectrons * 1.e3 / (::util::kGeVToElectrons);
 
@@ -270,11 +271,11 @@ namespace showerreco {
 	  double dEdx=0;
 	  if(fUseArea)
 	    { 
-	      dEdx = fCaloAlg->dEdx_AREA(theHit.charge / newpitch, theHit.t / fGSer->TimeToCm(), theHit.plane);
+	      dEdx = caloAlg.dEdx_AREA(theHit.charge / newpitch, theHit.t / fGSer->TimeToCm(), theHit.plane);
 	    }
 	  else  //this will hopefully go away, once all of the calibration factors are calculated.
 	    {
-	      dEdx = fCaloAlg->dEdx_AMP(theHit.peak / newpitch, theHit.t / fGSer->TimeToCm(), theHit.plane);
+	      dEdx = caloAlg.dEdx_AMP(theHit.peak / newpitch, theHit.t / fGSer->TimeToCm(), theHit.plane);
 	    }
 	  //fDistribAfterMin[set].push_back(MinBefore);
 	  //fDistribBeforeMin[set].push_back(MinAfter);
@@ -298,11 +299,11 @@ namespace showerreco {
 	  double dEdx=0;
 	  if(fUseArea)
 	    { 
-	      dEdx = fCaloAlg->dEdx_AREA(theHit.charge / newpitch, theHit.t / fGSer->TimeToCm(), theHit.plane);
+	      dEdx = caloAlg.dEdx_AREA(theHit.charge / newpitch, theHit.t / fGSer->TimeToCm(), theHit.plane);
 	    }
 	  else  //this will hopefully go away, once all of the calibration factors are calculated.
 	    {
-	      dEdx = fCaloAlg->dEdx_AMP(theHit.peak / newpitch, theHit.t / fGSer->TimeToCm(), theHit.plane);
+	      dEdx = caloAlg.dEdx_AMP(theHit.peak / newpitch, theHit.t / fGSer->TimeToCm(), theHit.plane);
 	    }
 	  //fDistribAfterMin[set].push_back(MinBefore);
 	  //fDistribBeforeMin[set].push_back(MinAfter);
@@ -50,7 +50,8 @@ namespace showerreco {
   protected:
 
     /// Function to reconstruct a shower
-    virtual ::recob::Shower RecoOneShower(const std::vector< ::showerreco::ShowerCluster_t>& );
+    virtual ::recob::Shower RecoOneShower(const std::vector< ::showerreco::ShowerCluster_t>& clusters,
+					  ::calo::CalorimetryAlg& caloAlg);
 
   protected:
 
@@ -2,6 +2,8 @@
 #define RECOTOOL_SHOWERRECOALGBASE_CXX
 
 #include "ShowerRecoAlgBase.h"
+#include "larreco/RecoAlg/ParallelFor.h"
+#include <algorithm>
 
 namespace showerreco {
   
@@ -17,39 +19,64 @@ namespace showerreco {
 
   void ShowerRecoAlgBase::AppendInputClusters(const std::vector< ::cluster::ClusterParamsAlg>& cpan_v)
   {
-    std::vector< ::showerreco::ShowerCluster_t> clusters;
+    std::vector<const ::cluster::ClusterParamsAlg*> cpan_ptr_v;
+    cpan_ptr_v.reserve(cpan_v.size());
+
+    for(auto const& cpan : cpan_v) cpan_ptr_v.push_back(&cpan);
+
+    AppendInputClusters(cpan_ptr_v);
+  }
+
+  void ShowerRecoAlgBase::AppendInputClusters(const std::vector<const ::cluster::ClusterParamsAlg*>& cpan_v)
+  {
+    fInputClusters.push_back(std::vector< ::showerreco::ShowerCluster_t>());
+    auto& clusters = fInputClusters.back();
     clusters.reserve(cpan_v.size());
 
     for(auto const& cpan : cpan_v) {
 
       clusters.push_back( ::showerreco::ShowerCluster_t() );
 
-      (*clusters.rbegin()).start_point = cpan.GetParams().start_point;
-      (*clusters.rbegin()).end_point   = cpan.GetParams().end_point;
-      (*clusters.rbegin()).angle_2d    = cpan.GetParams().angle_2d;
-      (*clusters.rbegin()).plane_id    = cpan.Plane();
-      (*clusters.rbegin()).hit_vector  = cpan.GetHitVector();
+      (*clusters.rbegin()).start_point = cpan->GetParams().start_point;
+      (*clusters.rbegin()).end_point   = cpan->GetParams().end_point;
+      (*clusters.rbegin()).angle_2d    = cpan->GetParams().angle_2d;
+      (*clusters.rbegin()).plane_id    = cpan->Plane();
+      (*clusters.rbegin()).hit_vector  = cpan->GetHitVector();
 
     }
 
-    fInputClusters.push_back(clusters);
-
   }
 
   std::vector< ::recob::Shower> ShowerRecoAlgBase::Reconstruct()
   {
 
-    if(!fCaloAlg) throw ShowerRecoException("Calorimetry algorithm must be provided!");
+    if(fCaloAlgs.empty() || std::count(fCaloAlgs.begin(),fCaloAlgs.end(),nullptr))
+      throw ShowerRecoException("Calorimetry algorithm must be provided!");
 
     ProcessInputClusters();
 
     std::vector< ::recob::Shower> output;
 
-    output.reserve(fInputClusters.size());
+    size_t const nthreads = fVerbosity ? 1 : std::min(fCaloAlgs.size(),fInputClusters.size());
+
+    if(nthreads < 2) {
+
+      output.reserve(fInputClusters.size());
+
+      for(auto const& clusters : fInputClusters)
+
+	output.push_back( RecoOneShower(clusters, *(fCaloAlgs.front())) );
+
+      return output;
+    }
 
-    for(auto const& clusters : fInputClusters)
+    // Each shower is independent: reconstruct them in parallel, each thread
+    // with its own calorimetry algorithm, and keep the input order
+    output.resize(fInputClusters.size());
 
-      output.push_back( RecoOneShower(clusters) );
+    ::util::ParallelFor(fInputClusters.size(), nthreads, [&](size_t i, size_t thread) {
+	output[i] = RecoOneShower(fInputClusters[i], *(fCaloAlgs[thread]));
+      });
 
     return output;
 
@@ -21,6 +21,7 @@
 #include "ShowerRecoException.h"
 #include <limits>
 #include <climits>
+#include <vector>
 namespace showerreco {
 
   struct ShowerCluster_t {
@@ -57,14 +58,21 @@ namespace showerreco {
     /// Setter for a matched combination of clusters
     virtual void AppendInputClusters(const std::vector<cluster::ClusterParamsAlg>& cpan_v);
 
-    /// Execute reconstruction
+    /// Setter for a matched combination of clusters, without copying them first
+    virtual void AppendInputClusters(const std::vector<const cluster::ClusterParamsAlg*>& cpan_v);
+
+    /// Execute reconstruction; the showers are in the order of the input cluster combinations
     std::vector<recob::Shower> Reconstruct();
 
     /// Verbosity switch
     virtual void Verbose(bool on=true) { fVerbosity=on; }
 
     /// Calorimetry algorithm setter
-    void CaloAlgo(::calo::CalorimetryAlg* alg) { fCaloAlg = alg; }
+    void CaloAlgo(::calo::CalorimetryAlg* alg) { fCaloAlgs.assign(1,alg); }
+
+    /// Calorimetry algorithms setter: the showers are reconstructed by as many
+    /// threads as algorithms, each thread using its own one (serially if verbose)
+    void CaloAlgos(const std::vector< ::calo::CalorimetryAlg*>& algs) { fCaloAlgs = algs; }
 
   protected:
 
@@ -72,16 +80,17 @@ namespace showerreco {
     virtual void ProcessInputClusters()
     { return; }
 
-    /// Function to reconstruct one shower
-    virtual ::recob::Shower RecoOneShower(const std::vector<showerreco::ShowerCluster_t>& clusters) = 0;
+    /// Function to reconstruct one shower; may be called by several threads at once, each with its own calorimetry algorithm
+    virtual ::recob::Shower RecoOneShower(const std::vector<showerreco::ShowerCluster_t>& clusters,
+					  ::calo::CalorimetryAlg& caloAlg) = 0;
     
   protected:
     
     /// Verbosity flag
     bool fVerbosity;
 
-    /// Calorimetry algorithm
-    ::calo::CalorimetryAlg *fCaloAlg;
+    /// Calorimetry algorithms, one for each thread
+    std::vector< ::calo::CalorimetryAlg*> fCaloAlgs;
 
     /// Input clusters
     std::vector<std::vector<showerreco::ShowerCluster_t> > fInputClusters;
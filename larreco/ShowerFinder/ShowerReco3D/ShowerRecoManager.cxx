@@ -58,13 +58,13 @@ namespace showerreco {
     
     for(auto const& pair : ass) {
       
-      std::vector< ::cluster::ClusterParamsAlg> cpans;
+      std::vector<const ::cluster::ClusterParamsAlg*> cpans;
       
       cpans.reserve(pair.size());
       
       for(auto const& index : pair)
 
-	cpans.push_back(fMatchMgr->GetInputClusters()[index]);
+	cpans.push_back(&(fMatchMgr->GetInputClusters()[index]));
 
       fShowerAlgo->AppendInputClusters(cpans);
     }
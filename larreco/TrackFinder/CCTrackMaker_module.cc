@@ -244,6 +244,10 @@ namespace trkf {
     // vector of many match combinations
     std::vector<MatchPars> matcomb;
     
+    // (X, cluster chain index) of both ends of the cluster chains that are not in a track,
+    // sorted by X in each plane. Filled in PlnMatch
+    std::array<std::vector<std::pair<float, unsigned short>>, 3> chainEndX;
+    
     void PrintClusters() const;
     
     void PrintTracks() const;
@@ -260,6 +264,10 @@ namespace trkf {
     void VtxMatch(art::FindManyP<recob::Hit> const& fmCluHits);
     // match clusters in all planes
     void PlnMatch(art::FindManyP<recob::Hit> const& fmCluHits);
+    // fill the chainEndX vectors
+    void FillChainEndX();
+    // add the cluster chains in plane ipl with an end near x to ccs
+    void FindChainsNearX(unsigned short ipl, float x, float dx, std::vector<unsigned short>& ccs);
     // match clusters in all planes
     void AngMatch(art::FindManyP<recob::Hit> const& fmCluHits);
     
@@ -343,6 +351,7 @@ namespace trkf {
     // vertex fitting
     fNVtxTrkHitsFit         = pset.get< unsigned short  >("NVtxTrkHitsFit");
     fHitFitErrFac           = pset.get< float >("HitFitErrFac");
+    fVertexFitAlg.SetUseMinuit(pset.get< bool >("VertexFitMinuit", false));
     // uB code
     fuBCode                 = pset.get< bool >("uBCode");
     // debugging inputs
@@ -2198,6 +2207,10 @@ namespace trkf {
     // temp array for making a rough charge asymmetry cut
     std::array<float, 3> mchg;
     
+    // only consider cluster chains with an end inside the X cut
+    FillChainEndX();
+    std::vector<unsigned short> jccs, kccs;
+    
     for(unsigned short ipl = 0; ipl < nplanes; ++ipl) {
       for(unsigned short icl = 0; icl < clsChain[ipl].size(); ++icl) {
         if(clsChain[ipl][icl].InTrack >= 0) continue;
@@ -2205,7 +2218,10 @@ namespace trkf {
         if(clsChain[ipl][icl].Length < fMatchMinLen[algIndex]) continue;
         unsigned short jpl = (ipl + 1) % nplanes;
         unsigned short kpl = (jpl + 1) % nplanes;
-        for(unsigned short jcl = 0; jcl < clsChain[jpl].size(); ++jcl) {
+        jccs.clear();
+        for(unsigned short iend = 0; iend < 2; ++iend) FindChainsNearX(jpl, clsChain[ipl][icl].X[iend], dxcut, jccs);
+        for(unsigned short jj = 0; jj < jccs.size(); ++jj) {
+          unsigned short jcl = jccs[jj];
           if(clsChain[jpl][jcl].InTrack >= 0) continue;
           // skip short clusters
           if(clsChain[jpl][jcl].Length < fMatchMinLen[algIndex]) continue;
@@ -2256,7 +2272,10 @@ namespace trkf {
               if(ignoreSign) kAng = fabs(kAng);
               dxkcut = dxcut * AngleFactor(kSlp);
               bool gotkcl = false;
-              for(unsigned short kcl = 0; kcl < clsChain[kpl].size(); ++kcl) {
+              kccs.clear();
+              FindChainsNearX(kpl, kX, dxkcut, kccs);
+              for(unsigned short kk = 0; kk < kccs.size(); ++kk) {
+                unsigned short kcl = kccs[kk];
                 if(clsChain[kpl][kcl].InTrack >= 0) continue;
                 // make second charge asymmetry cut
                 mchg[0] = clsChain[ipl][icl].TotChg;
@@ -2323,6 +2342,36 @@ namespace trkf {
     
   } // PlnMatch
   
+  ///////////////////////////////////////////////////////////////////////
+  void CCTrackMaker::FillChainEndX()
+  {
+    // sort the ends of the cluster chains that are not in a track by X in each plane
+    for(unsigned short ipl = 0; ipl < 3; ++ipl) {
+      chainEndX[ipl].clear();
+      if(ipl >= nplanes) continue;
+      for(unsigned short icl = 0; icl < clsChain[ipl].size(); ++icl) {
+        if(clsChain[ipl][icl].InTrack >= 0) continue;
+        for(unsigned short end = 0; end < 2; ++end) chainEndX[ipl].push_back(std::make_pair(clsChain[ipl][icl].X[end], icl));
+      } // icl
+      std::sort(chainEndX[ipl].begin(), chainEndX[ipl].end());
+    } // ipl
+  } // FillChainEndX
+  
+  ///////////////////////////////////////////////////////////////////////
+  void CCTrackMaker::FindChainsNearX(unsigned short ipl, float x, float dx, std::vector<unsigned short>& ccs)
+  {
+    // Add the cluster chains in plane ipl that have an end within dx of x to ccs, which is
+    // returned sorted by increasing chain index without duplicates, i.e. in the same order
+    // as a loop over all chains. The window is made a bit wider so that the calling
+    // routine can make its X cut as before
+    float xlo = x - dx - 1;
+    float xhi = x + dx + 1;
+    auto it = std::lower_bound(chainEndX[ipl].begin(), chainEndX[ipl].end(), std::make_pair(xlo, (unsigned short)0));
+    for(; it != chainEndX[ipl].end() && it->first <= xhi; ++it) ccs.push_back(it->second);
+    std::sort(ccs.begin(), ccs.end());
+    ccs.erase(std::unique(ccs.begin(), ccs.end()), ccs.end());
+  } // FindChainsNearX
+  
   ///////////////////////////////////////////////////////////////////////
   bool CCTrackMaker::DupMatch(MatchPars& match)
   {
@@ -3356,8 +3405,23 @@ namespace trkf {
     
     unsigned short wire;
     
+    // The hits on wires w1 - w2 are contiguous in allhits (see FillWireHitRange).
+    // Look at all hits if WireHitRange wasn't filled
+    unsigned int fhit = 0, lhit = allhits.size();
+    if(!WireHitRange[ipl].empty()) {
+      lhit = 0;
+      unsigned int wlo = std::max((unsigned int)w1, firstWire[ipl]);
+      unsigned int whi = std::min((unsigned int)w2 + 1, lastWire[ipl]);
+      for(unsigned int w = wlo; w < whi; ++w) {
+        unsigned int indx = w - firstWire[ipl];
+        if(WireHitRange[ipl][indx].first < 0) continue;
+        if(lhit == 0) fhit = WireHitRange[ipl][indx].first;
+        lhit = WireHitRange[ipl][indx].second;
+      } // w
+    }
+    
     float chg = 0;
-    for(unsigned short hit = 0; hit < allhits.size(); ++hit) {
+    for(unsigned int hit = fhit; hit < lhit; ++hit) {
       if(allhits[hit]->WireID().Cryostat != cstat) continue;
       if(allhits[hit]->WireID().TPC != tpc) continue;
       if(allhits[hit]->WireID().Plane != ipl) continue;
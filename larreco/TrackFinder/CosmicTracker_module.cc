@@ -51,6 +51,7 @@
 #include "lardata/Utilities/AssociationUtil.h"
 #include "larreco/RecoAlg/ClusterMatchTQ.h"
 #include "larreco/RecoAlg/CosmicTrackerAlg.h"
+#include "larreco/RecoAlg/ParallelFor.h"
 
 // ROOT includes
 #include "TVectorD.h"
@@ -218,6 +219,8 @@ namespace trkf {
     double          fAngCut;             ///< Angle cut for track merging
 
     bool            fTrajOnly;           ///< Only use trajectory points from TrackTrajectoryAlg for debugging
+
+    size_t          fNumThreads;         ///< Number of threads reconstructing the matched cluster sets
   
 
   }; // class CosmicTracker
@@ -250,6 +253,7 @@ namespace trkf {
     fDisCut                 = pset.get< double >("DisCut");
     fAngCut                 = pset.get< double >("AngCut");
     fTrajOnly               = pset.get< bool   >("TrajOnly");
+    fNumThreads             = pset.get< size_t >("NumThreads", 1);
   }
 
   //-------------------------------------------------
@@ -298,11 +302,11 @@ namespace trkf {
     fClusterMatch.ClusterMatch(clusterlist,fm);
     std::vector<std::vector<unsigned int> > &matchedclusters = fClusterMatch.matchedclusters;
 
-    // get track space points
-    std::vector<std::vector<trkPoint>> trkpts(matchedclusters.size());
+    // hits of each matched cluster set
+    std::vector<std::vector<art::Ptr<recob::Hit> > > hitlists(matchedclusters.size());
     for (size_t itrk = 0; itrk<matchedclusters.size(); ++itrk){//loop over tracks
 
-      std::vector<art::Ptr<recob::Hit> > hitlist;
+      std::vector<art::Ptr<recob::Hit> >& hitlist = hitlists[itrk];
       for (size_t iclu = 0; iclu<matchedclusters[itrk].size(); ++iclu){//loop over clusters
 
         std::vector< art::Ptr<recob::Hit> > hits = fm.at(matchedclusters[itrk][iclu]);
@@ -310,14 +314,29 @@ namespace trkf {
 	  hitlist.push_back(hits[ihit]);
 	}
       }
+      // pointers are resolved lazily: do it here, before they are shared between threads
+      for (size_t ihit = 0; ihit<hitlist.size(); ++ihit) hitlist[ihit].get();
+    }
+
+    // get track space points; the cluster sets are independent of each other,
+    // and each thread runs its own copy of the algorithm
+    std::vector<std::vector<trkPoint>> trkpts(matchedclusters.size());
+    std::vector<std::vector<TVector3>> trajPos(matchedclusters.size());
+    std::vector<std::vector<std::vector<art::Ptr<recob::Hit>>>> trajHit(matchedclusters.size());
+    std::vector<trkf::CosmicTrackerAlg> ctAlgs;
+    for (size_t thread = 1; thread < fNumThreads && thread < matchedclusters.size(); ++thread) ctAlgs.push_back(fCTAlg);
+    util::ParallelFor(matchedclusters.size(), fNumThreads, [&](size_t itrk, size_t thread) {
+
+      trkf::CosmicTrackerAlg& ctAlg = (thread == 0)? fCTAlg: ctAlgs[thread-1];
+      std::vector<art::Ptr<recob::Hit> >& hitlist = hitlists[itrk];
       //reconstruct space points and directions
-      fCTAlg.SPTReco(hitlist);
+      ctAlg.SPTReco(hitlist);
       if (!fTrajOnly){
-	if (!fCTAlg.trkPos.size()) continue;
+	if (!ctAlg.trkPos.size()) return;
 	for (size_t i = 0; i<hitlist.size(); ++i){
 	  trkPoint trkpt;
-	  trkpt.pos = fCTAlg.trkPos[i];
-	  trkpt.dir = fCTAlg.trkDir[i];
+	  trkpt.pos = ctAlg.trkPos[i];
+	  trkpt.dir = ctAlg.trkDir[i];
 	  trkpt.hit = hitlist[i];
 	  trkpts[itrk].push_back(trkpt);
 	}
@@ -328,20 +347,30 @@ namespace trkf {
 	if (fSortDir=="+z") std::sort(trkpts[itrk].begin(),trkpts[itrk].end(),sp_sort_z0);
 	if (fSortDir=="-z") std::sort(trkpts[itrk].begin(),trkpts[itrk].end(),sp_sort_z1);
       }
+      else{
+	trajPos[itrk] = ctAlg.trajPos;
+	trajHit[itrk] = ctAlg.trajHit;
+      }
+    });
+
+    // make the products in the order of the cluster sets
+    for (size_t itrk = 0; itrk<matchedclusters.size(); ++itrk){//loop over tracks
+
+      std::vector<art::Ptr<recob::Hit> >& hitlist = hitlists[itrk];
 
       if (fTrajOnly){//debug only
-	if (!fCTAlg.trajPos.size()) continue;
+	if (!trajPos[itrk].size()) continue;
 	size_t spStart = spcol->size();
 	std::vector<recob::SpacePoint> spacepoints;
 	//      for (size_t ihit = 0; ihit<hitlist.size(); ++ihit){
 	//	if (fCTAlg.usehit[ihit] == 1){
-	for (size_t ipt = 0; ipt<fCTAlg.trajPos.size(); ++ipt){
+	for (size_t ipt = 0; ipt<trajPos[itrk].size(); ++ipt){
 	  art::PtrVector<recob::Hit> sp_hits;
 	  //sp_hits.push_back(hitlist[ihit]);
 	  double hitcoord[3];
-	  hitcoord[0] = fCTAlg.trajPos[ipt].X();
-	  hitcoord[1] = fCTAlg.trajPos[ipt].Y();
-	  hitcoord[2] = fCTAlg.trajPos[ipt].Z();
+	  hitcoord[0] = trajPos[itrk][ipt].X();
+	  hitcoord[1] = trajPos[itrk][ipt].Y();
+	  hitcoord[2] = trajPos[itrk][ipt].Z();
 //	  if (itrk==1){
 //	    std::cout<<"hitcoord "<<hitcoord[0]<<" "<<hitcoord[1]<<" "<<hitcoord[2]<<std::endl;
 //	  }
@@ -352,7 +381,7 @@ namespace trkf {
 				 spStart + spacepoints.size());//3d point at end of track
 	  spacepoints.push_back(mysp);
 	  spcol->push_back(mysp);        
-	  util::CreateAssn(*this, evt, *spcol, fCTAlg.trajHit[ipt], *shassn);
+	  util::CreateAssn(*this, evt, *spcol, trajHit[itrk][ipt], *shassn);
 	  //}//
 	}//ihit
 	size_t spEnd = spcol->size();
@@ -41,6 +41,7 @@
 #include "SimulationBase/MCParticle.h"
 #include "larsim/Simulation/sim.h"
 #include "lardata/MCBase/MCTrack.h"
+#include "larreco/MCComp/MCHitTruthIndex.h"
 
 #include "TH2F.h"
 #include "TFile.h"
@@ -464,6 +465,13 @@ namespace trkf {
     bool fCheckOrigin;
     simb::Origin_t fOriginValue;
     int fPrintLevel;           // 0 = none, 1 = event summary, 2 = track detail
+    bool fUseTruthIndex;       // Back-track all the hits once per event (needs the SimChannels).
+    double fMinHitEnergyFraction;  // BackTracker MinHitEnergyFraction, for the truth index.
+
+    // Truth of all the hits of the event, when fUseTruthIndex is set.
+
+    btutil::MCHitTruthIndex fTruthIndex;
+    bool fHasTruthIndex;
 
     // Histograms.
 
@@ -801,6 +809,9 @@ namespace trkf {
     , fStitchedAnalysis(pset.get<bool>("StitchedAnalysis",false))
     , fOrigin(pset.get<std::string>("MCTrackOrigin", "Any"))
     , fPrintLevel(pset.get<int>("PrintLevel",0))
+    , fUseTruthIndex(pset.get<bool>("UseTruthIndex",false))
+    , fMinHitEnergyFraction(pset.get<double>("MinHitEnergyFraction",0.010))
+    , fHasTruthIndex(false)
     , fNumEvent(0)
   {
     
@@ -1043,6 +1054,17 @@ namespace trkf {
       }
     }
 
+    // Back-track all the hits at once, from the SimChannels of the back
+    // tracker: the efficiency of each matched track otherwise back-tracks
+    // the whole hit collection again.
+
+    fHasTruthIndex = false;
+    fTruthIndex.Clear();
+    if(mc && fUseTruthIndex && !bt->SimChannels().empty()) {
+      fTruthIndex.Reset(bt->SimChannels(), allhits, fMinHitEnergyFraction);
+      fHasTruthIndex = true;
+    }
+
     // Construct FindManyP object to be used for finding track-hit associations.
 
     art::FindManyP<recob::Hit> tkhit_find(trackh, evt, fTrackModuleLabel);
@@ -1289,11 +1311,17 @@ namespace trkf {
 
 		    // Calculate and fill hit efficiency and purity.
 
+		    // The truth index only knows the hits of fHitModuleLabel.
+
 		    std::set<int> tkidset;
 		    tkidset.insert(mcid);
-		    double hiteff = 
+		    bool indexed = fHasTruthIndex && fTruthIndex.Indexed(trackhits);
+		    double hiteff = indexed?
+		      fTruthIndex.Efficiency(tkidset, trackhits, geo::k3D):
 		      bt->HitCollectionEfficiency(tkidset, trackhits, allhits, geo::k3D);
-		    double hitpurity = bt->HitCollectionPurity(tkidset, trackhits);
+		    double hitpurity = indexed?
+		      fTruthIndex.Purity(tkidset, trackhits):
+		      bt->HitCollectionPurity(tkidset, trackhits);
 		    mchists.fHHitEff->Fill(hiteff);
 		    mchists.fHHitPurity->Fill(hitpurity);
 
@@ -39,6 +39,7 @@
 #include "art/Persistency/Common/PtrVector.h"
 #include "messagefacility/MessageLogger/MessageLogger.h"
 #include "fhiclcpp/ParameterSet.h"
+#include "cetlib/exception.h"
 
 
 // ROOT includes.
@@ -116,6 +117,11 @@ private:
     bool fSaveCalib;
     bool fSaveMC;
     bool fSaveJSON;
+    std::string fWfFormat;  // "TH1F": one histogram per waveform; "columnar": flat sample arrays
+    bool fColumnar;
+    int fCompression;       // ROOT compression settings (100*algorithm+level) of the output file; <0 for the ROOT default
+    int fBasketSize;
+    int fAutoFlush;         // number of events between basket flushes; 0 for the ROOT default
     art::ServiceHandle<geo::Geometry> fGeometry;       // pointer to Geometry service
 
     // art::ServiceHandle<geo::Geometry> fGeom;
@@ -141,11 +147,20 @@ private:
     // std::vector<std::vector<float> > fCalib_wf;
     TClonesArray *fCalib_wf;
     // std::vector<std::vector<int> > fCalib_wfTDC;
+    // columnar format: the regions of interest of all channels one after the other
+    std::vector<int> fCalib_roiOffset;     // index of the first ROI of each channel; size == calib_nChannel+1
+    std::vector<int> fCalib_roiStart;      // first tick of each ROI
+    std::vector<int> fCalib_sampleOffset;  // index of the first sample of each ROI in fCalib_charge; size == nROI+1
+    std::vector<float> fCalib_charge;
 
 
     int fRaw_nChannel;
     std::vector<int> fRaw_channelId;
     TClonesArray *fRaw_wf;
+    // columnar format: the samples of all channels one after the other
+    std::vector<int> fRaw_sampleOffset;    // index of the first sample of each channel in fRaw_adc; size == raw_nChannel+1
+    std::vector<short> fRaw_adc;
+    std::vector<short> fRaw_buffer;        // uncompression buffer, reused for all channels
 
     int fSIMIDE_size;
     vector<int> fSIMIDE_channelIdY;
@@ -226,6 +241,14 @@ void CellTree::reconfigure(fhicl::ParameterSet const& p){
     fSaveMC          = p.get<bool>("saveMC");
     fSaveSimChannel  = p.get<bool>("saveSimChannel");
     fSaveJSON        = p.get<bool>("saveJSON");
+    fWfFormat        = p.get<std::string>("wfFormat", "TH1F");
+    fCompression     = p.get<int>("compression", -1);
+    fBasketSize      = p.get<int>("basketSize", 256000);
+    fAutoFlush       = p.get<int>("autoFlush", 0);
+    if (fWfFormat != "TH1F" && fWfFormat != "columnar") {
+        throw cet::exception("CellTree") << "unknown wfFormat " << fWfFormat << ", should be TH1F or columnar\n";
+    }
+    fColumnar = (fWfFormat == "columnar");
 }
 
 //-----------------------------------------------------------------------
@@ -234,10 +257,15 @@ void CellTree::initOutput()
     TDirectory* tmpDir = gDirectory;
 
     fOutFile = new TFile(fOutFileName.c_str(), "recreate");
+    if (fCompression >= 0) fOutFile->SetCompressionSettings(fCompression);
 
     // 3.1: add mc_trackPosition
     TNamed version("version", "3.1");
     version.Write();
+    if (fColumnar) {
+        TNamed wfFormat("wfFormat", fWfFormat.c_str());
+        wfFormat.Write();
+    }
 
     // init Event TTree
     TDirectory* subDir = fOutFile->mkdir("Event");
@@ -250,13 +278,27 @@ void CellTree::initOutput()
     fEventTree->Branch("raw_nChannel", &fRaw_nChannel);  // number of hit channels above threshold
     fEventTree->Branch("raw_channelId" , &fRaw_channelId); // hit channel id; size == raw_nChannel
     fRaw_wf = new TClonesArray("TH1F");
-    fEventTree->Branch("raw_wf", &fRaw_wf, 256000, 0);  // raw waveform adc of each channel
+    if (fColumnar) {
+        fEventTree->Branch("raw_sampleOffset", &fRaw_sampleOffset, fBasketSize);  // first sample of each channel in raw_adc
+        fEventTree->Branch("raw_adc", &fRaw_adc, fBasketSize);  // raw waveform adc of all channels
+    }
+    else {
+        fEventTree->Branch("raw_wf", &fRaw_wf, fBasketSize, 0);  // raw waveform adc of each channel
+    }
 
 
     fEventTree->Branch("calib_nChannel", &fCalib_nChannel);  // number of hit channels above threshold
     fEventTree->Branch("calib_channelId" , &fCalib_channelId); // hit channel id; size == calib_Nhit
     fCalib_wf = new TClonesArray("TH1F");
-    fEventTree->Branch("calib_wf", &fCalib_wf, 256000, 0);  // calib waveform adc of each channel
+    if (fColumnar) {
+        fEventTree->Branch("calib_roiOffset", &fCalib_roiOffset, fBasketSize);  // first ROI of each channel
+        fEventTree->Branch("calib_roiStart", &fCalib_roiStart, fBasketSize);  // first tick of each ROI
+        fEventTree->Branch("calib_sampleOffset", &fCalib_sampleOffset, fBasketSize);  // first sample of each ROI in calib_charge
+        fEventTree->Branch("calib_charge", &fCalib_charge, fBasketSize);  // calib waveform of all ROIs
+    }
+    else {
+        fEventTree->Branch("calib_wf", &fCalib_wf, fBasketSize, 0);  // calib waveform adc of each channel
+    }
     // fCalib_wf->BypassStreamer();
     // fEventTree->Branch("calib_wfTDC", &fCalib_wfTDC);  // calib waveform tdc of each channel
 
@@ -301,6 +343,8 @@ void CellTree::initOutput()
     fEventTree->Branch("mc_nu_pos", &mc_nu_pos, "mc_nu_pos[4]/F");
     fEventTree->Branch("mc_nu_mom", &mc_nu_mom, "mc_nu_mom[4]/F");
 
+    if (fAutoFlush > 0) fEventTree->SetAutoFlush(fAutoFlush);
+
     gDirectory = tmpDir;
 
     if (fSaveJSON) {
@@ -395,6 +439,12 @@ void CellTree::reset()
 
     fCalib_channelId.clear();
     fCalib_wf->Clear();
+    fRaw_sampleOffset.clear();
+    fRaw_adc.clear();
+    fCalib_roiOffset.clear();
+    fCalib_roiStart.clear();
+    fCalib_sampleOffset.clear();
+    fCalib_charge.clear();
 
     fSIMIDE_channelIdY.clear();
     fSIMIDE_trackId.clear();
@@ -458,6 +508,20 @@ void CellTree::processRaw( const art::Event& event )
 
     fRaw_nChannel = wires.size();
 
+    if (fColumnar) {
+        fRaw_channelId.reserve(wires.size());
+        fRaw_sampleOffset.reserve(wires.size()+1);
+        fRaw_sampleOffset.push_back(0);
+        for (auto const& wire: wires) {
+            fRaw_channelId.push_back(wire->Channel());
+            fRaw_buffer.resize(wire->Samples());
+            raw::Uncompress(wire->ADCs(), fRaw_buffer, wire->Compression());
+            fRaw_adc.insert(fRaw_adc.end(), fRaw_buffer.begin(), fRaw_buffer.end());
+            fRaw_sampleOffset.push_back(fRaw_adc.size());
+        }
+        return;
+    }
+
     int i=0;
     for (auto const& wire: wires) {
         int chanId = wire->Channel();
@@ -492,6 +556,24 @@ void CellTree::processCalib( const art::Event& event )
     // cout << "\n wires size: " << wires.size() << endl;
     fCalib_nChannel = wires.size();
 
+    if (fColumnar) {
+        // only the regions of interest are saved, the rest of the waveform is 0
+        fCalib_channelId.reserve(wires.size());
+        fCalib_roiOffset.reserve(wires.size()+1);
+        fCalib_roiOffset.push_back(0);
+        fCalib_sampleOffset.push_back(0);
+        for (auto const& wire: wires) {
+            fCalib_channelId.push_back(wire->Channel());
+            for (auto const& range: wire->SignalROI().get_ranges()) {
+                fCalib_roiStart.push_back(range.begin_index());
+                fCalib_charge.insert(fCalib_charge.end(), range.data().begin(), range.data().end());
+                fCalib_sampleOffset.push_back(fCalib_charge.size());
+            }
+            fCalib_roiOffset.push_back(fCalib_roiStart.size());
+        }
+        return;
+    }
+
     int i=0;
     for (auto const& wire: wires) {
         std::vector<float> calibwf = wire->Signal();
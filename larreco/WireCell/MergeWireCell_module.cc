@@ -16,6 +16,7 @@
 #include "art/Utilities/InputTag.h"
 #include "fhiclcpp/ParameterSet.h"
 #include "messagefacility/MessageLogger/MessageLogger.h"
+#include "cetlib/exception.h"
 
 #include "lardata/RecoBase/Hit.h"
 #include "lardata/RecoBase/SpacePoint.h"
@@ -29,6 +30,9 @@
 
 #include <memory>
 #include <string>
+#include <map>
+#include <tuple>
+#include <unordered_map>
 #include <dirent.h>
 #include <iostream>
 
@@ -62,7 +66,6 @@ public:
 		  std::unique_ptr<art::Assns<recob::Track, recob::SpacePoint>> &trksassn,
 		  std::unique_ptr<std::vector<recob::Hit>> &hit_coll,
 		  std::unique_ptr<std::vector<recob::SpacePoint>> &spt_coll,		  
-		  std::vector<int> &index,
 		  TTree *tree);
 
   // Make recob::Showers
@@ -72,13 +75,35 @@ public:
 		  std::unique_ptr<art::Assns<recob::Shower, recob::SpacePoint>> &shwsassn,
 		  std::unique_ptr<std::vector<recob::Hit>> &hit_coll,
 		  std::unique_ptr<std::vector<recob::SpacePoint>> &spt_coll,		  
-		  std::vector<int> &index,
 		  TTree *tree);
 
 private:
 
+  typedef std::tuple<int,int,int> EventID_t; // run, subrun, event
+
+  // Read run, subrun and event numbers of a Wire-Cell file; false if it has none
+  bool ReadEventID(TFile &f, EventID_t &id) const;
+
+  // Map the events to the Wire-Cell files of the input directory, opening each file once
+  void IndexInput();
+
+  // Find the Wire-Cell file of this event, empty if there is none
+  std::string FindInput(EventID_t const &id);
+
+  // Find the space points (TC entries) of a merged cell; reused for all the tracks and showers of an event
+  void FindCellPoints(int const* msc_id, int npoints,
+		      std::vector<size_t> &spts, std::vector<size_t> &hits) const;
+
   // Declare member data here.
   std::string fInput;
+  bool fIndexInput;
+
+  // event -> file, filled once per job when fIndexInput is set
+  std::map<EventID_t, std::string> fFileIndex;
+  bool fIndexed = false;
+
+  // merged cell id -> TC entries of the current event
+  std::unordered_map<int, std::vector<size_t> > fCellPoints;
 
   static constexpr float Sqrt2Pi = 2.5066;
   static constexpr float SqrtPi  = 1.7725;
@@ -87,7 +112,8 @@ private:
 
 
 wc::MergeWireCell::MergeWireCell(fhicl::ParameterSet const & p) :
-  fInput(p.get<std::string>("WireCellInput"))
+  fInput(p.get<std::string>("WireCellInput")),
+  fIndexInput(p.get<bool>("IndexInput", true))
 {
   // Call appropriate produces<>() functions here.
   produces<std::vector<recob::Hit>                      >();
@@ -119,35 +145,12 @@ void wc::MergeWireCell::produce(art::Event & evt){
   std::unique_ptr<art::Assns<recob::Shower, recob::Hit>> shwhassn(new art::Assns<recob::Shower, recob::Hit>);
   std::unique_ptr<art::Assns<recob::Shower, recob::SpacePoint>> shwsassn(new art::Assns<recob::Shower, recob::SpacePoint>);
 
-  std::string path(fInput);
-  path=(path+"/");
-
-  DIR *pDIR;
-  struct dirent *entry;
-  if( (pDIR=opendir(path.c_str())) != NULL ){
-     
-    while((entry = readdir(pDIR)) != NULL){
-
-      if( strcmp(entry->d_name, ".")==0 || strcmp(entry->d_name, "..")==00) continue;
-
-      std::string filename(entry->d_name);    
-      if((int)filename.find(".root")==-1)
-      continue;
+  std::string file = FindInput(EventID_t(run, subrun, event));
+  if (!file.empty()) {
 
-      std::string file = (path + entry->d_name);
-      TFile *f = new TFile(file.c_str());
-      TTree *Trun = (TTree*)f->Get("Trun");
-      int eventNo, runNo, subRunNo;
-      Trun->SetBranchAddress("eventNo",&eventNo);
-      Trun->SetBranchAddress("runNo",&runNo);
-      Trun->SetBranchAddress("subRunNo",&subRunNo);
-      if (!Trun->GetEntries()) continue;
-      Trun->GetEntry(0);
-      //std::cout<<run<<" "<<subrun<<" "<<event<<" "<<runNo<<" "<<subRunNo<<" "<<eventNo<<std::endl;
-      if (runNo!=run||eventNo!=event||subRunNo!=subrun) {
-	f->Close();
-	continue;
-      }
+      std::unique_ptr<TFile> f(TFile::Open(file.c_str()));
+      if (!f || f->IsZombie())
+	throw cet::exception("MergeWireCell") << "cannot open Wire-Cell file " << file << "\n";
       TTree *TC = (TTree*)f->Get("TC");
       Int_t           time_slice;
       Double_t        charge;
@@ -167,6 +170,12 @@ void wc::MergeWireCell::produce(art::Event & evt){
       Int_t           cryostat_no;
       Int_t           mcell_id;
 
+      // only the branches used here are read
+      TC->SetBranchStatus("*", 0);
+      for (auto const& branch : { "time_slice", "charge", "xx", "yy", "zz",
+	    "u_index", "v_index", "w_index", "u_charge", "v_charge", "w_charge",
+	    "u_charge_err", "v_charge_err", "w_charge_err", "tpc_no", "cryostat_no", "mcell_id" })
+	TC->SetBranchStatus(branch, 1);
       TC->SetBranchAddress("time_slice", &time_slice);
       TC->SetBranchAddress("charge", &charge);
       TC->SetBranchAddress("xx", &xx);
@@ -185,11 +194,14 @@ void wc::MergeWireCell::produce(art::Event & evt){
       TC->SetBranchAddress("cryostat_no", &cryostat_no);
       TC->SetBranchAddress("mcell_id",&mcell_id);
 
-      std::vector<int> vcell_id;
+      Long64_t nCells = TC->GetEntries();
+      spt_coll->reserve(nCells);
+      hit_coll->reserve(3*nCells);
+      for (auto& cell : fCellPoints) cell.second.clear();
 
-      for (int i = 0; i<TC->GetEntries(); ++i){
+      for (int i = 0; i<nCells; ++i){
 	TC->GetEntry(i);
-	vcell_id.push_back(mcell_id);
+	fCellPoints[mcell_id].push_back(i);
 	double xyz[3] = {xx,yy,zz};
 	double err[3] = {0,0,0};
 	spt_coll->push_back(recob::SpacePoint(xyz,err,charge));
@@ -266,20 +278,16 @@ void wc::MergeWireCell::produce(art::Event & evt){
       }//Loop over TC
 
       TTree *T_goodtrack = (TTree*)f->Get("T_goodtrack");
-      MakeTracks(evt, trk_coll, trkhassn, trksassn, hit_coll, spt_coll, vcell_id, T_goodtrack);
+      MakeTracks(evt, trk_coll, trkhassn, trksassn, hit_coll, spt_coll, T_goodtrack);
       TTree *T_shorttrack = (TTree*)f->Get("T_shorttrack");
-      MakeTracks(evt, trk_coll, trkhassn, trksassn, hit_coll, spt_coll, vcell_id, T_shorttrack);
+      MakeTracks(evt, trk_coll, trkhassn, trksassn, hit_coll, spt_coll, T_shorttrack);
       TTree *T_paratrack = (TTree*)f->Get("T_paratrack");
-      MakeTracks(evt, trk_coll, trkhassn, trksassn, hit_coll, spt_coll, vcell_id, T_paratrack);
+      MakeTracks(evt, trk_coll, trkhassn, trksassn, hit_coll, spt_coll, T_paratrack);
 
       TTree *T_shower = (TTree*)f->Get("T_shower");
-      MakeShowers(evt, shw_coll, shwhassn, shwsassn, hit_coll, spt_coll, vcell_id, T_shower);
+      MakeShowers(evt, shw_coll, shwhassn, shwsassn, hit_coll, spt_coll, T_shower);
 
       f->Close();
-      break;
-    }
-    closedir(pDIR);
-
   }
   evt.put(std::move(spt_coll));
   evt.put(std::move(hit_coll));
@@ -298,7 +306,6 @@ void wc::MergeWireCell::MakeTracks(art::Event &evt,
 				   std::unique_ptr<art::Assns<recob::Track, recob::SpacePoint>> &trksassn,
 				   std::unique_ptr<std::vector<recob::Hit>> &hit_coll,
 				   std::unique_ptr<std::vector<recob::SpacePoint>> &spt_coll,		  
-				   std::vector<int> &index,
 				   TTree *tree){
   Int_t           npoints;
   Int_t           trackid;
@@ -309,6 +316,9 @@ void wc::MergeWireCell::MakeTracks(art::Event &evt,
   Double_t        theta[1000];   //[npoints]
   Double_t        phi[1000];   //[npoints]
 
+  tree->SetBranchStatus("*", 0);
+  for (auto const& branch : { "npoints", "trackid", "msc_id", "x", "y", "z", "theta", "phi" })
+    tree->SetBranchStatus(branch, 1);
   tree->SetBranchAddress("npoints", &npoints);
   tree->SetBranchAddress("trackid", &trackid);
   tree->SetBranchAddress("msc_id", msc_id);
@@ -331,15 +341,8 @@ void wc::MergeWireCell::MakeTracks(art::Event &evt,
     for (int i = 0; i<npoints; ++i){
       xyz.push_back(TVector3(x[i],y[i],z[i]));
       dircos.push_back(TVector3(sin(theta[i])*cos(phi[i]),sin(theta[i])*sin(phi[i]),cos(theta[i])));
-      for (size_t j = 0; j<index.size(); ++j){
-	if (index[j]==msc_id[i]){
-	  spts.push_back(j);
-	  hits.push_back(3*j);
-	  hits.push_back(3*j+1);
-	  hits.push_back(3*j+2);
-	}
-      }
     }
+    FindCellPoints(msc_id, npoints, spts, hits);
     trk_coll->push_back(recob::Track(xyz, dircos, dQdx, mom, trackid));
     // make associations between the track and space points
     util::CreateAssn(*this, evt, *trk_coll, *spt_coll, *trksassn, spts);
@@ -354,12 +357,14 @@ void wc::MergeWireCell::MakeShowers(art::Event &evt,
 				   std::unique_ptr<art::Assns<recob::Shower, recob::SpacePoint>> &shwsassn,
 				   std::unique_ptr<std::vector<recob::Hit>> &hit_coll,
 				   std::unique_ptr<std::vector<recob::SpacePoint>> &spt_coll,		  
-				   std::vector<int> &index,
 				   TTree *tree){
   Int_t           npoints;
   Int_t           showerid;
   Int_t           msc_id[1000];   //[npoints]
 
+  tree->SetBranchStatus("*", 0);
+  for (auto const& branch : { "npoints", "showerid", "msc_id" })
+    tree->SetBranchStatus(branch, 1);
   tree->SetBranchAddress("npoints", &npoints);
   tree->SetBranchAddress("showerid", &showerid);
   tree->SetBranchAddress("msc_id", msc_id);
@@ -373,16 +378,7 @@ void wc::MergeWireCell::MakeShowers(art::Event &evt,
     int bestplane = -1;
     std::vector<size_t> hits;
     std::vector<size_t> spts;
-    for (int i = 0; i<npoints; ++i){
-      for (size_t j = 0; j<index.size(); ++j){
-	if (index[j]==msc_id[i]){
-	  spts.push_back(j);
-	  hits.push_back(3*j);
-	  hits.push_back(3*j+1);
-	  hits.push_back(3*j+2);
-	}
-      }
-    }
+    FindCellPoints(msc_id, npoints, spts, hits);
     shw_coll->push_back(recob::Shower(v1, v1, v1, v1, tmp, tmp, tmp, tmp, bestplane, showerid));
     // make associations between the track and space points
     util::CreateAssn(*this, evt, *shw_coll, *spt_coll, *shwsassn, spts);
@@ -391,6 +387,110 @@ void wc::MergeWireCell::MakeShowers(art::Event &evt,
   }
 }    
 
+void wc::MergeWireCell::FindCellPoints(int const* msc_id, int npoints,
+				       std::vector<size_t> &spts, std::vector<size_t> &hits) const{
+  for (int i = 0; i<npoints; ++i){
+    auto cell = fCellPoints.find(msc_id[i]);
+    if (cell == fCellPoints.end()) continue;
+    for (size_t j : cell->second){
+      spts.push_back(j);
+      hits.push_back(3*j);
+      hits.push_back(3*j+1);
+      hits.push_back(3*j+2);
+    }
+  }
+}
+
+bool wc::MergeWireCell::ReadEventID(TFile &f, EventID_t &id) const{
+  TTree *Trun = (TTree*)f.Get("Trun");
+  if (!Trun || !Trun->GetEntries()) return false;
+  int eventNo, runNo, subRunNo;
+  Trun->SetBranchStatus("*", 0);
+  Trun->SetBranchStatus("eventNo", 1);
+  Trun->SetBranchStatus("runNo", 1);
+  Trun->SetBranchStatus("subRunNo", 1);
+  Trun->SetBranchAddress("eventNo",&eventNo);
+  Trun->SetBranchAddress("runNo",&runNo);
+  Trun->SetBranchAddress("subRunNo",&subRunNo);
+  Trun->GetEntry(0);
+  Trun->ResetBranchAddresses();
+  id = EventID_t(runNo, subRunNo, eventNo);
+  return true;
+}
+
+void wc::MergeWireCell::IndexInput(){
+  fFileIndex.clear();
+  fIndexed = true;
+
+  std::string path(fInput);
+  path=(path+"/");
+
+  DIR *pDIR;
+  struct dirent *entry;
+  if( (pDIR=opendir(path.c_str())) == NULL ) return;
+
+  while((entry = readdir(pDIR)) != NULL){
+
+    if( strcmp(entry->d_name, ".")==0 || strcmp(entry->d_name, "..")==00) continue;
+
+    std::string filename(entry->d_name);
+    if((int)filename.find(".root")==-1)
+      continue;
+
+    std::string file = (path + entry->d_name);
+    std::unique_ptr<TFile> f(TFile::Open(file.c_str()));
+    if (!f || f->IsZombie()) continue;
+    EventID_t id;
+    // the first file found for an event is used, as when the directory is scanned for each event
+    if (ReadEventID(*f, id)) fFileIndex.emplace(id, file);
+    f->Close();
+  }
+  closedir(pDIR);
+
+  mf::LogInfo("MergeWireCell") << "Indexed " << fFileIndex.size() << " events in " << fInput;
+}
+
+std::string wc::MergeWireCell::FindInput(EventID_t const &id){
+
+  if (fIndexInput) {
+    if (!fIndexed) IndexInput();
+    auto file = fFileIndex.find(id);
+    return file == fFileIndex.end()? std::string(): file->second;
+  }
+
+  // open the files one by one until the event is found
+  std::string path(fInput);
+  path=(path+"/");
+
+  std::string found;
+  DIR *pDIR;
+  struct dirent *entry;
+  if( (pDIR=opendir(path.c_str())) == NULL ) return found;
+
+  while((entry = readdir(pDIR)) != NULL){
+
+    if( strcmp(entry->d_name, ".")==0 || strcmp(entry->d_name, "..")==00) continue;
+
+    std::string filename(entry->d_name);
+    if((int)filename.find(".root")==-1)
+      continue;
+
+    std::string file = (path + entry->d_name);
+    std::unique_ptr<TFile> f(TFile::Open(file.c_str()));
+    if (!f || f->IsZombie()) continue;
+    EventID_t fileID;
+    bool match = ReadEventID(*f, fileID) && fileID == id;
+    f->Close();
+    if (match) {
+      found = file;
+      break;
+    }
+  }
+  closedir(pDIR);
+
+  return found;
+}
+
 void wc::MergeWireCell::beginJob()
 {
   // Implementation of optional member function here.
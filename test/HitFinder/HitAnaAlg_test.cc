@@ -27,6 +27,11 @@ namespace hit{
 
     void AddHitModuleLabel(std::string str) { alg.HitModuleLabels.push_back(str); }
 
+    void BuildHitIndex(size_t nWires) { alg.BuildHitIndex(nWires); }
+
+    std::vector<size_t> FindHitsInRange(size_t module, size_t wire, size_t begin, size_t end)
+    { std::vector<size_t> positions; alg.FindHitsInRange(module,wire,begin,end,positions); return positions; }
+
   private:
     HitAnaAlg alg;
 
@@ -217,5 +222,34 @@ BOOST_AUTO_TEST_CASE(ClearWireDataHitInfo_OneModule)
 
 }
 
+BOOST_AUTO_TEST_CASE(FindHitsInRange_OneModule)
+{
+  //hits with PeakTimeMinusRMS at 30, 5, 12, 20, 10 (rms of 2), all on wire 0
+  std::vector<float> peak_times = { 32., 7., 14., 22., 12. };
+  std::vector<recob::Hit> HitVector;
+  for(auto const& peak_time : peak_times)
+    HitVector.push_back(recob::Hit(0, peak_time-5, peak_time+5, peak_time, 1., 2., 10., 1., 20., 20., 1., 1, 0, 1., 0,
+				   geo::kU, geo::kInduction, geo::WireID(0,0,0,0)));
+
+  //the wire's hit list is not in time order
+  std::vector< std::vector<int> > AssocVector(2);
+  AssocVector[0] = { 4, 0, 3, 1, 2 };
+
+  myHitAnaAlgTest.LoadHitAssocPair(HitVector,AssocVector,"hit");
+  myHitAnaAlgTest.BuildHitIndex(AssocVector.size());
+
+  //hits starting in [10,20], as positions in the wire's hit list and in that order
+  std::vector<size_t> positions = myHitAnaAlgTest.FindHitsInRange(0,0,10,20);
+  BOOST_CHECK_EQUAL( positions.size() , 3U );
+  BOOST_CHECK_EQUAL( positions[0] , 0U );
+  BOOST_CHECK_EQUAL( positions[1] , 2U );
+  BOOST_CHECK_EQUAL( positions[2] , 4U );
+
+  BOOST_CHECK_EQUAL( myHitAnaAlgTest.FindHitsInRange(0,0,40,50).size() , 0U );
+  BOOST_CHECK_EQUAL( myHitAnaAlgTest.FindHitsInRange(0,0,0,100).size() , 5U );
+  BOOST_CHECK_EQUAL( myHitAnaAlgTest.FindHitsInRange(0,1,0,100).size() , 0U );
+
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
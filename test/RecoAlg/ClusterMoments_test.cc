@@ -0,0 +1,148 @@
+/**
+ * @file   ClusterMoments_test.cc
+ * @brief  Test of the mergeable hit moments of 2D clusters
+ * @see    ClusterMoments.h
+ *
+ * The averages and eigenvalues are compared with the TPrincipal result used by
+ * ClusterParamsAlg::GetAverages(), and the moments of a cluster merged from
+ * parts are compared with the ones filled from all its hits.
+ */
+
+// C/C++ standard libraries
+#include <cmath>
+#include <vector>
+#include <random>
+
+// boost test libraries
+#define BOOST_TEST_MODULE ( ClusterMoments_test )
+#include "boost/test/auto_unit_test.hpp"
+#include <boost/test/unit_test.hpp>
+
+// ROOT libraries
+#include "TPrincipal.h"
+#include "TVectorD.h"
+
+// LArSoft libraries
+#include "larreco/RecoAlg/ClusterRecoUtil/ClusterMoments.h"
+
+
+//------------------------------------------------------------------------------
+/// Random hits along a line on a wire plane, a few of them on the same wire
+std::vector<util::PxHit> MakeHits
+  (std::mt19937& engine, unsigned int nHits, double slope, double width)
+{
+  std::uniform_real_distribution<double> uniform(0., 1.);
+  std::normal_distribution<double> gaus;
+  double const wirePitch = 0.3;
+
+  std::vector<util::PxHit> hits;
+  for (unsigned int i = 0; i < nHits; ++i) {
+    util::PxHit hit;
+    hit.w = wirePitch * std::floor(100. * uniform(engine));
+    hit.t = 20. + slope * hit.w + width * gaus(engine);
+    hit.charge = 50. + 200. * uniform(engine);
+    hit.sumADC = 0.9 * hit.charge + 10. * uniform(engine);
+    hits.push_back(hit);
+  } // for
+  return hits;
+} // MakeHits()
+
+
+/// Checks that two sets of moments describe the same hits
+void CheckSameMoments
+  (cluster::ClusterMoments const& a, cluster::ClusterMoments const& b)
+{
+  double const tol = 1e-8; // percent
+
+  BOOST_CHECK_EQUAL(a.N(), b.N());
+  BOOST_CHECK_EQUAL(a.NWires(), b.NWires());
+  BOOST_CHECK_EQUAL(a.MultiHitWires(), b.MultiHitWires());
+  BOOST_CHECK_CLOSE(a.SumCharge(), b.SumCharge(), tol);
+  BOOST_CHECK_CLOSE(a.MeanCharge(), b.MeanCharge(), tol);
+  BOOST_CHECK_CLOSE(a.RMSCharge(), b.RMSCharge(), tol);
+  BOOST_CHECK_CLOSE(a.SumADC(), b.SumADC(), tol);
+  BOOST_CHECK_CLOSE(a.MeanADC(), b.MeanADC(), tol);
+  BOOST_CHECK_CLOSE(a.RMSADC(), b.RMSADC(), tol);
+  BOOST_CHECK_CLOSE(a.MeanW(), b.MeanW(), tol);
+  BOOST_CHECK_CLOSE(a.MeanT(), b.MeanT(), tol);
+  BOOST_CHECK_CLOSE(a.RMSW(), b.RMSW(), tol);
+  BOOST_CHECK_CLOSE(a.RMST(), b.RMST(), tol);
+  BOOST_CHECK_CLOSE(a.ChargeWeightedW(), b.ChargeWeightedW(), tol);
+  BOOST_CHECK_CLOSE(a.ChargeWeightedT(), b.ChargeWeightedT(), tol);
+  BOOST_CHECK_SMALL(a.EigenValues().first - b.EigenValues().first, 1e-10);
+  BOOST_CHECK_SMALL(a.EigenValues().second - b.EigenValues().second, 1e-10);
+} // CheckSameMoments()
+
+
+//------------------------------------------------------------------------------
+BOOST_AUTO_TEST_SUITE( ClusterMomentsSuite )
+
+
+BOOST_AUTO_TEST_CASE(CompareWithTPrincipalTest)
+{
+  std::mt19937 engine(12345);
+
+  for (int iTest = 0; iTest < 200; ++iTest) {
+    auto hits = MakeHits(engine, 3 + iTest % 300, -2. + 0.02 * iTest, 0.1 + iTest % 5);
+
+    cluster::ClusterMoments moments;
+    moments.Fill(hits);
+
+    // as in ClusterParamsAlg::GetAverages()
+    TPrincipal principal(2, "D");
+    double sumQ = 0., sumQW = 0., sumQT = 0.;
+    for (auto const& hit: hits) {
+      double data[2] = { hit.w, hit.t };
+      principal.AddRow(data);
+      sumQ += hit.charge;
+      sumQW += hit.w * hit.charge;
+      sumQT += hit.t * hit.charge;
+    } // for
+    principal.MakePrincipals();
+
+    BOOST_CHECK_EQUAL(moments.N(), hits.size());
+    BOOST_CHECK_CLOSE(moments.SumCharge(), sumQ, 1e-8);
+    BOOST_CHECK_CLOSE(moments.ChargeWeightedW(), sumQW / sumQ, 1e-8);
+    BOOST_CHECK_CLOSE(moments.ChargeWeightedT(), sumQT / sumQ, 1e-8);
+    BOOST_CHECK_SMALL(moments.MeanW() - (*principal.GetMeanValues())[0], 1e-8);
+    BOOST_CHECK_SMALL(moments.MeanT() - (*principal.GetMeanValues())[1], 1e-8);
+
+    std::pair<double, double> eigenValues = moments.EigenValues();
+    BOOST_CHECK_SMALL(eigenValues.first - (*principal.GetEigenValues())[0], 1e-8);
+    BOOST_CHECK_SMALL(eigenValues.second - (*principal.GetEigenValues())[1], 1e-8);
+  } // for
+} // CompareWithTPrincipalTest
+
+
+BOOST_AUTO_TEST_CASE(MergeTest)
+{
+  std::mt19937 engine(54321);
+  auto hits = MakeHits(engine, 500, 0.7, 1.);
+
+  cluster::ClusterMoments all;
+  all.Fill(hits);
+
+  // three parts, some sharing wires, merged in two different ways
+  std::vector<util::PxHit> part1(hits.begin(), hits.begin() + 100),
+    part2(hits.begin() + 100, hits.begin() + 350),
+    part3(hits.begin() + 350, hits.end());
+  cluster::ClusterMoments moments1, moments2, moments3, empty;
+  moments1.Fill(part1);
+  moments2.Fill(part2);
+  for (auto const& hit: part3) moments3.Add(hit);
+
+  cluster::ClusterMoments merged = moments1;
+  merged.Merge(moments2);
+  merged.Merge(empty);
+  merged.Merge(moments3);
+  CheckSameMoments(merged, all);
+
+  cluster::ClusterMoments mergedFromEmpty;
+  mergedFromEmpty.Merge(moments3);
+  mergedFromEmpty.Merge(moments1);
+  mergedFromEmpty.Merge(moments2);
+  CheckSameMoments(mergedFromEmpty, all);
+} // MergeTest
+
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,198 @@
+/**
+ * @file   EndPointAlg_test.cc
+ * @brief  Test of the sparse cornerness map of the 2D end point finder
+ * @see    EndPointAlg.h
+ *
+ * The cornerness of the cells with a hit, computed by the sparse map only in
+ * the tiles around the hits, must be the same as the one of the dense map of
+ * EndPoint(), whose loops are reproduced here on the whole plane.
+ */
+
+// C/C++ standard libraries
+#include <cmath>
+#include <vector>
+#include <random>
+
+// boost test libraries
+#define BOOST_TEST_MODULE ( EndPointAlg_test )
+#include "boost/test/auto_unit_test.hpp"
+#include <boost/test/unit_test.hpp>
+
+// LArSoft libraries
+#include "fhiclcpp/ParameterSet.h"
+#include "larreco/RecoAlg/EndPointAlg.h"
+
+// ROOT libraries
+#include "TMath.h"
+
+
+//------------------------------------------------------------------------------
+double Gaussian(int x, int y, double sigma)
+{
+  return std::exp(-(std::pow(x, 2) + std::pow(y, 2)) / (2 * std::pow(sigma, 2)))
+    / std::sqrt(2 * TMath::Pi() * std::pow(sigma, 2));
+} // Gaussian()
+
+
+/// Derivative of the Gaussian in x (or in y, swapping the arguments)
+double GaussianDerivative(int x, int y, double sigma)
+{
+  return -x * std::exp(-(std::pow(x, 2) + std::pow(y, 2)) / (2 * std::pow(sigma, 2)))
+    / (std::sqrt(2 * TMath::Pi()) * std::pow(sigma, 3));
+} // GaussianDerivative()
+
+
+/// Candidates from the dense map over the whole plane, as in EndPointAlg::EndPoint()
+std::vector<cluster::EndPointAlg::CornerCandidate> DenseCornerness(
+  std::vector<cluster::EndPointAlg::MapHit> const& hits,
+  unsigned int numberwires, unsigned int numbertimesamples, int timeBins, double gsigma)
+{
+  double w[49], wx[49], wy[49];
+  int n = 0;
+  for (int i = -3; i < 4; ++i) {
+    for (int j = 3; j > -4; --j) {
+      w[n] = Gaussian(i, j, gsigma);
+      wx[n] = GaussianDerivative(i, j, gsigma);
+      wy[n] = GaussianDerivative(j, i, gsigma);
+      ++n;
+    }
+  }
+
+  std::vector<std::vector<double>> hit_map(numberwires, std::vector<double>(timeBins, 0.));
+  std::vector<std::vector<double>> MatrixAsum(hit_map), MatrixBsum(hit_map);
+  const float TicksPerBin = numbertimesamples / timeBins;
+  for (auto const& hit: hits) {
+    const int iFirstBin = int((hit.peakTime - 3*hit.rms) / TicksPerBin),
+      iLastBin = int((hit.peakTime + 3*hit.rms) / TicksPerBin);
+    for (int iBin = iFirstBin; iBin <= iLastBin; ++iBin)
+      hit_map[hit.wire][iBin] += Gaussian(iBin * TicksPerBin, hit.peakTime, hit.rms);
+  }
+
+  // the window is clamped at the edges of the map
+  auto windex = [numberwires](int i){ return std::min(std::max(i, 0), int(numberwires) - 1); };
+  auto tindex = [timeBins](int j){ return std::min(std::max(j, 0), timeBins - 1); };
+
+  for (unsigned int wire = 1; wire < numberwires - 1; ++wire) {
+    for (int timebin = 1; timebin < timeBins - 1; ++timebin) {
+      n = 0;
+      for (int i = -3; i <= 3; ++i) {
+        for (int j = -3; j <= 3; ++j) {
+          MatrixAsum[wire][timebin] += wx[n] * hit_map[windex(wire + i)][tindex(timebin + j)];
+          MatrixBsum[wire][timebin] += wy[n] * hit_map[windex(wire + i)][tindex(timebin + j)];
+          ++n;
+        }
+      }
+    }
+  }
+
+  std::vector<cluster::EndPointAlg::CornerCandidate> candidates;
+  for (unsigned int wire = 1; wire < numberwires - 1; ++wire) {
+    for (int timebin = 1; timebin < timeBins - 1; ++timebin) {
+      double AA = 0., BB = 0., CC = 0.;
+      n = 0;
+      for (int i = -3; i <= 3; ++i) {
+        for (int j = -3; j <= 3; ++j) {
+          const double A = MatrixAsum[windex(wire + i)][tindex(timebin + j)],
+            B = MatrixBsum[windex(wire + i)][tindex(timebin + j)];
+          AA += w[n] * std::pow(A, 2);
+          BB += w[n] * std::pow(B, 2);
+          CC += w[n] * A * B;
+          ++n;
+        }
+      }
+      const double cornerness = (AA + BB > 0)? (AA*BB - std::pow(CC, 2)) / (AA + BB): 0.;
+      if (cornerness <= 0) continue;
+
+      // the first hit on the cell, as recob::Hit::TimeDistanceAsRMS()
+      for (size_t i = 0; i < hits.size(); ++i) {
+        const float time = timebin * (numbertimesamples / timeBins);
+        if (hits[i].wire == wire && std::abs((time - hits[i].peakTime) / hits[i].rms) < 1.) {
+          candidates.push_back({ wire, timebin, cornerness, i });
+          break;
+        }
+      }
+    } // for time bins
+  } // for wires
+  return candidates;
+} // DenseCornerness()
+
+
+/// Adds hits on consecutive wires along a line in the (wire, tick) plane
+void AddTrack(std::mt19937& engine, std::vector<cluster::EndPointAlg::MapHit>& hits,
+              unsigned int firstWire, unsigned int nWires, float startTime, float slope)
+{
+  std::uniform_real_distribution<float> rms(12., 20.);
+  for (unsigned int k = 0; k < nWires; ++k)
+    hits.push_back({ firstWire + k, startTime + slope * k, rms(engine) });
+} // AddTrack()
+
+
+/// Compares the sparse and the dense candidates
+void CheckCandidates(cluster::EndPointAlg& alg, std::vector<cluster::EndPointAlg::MapHit> const& hits,
+                     unsigned int numberwires, unsigned int numbertimesamples, int timeBins, double gsigma)
+{
+  std::vector<cluster::EndPointAlg::CornerCandidate> sparse;
+  alg.SparseCornerness(hits, numberwires, numbertimesamples, sparse);
+  auto const dense = DenseCornerness(hits, numberwires, numbertimesamples, timeBins, gsigma);
+
+  BOOST_CHECK_EQUAL(sparse.size(), dense.size());
+  for (size_t i = 0; i < std::min(sparse.size(), dense.size()); ++i) {
+    BOOST_CHECK_EQUAL(sparse[i].wire, dense[i].wire);
+    BOOST_CHECK_EQUAL(sparse[i].timebin, dense[i].timebin);
+    BOOST_CHECK_EQUAL(sparse[i].hitIndex, dense[i].hitIndex);
+    BOOST_CHECK_CLOSE(sparse[i].cornerness, dense[i].cornerness, 1e-6);
+  } // for
+} // CheckCandidates()
+
+
+//------------------------------------------------------------------------------
+BOOST_AUTO_TEST_SUITE( EndPointAlgSuite )
+
+
+BOOST_AUTO_TEST_CASE(SparseCornernessTest)
+{
+  // 4 ticks per time bin; the hits are far enough from the edges of the map
+  // for all their pixels to be in it
+  unsigned int const numberwires = 120, numbertimesamples = 400;
+  int const timeBins = 100;
+  double const gsigma = 1.;
+
+  fhicl::ParameterSet pset;
+  pset.put("TimeBins", timeBins);
+  pset.put("MaxCorners", 20);
+  pset.put("Gsigma", gsigma);
+  pset.put("Window", 5);
+  pset.put("Threshold", 0.1);
+  pset.put("SaveVertexMap", -1);
+  pset.put("SparseTiles", true);
+  cluster::EndPointAlg alg(pset);
+
+  std::mt19937 engine(12345);
+  std::uniform_int_distribution<unsigned int> firstWire(5, 80), nWires(3, 30);
+  std::uniform_real_distribution<float> startTime(100., 130.), slope(-1., 1.);
+
+  // a kink, then random tracks, some crossing the tiles and some far apart
+  std::vector<cluster::EndPointAlg::MapHit> hits;
+  AddTrack(engine, hits, 20, 20, 80., 2.);
+  AddTrack(engine, hits, 40, 20, 120., -1.);
+  CheckCandidates(alg, hits, numberwires, numbertimesamples, timeBins, gsigma);
+
+  for (int event = 0; event < 10; ++event) {
+    hits.clear();
+    for (int track = 0; track <= event % 4; ++track) {
+      unsigned int const wire = firstWire(engine), n = nWires(engine);
+      float const t0 = startTime(engine);
+      AddTrack(engine, hits, wire, n, t0, slope(engine));
+    }
+    CheckCandidates(alg, hits, numberwires, numbertimesamples, timeBins, gsigma);
+  } // for
+
+  // no hit, no candidate
+  hits.clear();
+  std::vector<cluster::EndPointAlg::CornerCandidate> candidates(1);
+  alg.SparseCornerness(hits, numberwires, numbertimesamples, candidates);
+  BOOST_CHECK(candidates.empty());
+} // SparseCornernessTest
+
+
+BOOST_AUTO_TEST_SUITE_END()
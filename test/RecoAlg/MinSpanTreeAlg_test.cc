@@ -0,0 +1,97 @@
+/**
+ * @file   MinSpanTreeAlg_test.cc
+ * @brief  Test of the minimum spanning tree splitting of Cluster3D
+ * @see    MinSpanTreeAlg.h
+ *
+ * Two straight branches, separated by a gap bridged by a few stray points,
+ * must come out as two pieces, each containing a whole branch; a single
+ * branch must not be split.
+ */
+
+// C/C++ standard libraries
+#include <vector>
+#include <random>
+
+// boost test libraries
+#define BOOST_TEST_MODULE ( MinSpanTreeAlg_test )
+#include "boost/test/auto_unit_test.hpp"
+#include <boost/test/unit_test.hpp>
+
+// LArSoft libraries
+#include "fhiclcpp/ParameterSet.h"
+#include "larreco/RecoAlg/Cluster3DAlgs/MinSpanTreeAlg.h"
+
+
+//------------------------------------------------------------------------------
+/// Adds nPoints along the segment from start to end, with a gaussian spread
+void AddBranch(std::mt19937& engine, std::vector<double>& positions,
+               const double start[3], const double end[3], unsigned int nPoints, double spread)
+{
+  std::uniform_real_distribution<double> uniform(0., 1.);
+  std::normal_distribution<double> gaus(0., spread);
+
+  for (unsigned int i = 0; i < nPoints; ++i) {
+    double a = uniform(engine);
+    for (int k = 0; k < 3; ++k)
+      positions.push_back(start[k] + a * (end[k] - start[k]) + gaus(engine));
+  } // for
+} // AddBranch()
+
+
+//------------------------------------------------------------------------------
+BOOST_AUTO_TEST_SUITE( MinSpanTreeAlgSuite )
+
+
+BOOST_AUTO_TEST_CASE(TwoBranchesTest)
+{
+  std::mt19937 engine(12345);
+  lar_cluster3d::MinSpanTreeAlg alg{fhicl::ParameterSet()};
+
+  // first branch along x, second one going up in y from 20 cm past its end
+  unsigned int const nBranch = 300;
+  double const start1[] = {  0.,  0., 0. }, end1[] = { 60.,  0., 0. };
+  double const start2[] = { 80.,  0., 0. }, end2[] = { 80., 60., 0. };
+
+  std::vector<double> positions;
+  AddBranch(engine, positions, start1, end1, nBranch, 0.2);
+  AddBranch(engine, positions, start2, end2, nBranch, 0.2);
+
+  // stray points across the gap, each one further than the cut length from the others
+  for (double x: { 65., 70., 75. }) positions.insert(positions.end(), { x, 0., 0. });
+
+  std::vector<size_t> pieceIndex;
+  size_t const nPieces = alg.PartitionPoints(positions, 0.2, pieceIndex);
+
+  BOOST_CHECK_EQUAL(nPieces, 2U);
+  BOOST_CHECK_EQUAL(pieceIndex.size(), positions.size() / 3);
+
+  // each branch is in one piece, and the two pieces differ
+  for (unsigned int i = 0; i < nBranch; ++i) {
+    BOOST_CHECK_EQUAL(pieceIndex[i], pieceIndex[0]);
+    BOOST_CHECK_EQUAL(pieceIndex[nBranch + i], pieceIndex[nBranch]);
+  } // for
+  BOOST_CHECK_NE(pieceIndex[0], pieceIndex[nBranch]);
+
+  // the stray points are put back with one of the branches
+  for (size_t i = 2 * nBranch; i < pieceIndex.size(); ++i) BOOST_CHECK_LT(pieceIndex[i], 2U);
+} // TwoBranchesTest
+
+
+BOOST_AUTO_TEST_CASE(SingleBranchTest)
+{
+  std::mt19937 engine(54321);
+  lar_cluster3d::MinSpanTreeAlg alg{fhicl::ParameterSet()};
+
+  double const start[] = { 0., 0., 0. }, end[] = { 50., 30., 20. };
+
+  std::vector<double> positions;
+  AddBranch(engine, positions, start, end, 500, 0.2);
+
+  std::vector<size_t> pieceIndex;
+  BOOST_CHECK_EQUAL(alg.PartitionPoints(positions, 0.2, pieceIndex), 1U);
+  BOOST_CHECK_EQUAL(pieceIndex.size(), 500U);
+  for (size_t piece: pieceIndex) BOOST_CHECK_EQUAL(piece, 0U);
+} // SingleBranchTest
+
+
+BOOST_AUTO_TEST_SUITE_END()
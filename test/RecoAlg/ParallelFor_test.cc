@@ -0,0 +1,65 @@
+/**
+ * @file   ParallelFor_test.cc
+ * @brief  Test of the thread pool running independent items
+ * @see    ParallelFor.h
+ *
+ * Each item must be processed exactly once, by a thread with a valid number,
+ * whatever the number of threads; an exception thrown by an item must reach
+ * the caller.
+ */
+
+// C/C++ standard libraries
+#include <stdexcept>
+#include <vector>
+
+// boost test libraries
+#define BOOST_TEST_MODULE ( ParallelFor_test )
+#include "boost/test/auto_unit_test.hpp"
+#include <boost/test/unit_test.hpp>
+
+// LArSoft libraries
+#include "larreco/RecoAlg/ParallelFor.h"
+
+
+//------------------------------------------------------------------------------
+BOOST_AUTO_TEST_SUITE( ParallelForSuite )
+
+
+BOOST_AUTO_TEST_CASE(AllItemsTest)
+{
+  size_t const n = 1000;
+
+  for (size_t nThreads: { 0, 1, 2, 4, 2000 }) {
+    std::vector<int> count(n, 0);
+    std::vector<size_t> threadOf(n, 0);
+    util::ParallelFor(n, nThreads, [&](size_t index, size_t thread) {
+      ++count[index];
+      threadOf[index] = thread;
+    });
+
+    for (size_t i = 0; i < n; ++i) {
+      BOOST_CHECK_EQUAL(count[i], 1);
+      BOOST_CHECK_LT(threadOf[i], std::max<size_t>(nThreads, 1));
+    } // for
+  } // for nThreads
+
+  // no item, no call
+  int calls = 0;
+  util::ParallelFor(0, 4, [&](size_t, size_t) { ++calls; });
+  BOOST_CHECK_EQUAL(calls, 0);
+} // AllItemsTest
+
+
+BOOST_AUTO_TEST_CASE(ExceptionTest)
+{
+  for (size_t nThreads: { 1, 4 }) {
+    BOOST_CHECK_THROW(
+      util::ParallelFor(100, nThreads, [](size_t index, size_t) {
+        if (index == 37) throw std::runtime_error("item 37");
+      }),
+      std::runtime_error);
+  } // for nThreads
+} // ExceptionTest
+
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,188 @@
+/**
+ * @file   PlaneProjectionTable_test.cc
+ * @brief  Test of the per-run wire plane projection table
+ * @see    PlaneProjectionTable.h
+ *
+ * The table is filled from mock geometry and detector properties providers
+ * with the same interface as geo::GeometryCore and detinfo::DetectorProperties,
+ * and all its queries are compared with the ones of the providers.
+ */
+
+// C/C++ standard libraries
+#include <cmath>
+#include <random>
+
+// boost test libraries
+#define BOOST_TEST_MODULE ( PlaneProjectionTable_test )
+#include "boost/test/auto_unit_test.hpp"
+#include <boost/test/unit_test.hpp>
+
+// LArSoft libraries
+#include "larreco/RecoAlg/PlaneProjectionTable.h"
+
+// Framework libraries
+#include "cetlib/exception.h"
+
+
+//------------------------------------------------------------------------------
+/// Wire with its centre, as geo::WireGeo
+struct MockWire {
+  double y, z;
+  void GetCenter(double* xyz) const { xyz[0] = 0.; xyz[1] = y; xyz[2] = z; }
+}; // MockWire
+
+
+/**
+ * @brief Geometry with two cryostats of four TPCs of two planes
+ *
+ * The TPCs are in pairs along z; the wires of plane 0 (induction) are at an
+ * angle, the ones of plane 1 (collection) are vertical. Each TPC has its own
+ * origin, so the wire coordinate of the same point differs between TPCs.
+ */
+struct MockGeometry {
+
+  unsigned int Ncryostats() const { return 2; }
+  unsigned int NTPC(unsigned int) const { return 4; }
+  unsigned int Nplanes(unsigned int, unsigned int) const { return 2; }
+
+  double WirePitch(geo::PlaneID const& planeID) const
+    { return planeID.Plane == 0? 0.5: 0.45; }
+
+  geo::SigType_t SignalType(geo::PlaneID const& planeID) const
+    { return planeID.Plane == 0? geo::kInduction: geo::kCollection; }
+
+  unsigned int Nwires(unsigned int plane, unsigned int tpc, unsigned int cryo) const
+    { return 100 + 10 * plane + 2 * tpc + cryo; }
+
+  double WireCoordinate(double y, double z, unsigned int plane, unsigned int tpc, unsigned int cryo) const
+    {
+      double const angle = plane == 0? 0.6: 0.;
+      geo::PlaneID const planeID(cryo, tpc, plane);
+      return (std::cos(angle) * (z - ZOrigin(tpc, cryo)) + std::sin(angle) * (y - YOrigin(tpc)))
+        / WirePitch(planeID);
+    }
+
+  MockWire WireIDToWireGeo(geo::WireID const& wireID) const
+    {
+      // the wire coordinate of the centre is the wire number
+      double const angle = wireID.Plane == 0? 0.6: 0.;
+      double const dist = wireID.Wire * WirePitch(wireID);
+      return { YOrigin(wireID.TPC) + std::sin(angle) * dist, ZOrigin(wireID.TPC, wireID.Cryostat) + std::cos(angle) * dist };
+    }
+
+  double YOrigin(unsigned int tpc) const { return (tpc % 2 == 0)? -100.: 0.; }
+  double ZOrigin(unsigned int tpc, unsigned int cryo) const { return 1000. * cryo + 50. * (tpc / 2); }
+
+}; // MockGeometry
+
+
+/// Drift velocity and trigger offset different for each plane, as detinfo::DetectorProperties
+struct MockDetectorProperties {
+
+  double ConvertTicksToX(double ticks, geo::PlaneID const& planeID) const
+    { return (ticks - TickOffset(planeID)) * DriftScale(planeID); }
+
+  double TickOffset(geo::PlaneID const& planeID) const
+    { return 3200. + 10. * planeID.Plane + planeID.TPC; }
+
+  double DriftScale(geo::PlaneID const& planeID) const
+    { return (planeID.TPC % 2 == 0? 1.: -1.) * (0.08 + 0.001 * planeID.Cryostat); }
+
+}; // MockDetectorProperties
+
+
+//------------------------------------------------------------------------------
+BOOST_AUTO_TEST_SUITE( PlaneProjectionTableSuite )
+
+
+BOOST_AUTO_TEST_CASE(GeometryTest)
+{
+  MockGeometry const geom;
+  util::PlaneProjectionTable table;
+  BOOST_CHECK(!table.HasGeometry());
+
+  table.UpdateGeometry(geom);
+  BOOST_CHECK(table.HasGeometry());
+  BOOST_CHECK(!table.HasDetectorProperties());
+
+  std::mt19937 engine(12345);
+  std::uniform_real_distribution<double> uniform(-200., 200.);
+
+  for (unsigned int cryo = 0; cryo < geom.Ncryostats(); ++cryo) {
+    for (unsigned int tpc = 0; tpc < geom.NTPC(cryo); ++tpc) {
+      for (unsigned int plane = 0; plane < geom.Nplanes(tpc, cryo); ++plane) {
+        geo::PlaneID const planeID(cryo, tpc, plane);
+        BOOST_CHECK_EQUAL(table.WirePitch(planeID), geom.WirePitch(planeID));
+        BOOST_CHECK_EQUAL(table.SignalType(planeID), geom.SignalType(planeID));
+        BOOST_CHECK_EQUAL(table.Nwires(planeID), geom.Nwires(plane, tpc, cryo));
+
+        for (int i = 0; i < 10; ++i) {
+          double const y = uniform(engine), z = uniform(engine);
+          BOOST_CHECK_SMALL(table.WireCoordinate(y, z, planeID) - geom.WireCoordinate(y, z, plane, tpc, cryo), 1e-9);
+        } // for
+
+        // the wire centre projected on the plane of the reference TPC
+        for (unsigned int wire = 0; wire < geom.Nwires(plane, tpc, cryo); ++wire) {
+          geo::WireID const wireID(cryo, tpc, plane, wire);
+          double wireCentre[3];
+          geom.WireIDToWireGeo(wireID).GetCenter(wireCentre);
+          double const expected = geom.WireCoordinate(wireCentre[1], wireCentre[2], plane, tpc % 2, cryo);
+          BOOST_CHECK_SMALL(table.ReferenceWireCoordinate(wireID) - expected, 1e-9);
+          if (tpc < 2) BOOST_CHECK_SMALL(table.ReferenceWireCoordinate(wireID) - wire, 1e-9);
+        } // for wire
+      } // for plane
+    } // for TPC
+  } // for cryostat
+
+  // planes not in the geometry
+  BOOST_CHECK_THROW(table.PlaneIndex(geo::PlaneID(0, 0, 2)), cet::exception);
+  BOOST_CHECK_THROW(table.PlaneIndex(geo::PlaneID(0, 4, 0)), cet::exception);
+  BOOST_CHECK_THROW(table.WirePitch(geo::PlaneID(2, 0, 0)), cet::exception);
+} // GeometryTest
+
+
+BOOST_AUTO_TEST_CASE(DetectorPropertiesTest)
+{
+  MockGeometry const geom;
+  MockDetectorProperties const detprop;
+  util::PlaneProjectionTable table;
+
+  // the drift part needs the geometry part
+  table.UpdateDetectorProperties(detprop);
+  BOOST_CHECK(!table.HasDetectorProperties());
+
+  table.UpdateGeometry(geom);
+  table.UpdateDetectorProperties(detprop);
+  BOOST_CHECK(table.HasDetectorProperties());
+
+  for (unsigned int cryo = 0; cryo < geom.Ncryostats(); ++cryo) {
+    for (unsigned int tpc = 0; tpc < geom.NTPC(cryo); ++tpc) {
+      for (unsigned int plane = 0; plane < geom.Nplanes(tpc, cryo); ++plane) {
+        geo::PlaneID const planeID(cryo, tpc, plane);
+        for (double ticks: { 0., 1., 3205.5, 9599. }) {
+          double const x = detprop.ConvertTicksToX(ticks, planeID);
+          BOOST_CHECK_SMALL(table.TicksToX(ticks, planeID) - x, 1e-9);
+          BOOST_CHECK_SMALL(table.XToTicks(x, planeID) - ticks, 1e-7);
+        } // for ticks
+      } // for plane
+    } // for TPC
+  } // for cryostat
+
+  // a new geometry clears the drift part
+  table.UpdateGeometry(geom);
+  BOOST_CHECK(!table.HasDetectorProperties());
+} // DetectorPropertiesTest
+
+
+BOOST_AUTO_TEST_CASE(NoProvidersTest)
+{
+  // an empty table asks the providers, and there are none
+  util::PlaneProjectionTable table;
+  geo::PlaneID const planeID(0, 0, 0);
+  BOOST_CHECK_THROW(table.WirePitch(planeID), cet::exception);
+  BOOST_CHECK_THROW(table.ReferenceWireCoordinate(geo::WireID(planeID, 0)), cet::exception);
+  BOOST_CHECK_THROW(table.TicksToX(0., planeID), cet::exception);
+} // NoProvidersTest
+
+
+BOOST_AUTO_TEST_SUITE_END()
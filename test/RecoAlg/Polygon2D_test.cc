@@ -0,0 +1,214 @@
+/**
+ * @file   Polygon2D_test.cc
+ * @brief  Test and micro-benchmark for the Polygon2D overlap/containment queries
+ * @see    Polygon2D.h
+ *
+ * The optimised queries (bounding box rejection, convex polygon binary search,
+ * edge sweep) are compared with the all-pairs implementations they replace,
+ * on random convex and star-shaped polygons.
+ * The benchmark results are printed out, not tested.
+ */
+
+// C/C++ standard libraries
+#include <cmath>
+#include <vector>
+#include <utility>
+#include <random>
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+
+// boost test libraries
+#define BOOST_TEST_MODULE ( Polygon2D_test )
+#include "boost/test/auto_unit_test.hpp"
+#include <boost/test/unit_test.hpp>
+
+// LArSoft libraries
+#include "larreco/RecoAlg/ClusterRecoUtil/Polygon2D.h"
+
+
+using Point_t = std::pair<float,float>;
+
+//------------------------------------------------------------------------------
+// reference (all-pairs) implementation
+namespace ref {
+
+  bool Clockwise(double Ax,double Ay,double Bx,double By,double Cx,double Cy)
+    { return (Cy-Ay)*(Bx-Ax) > (By-Ay)*(Cx-Ax); }
+
+  bool SegmentOverlap(double Ax, double Ay, double Bx, double By,
+                      double Cx, double Cy, double Dx, double Dy)
+  {
+    return (Clockwise(Ax,Ay,Cx,Cy,Dx,Dy) != Clockwise(Bx,By,Cx,Cy,Dx,Dy))
+      and (Clockwise(Ax,Ay,Bx,By,Cx,Cy) != Clockwise(Ax,Ay,Bx,By,Dx,Dy));
+  }
+
+  bool PointInside(const Polygon2D& poly, const Point_t& point) {
+    int intersections = 0;
+    for (unsigned int i = 0; i < poly.Size(); ++i) {
+      if (SegmentOverlap(poly.Point(i).first, poly.Point(i).second,
+                         poly.Point(i+1).first, poly.Point(i+1).second,
+                         10000.0, 10000.0, point.first, point.second))
+        ++intersections;
+    }
+    return (intersections % 2) == 1;
+  }
+
+  bool Contained(const Polygon2D& poly1, const Polygon2D& poly2) {
+    for (unsigned int i = 0; i < poly2.Size(); ++i)
+      if (!PointInside(poly1, poly2.Point(i))) return false;
+    return true;
+  }
+
+  bool PolyOverlapSegments(const Polygon2D& poly1, const Polygon2D& poly2) {
+    if (Contained(poly1, poly2) or Contained(poly2, poly1)) return true;
+    for (unsigned int i = 0; i < poly1.Size(); ++i) {
+      for (unsigned int j = 0; j < poly2.Size(); ++j) {
+        if (SegmentOverlap(poly1.Point(i).first, poly1.Point(i).second,
+                           poly1.Point(i+1).first, poly1.Point(i+1).second,
+                           poly2.Point(j).first, poly2.Point(j).second,
+                           poly2.Point(j+1).first, poly2.Point(j+1).second))
+          return true;
+      }
+    }
+    return false;
+  }
+
+} // namespace ref
+
+
+//------------------------------------------------------------------------------
+// random polygons
+class PolygonMaker {
+    public:
+  PolygonMaker(unsigned int seed): engine(seed) {}
+
+  /// convex hull of random points in a box of the given size
+  Polygon2D Convex(float x, float y, float size, unsigned int npoints) {
+    std::uniform_real_distribution<float> coord(-size/2., size/2.);
+    std::vector<Point_t> points(npoints);
+    for (auto& p: points) p = { x + coord(engine), y + coord(engine) };
+    std::sort(points.begin(), points.end());
+    auto cross = [](const Point_t& o, const Point_t& a, const Point_t& b)
+      { return (a.first-o.first)*(b.second-o.second) - (a.second-o.second)*(b.first-o.first); };
+    std::vector<Point_t> hull(2*npoints);
+    size_t k = 0;
+    for (size_t i = 0; i < npoints; ++i) {
+      while (k >= 2 && cross(hull[k-2], hull[k-1], points[i]) <= 0) --k;
+      hull[k++] = points[i];
+    }
+    for (size_t i = npoints-1, t = k+1; i > 0; --i) {
+      while (k >= t && cross(hull[k-2], hull[k-1], points[i-1]) <= 0) --k;
+      hull[k++] = points[i-1];
+    }
+    hull.resize(k-1);
+    return Polygon2D(hull);
+  }
+
+  /// star-shaped (generally not convex) polygon around (x, y)
+  Polygon2D Star(float x, float y, float size, unsigned int nvertices) {
+    std::uniform_real_distribution<float> radius(size/10., size/2.);
+    std::vector<Point_t> vertices;
+    for (unsigned int i = 0; i < nvertices; ++i) {
+      double phi = 2. * M_PI * i / nvertices;
+      double r = radius(engine);
+      vertices.emplace_back(x + r * std::cos(phi), y + r * std::sin(phi));
+    }
+    return Polygon2D(vertices);
+  }
+
+  Point_t RandomPoint(float size) {
+    std::uniform_real_distribution<float> coord(0., size);
+    return { coord(engine), coord(engine) };
+  }
+
+    private:
+  std::mt19937 engine;
+}; // class PolygonMaker
+
+
+//------------------------------------------------------------------------------
+BOOST_AUTO_TEST_SUITE( Polygon2DSuite )
+
+
+BOOST_AUTO_TEST_CASE(ConvexityTest)
+{
+  Polygon2D square({ { 0., 0. }, { 1., 0. }, { 1., 1. }, { 0., 1. } });
+  BOOST_CHECK(square.IsConvex());
+  BOOST_CHECK_EQUAL(square.BoundingBoxMin().first, 0.);
+  BOOST_CHECK_EQUAL(square.BoundingBoxMax().second, 1.);
+
+  Polygon2D arrow({ { 0., 0. }, { 2., 1. }, { 0., 2. }, { 1., 1. } });
+  BOOST_CHECK(!arrow.IsConvex());
+
+  // a pentagram turns always the same way, but winds twice
+  std::vector<Point_t> star;
+  for (int i = 0; i < 5; ++i)
+    star.emplace_back(std::cos(4. * M_PI * i / 5.), std::sin(4. * M_PI * i / 5.));
+  BOOST_CHECK(!Polygon2D(star).IsConvex());
+
+  BOOST_CHECK( square.PointInside({ 0.5, 0.5 }));
+  BOOST_CHECK(!square.PointInside({ 1.5, 0.5 }));
+  BOOST_CHECK( arrow.PointInside({ 1.5, 1.0 }));
+  BOOST_CHECK(!arrow.PointInside({ 0.5, 1.0 }));
+} // ConvexityTest
+
+
+BOOST_AUTO_TEST_CASE(CompareWithReferenceTest)
+{
+  PolygonMaker maker(12345);
+  const float world = 100.;
+
+  for (int iTest = 0; iTest < 400; ++iTest) {
+    Point_t c1 = maker.RandomPoint(world), c2 = maker.RandomPoint(world);
+    bool convex = (iTest % 2 == 0);
+    Polygon2D poly1 = convex
+      ? maker.Convex(c1.first, c1.second, 30., 40): maker.Star(c1.first, c1.second, 30., 25);
+    Polygon2D poly2 = convex
+      ? maker.Convex(c2.first, c2.second, 10., 20): maker.Star(c2.first, c2.second, 10., 15);
+    if (convex) BOOST_CHECK(poly1.IsConvex());
+
+    std::vector<Point_t> points;
+    for (int i = 0; i < 50; ++i) points.push_back(maker.RandomPoint(world));
+    for (auto const& point: points)
+      BOOST_CHECK_EQUAL(poly1.PointInside(point), ref::PointInside(poly1, point));
+
+    BOOST_CHECK_EQUAL(poly1.Contained(poly2), ref::Contained(poly1, poly2));
+    BOOST_CHECK_EQUAL
+      (poly1.PolyOverlapSegments(poly2), ref::PolyOverlapSegments(poly1, poly2));
+    BOOST_CHECK_EQUAL
+      (poly2.PolyOverlapSegments(poly1), ref::PolyOverlapSegments(poly2, poly1));
+  } // for
+} // CompareWithReferenceTest
+
+
+BOOST_AUTO_TEST_CASE(BenchmarkTest)
+{
+  // many small cluster-like convex polygons, all pairs compared
+  PolygonMaker maker(54321);
+  std::vector<Polygon2D> polygons;
+  for (int i = 0; i < 300; ++i) {
+    Point_t c = maker.RandomPoint(1000.);
+    polygons.push_back(maker.Convex(c.first, c.second, 50., 60));
+  }
+
+  using clock = std::chrono::steady_clock;
+  unsigned int nRef = 0, nFast = 0;
+
+  auto start = clock::now();
+  for (auto const& p1: polygons)
+    for (auto const& p2: polygons) if (ref::PolyOverlapSegments(p1, p2)) ++nRef;
+  auto refTime = std::chrono::duration<double>(clock::now() - start).count();
+
+  start = clock::now();
+  for (auto const& p1: polygons)
+    for (auto const& p2: polygons) if (p1.PolyOverlapSegments(p2)) ++nFast;
+  auto fastTime = std::chrono::duration<double>(clock::now() - start).count();
+
+  BOOST_CHECK_EQUAL(nFast, nRef);
+  std::cout << "PolyOverlapSegments on " << polygons.size() << "^2 pairs: "
+    << refTime << " s (all pairs) vs. " << fastTime << " s" << std::endl;
+} // BenchmarkTest
+
+
+BOOST_AUTO_TEST_SUITE_END()
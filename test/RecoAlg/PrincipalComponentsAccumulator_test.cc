@@ -0,0 +1,217 @@
+/**
+ * @file   PrincipalComponentsAccumulator_test.cc
+ * @brief  Test and micro-benchmark for the closed form PCA of Cluster3D
+ * @see    PrincipalComponentsAccumulator.h
+ *
+ * The closed form eigen decomposition is compared with the TDecompSVD result
+ * on random elongated point clouds, and the moments updated by adding and
+ * removing points are compared with the ones accumulated from scratch.
+ * The benchmark results are printed out, not tested.
+ */
+
+// C/C++ standard libraries
+#include <cmath>
+#include <vector>
+#include <array>
+#include <random>
+#include <chrono>
+#include <iostream>
+
+// boost test libraries
+#define BOOST_TEST_MODULE ( PrincipalComponentsAccumulator_test )
+#include "boost/test/auto_unit_test.hpp"
+#include <boost/test/unit_test.hpp>
+
+// ROOT libraries
+#include "TMatrixD.h"
+#include "TVectorD.h"
+#include "TDecompSVD.h"
+
+// LArSoft libraries
+#include "larreco/RecoAlg/Cluster3DAlgs/PrincipalComponentsAccumulator.h"
+
+
+using Point_t = std::array<double, 3>;
+
+//------------------------------------------------------------------------------
+/// Random cloud of points along a line, with the specified spreads
+std::vector<Point_t> MakeCloud
+  (std::mt19937& engine, unsigned int nPoints, double length, double width1, double width2)
+{
+  std::uniform_real_distribution<double> uniform(-1., 1.);
+  std::normal_distribution<double> gaus;
+
+  // random orthonormal frame
+  Point_t dir = {{ uniform(engine), uniform(engine), uniform(engine) }};
+  double mag = std::sqrt(dir[0]*dir[0] + dir[1]*dir[1] + dir[2]*dir[2]);
+  for (auto& c: dir) c /= mag;
+  Point_t ortho1 = {{ -dir[1], dir[0], 0. }};
+  mag = std::sqrt(ortho1[0]*ortho1[0] + ortho1[1]*ortho1[1]);
+  for (auto& c: ortho1) c /= mag;
+  Point_t ortho2 = {{
+    dir[1]*ortho1[2] - dir[2]*ortho1[1],
+    dir[2]*ortho1[0] - dir[0]*ortho1[2],
+    dir[0]*ortho1[1] - dir[1]*ortho1[0]
+  }};
+
+  Point_t center = {{ 200. * uniform(engine), 100. * uniform(engine), 500. * uniform(engine) }};
+
+  std::vector<Point_t> points;
+  for (unsigned int i = 0; i < nPoints; ++i) {
+    double a = length * uniform(engine), b = width1 * gaus(engine), c = width2 * gaus(engine);
+    Point_t p;
+    for (int k = 0; k < 3; ++k)
+      p[k] = center[k] + a * dir[k] + b * ortho1[k] + c * ortho2[k];
+    points.push_back(p);
+  } // for
+  return points;
+} // MakeCloud()
+
+
+/// Decomposition with TDecompSVD, as done in PrincipalComponentsAlg
+bool RootDecompose
+  (const double covariance[3][3], double eigenValues[3], double eigenVectors[3][3])
+{
+  TMatrixD sigma(3, 3);
+  for (int i = 0; i < 3; ++i)
+    for (int j = 0; j < 3; ++j) sigma(i, j) = covariance[i][j];
+
+  TDecompSVD rootSVD(sigma);
+  if (!rootSVD.Decompose()) return false;
+
+  TVectorD eigenVals = rootSVD.GetSig();
+  TMatrixD eigenVecs = rootSVD.GetU();
+  for (int i = 0; i < 3; ++i) {
+    eigenValues[i] = eigenVals[i];
+    for (int j = 0; j < 3; ++j) eigenVectors[i][j] = eigenVecs(j, i);
+  }
+  return true;
+} // RootDecompose()
+
+
+//------------------------------------------------------------------------------
+BOOST_AUTO_TEST_SUITE( PrincipalComponentsAccumulatorSuite )
+
+
+BOOST_AUTO_TEST_CASE(CompareWithROOTTest)
+{
+  std::mt19937 engine(12345);
+
+  for (int iTest = 0; iTest < 1000; ++iTest) {
+    // every few tests, make the two transverse spreads equal (degenerate case)
+    double width1 = 0.1 + iTest % 7;
+    double width2 = (iTest % 5 == 0)? width1: 0.05 + iTest % 3;
+    auto points = MakeCloud(engine, 3 + iTest % 500, 5. + iTest % 100, width1, width2);
+
+    lar_cluster3d::PrincipalComponentsAccumulator moments;
+    for (auto const& p: points) moments.Add(p[0], p[1], p[2]);
+
+    double eigenValues[3], eigenVectors[3][3];
+    BOOST_CHECK(moments.Decompose(eigenValues, eigenVectors));
+
+    double covariance[3][3], rootValues[3], rootVectors[3][3];
+    moments.GetCovariance(covariance);
+    BOOST_CHECK(RootDecompose(covariance, rootValues, rootVectors));
+
+    double const scale = rootValues[0];
+    for (int i = 0; i < 3; ++i)
+      BOOST_CHECK_SMALL((eigenValues[i] - rootValues[i]) / scale, 1e-9);
+
+    // eigenvectors are defined up to the sign, and only for distinct eigenvalues
+    for (int i = 0; i < 3; ++i) {
+      double gap = std::min(
+        (i > 0)? rootValues[i-1] - rootValues[i]: scale,
+        (i < 2)? rootValues[i] - rootValues[i+1]: scale
+        );
+      if (gap < 1e-3 * scale) continue;
+      double dot = 0.;
+      for (int j = 0; j < 3; ++j) dot += eigenVectors[i][j] * rootVectors[i][j];
+      BOOST_CHECK_CLOSE(std::abs(dot), 1., 1e-6);
+    } // for
+  } // for
+} // CompareWithROOTTest
+
+
+BOOST_AUTO_TEST_CASE(UpdateTest)
+{
+  std::mt19937 engine(54321);
+  auto points = MakeCloud(engine, 300, 50., 1., 0.5);
+
+  // all points, then the first third removed and added back from another accumulator
+  lar_cluster3d::PrincipalComponentsAccumulator all, updated, removed;
+  for (auto const& p: points) {
+    all.Add(p[0], p[1], p[2]);
+    updated.Add(p[0], p[1], p[2]);
+  }
+  for (size_t i = 0; i < points.size() / 3; ++i) {
+    updated.Remove(points[i][0], points[i][1], points[i][2]);
+    removed.Add(points[i][0], points[i][1], points[i][2]);
+  }
+  BOOST_CHECK_EQUAL(updated.NumPoints(), points.size() - points.size() / 3);
+  updated.Add(removed);
+  BOOST_CHECK_EQUAL(updated.NumPoints(), all.NumPoints());
+
+  double allMean[3], updatedMean[3], allCov[3][3], updatedCov[3][3];
+  all.GetMean(allMean);
+  updated.GetMean(updatedMean);
+  all.GetCovariance(allCov, allMean);
+  updated.GetCovariance(updatedCov);
+  for (int i = 0; i < 3; ++i) {
+    BOOST_CHECK_CLOSE(updatedMean[i], allMean[i], 1e-9);
+    for (int j = 0; j < 3; ++j)
+      BOOST_CHECK_SMALL(updatedCov[i][j] - allCov[i][j], 1e-9 * allCov[0][0]);
+  }
+
+  // too few points
+  lar_cluster3d::PrincipalComponentsAccumulator single;
+  single.Add(1., 2., 3.);
+  double eigenValues[3], eigenVectors[3][3];
+  BOOST_CHECK(!single.Decompose(eigenValues, eigenVectors));
+} // UpdateTest
+
+
+BOOST_AUTO_TEST_CASE(BenchmarkTest)
+{
+  std::mt19937 engine(2468);
+  std::vector<std::array<std::array<double, 3>, 3>> matrices;
+  for (int i = 0; i < 10000; ++i) {
+    auto points = MakeCloud(engine, 20, 20., 1., 0.3);
+    lar_cluster3d::PrincipalComponentsAccumulator moments;
+    for (auto const& p: points) moments.Add(p[0], p[1], p[2]);
+    double covariance[3][3];
+    moments.GetCovariance(covariance);
+    std::array<std::array<double, 3>, 3> m;
+    for (int j = 0; j < 3; ++j)
+      for (int k = 0; k < 3; ++k) m[j][k] = covariance[j][k];
+    matrices.push_back(m);
+  }
+
+  using clock = std::chrono::steady_clock;
+  double eigenValues[3], eigenVectors[3][3], covariance[3][3];
+  double sumRoot = 0., sumAnalytic = 0.;
+
+  auto start = clock::now();
+  for (auto const& m: matrices) {
+    for (int j = 0; j < 3; ++j)
+      for (int k = 0; k < 3; ++k) covariance[j][k] = m[j][k];
+    RootDecompose(covariance, eigenValues, eigenVectors);
+    sumRoot += eigenValues[1];
+  }
+  auto rootTime = std::chrono::duration<double>(clock::now() - start).count();
+
+  start = clock::now();
+  for (auto const& m: matrices) {
+    for (int j = 0; j < 3; ++j)
+      for (int k = 0; k < 3; ++k) covariance[j][k] = m[j][k];
+    lar_cluster3d::SymmetricEigen3x3(covariance, eigenValues, eigenVectors);
+    sumAnalytic += eigenValues[1];
+  }
+  auto analyticTime = std::chrono::duration<double>(clock::now() - start).count();
+
+  BOOST_CHECK_CLOSE(sumAnalytic, sumRoot, 1e-6);
+  std::cout << matrices.size() << " 3x3 decompositions: " << rootTime
+    << " s (TDecompSVD) vs. " << analyticTime << " s (closed form)" << std::endl;
+} // BenchmarkTest
+
+
+BOOST_AUTO_TEST_SUITE_END()
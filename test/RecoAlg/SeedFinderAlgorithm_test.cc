@@ -0,0 +1,151 @@
+/**
+ * @file   SeedFinderAlgorithm_test.cc
+ * @brief  Test of the incremental book keeping of the seed search
+ * @see    SeedFinderAlgorithm.h
+ *
+ * The seed search changes the status of the space points and of the hits a few
+ * at a time, the way FindSeeds() does. After each step, the unused point list,
+ * the number of used points and the list of the seed hits must be the same as
+ * the ones the old code recomputed by scanning all the statuses.
+ */
+
+// C/C++ standard libraries
+#include <vector>
+#include <random>
+
+// boost test libraries
+#define BOOST_TEST_MODULE ( SeedFinderAlgorithm_test )
+#include "boost/test/auto_unit_test.hpp"
+#include <boost/test/unit_test.hpp>
+
+// LArSoft libraries
+#include "larreco/RecoAlg/SeedFinderAlgorithm.h"
+
+
+//------------------------------------------------------------------------------
+/// Compares the point book keeping with a scan of all the statuses
+void CheckPoints(trkf::SeedFinderAlgorithm::SpacePointStatus const& PointStatus)
+{
+  // unused points from high z, as the old FindSeedAtEnd() loop visited them
+  std::vector<int> unused;
+  int nUsed = 0;
+  for (int i = int(PointStatus.Status.size()) - 1; i >= 0; --i) {
+    if (PointStatus.Status[i] == 0) unused.push_back(i);
+    else ++nUsed;
+  }
+
+  std::vector<int> walked;
+  for (int i = PointStatus.Top; i != -1; i = PointStatus.Lower[i]) walked.push_back(i);
+
+  BOOST_CHECK_EQUAL(PointStatus.Top, unused.empty()? -1: unused.front());
+  BOOST_CHECK_EQUAL_COLLECTIONS(walked.begin(), walked.end(), unused.begin(), unused.end());
+  BOOST_CHECK_EQUAL(PointStatus.NUsed, nUsed);
+} // CheckPoints()
+
+
+/// Hits with status 2, in index order, as the old loops over HitStatus found them
+std::vector<int> ScanSeedHits(std::vector<char> const& HitStatus)
+{
+  std::vector<int> seedHits;
+  for (size_t i = 0; i < HitStatus.size(); ++i)
+    if (HitStatus[i] == 2) seedHits.push_back(i);
+  return seedHits;
+} // ScanSeedHits()
+
+
+/// Compares the compacted seed hit list with a scan of all the statuses
+void CheckSeedHits(std::vector<char> const& HitStatus, std::vector<int>& SeedHits)
+{
+  trkf::SeedFinderAlgorithm::CompactSeedHits(HitStatus, SeedHits);
+  std::vector<int> const expected = ScanSeedHits(HitStatus);
+  BOOST_CHECK_EQUAL_COLLECTIONS(SeedHits.begin(), SeedHits.end(), expected.begin(), expected.end());
+} // CheckSeedHits()
+
+
+/// Changes the status of a few hits, as ConsolidateSeed() does: some seed hits
+/// are tossed and some free hits are added, maybe more than once
+void ConsolidateHits(std::mt19937& engine, std::vector<char>& HitStatus, std::vector<int>& SeedHits)
+{
+  std::uniform_int_distribution<int> hit(0, HitStatus.size() - 1), toss(0, 2);
+  for (int n = 0; n < 20; ++n) {
+    int const h = hit(engine);
+    if (HitStatus[h] == 2 && toss(engine) == 0) HitStatus[h] = 0;
+    else if (HitStatus[h] != 1) trkf::SeedFinderAlgorithm::SetHitStatus(HitStatus, SeedHits, h, 2);
+  } // for
+} // ConsolidateHits()
+
+
+//------------------------------------------------------------------------------
+BOOST_AUTO_TEST_SUITE( SeedFinderAlgorithmSuite )
+
+
+BOOST_AUTO_TEST_CASE(SpacePointStatusTest)
+{
+  std::mt19937 engine(1357);
+
+  for (size_t nPoints: { 0, 1, 2, 10, 300 }) {
+    trkf::SeedFinderAlgorithm::SpacePointStatus PointStatus(nPoints);
+    CheckPoints(PointStatus);
+    if (nPoints == 0) continue;
+
+    // points are used or thrown, some of them more than once, until none is left
+    std::uniform_int_distribution<int> point(0, nPoints - 1), status(1, 2);
+    while (PointStatus.Top != -1) {
+      // mostly around the top, where FindSeedAtEnd() looks
+      int const p = (point(engine) % 3 == 0)? point(engine): PointStatus.Top;
+      PointStatus.Set(p, status(engine));
+      CheckPoints(PointStatus);
+    } // while
+
+    // no point left: FindSeeds() is told to stop
+    PointStatus.Set(0, 3);
+    CheckPoints(PointStatus);
+    BOOST_CHECK_EQUAL(PointStatus.NUsed, int(nPoints));
+  } // for nPoints
+} // SpacePointStatusTest
+
+
+BOOST_AUTO_TEST_CASE(SeedHitsTest)
+{
+  std::mt19937 engine(2468);
+  size_t const nHits = 200;
+  std::uniform_int_distribution<int> hit(0, nHits - 1), nRefits(0, 4), fail(0, 3);
+
+  std::vector<char> HitStatus(nHits, 0);
+  std::vector<int> SeedHits;
+  for (int seed = 0; seed < 30; ++seed) {
+    // hits of the space points of the seed, even if already used
+    for (int n = 0; n < 10; ++n)
+      trkf::SeedFinderAlgorithm::SetHitStatus(HitStatus, SeedHits, hit(engine), 2);
+    ConsolidateHits(engine, HitStatus, SeedHits);
+    CheckSeedHits(HitStatus, SeedHits);
+
+    // refits, the last one maybe invalidating the seed
+    for (int r = nRefits(engine); r > 0; --r) {
+      trkf::SeedFinderAlgorithm::CompactSeedHits(HitStatus, SeedHits);
+      std::vector<char> const HitStatusGood = HitStatus;
+      std::vector<int> const SeedHitsGood = SeedHits;
+
+      ConsolidateHits(engine, HitStatus, SeedHits);
+      CheckSeedHits(HitStatus, SeedHits);
+
+      if (fail(engine) == 0) {
+        // the old code copied back the whole status vector
+        trkf::SeedFinderAlgorithm::RestoreSeedHits(HitStatus, SeedHits, SeedHitsGood);
+        BOOST_CHECK_EQUAL_COLLECTIONS(HitStatus.begin(), HitStatus.end(),
+                                      HitStatusGood.begin(), HitStatusGood.end());
+        CheckSeedHits(HitStatus, SeedHits);
+        break;
+      }
+    } // for refits
+
+    // the seed hits are collected and used
+    CheckSeedHits(HitStatus, SeedHits);
+    for (int h: SeedHits) HitStatus[h] = 1;
+    SeedHits.clear();
+    BOOST_CHECK(ScanSeedHits(HitStatus).empty());
+  } // for seeds
+} // SeedHitsTest
+
+
+BOOST_AUTO_TEST_SUITE_END()
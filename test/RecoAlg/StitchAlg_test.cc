@@ -0,0 +1,210 @@
+/**
+ * @file   StitchAlg_test.cc
+ * @brief  Test of the head and tail matching of the track stitcher
+ * @see    StitchAlg.h
+ *
+ * FindHeadsAndTails() compares each track only with the later tracks with an
+ * endpoint in the grid cells around its head and tail, and replays the conflict
+ * checks for the tracks it skips. Its matches must be the same as the ones of
+ * the loop over all the pairs of tracks it replaced, which is reproduced here.
+ */
+
+// C/C++ standard libraries
+#include <cmath>
+#include <cstdlib>
+#include <string>
+#include <tuple>
+#include <vector>
+#include <random>
+
+// boost test libraries
+#define BOOST_TEST_MODULE ( StitchAlg_test )
+#include "boost/test/auto_unit_test.hpp"
+#include <boost/test/unit_test.hpp>
+
+// LArSoft libraries
+#include "fhiclcpp/ParameterSet.h"
+#include "lardata/RecoBase/Track.h"
+#include "larreco/RecoAlg/StitchAlg.h"
+
+// ROOT libraries
+#include "TVector3.h"
+
+
+using HTMatch_t = trkf::StitchAlg::HTMatch_t;
+
+
+//------------------------------------------------------------------------------
+/// A straight track from start along dir
+recob::Track MakeTrack(TVector3 const& start, TVector3 const& dir, double length, int id)
+{
+  std::vector<TVector3> const xyz = { start, start + length * dir };
+  std::vector<TVector3> const dircos = { dir, dir };
+  return recob::Track(xyz, dircos, std::vector<std::vector<double>>(0), std::vector<double>(2, 0.), id);
+} // MakeTrack()
+
+
+/// Drops the match of track ii if one of the earlier tracks has a better match
+/// to the same end of the same track, as the old loop did after each later track
+void CheckConflicts(std::vector<HTMatch_t>& vv, std::vector<HTMatch_t>& f, int ii)
+{
+  if (vv.empty()) return;
+  int const otrk = std::get<2>(vv.back());
+  std::string const sotrkht(std::get<0>(vv.back()));
+  for (int kk = 0; kk < ii; ++kk) {
+    if (std::get<2>(f.at(kk)) == otrk && !sotrkht.compare(std::get<0>(f.at(kk)))) {
+      if (std::get<4>(vv.back()) < std::get<4>(f.at(kk)) && std::get<4>(vv.back()) != 0.0)
+        f.at(kk) = std::make_tuple(std::string("NA"), kk, -12, 0.0, 0.0);
+      else if (std::get<4>(vv.back()) != 0.0) {
+        vv.pop_back();
+        break;
+      }
+    }
+  } // for kk
+} // CheckConflicts()
+
+
+/// Head and tail matches from the loop over all the pairs of tracks
+void AllPairsHeadsAndTails(std::vector<recob::Track> const& tracks, double cosAngTol, double sepTol,
+                           std::vector<HTMatch_t>& fh, std::vector<HTMatch_t>& ft)
+{
+  fh.clear();
+  ft.clear();
+  int const ntrack = tracks.size();
+  for (int ii = 0; ii < ntrack; ++ii) {
+    TVector3 const start1(tracks[ii].Vertex()), end1(tracks[ii].End());
+    TVector3 const start1Dir(tracks[ii].VertexDirection()), end1Dir(tracks[ii].EndDirection());
+    std::vector<HTMatch_t> headvv, tailvv;
+    std::vector<std::vector<std::pair<double, double>>> matchhead, matchtail;
+    bool head = false, tail = false;
+
+    for (int jj = ii + 1; jj < ntrack; ++jj) {
+      TVector3 const start2(tracks[jj].Vertex()), end2(tracks[jj].End());
+      TVector3 const start2Dir(tracks[jj].VertexDirection()), end2Dir(tracks[jj].EndDirection());
+      std::string sHT2("NA");
+
+      bool const c12 = (std::abs(start1Dir.Dot(end2Dir)) > cosAngTol) && ((start1 - end2).Mag() < sepTol);
+      bool const c21 = (std::abs(end1Dir.Dot(start2Dir)) > cosAngTol) && ((start2 - end1).Mag() < sepTol);
+      bool const c11 = (std::abs(start1Dir.Dot(start2Dir)) > cosAngTol) && ((start1 - start2).Mag() < sepTol);
+      bool const c22 = (std::abs(end1Dir.Dot(end2Dir)) > cosAngTol) && ((end1 - end2).Mag() < sepTol);
+
+      if (c12 || c21 || c11 || c22) {
+        if (c12 || c11) head = true;
+        if (c11) sHT2 = "H"; else if (c12) sHT2 = "T";
+        if (c21 || c22) tail = true;
+        if (c21) sHT2 = "H"; else if (c22) sHT2 = "T";
+
+        if (head && tail) { // split the tie by distance
+          head = ((start1 - end2).Mag() < (start2 - end1).Mag()) || ((start1 - end2).Mag() < (start2 - end2).Mag())
+            || ((start1 - start2).Mag() < (start2 - end1).Mag()) || ((start1 - start2).Mag() < (start2 - end2).Mag());
+          tail = !head;
+        }
+
+        // the cosines are computed as in StitchAlg, which does not qualify abs
+        if (head) {
+          matchhead.push_back({ { abs(start1Dir.Dot(start2Dir)), (start1 - start2).Mag() },
+                                { abs(start1Dir.Dot(end2Dir)), (start1 - end2).Mag() } });
+          if (matchhead.size() == 1 || matchhead.back().at(0).second < matchhead.front().at(0).second
+              || matchhead.back().at(1).second < matchhead.front().at(1).second) {
+            if (matchhead.size() > 1) matchhead.erase(matchhead.begin());
+            if (headvv.size() > 1) headvv.erase(headvv.begin());
+            auto const& m = matchhead.back().at(sHT2 == "H"? 0: 1);
+            headvv.push_back(std::make_tuple(sHT2, ii, jj, m.first, m.second));
+          }
+          else matchhead.pop_back();
+        }
+        else if (tail) {
+          matchtail.push_back({ { abs(end1Dir.Dot(start2Dir)), (start2 - end1).Mag() },
+                                { abs(end1Dir.Dot(end2Dir)), (end1 - end2).Mag() } });
+          if (matchtail.size() == 1 || matchtail.back().at(0).second < matchtail.front().at(0).second
+              || matchtail.back().at(1).second < matchtail.front().at(1).second) {
+            if (matchtail.size() > 1) matchtail.erase(matchtail.begin());
+            if (tailvv.size() > 1) tailvv.erase(tailvv.begin());
+            auto const& m = matchtail.back().at(sHT2 == "T"? 0: 1);
+            tailvv.push_back(std::make_tuple(sHT2, ii, jj, m.first, m.second));
+          }
+          else matchtail.pop_back();
+        }
+      } // if match
+
+      CheckConflicts(headvv, fh, ii);
+      CheckConflicts(tailvv, ft, ii);
+    } // for jj
+
+    auto const noMatch = std::make_tuple(std::string("NA"), ii, -12, 0.0, 0.0);
+    fh.push_back(headvv.empty()? noMatch: headvv.back());
+    ft.push_back(tailvv.empty()? noMatch: tailvv.back());
+  } // for ii
+} // AllPairsHeadsAndTails()
+
+
+/// Compares the matches of the algorithm with the ones of all the pairs;
+/// returns the number of matched ends
+unsigned int CheckHeadsAndTails(std::vector<recob::Track> const& tracks, double cosAngTol, double sepTol)
+{
+  fhicl::ParameterSet pset;
+  pset.put("CosAngTolerance", cosAngTol);
+  pset.put("SpptSepTolerance", sepTol);
+  trkf::StitchAlg alg(pset);
+
+  std::vector<HTMatch_t> fh, ft;
+  alg.FindHeadsAndTails(tracks);
+  alg.GetHeadsAndTails(fh, ft);
+
+  std::vector<HTMatch_t> allfh, allft;
+  AllPairsHeadsAndTails(tracks, cosAngTol, sepTol, allfh, allft);
+
+  unsigned int nMatched = 0;
+  for (auto const* vv: { &fh, &ft }) {
+    auto const& all = (vv == &fh)? allfh: allft;
+    BOOST_CHECK_EQUAL(vv->size(), all.size());
+    for (size_t i = 0; i < std::min(vv->size(), all.size()); ++i) {
+      BOOST_CHECK_EQUAL(std::get<0>((*vv)[i]), std::get<0>(all[i]));
+      BOOST_CHECK_EQUAL(std::get<1>((*vv)[i]), std::get<1>(all[i]));
+      BOOST_CHECK_EQUAL(std::get<2>((*vv)[i]), std::get<2>(all[i]));
+      BOOST_CHECK_EQUAL(std::get<3>((*vv)[i]), std::get<3>(all[i]));
+      BOOST_CHECK_EQUAL(std::get<4>((*vv)[i]), std::get<4>(all[i]));
+      if (std::get<2>(all[i]) >= 0) ++nMatched;
+    }
+  } // for heads and tails
+  return nMatched;
+} // CheckHeadsAndTails()
+
+
+//------------------------------------------------------------------------------
+BOOST_AUTO_TEST_SUITE( StitchAlgSuite )
+
+
+BOOST_AUTO_TEST_CASE(HeadsAndTailsTest)
+{
+  std::mt19937 engine(97531);
+  std::uniform_real_distribution<double> cosine(-1., 1.), length(0., 20.), sepTol(1., 15.);
+  std::uniform_int_distribution<int> nTracks(1, 60), box(5, 200), cosAngTol(0, 4), pick(0, 49);
+
+  unsigned int nMatched = 0;
+  for (int event = 0; event < 200; ++event) {
+    // many short tracks in a small box, some along the same axis, so that
+    // tracks match several others and the conflict checks have work to do
+    std::uniform_real_distribution<double> position(0., box(engine));
+    std::vector<recob::Track> tracks;
+    for (int itrk = nTracks(engine); itrk > 0; --itrk) {
+      TVector3 dir(1., 0., 0.);
+      if (pick(engine) % 3 != 0) dir = TVector3(cosine(engine), cosine(engine), cosine(engine)).Unit();
+      TVector3 start(position(engine), position(engine), position(engine));
+      // an end which is not finite matches nothing
+      if (pick(engine) == 0) start.SetX(std::nan(""));
+      tracks.push_back(MakeTrack(start, dir, length(engine), tracks.size()));
+    } // for tracks
+
+    // a tolerance of 0 matches nothing
+    double const tol = (event % 4 == 0)? 0.: sepTol(engine);
+    nMatched += CheckHeadsAndTails(tracks, 0.5 + 0.1 * cosAngTol(engine), tol);
+  } // for events
+  BOOST_CHECK_GT(nMatched, 0U);
+
+  // no track, no match
+  BOOST_CHECK_EQUAL(CheckHeadsAndTails(std::vector<recob::Track>(), 0.95, 10.), 0U);
+} // HeadsAndTailsTest
+
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,153 @@
+/**
+ * @file   VertexFitAlg_test.cc
+ * @brief  Test of the Levenberg-Marquardt vertex fit against the Minuit one
+ * @see    VertexFitAlg.h
+ *
+ * Tracks from a common vertex are crossed with the wires of three planes and
+ * their hits are smeared in X. Both fits minimise the same chisq from the same
+ * starting values, so they must find the same vertex, track directions and
+ * chisq, within the Minuit convergence tolerance.
+ */
+
+// C/C++ standard libraries
+#include <cmath>
+#include <vector>
+#include <random>
+
+// boost test libraries
+#define BOOST_TEST_MODULE ( VertexFitAlg_test )
+#include "boost/test/auto_unit_test.hpp"
+#include <boost/test/unit_test.hpp>
+
+// LArSoft libraries
+#include "larreco/RecoAlg/VertexFitAlg.h"
+
+// ROOT libraries
+#include "TVector3.h"
+
+
+//------------------------------------------------------------------------------
+/// Three planes, at +/-30 degrees from the Z axis and along Y, 3 mm pitch
+trkf::VertexFitAlg::FitGeometry MakeGeometry()
+{
+  trkf::VertexFitAlg::FitGeometry fitGeom;
+  fitGeom.NPlanes = 3;
+  fitGeom.WirePitch = 0.3;
+  double const angles[3] = { M_PI / 6, -M_PI / 6, 0. };
+  for (unsigned short ipl = 0; ipl < 3; ++ipl) {
+    fitGeom.OrthY[ipl] = std::sin(angles[ipl]) / fitGeom.WirePitch;
+    fitGeom.OrthZ[ipl] = std::cos(angles[ipl]) / fitGeom.WirePitch;
+    // the wire numbers of the vertices are positive
+    fitGeom.FirstWire[ipl] = -500. - 10. * ipl;
+  }
+  return fitGeom;
+} // MakeGeometry()
+
+
+/// Adds the hits of the track on nWires wires of each plane, starting a few
+/// wires from the vertex so that the hits are not at the X of the vertex
+void AddTrack(std::mt19937& engine, trkf::VertexFitAlg::FitGeometry const& fitGeom,
+              TVector3 const& vtx, TVector3 const& dir, unsigned int nWires, double xErr,
+              std::vector<geo::WireID>& hitWID, std::vector<double>& hitX, std::vector<double>& hitXErr)
+{
+  std::normal_distribution<double> smear(0., xErr);
+  for (unsigned short ipl = 0; ipl < fitGeom.NPlanes; ++ipl) {
+    double const vWire = vtx.Y() * fitGeom.OrthY[ipl] + vtx.Z() * fitGeom.OrthZ[ipl] - fitGeom.FirstWire[ipl];
+    // wires crossed per cm along the track
+    double const dWire = dir.Y() * fitGeom.OrthY[ipl] + dir.Z() * fitGeom.OrthZ[ipl];
+    if (std::abs(dWire) < 0.5) continue;
+    for (unsigned int k = 4; k < 4 + nWires; ++k) {
+      double const wire = (dWire > 0)? std::floor(vWire) + k: std::ceil(vWire) - k;
+      double const s = (wire - vWire) / dWire;
+      hitWID.emplace_back(0, 0, ipl, (unsigned int) wire);
+      hitX.push_back(vtx.X() + s * dir.X() + smear(engine));
+      hitXErr.push_back(xErr);
+    } // for wires
+  } // for planes
+} // AddTrack()
+
+
+//------------------------------------------------------------------------------
+BOOST_AUTO_TEST_SUITE( VertexFitAlgSuite )
+
+
+BOOST_AUTO_TEST_CASE(CompareWithMinuitTest)
+{
+  trkf::VertexFitAlg::FitGeometry const fitGeom = MakeGeometry();
+  double const xErr = 0.05;
+
+  std::mt19937 engine(4321);
+  std::uniform_real_distribution<double> position(50., 150.), theta(0.4, 1.3), phi(0., 2 * M_PI),
+    offset(-0.1, 0.1), tilt(-0.03, 0.03);
+  std::uniform_int_distribution<unsigned int> nWires(5, 15);
+
+  for (int event = 0; event < 10; ++event) {
+    TVector3 const vtx(position(engine), position(engine), position(engine));
+    unsigned int const ntrks = 2 + event % 3;
+
+    std::vector<std::vector<geo::WireID>> hitWID(ntrks);
+    std::vector<std::vector<double>> hitX(ntrks), hitXErr(ntrks);
+    std::vector<TVector3> trueDir(ntrks), startDir(ntrks);
+    for (unsigned int itk = 0; itk < ntrks; ++itk) {
+      // the fits return DirX > 0; the tracks cross the wires of two planes at least
+      double const th = theta(engine), ph = phi(engine);
+      trueDir[itk] = TVector3(std::cos(th), std::sin(th) * std::cos(ph), std::sin(th) * std::sin(ph));
+      AddTrack(engine, fitGeom, vtx, trueDir[itk], nWires(engine), xErr,
+               hitWID[itk], hitX[itk], hitXErr[itk]);
+      startDir[itk] = (trueDir[itk] + TVector3(0., tilt(engine), tilt(engine))).Unit();
+    } // for tracks
+    TVector3 const startVtx = vtx + TVector3(offset(engine), offset(engine), offset(engine));
+
+    TVector3 lmPos(startVtx), lmPosErr;
+    std::vector<TVector3> lmDir(startDir), lmDirErr(ntrks);
+    float lmChiDOF;
+    trkf::VertexFitAlg::VertexFit(fitGeom, hitWID, hitX, hitXErr,
+                                  lmPos, lmPosErr, lmDir, lmDirErr, lmChiDOF);
+
+    TVector3 minuitPos(startVtx), minuitPosErr;
+    std::vector<TVector3> minuitDir(startDir), minuitDirErr(ntrks);
+    float minuitChiDOF;
+    trkf::VertexFitAlg::VertexFitMinuit(fitGeom, hitWID, hitX, hitXErr,
+                                        minuitPos, minuitPosErr, minuitDir, minuitDirErr, minuitChiDOF);
+
+    BOOST_TEST_MESSAGE("event " << event << " ChiDOF " << lmChiDOF << " (Minuit " << minuitChiDOF << ")");
+    BOOST_CHECK_LT(lmChiDOF, 5.);
+    // Minuit stops at a chisq/DOF within its tolerance of the minimum
+    BOOST_CHECK_CLOSE(lmChiDOF, minuitChiDOF, 2.);
+
+    for (unsigned short i = 0; i < 3; ++i) {
+      BOOST_CHECK_SMALL(lmPos[i] - minuitPos[i], 0.25 * lmPosErr[i] + 1E-3);
+      // Minuit estimates the covariance matrix on the way
+      BOOST_CHECK_CLOSE(lmPosErr[i], minuitPosErr[i], 50.);
+      BOOST_CHECK_SMALL(lmPos[i] - vtx[i], 0.5);
+    }
+    for (unsigned int itk = 0; itk < ntrks; ++itk) {
+      for (unsigned short i = 1; i < 3; ++i) {
+        BOOST_CHECK_SMALL(lmDir[itk][i] - minuitDir[itk][i], 0.25 * lmDirErr[itk][i] + 1E-3);
+        BOOST_CHECK_CLOSE(lmDirErr[itk][i], minuitDirErr[itk][i], 50.);
+        BOOST_CHECK_SMALL(lmDir[itk][i] - trueDir[itk][i], 0.2);
+      }
+    } // for tracks
+  } // for events
+} // CompareWithMinuitTest
+
+
+BOOST_AUTO_TEST_CASE(FailureTest)
+{
+  trkf::VertexFitAlg::FitGeometry const fitGeom = MakeGeometry();
+
+  // a single track can't make a vertex
+  std::mt19937 engine(1234);
+  std::vector<std::vector<geo::WireID>> hitWID(1);
+  std::vector<std::vector<double>> hitX(1), hitXErr(1);
+  TVector3 pos(100., 100., 100.), posErr;
+  std::vector<TVector3> dir(1, TVector3(0.6, 0.48, 0.64)), dirErr(1);
+  AddTrack(engine, fitGeom, pos, dir[0], 10, 0.05, hitWID[0], hitX[0], hitXErr[0]);
+
+  float chiDOF = 0;
+  trkf::VertexFitAlg::VertexFit(fitGeom, hitWID, hitX, hitXErr, pos, posErr, dir, dirErr, chiDOF);
+  BOOST_CHECK_EQUAL(chiDOF, 9999);
+} // FailureTest
+
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,91 @@
+/**
+ * @file   fuzzyClusterAlg_test.cc
+ * @brief  Test of the Hough transform of the fuzzy cluster regions on threads
+ * @see    fuzzyClusterAlg.h
+ *
+ * Each region of fuzzyClusterAlg draws the hits of its Hough lines at random
+ * from its own engine. Here a transform draws hits in the same way, and the
+ * lines of all the regions must be the same with one thread and with many.
+ */
+
+// C/C++ standard libraries
+#include <vector>
+#include <random>
+
+// boost test libraries
+#define BOOST_TEST_MODULE ( fuzzyClusterAlg_test )
+#include "boost/test/auto_unit_test.hpp"
+#include <boost/test/unit_test.hpp>
+
+// LArSoft libraries
+#include "larreco/RecoAlg/fuzzyClusterAlg.h"
+
+// CLHEP libraries
+#include "CLHEP/Random/RandFlat.h"
+
+
+//------------------------------------------------------------------------------
+/// Line number of each hit of each region, with the lines made of random hits
+std::vector<std::vector<unsigned int> > FindLines(std::vector<long> const& seeds,
+                                                  std::vector<unsigned int> const& nHits,
+                                                  unsigned int nThreads)
+{
+  std::vector<std::vector<unsigned int> > lineIds(seeds.size());
+  cluster::fuzzyClusterAlg::ForEachRegion(seeds, nThreads,
+    [&](size_t region, CLHEP::HepRandomEngine& engine){
+      // as HoughBaseAlg::Transform, pick hits at random until all are used
+      CLHEP::RandFlat flat(engine);
+      std::vector<unsigned int>& ids = lineIds[region];
+      ids.assign(nHits[region], 0);
+      std::vector<unsigned int> free(nHits[region]);
+      for (unsigned int i = 0; i < free.size(); ++i) free[i] = i;
+      unsigned int line = 1;
+      while (!free.empty()) {
+        unsigned int const pick = flat.fireInt(free.size());
+        ids[free[pick]] = line;
+        free.erase(free.begin() + pick);
+        if (flat.fire() < 0.3) ++line;
+      }
+    });
+  return lineIds;
+} // FindLines()
+
+
+//------------------------------------------------------------------------------
+BOOST_AUTO_TEST_SUITE( fuzzyClusterAlgSuite )
+
+
+BOOST_AUTO_TEST_CASE(ForEachRegionTest)
+{
+  // regions of very different sizes, some empty, so that the threads do not
+  // take them in order
+  std::mt19937 engine(2468);
+  std::uniform_int_distribution<long> seed(0, 900000000L);
+  std::uniform_int_distribution<unsigned int> size(0, 2000);
+  std::vector<long> seeds(40);
+  std::vector<unsigned int> nHits(seeds.size());
+  for (size_t region = 0; region < seeds.size(); ++region) {
+    seeds[region] = seed(engine);
+    nHits[region] = (region % 5 == 0)? 0: size(engine);
+  }
+
+  auto const serial = FindLines(seeds, nHits, 1);
+  for (unsigned int nThreads: { 2, 4, 16 }) {
+    auto const parallel = FindLines(seeds, nHits, nThreads);
+    BOOST_CHECK_EQUAL(parallel.size(), serial.size());
+    for (size_t region = 0; region < serial.size(); ++region) {
+      BOOST_CHECK_EQUAL_COLLECTIONS(parallel[region].begin(), parallel[region].end(),
+                                    serial[region].begin(), serial[region].end());
+    }
+  } // for nThreads
+
+  // a region does not depend on the others either
+  std::vector<long> const oneSeed(1, seeds[7]);
+  std::vector<unsigned int> const oneSize(1, nHits[7]);
+  auto const alone = FindLines(oneSeed, oneSize, 1);
+  BOOST_CHECK_EQUAL_COLLECTIONS(alone[0].begin(), alone[0].end(),
+                                serial[7].begin(), serial[7].end());
+} // ForEachRegionTest
+
+
+BOOST_AUTO_TEST_SUITE_END()